@@ -0,0 +1,114 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/infrastructure/BenchmarkMeasurementContainer.h"
+#include "index/ColumnCodec.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Compare the different `ColumnCodec`s for the columns of the permutations
+// with respect to the size of the compressed columns and the time needed for
+// decompressing them, which is the dominant cost of large index scans.
+class ColumnCodecBenchmark : public BenchmarkInterface {
+  // The number of rows of a single column, this corresponds to the default
+  // uncompressed block size of 8 MB per column.
+  static constexpr size_t numRows = 1'000'000;
+  // The number of times each column is decompressed per measurement.
+  static constexpr size_t numRepetitions = 10;
+
+  std::string name() const final {
+    return "Compression and decompression of the columns of a permutation "
+           "with the different column codecs";
+  }
+
+  // Typical columns of the blocks of a permutation.
+  static std::vector<std::pair<std::string, std::vector<Id>>> getColumns() {
+    auto V = [](uint64_t bits) { return Id::fromBits(bits); };
+    ad_utility::SlowRandomIntGenerator<uint64_t> smallGaps{0, 10};
+    ad_utility::SlowRandomIntGenerator<uint64_t> allValues{};
+    ad_utility::SlowRandomIntGenerator<uint64_t> mostlyEqual{0, 99};
+    std::vector<std::pair<std::string, std::vector<Id>>> columns;
+    auto add = [&columns](std::string name, auto generator) {
+      std::vector<Id> column;
+      column.reserve(numRows);
+      for (size_t i = 0; i < numRows; ++i) {
+        column.push_back(generator(i));
+      }
+      columns.emplace_back(std::move(name), std::move(column));
+    };
+    // The first column of a block, which typically contains only a single or
+    // few different relations.
+    add("col0 (constant)", [&](size_t) { return V(1'234'567); });
+    add("col0 (few runs)",
+        [&](size_t i) { return V(1'234'567 + i / (numRows / 10)); });
+    // The second column of a block, which is sorted.
+    add("col1 (sorted)", [&, current = uint64_t{1'000'000}](size_t) mutable {
+      current += smallGaps();
+      return V(current);
+    });
+    // The graph column, which often contains only the default graph.
+    add("graph (almost constant)", [&](size_t) {
+      return V(mostlyEqual() == 0 ? 42 : 17);
+    });
+    // The third column with arbitrary values.
+    add("col2 (random)", [&](size_t) { return V(allValues()); });
+    return columns;
+  }
+
+  BenchmarkResults runAllBenchmarks() final {
+    BenchmarkResults results{};
+    auto columns = getColumns();
+    std::vector<std::string> rowNames;
+    for (const auto& [columnName, column] : columns) {
+      rowNames.push_back(columnName);
+    }
+    std::vector<std::string> columnNames{"column"};
+    for (ColumnCodec codec : columnCodec::allCodecs) {
+      columnNames.emplace_back(toString(codec));
+    }
+    columnNames.emplace_back("chosen codec");
+
+    auto& sizes = results.addTable("Compressed size in bytes (uncompressed: " +
+                                       std::to_string(numRows * sizeof(Id)) +
+                                       ")",
+                                   rowNames, columnNames);
+    auto& times = results.addTable(
+        "Time for decompressing the column " + std::to_string(numRepetitions) +
+            " times",
+        rowNames, columnNames);
+
+    std::vector<Id> target(numRows);
+    for (size_t row = 0; row < columns.size(); ++row) {
+      const auto& column = columns.at(row).second;
+      for (size_t i = 0; i < columnCodec::allCodecs.size(); ++i) {
+        ColumnCodec codec = columnCodec::allCodecs.at(i);
+        auto compressed = columnCodec::compress(column, codec);
+        if (!compressed.has_value()) {
+          sizes.setEntry(row, i + 1, std::string{"not applicable"});
+          times.setEntry(row, i + 1, std::string{"not applicable"});
+          continue;
+        }
+        sizes.setEntry(row, i + 1, compressed->size());
+        times.addMeasurement(row, i + 1, [&]() {
+          for (size_t j = 0; j < numRepetitions; ++j) {
+            columnCodec::decompress(codec, compressed.value(), target);
+          }
+        });
+        AD_CORRECTNESS_CHECK(target == column);
+      }
+      auto chosenCodec = std::string{
+          toString(columnCodec::compressWithBestCodec(column).codec_)};
+      sizes.setEntry(row, columnNames.size() - 1, chosenCodec);
+      times.setEntry(row, columnNames.size() - 1, chosenCodec);
+    }
+    return results;
+  }
+};
+
+AD_REGISTER_BENCHMARK(ColumnCodecBenchmark);
+}  // namespace ad_benchmark
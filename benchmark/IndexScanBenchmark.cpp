@@ -0,0 +1,162 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/infrastructure/BenchmarkMeasurementContainer.h"
+#include "index/CompressedRelation.h"
+#include "index/LocatedTriples.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Compare index scans on a permutation that is stored compressed (the default)
+// with scans on a permutation that is stored uncompressed, both via reading
+// from the file and via a memory mapping of the file, and with the zero-copy
+// `CompressedRelationReader::scanAsView`.
+class IndexScanBenchmark : public BenchmarkInterface {
+  using ScanSpecAndBlocks = CompressedRelationReader::ScanSpecAndBlocks;
+  // The permutation consists of `numRelations` relations (e.g. predicates in
+  // PSO) with `numRowsPerRelation` rows each.
+  static constexpr size_t numRelations = 20;
+  static constexpr size_t numRowsPerRelation = 100'000;
+  // The number of rows with the same `col1Id` in each relation.
+  static constexpr size_t numRowsPerCol1 = 10;
+  // The number of times each scan is performed per measurement.
+  static constexpr size_t numRepetitions = 100;
+
+  std::string name() const final {
+    return "Index scans on compressed and uncompressed (memory-mapped) "
+           "permutations";
+  }
+
+  static Id V(uint64_t bits) { return Id::fromBits(bits); }
+
+  // The triples of the permutation in blocks, sorted by the first three
+  // columns. The last column is the graph column.
+  static cppcoro::generator<IdTableStatic<0>> makeSortedTriples() {
+    ad_utility::SlowRandomIntGenerator<uint64_t> randomObject{0, 999'999};
+    static constexpr size_t numColumns = 4;
+    IdTableStatic<0> block{numColumns,
+                           ad_utility::makeUnlimitedAllocator<Id>()};
+    for (size_t col0 = 0; col0 < numRelations; ++col0) {
+      for (size_t i = 0; i < numRowsPerRelation; ++i) {
+        // Make the `col2` sorted within each `(col0, col1)` range.
+        uint64_t col2 = randomObject() / numRowsPerCol1 +
+                        (i % numRowsPerCol1) * (1'000'000 / numRowsPerCol1);
+        block.push_back({V(col0), V(i / numRowsPerCol1), V(col2), V(0)});
+      }
+      co_yield block;
+      block.clear();
+    }
+  }
+
+  // Write the permutation to `filename` (and the twin permutation, which is
+  // not used by this benchmark, to `filename + ".twin"`) and return the
+  // metadata of its blocks.
+  static std::vector<CompressedBlockMetadata> writePermutation(
+      const std::string& filename, bool storeUncompressed) {
+    auto blocksize = UNCOMPRESSED_BLOCKSIZE_COMPRESSED_METADATA_PER_COLUMN;
+    CompressedRelationWriter writer1{4, ad_utility::File{filename, "w"},
+                                     blocksize, 0, storeUncompressed};
+    CompressedRelationWriter writer2{4,
+                                     ad_utility::File{filename + ".twin", "w"},
+                                     blocksize, 0, storeUncompressed};
+    auto ignoreMetadata = [](ql::span<const CompressedRelationMetadata>) {};
+    auto result = CompressedRelationWriter::createPermutationPair(
+        filename, {writer1, ignoreMetadata}, {writer2, ignoreMetadata},
+        makeSortedTriples(), qlever::KeyOrder{0, 1, 2, 3}, {});
+    std::remove((filename + ".twin").c_str());
+    return std::move(result.blockMetadata_);
+  }
+
+  // The `BlockMetadataRanges` for all the `blocks`.
+  static BlockMetadataRanges allBlocks(
+      const std::vector<CompressedBlockMetadata>& blocks) {
+    BlockMetadataSpan span{blocks};
+    return {{span.begin(), span.end()}};
+  }
+
+  BenchmarkResults runAllBenchmarks() final {
+    BenchmarkResults results{};
+    const std::string filenameCompressed = "indexScanBenchmark.compressed";
+    const std::string filenameUncompressed = "indexScanBenchmark.uncompressed";
+    auto blocksCompressed = writePermutation(filenameCompressed, false);
+    auto blocksUncompressed = writePermutation(filenameUncompressed, true);
+    auto makeReader = [](const std::string& filename) {
+      return std::make_unique<CompressedRelationReader>(
+          ad_utility::makeUnlimitedAllocator<Id>(),
+          ad_utility::File{filename, "r"});
+    };
+    auto readerCompressed = makeReader(filenameCompressed);
+    auto readerUncompressed = makeReader(filenameUncompressed);
+    auto readerMapped = makeReader(filenameUncompressed);
+    readerMapped->enableMemoryMapping();
+
+    const LocatedTriplesPerBlock locatedTriples;
+    auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+    std::vector<std::pair<std::string, ScanSpecification>> scans{
+        {"complete relation (" + std::to_string(numRowsPerRelation) + " rows)",
+         {V(numRelations / 2), std::nullopt, std::nullopt}},
+        {"fixed col0 and col1 (" + std::to_string(numRowsPerCol1) + " rows)",
+         {V(numRelations / 2), V(1234), std::nullopt}}};
+    std::vector<std::string> rowNames;
+    for (const auto& [scanName, spec] : scans) {
+      rowNames.push_back(scanName);
+    }
+    auto& table = results.addTable(
+        "Time for performing the scan " + std::to_string(numRepetitions) +
+            " times",
+        rowNames,
+        {"scan", "compressed", "uncompressed", "uncompressed, memory-mapped",
+         "uncompressed, memory-mapped, zero-copy view"});
+
+    for (size_t row = 0; row < scans.size(); ++row) {
+      const auto& spec = scans.at(row).second;
+      auto measureScan = [&](size_t column, const auto& reader,
+                             const auto& blocks) {
+        ScanSpecAndBlocks specAndBlocks{spec, allBlocks(blocks)};
+        size_t numRows = 0;
+        table.addMeasurement(row, column, [&]() {
+          for (size_t j = 0; j < numRepetitions; ++j) {
+            numRows +=
+                reader->scan(specAndBlocks, {}, handle, locatedTriples)
+                    .numRows();
+          }
+        });
+        return numRows;
+      };
+      auto numRows = measureScan(1, readerCompressed, blocksCompressed);
+      AD_CORRECTNESS_CHECK(
+          measureScan(2, readerUncompressed, blocksUncompressed) == numRows);
+      AD_CORRECTNESS_CHECK(measureScan(3, readerMapped, blocksUncompressed) ==
+                           numRows);
+
+      ScanSpecAndBlocks specAndBlocks{spec, allBlocks(blocksUncompressed)};
+      auto scanAsView = [&]() {
+        return readerMapped->scanAsView(specAndBlocks, {}, locatedTriples);
+      };
+      if (!scanAsView().has_value()) {
+        table.setEntry(row, 4, std::string{"not applicable"});
+        continue;
+      }
+      size_t numRowsOfViews = 0;
+      table.addMeasurement(row, 4, [&]() {
+        for (size_t j = 0; j < numRepetitions; ++j) {
+          numRowsOfViews += scanAsView().value().numRows();
+        }
+      });
+      AD_CORRECTNESS_CHECK(numRowsOfViews == numRows);
+    }
+    std::remove(filenameCompressed.c_str());
+    std::remove(filenameUncompressed.c_str());
+    return results;
+  }
+};
+
+AD_REGISTER_BENCHMARK(IndexScanBenchmark);
+}  // namespace ad_benchmark
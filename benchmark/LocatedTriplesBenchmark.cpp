@@ -0,0 +1,200 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../benchmark/infrastructure/Benchmark.h"
+#include "../benchmark/infrastructure/BenchmarkMeasurementContainer.h"
+#include "index/LocatedTriples.h"
+#include "util/Random.h"
+
+namespace ad_benchmark {
+
+// Compare the `LocatedTriples` (a sorted vector) with the `std::set` that was
+// previously used to store the located triples of a block, for the operations
+// on the hot path: merging the located triples into the triples of a block
+// (for each scan of a block with updates) and inserting a batch of located
+// triples (for each update).
+class LocatedTriplesBenchmark : public BenchmarkInterface {
+  using LocatedTripleSet = std::set<LocatedTriple, LocatedTripleCompare>;
+  // The number of rows of the block into which the located triples are
+  // merged.
+  static constexpr size_t numRowsInBlock = 100'000;
+  // The number of times each operation is performed per measurement.
+  static constexpr size_t numRepetitions = 20;
+
+  std::string name() const final {
+    return "Located triples as a sorted vector vs. as a std::set";
+  }
+
+  static Id V(uint64_t bits) { return Id::fromBits(bits); }
+
+  // A sorted block with `numRowsInBlock` rows and four columns, where the
+  // third column contains the even numbers.
+  static IdTable makeBlock() {
+    IdTable block{4, ad_utility::makeUnlimitedAllocator<Id>()};
+    for (size_t i = 0; i < numRowsInBlock; ++i) {
+      block.push_back({V(0), V(0), V(2 * i), V(0)});
+    }
+    return block;
+  }
+
+  // The metadata of the `block` (as block 0).
+  static CompressedBlockMetadata makeBlockMetadata(const IdTable& block) {
+    auto toPermutedTriple = [](const auto& row) {
+      return CompressedBlockMetadata::PermutedTriple{row[0], row[1], row[2],
+                                                     row[3]};
+    };
+    return CompressedBlockMetadata{
+        {{},
+         block.numRows(),
+         toPermutedTriple(block.front()),
+         toPermutedTriple(block.back()),
+         std::nullopt,
+         false},
+        0};
+  }
+
+  // `numTriples` random located triples for the block above (in random
+  // order). Half of them are insertions of triples that are not contained in
+  // the block (odd values in the third column), the other half are deletions
+  // of triples that are contained in the block.
+  static std::vector<LocatedTriple> makeLocatedTriples(size_t numTriples,
+                                                       size_t seed) {
+    ad_utility::SlowRandomIntGenerator<uint64_t> randomRow{
+        0, numRowsInBlock - 1, ad_utility::RandomSeed::make(seed)};
+    std::set<uint64_t> values;
+    while (values.size() < numTriples) {
+      values.insert(2 * randomRow() + values.size() % 2);
+    }
+    std::vector<LocatedTriple> result;
+    for (auto value : values) {
+      result.push_back(LocatedTriple{
+          0, IdTriple<0>{{V(0), V(0), V(value), V(0)}}, value % 2 == 1});
+    }
+    ad_utility::randomShuffle(result.begin(), result.end(),
+                              ad_utility::RandomSeed::make(seed));
+    return result;
+  }
+
+  // Merge the `locatedTriples` (either a `LocatedTripleSet` or
+  // `LocatedTriples`) into the `block`. This is the same algorithm as in
+  // `LocatedTriplesPerBlock::mergeTriples`, but for any container of located
+  // triples.
+  static IdTable mergeTriples(const auto& locatedTriples,
+                              const IdTable& block) {
+    IdTable result{block.numColumns(), block.getAllocator()};
+    result.resize(block.numRows() + locatedTriples.size());
+    auto key = [](const auto& row) {
+      return std::tie(row[0], row[1], row[2], row[3]);
+    };
+    auto rowIt = block.begin();
+    auto resultIt = result.begin();
+    auto writeLocatedTriple = [&resultIt](const LocatedTriple& lt) {
+      for (size_t i = 0; i < 4; ++i) {
+        (*resultIt)[i] = lt.triple_.ids()[i];
+      }
+      ++resultIt;
+    };
+    for (const auto& lt : locatedTriples) {
+      while (rowIt != block.end() && key(*rowIt) < key(lt.triple_.ids())) {
+        *resultIt++ = *rowIt++;
+      }
+      if (rowIt != block.end() && key(*rowIt) == key(lt.triple_.ids())) {
+        if (!lt.insertOrDelete_) {
+          ++rowIt;
+        }
+      } else if (lt.insertOrDelete_) {
+        writeLocatedTriple(lt);
+      }
+    }
+    while (rowIt != block.end()) {
+      *resultIt++ = *rowIt++;
+    }
+    result.resize(resultIt - result.begin());
+    return result;
+  }
+
+  BenchmarkResults runAllBenchmarks() final {
+    BenchmarkResults results{};
+    const auto block = makeBlock();
+    const std::vector<size_t> numsLocatedTriples{100, 1'000, 10'000, 50'000};
+    std::vector<std::string> rowNames;
+    for (auto numTriples : numsLocatedTriples) {
+      rowNames.push_back(std::to_string(numTriples) + " located triples");
+    }
+
+    auto& mergeTable = results.addTable(
+        "Time for merging the located triples into a block with " +
+            std::to_string(numRowsInBlock) + " rows " +
+            std::to_string(numRepetitions) + " times",
+        rowNames,
+        {"located triples", "std::set", "sorted vector",
+         "sorted vector, LocatedTriplesPerBlock::mergeTriples"});
+    auto& insertTable = results.addTable(
+        "Time for inserting a batch of located triples into a block that "
+        "already contains the same number of located triples " +
+            std::to_string(numRepetitions) + " times",
+        rowNames, {"located triples", "std::set", "sorted vector"});
+
+    for (size_t row = 0; row < numsLocatedTriples.size(); ++row) {
+      auto triples = makeLocatedTriples(numsLocatedTriples.at(row), row);
+      LocatedTripleSet set{triples.begin(), triples.end()};
+      LocatedTriples vector;
+      vector.insert(triples);
+      LocatedTriplesPerBlock locatedTriplesPerBlock;
+      locatedTriplesPerBlock.setOriginalMetadata(
+          std::vector{makeBlockMetadata(block)});
+      locatedTriplesPerBlock.add(triples);
+
+      size_t numRowsSet = 0;
+      mergeTable.addMeasurement(row, 1, [&]() {
+        for (size_t i = 0; i < numRepetitions; ++i) {
+          numRowsSet += mergeTriples(set, block).numRows();
+        }
+      });
+      size_t numRowsVector = 0;
+      mergeTable.addMeasurement(row, 2, [&]() {
+        for (size_t i = 0; i < numRepetitions; ++i) {
+          numRowsVector += mergeTriples(vector, block).numRows();
+        }
+      });
+      size_t numRowsMergeTriples = 0;
+      mergeTable.addMeasurement(row, 3, [&]() {
+        for (size_t i = 0; i < numRepetitions; ++i) {
+          numRowsMergeTriples +=
+              locatedTriplesPerBlock.mergeTriples(0, block, 3, true).numRows();
+        }
+      });
+      AD_CORRECTNESS_CHECK(numRowsSet == numRowsVector);
+      AD_CORRECTNESS_CHECK(numRowsSet == numRowsMergeTriples);
+
+      // A second batch of located triples, which is disjoint from the first.
+      auto newTriples =
+          makeLocatedTriples(numsLocatedTriples.at(row), row + 1000);
+      std::erase_if(newTriples, [&set](const LocatedTriple& lt) {
+        return set.contains(lt);
+      });
+      insertTable.addMeasurement(row, 1, [&]() {
+        for (size_t i = 0; i < numRepetitions; ++i) {
+          auto copy = set;
+          for (const auto& lt : newTriples) {
+            copy.emplace(lt);
+          }
+        }
+      });
+      insertTable.addMeasurement(row, 2, [&]() {
+        for (size_t i = 0; i < numRepetitions; ++i) {
+          auto copy = vector;
+          copy.insert(newTriples);
+        }
+      });
+    }
+    return results;
+  }
+};
+
+AD_REGISTER_BENCHMARK(LocatedTriplesBenchmark);
+}  // namespace ad_benchmark
@@ -54,6 +54,12 @@ class CountAvailablePredicates : public Operation {
     return subtree_ != nullptr ? R{subtree_.get()} : R{};
   }
 
+  // The patterns are read directly from the index, so the result depends on
+  // all the triples.
+  size_t getLastModificationOfScannedTriples() const override {
+    return locatedTriplesSnapshot().lastModification_;
+  }
+
   bool knownEmptyResult() override {
     if (subtree_ != nullptr) {
       return subtree_->knownEmptyResult();
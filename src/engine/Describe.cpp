@@ -27,6 +27,12 @@ std::vector<QueryExecutionTree*> Describe::getChildren() {
   return {subtree_.get()};
 }
 
+// _____________________________________________________________________________
+size_t Describe::getLastModificationOfScannedTriples() const {
+  // The triples of the described resources are scanned from the full index.
+  return locatedTriplesSnapshot().lastModification_;
+}
+
 // _____________________________________________________________________________
 string Describe::getCacheKeyImpl() const {
   // The cache key must represent the `resources_` (the variables and IRIs of
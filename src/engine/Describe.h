@@ -35,6 +35,7 @@ class Describe : public Operation {
 
   // The following functions override those from the base class `Operation`.
   std::vector<QueryExecutionTree*> getChildren() override;
+  size_t getLastModificationOfScannedTriples() const override;
   string getCacheKeyImpl() const override;
   string getDescriptor() const override;
   size_t getResultWidth() const override;
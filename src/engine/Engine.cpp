@@ -4,9 +4,100 @@
 
 #include "engine/Engine.h"
 
+#include <algorithm>
+#include <array>
+#include <numeric>
+
 #include "engine/CallFixedSize.h"
 #include "util/ChunkedForLoop.h"
 #include "util/Exception.h"
+#include "util/RunTasksInParallel.h"
+
+namespace {
+// Tables with at least this many rows and either at least this many columns
+// or more than two sort columns are sorted by `Engine::sortByPermutation`.
+constexpr size_t SORT_BY_PERMUTATION_MIN_NUM_ROWS = 10'000;
+constexpr size_t SORT_BY_PERMUTATION_MIN_NUM_COLUMNS = 5;
+// `Engine::sort` only uses an additional thread for `sortByPermutation` per
+// this many rows. Each pass over smaller chunks is done in well below a
+// millisecond, so that handing the chunks to other threads doesn't pay off.
+constexpr size_t SORT_BY_PERMUTATION_MIN_NUM_ROWS_PER_THREAD = 100'000;
+
+template <typename T>
+using Vector = std::vector<T, ad_utility::AllocatorWithLimit<T>>;
+
+// Split `[0, numRows)` into one contiguous chunk per thread of the `runner`
+// and call `f(chunkIndex, begin, end)` for each of them in parallel.
+template <typename F>
+void forEachChunkInParallel(ad_utility::ParallelTaskRunner& runner,
+                            size_t numRows, const F& f) {
+  size_t numChunks = runner.numThreads();
+  runner.run(numChunks, [&](size_t i) {
+    f(i, numRows * i / numChunks, numRows * (i + 1) / numChunks);
+  });
+}
+
+// One pass of a parallel LSD radix sort: Stably sort the `keys` and the
+// `permutation` by the digit of the `keys` that starts at bit `shift`. The
+// `keysBuffer` and `permutationBuffer` must have the same size as the `keys`
+// and are used as scratch space. The pass is run on the threads of the
+// `runner`. If all the keys have the same digit, nothing is changed and false
+// is returned.
+bool radixSortPass(Vector<uint64_t>& keys, Vector<size_t>& permutation,
+                   Vector<uint64_t>& keysBuffer,
+                   Vector<size_t>& permutationBuffer, size_t shift,
+                   ad_utility::ParallelTaskRunner& runner) {
+  constexpr size_t bitsPerDigit = 8;
+  constexpr size_t numBuckets = size_t{1} << bitsPerDigit;
+  auto digit = [shift](uint64_t key) {
+    return (key >> shift) & (numBuckets - 1);
+  };
+  size_t numRows = keys.size();
+  std::vector<std::array<size_t, numBuckets>> histograms(runner.numThreads());
+  forEachChunkInParallel(runner, numRows, [&](size_t i, size_t begin,
+                                              size_t end) {
+    auto& histogram = histograms[i];
+    histogram.fill(0);
+    for (size_t row = begin; row < end; ++row) {
+      ++histogram[digit(keys[row])];
+    }
+  });
+  // The pass can be skipped if the keys of all the chunks have the same digit,
+  // which is typically the case for the high digits (e.g. the datatype bits).
+  for (size_t d = 0; d < numBuckets; ++d) {
+    size_t count = 0;
+    for (const auto& histogram : histograms) {
+      count += histogram[d];
+    }
+    if (count == numRows) {
+      return false;
+    }
+  }
+  // Turn the histograms into the positions to which each thread writes the
+  // next key with a given digit.
+  size_t position = 0;
+  for (size_t d = 0; d < numBuckets; ++d) {
+    for (auto& histogram : histograms) {
+      size_t count = histogram[d];
+      histogram[d] = position;
+      position += count;
+    }
+  }
+  forEachChunkInParallel(runner, numRows, [&](size_t i, size_t begin,
+                                              size_t end) {
+    auto& positions = histograms[i];
+    for (size_t row = begin; row < end; ++row) {
+      size_t& target = positions[digit(keys[row])];
+      keysBuffer[target] = keys[row];
+      permutationBuffer[target] = permutation[row];
+      ++target;
+    }
+  });
+  keys.swap(keysBuffer);
+  permutation.swap(permutationBuffer);
+  return true;
+}
+}  // namespace
 
 // The actual implementation of sorting an `IdTable` according to the
 // `sortCols`.
@@ -19,9 +110,19 @@ void Engine::sort(IdTable& idTable, const std::vector<ColumnIndex>& sortCols) {
   // this is in fact beneficial and whether it should also be applied for a
   // higher number of columns, maybe even using `CALL_FIXED_SIZE` for the
   // number of sort columns.
-  // TODO<joka921> Also experiment with sorting algorithms that take the
-  // column-based structure of the `IdTable` into account.
-  if (sortCols.size() == 1) {
+  // Large tables that are wide or have many sort columns are sorted by a
+  // permutation, which takes the column-based structure of the `IdTable` into
+  // account (see `sortByPermutation`).
+  if (idTable.numRows() >= SORT_BY_PERMUTATION_MIN_NUM_ROWS &&
+      (width >= SORT_BY_PERMUTATION_MIN_NUM_COLUMNS || sortCols.size() > 2)) {
+    size_t numThreads =
+        USE_PARALLEL_SORT
+            ? std::clamp(idTable.numRows() /
+                             SORT_BY_PERMUTATION_MIN_NUM_ROWS_PER_THREAD,
+                         size_t{1}, size_t{NUM_SORT_THREADS})
+            : 1;
+    sortByPermutation(idTable, sortCols, numThreads);
+  } else if (sortCols.size() == 1) {
     CALL_FIXED_SIZE(width, &Engine::sort, &idTable, sortCols.at(0));
   } else if (sortCols.size() == 2) {
     auto comparison = [c0 = sortCols[0], c1 = sortCols[1]](const auto& row1,
@@ -52,6 +153,94 @@ void Engine::sort(IdTable& idTable, const std::vector<ColumnIndex>& sortCols) {
   }
 }
 
+// ___________________________________________________________________________
+size_t Engine::sortByPermutation(IdTable& idTable,
+                                 const std::vector<ColumnIndex>& sortCols,
+                                 size_t numThreads) {
+  LOG(DEBUG) << "Sorting " << idTable.numRows() << " rows by permutation.\n";
+  size_t numRows = idTable.numRows();
+  auto allocator = idTable.getAllocator();
+  size_t numRadixSortPasses = 0;
+  // All the parallel passes below are run on the same threads.
+  ad_utility::ParallelTaskRunner runner{std::max(numThreads, size_t{1})};
+  Vector<size_t> permutation(numRows, allocator);
+  std::iota(permutation.begin(), permutation.end(), size_t{0});
+
+  auto containsLocalVocabIndex = [](ql::span<const Id> column) {
+    return ql::ranges::any_of(column, [](Id id) {
+      return id.getDatatype() == Datatype::LocalVocabIndex;
+    });
+  };
+  bool bitsAreOrdered =
+      ql::ranges::none_of(sortCols, [&](ColumnIndex sortCol) {
+        return containsLocalVocabIndex(idTable.getColumn(sortCol));
+      });
+
+  if (bitsAreOrdered) {
+    // LSD radix sort: Stably sort by the sort columns from the last to the
+    // first one, and each column by its bits from the lowest to the highest
+    // digit. The keys are always stored in the current order of the rows.
+    Vector<uint64_t> keys(numRows, allocator);
+    Vector<uint64_t> keysBuffer(numRows, allocator);
+    Vector<size_t> permutationBuffer(numRows, allocator);
+    for (ColumnIndex sortCol : sortCols | ql::views::reverse) {
+      ql::span<const Id> column = idTable.getColumn(sortCol);
+      forEachChunkInParallel(runner, numRows,
+                             [&](size_t, size_t begin, size_t end) {
+                               for (size_t i = begin; i < end; ++i) {
+                                 keys[i] = column[permutation[i]].getBits();
+                               }
+                             });
+      for (size_t shift = 0; shift < 64; shift += 8) {
+        numRadixSortPasses += radixSortPass(keys, permutation, keysBuffer,
+                                            permutationBuffer, shift, runner);
+      }
+    }
+  } else {
+    // Compare the sort keys of the rows, which are stored contiguously for
+    // each row.
+    size_t numKeys = sortCols.size();
+    Vector<Id> keys(numRows * numKeys, allocator);
+    for (size_t k = 0; k < numKeys; ++k) {
+      ql::span<const Id> column = idTable.getColumn(sortCols[k]);
+      forEachChunkInParallel(runner, numRows,
+                             [&](size_t, size_t begin, size_t end) {
+                               for (size_t i = begin; i < end; ++i) {
+                                 keys[i * numKeys + k] = column[i];
+                               }
+                             });
+    }
+    auto comparison = [&keys, numKeys](size_t a, size_t b) {
+      auto keysA = keys.begin() + a * numKeys;
+      auto keysB = keys.begin() + b * numKeys;
+      return std::lexicographical_compare(keysA, keysA + numKeys, keysB,
+                                          keysB + numKeys);
+    };
+    if constexpr (USE_PARALLEL_SORT) {
+      ad_utility::parallel_sort(permutation.begin(), permutation.end(),
+                                comparison,
+                                ad_utility::parallel_tag(NUM_SORT_THREADS));
+    } else {
+      std::sort(permutation.begin(), permutation.end(), comparison);
+    }
+  }
+
+  // Apply the permutation to one column after the other.
+  Vector<Id> buffer(numRows, allocator);
+  for (size_t col = 0; col < idTable.numColumns(); ++col) {
+    ql::span<Id> column = idTable.getColumn(col);
+    forEachChunkInParallel(runner, numRows,
+                           [&](size_t, size_t begin, size_t end) {
+                             for (size_t i = begin; i < end; ++i) {
+                               buffer[i] = column[permutation[i]];
+                             }
+                           });
+    ql::ranges::copy(buffer, column.begin());
+  }
+  LOG(DEBUG) << "Sort done.\n";
+  return numRadixSortPasses;
+}
+
 // ___________________________________________________________________________
 size_t Engine::countDistinct(IdTableView<0> input,
                              const std::function<void()>& checkCancellation) {
@@ -5,6 +5,7 @@
 #include "engine/ExecuteUpdate.h"
 
 #include "engine/ExportQueryExecutionTrees.h"
+#include "util/HashSet.h"
 
 // _____________________________________________________________________________
 UpdateMetadata ExecuteUpdate::executeUpdate(
@@ -32,6 +33,146 @@ UpdateMetadata ExecuteUpdate::executeUpdate(
   return metadata;
 }
 
+// _____________________________________________________________________________
+std::pair<DeltaTriples::StagedUpdate, UpdateMetadata>
+ExecuteUpdate::stageUpdate(const Index& index, const ParsedQuery& query,
+                           const QueryExecutionTree& qet,
+                           DeltaTriplesManager& deltaTriplesManager,
+                           const CancellationHandle& cancellationHandle) {
+  UpdateMetadata metadata{};
+  // The local vocabs of the `result` and of the quads have to be kept alive
+  // until the triples are staged, which moves their local vocab entries to the
+  // local vocab of the delta triples.
+  auto result = qet.getResult(false);
+  auto [toInsert, toDelete] =
+      computeGraphUpdateQuads(index, query, *result, qet.getVariableColumns(),
+                              cancellationHandle, metadata);
+  ad_utility::Timer timer{ad_utility::Timer::InitialStatus::Started};
+  auto stagedUpdate = deltaTriplesManager.stageUpdate(
+      cancellationHandle, std::move(toDelete.idTriples_),
+      std::move(toInsert.idTriples_));
+  metadata.triplePreparationTime_ += timer.msecs();
+  return {std::move(stagedUpdate), metadata};
+}
+
+// _____________________________________________________________________________
+void ExecuteUpdate::applyStagedUpdate(
+    DeltaTriples& deltaTriples, DeltaTriples::StagedUpdate stagedUpdate,
+    UpdateMetadata& metadata, const CancellationHandle& cancellationHandle) {
+  // "The deletion of the triples happens before the insertion." (SPARQL 1.1
+  // Update 3.1.3)
+  ad_utility::Timer timer{ad_utility::Timer::InitialStatus::Started};
+  deltaTriples.applyStagedTriples(cancellationHandle,
+                                  std::move(stagedUpdate.toDelete_));
+  metadata.deletionTime_ = timer.msecs();
+  timer.reset();
+  deltaTriples.applyStagedTriples(cancellationHandle,
+                                  std::move(stagedUpdate.toInsert_));
+  metadata.insertionTime_ = timer.msecs();
+}
+
+// _____________________________________________________________________________
+UpdateMetadata ExecuteUpdate::executeUpdateStreaming(
+    const Index& index, const ParsedQuery& query, const QueryExecutionTree& qet,
+    DeltaTriplesManager::BatchedModification& modification,
+    const CancellationHandle& cancellationHandle, size_t batchSize) {
+  AD_CONTRACT_CHECK(batchSize > 0);
+  AD_CONTRACT_CHECK(query.hasUpdateClause());
+  UpdateMetadata metadata{};
+  metadata.inUpdate_ = DeltaTriplesCount{0, 0};
+  auto result = qet.getResult(true);
+
+  // NOTE: For a lazy result, the preparation time also includes the time for
+  // computing the result of the WHERE clause.
+  ad_utility::Timer timer{ad_utility::Timer::InitialStatus::Started};
+  auto updateClause = query.updateClause();
+  auto& graphUpdate = updateClause.op_;
+  const auto& variableColumns = qet.getVariableColumns();
+  // The local vocabs of the templates have to be kept alive until the end.
+  auto [toInsertTemplates, localVocabInsert] = transformTriplesTemplate(
+      index.getVocab(), variableColumns, std::move(graphUpdate.toInsert_));
+  auto [toDeleteTemplates, localVocabDelete] = transformTriplesTemplate(
+      index.getVocab(), variableColumns, std::move(graphUpdate.toDelete_));
+
+  // "The deletion of the triples happens before the insertion." (SPARQL 1.1
+  // Update 3.1.3). This has to hold for the update as a whole, so a triple
+  // that was inserted for one batch must not be deleted for a later batch.
+  // This is only relevant if there are triples to delete and to insert. The
+  // set grows with the update, so it is charged to the memory limit.
+  const bool trackInsertedTriples =
+      !toInsertTemplates.empty() && !toDeleteTemplates.empty();
+  ad_utility::HashSetWithMemoryLimit<IdTriple<>> insertedTriples{
+      qet.getRootOperation()->allocator()};
+  // The local vocab entries of the `insertedTriples`, which have to outlive the
+  // local vocabs of the batches (see below).
+  LocalVocab localVocabOfInsertedTriples;
+
+  std::vector<IdTriple<>> toInsert;
+  std::vector<IdTriple<>> toDelete;
+  // The `IdTable`s (and their local vocabs) of a lazy result are destroyed
+  // when the next one is computed, but the `LocalVocabIndex`s of the current
+  // batch have to stay valid until the batch has been applied.
+  LocalVocab localVocabOfBatch;
+  size_t numRowsInBatch = 0;
+
+  auto applyBatch = [&]() {
+    sortAndRemoveDuplicates(toInsert);
+    sortAndRemoveDuplicates(toDelete);
+    metadata.inUpdate_->triplesInserted_ +=
+        static_cast<int64_t>(toInsert.size());
+    metadata.inUpdate_->triplesDeleted_ +=
+        static_cast<int64_t>(toDelete.size());
+    toDelete = setMinus(toDelete, toInsert);
+    if (trackInsertedTriples) {
+      std::erase_if(toDelete, [&insertedTriples](const IdTriple<>& triple) {
+        return insertedTriples.contains(triple);
+      });
+      for (IdTriple<> triple : toInsert) {
+        for (Id& id : triple.ids()) {
+          if (id.getDatatype() == Datatype::LocalVocabIndex) {
+            id = Id::makeFromLocalVocabIndex(
+                localVocabOfInsertedTriples.getIndexAndAddIfNotContained(
+                    *id.getLocalVocabIndex()));
+          }
+        }
+        insertedTriples.insert(triple);
+      }
+    }
+    metadata.triplePreparationTime_ += timer.msecs();
+
+    timer.start();
+    modification.applyBatch(cancellationHandle, std::move(toDelete),
+                            std::move(toInsert));
+    metadata.insertionTime_ += timer.msecs();
+
+    timer.start();
+    toInsert = {};
+    toDelete = {};
+    localVocabOfBatch = LocalVocab{};
+    numRowsInBatch = 0;
+  };
+
+  uint64_t resultSize = 0;
+  for (const auto& [pair, range] : ExportQueryExecutionTrees::getRowIndices(
+           query._limitOffset, *result, resultSize)) {
+    auto& idTable = pair.idTable_;
+    localVocabOfBatch.mergeWith(pair.localVocab_);
+    for (const uint64_t i : range) {
+      computeAndAddQuadsForResultRow(toInsertTemplates, toInsert, idTable, i);
+      computeAndAddQuadsForResultRow(toDeleteTemplates, toDelete, idTable, i);
+      cancellationHandle->throwIfCancelled();
+      if (++numRowsInBatch == batchSize) {
+        applyBatch();
+        localVocabOfBatch.mergeWith(pair.localVocab_);
+      }
+    }
+  }
+  if (numRowsInBatch > 0) {
+    applyBatch();
+  }
+  return metadata;
+}
+
 // _____________________________________________________________________________
 std::pair<std::vector<ExecuteUpdate::TransformedTriple>, LocalVocab>
 ExecuteUpdate::transformTriplesTemplate(
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest_prod.h>
 
+#include "index/DeltaTriples.h"
 #include "index/Index.h"
 #include "parser/ParsedQuery.h"
 #include "util/CancellationHandle.h"
@@ -34,6 +35,38 @@ class ExecuteUpdate {
       const QueryExecutionTree& qet, DeltaTriples& deltaTriples,
       const CancellationHandle& cancellationHandle);
 
+  // Execute an update in two steps, such that only the second step has to hold
+  // the lock for the delta triples. `stageUpdate` computes the result of the
+  // WHERE clause and the triples to delete and insert, and stages them (see
+  // `DeltaTriplesManager::stageUpdate`). `applyStagedUpdate` then applies
+  // them to the `deltaTriples`, typically from `DeltaTriplesManager::modify`.
+  static std::pair<DeltaTriples::StagedUpdate, UpdateMetadata> stageUpdate(
+      const Index& index, const ParsedQuery& query,
+      const QueryExecutionTree& qet, DeltaTriplesManager& deltaTriplesManager,
+      const CancellationHandle& cancellationHandle);
+  static void applyStagedUpdate(DeltaTriples& deltaTriples,
+                                DeltaTriples::StagedUpdate stagedUpdate,
+                                UpdateMetadata& metadata,
+                                const CancellationHandle& cancellationHandle);
+
+  // Execute an update like `executeUpdate`, but without materializing the
+  // complete result of the WHERE clause and all the triples to delete and
+  // insert. The result is computed lazily (if the operation supports it), and
+  // the triples for each `batchSize` rows of the result are applied as one
+  // batch of the `modification` before the next rows are processed. The lock
+  // for the delta triples is only held while a batch is applied. After the
+  // `modification` has been committed, the state of the delta triples is the
+  // same as for `executeUpdate`; if this function throws, the `modification`
+  // is rolled back when it is destroyed. Note that the counts in
+  // `UpdateMetadata::inUpdate_` are summed up over the batches, so a triple
+  // that occurs in several batches is counted several times. The time for
+  // applying the batches is reported as the `insertionTime_`.
+  static UpdateMetadata executeUpdateStreaming(
+      const Index& index, const ParsedQuery& query,
+      const QueryExecutionTree& qet,
+      DeltaTriplesManager::BatchedModification& modification,
+      const CancellationHandle& cancellationHandle, size_t batchSize);
+
  private:
   // Resolve all `TripleComponent`s and `Graph`s in a vector of
   // `SparqlTripleSimpleWithGraph` into `Variable`s or `Id`s.
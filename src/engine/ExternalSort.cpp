@@ -0,0 +1,116 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "engine/ExternalSort.h"
+
+#include <absl/strings/str_cat.h>
+
+#include <atomic>
+
+#include "util/Timer.h"
+
+namespace qlever::externalSort {
+
+namespace {
+// Yield the sorted blocks of the `sorter`, each together with a copy of the
+// `localVocab` of the complete input.
+Result::Generator yieldSortedBlocks(
+    SorterPtr sorter, LocalVocab localVocab,
+    ad_utility::SharedCancellationHandle cancellationHandle) {
+  for (auto& block : sorter->getSortedOutput()) {
+    cancellationHandle->throwIfCancelled();
+    co_yield {std::move(block), localVocab.clone()};
+  }
+}
+
+// Return the result of the `sorter`, to which all rows of the input have
+// already been pushed. It is lazy iff `requestLaziness` is true.
+Result sortedOutput(SorterPtr sorter, LocalVocab localVocab,
+                    size_t numColumns, std::vector<ColumnIndex> sortedOn,
+                    bool requestLaziness,
+                    const ad_utility::AllocatorWithLimit<Id>& allocator,
+                    ad_utility::SharedCancellationHandle cancellationHandle,
+                    RuntimeInformation& runtimeInfo) {
+  runtimeInfo.addDetail("sorted-externally", true);
+  auto blocks = yieldSortedBlocks(std::move(sorter), localVocab.clone(),
+                                  std::move(cancellationHandle));
+  if (requestLaziness) {
+    return {std::move(blocks), std::move(sortedOn)};
+  }
+  IdTable result{numColumns, allocator};
+  for (auto& [block, blockLocalVocab] : blocks) {
+    result.insertAtEnd(block);
+  }
+  return {std::move(result), std::move(sortedOn), std::move(localVocab)};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+bool exceedsInMemoryThreshold(size_t numRows, size_t numColumns) {
+  return ad_utility::MemorySize::bytes(numRows * numColumns * sizeof(Id)) >
+         RuntimeParameters().get<"sort-in-memory-threshold">();
+}
+
+// _____________________________________________________________________________
+std::string makeTemporaryFilename(const QueryExecutionContext& qec) {
+  static std::atomic<size_t> counter = 0;
+  return absl::StrCat(qec.getIndex().getOnDiskBase(), ".external-sort.",
+                      counter++);
+}
+
+// _____________________________________________________________________________
+Result sortResult(std::shared_ptr<const Result> input, size_t numColumns,
+                  std::vector<ColumnIndex> sortedOn,
+                  const InMemorySort& sortInMemory,
+                  const std::function<SorterPtr()>& makeSorter,
+                  bool requestLaziness,
+                  const ad_utility::AllocatorWithLimit<Id>& allocator,
+                  ad_utility::SharedCancellationHandle cancellationHandle,
+                  RuntimeInformation& runtimeInfo) {
+  if (input->isFullyMaterialized()) {
+    const IdTable& table = input->idTable();
+    if (exceedsInMemoryThreshold(table.numRows(), numColumns)) {
+      SorterPtr sorter = makeSorter();
+      sorter->pushBlock(table);
+      return sortedOutput(std::move(sorter), input->getCopyOfLocalVocab(),
+                          numColumns, std::move(sortedOn), requestLaziness,
+                          allocator, std::move(cancellationHandle),
+                          runtimeInfo);
+    }
+    ad_utility::Timer t{ad_utility::Timer::Started};
+    IdTable idTable = table.clone();
+    runtimeInfo.addDetail("time-cloning", t.msecs());
+    sortInMemory(idTable);
+    return {std::move(idTable), std::move(sortedOn),
+            input->getSharedLocalVocab()};
+  }
+
+  // For a lazy input, collect the blocks in RAM until they exceed the
+  // threshold. From then on, all the blocks are pushed to the sorter.
+  IdTable collected{numColumns, allocator};
+  LocalVocab localVocab;
+  SorterPtr sorter;
+  for (auto& [idTable, blockLocalVocab] : input->idTables()) {
+    cancellationHandle->throwIfCancelled();
+    localVocab.mergeWith(blockLocalVocab);
+    if (sorter) {
+      sorter->pushBlock(idTable);
+      continue;
+    }
+    collected.insertAtEnd(idTable);
+    if (exceedsInMemoryThreshold(collected.numRows(), numColumns)) {
+      sorter = makeSorter();
+      sorter->pushBlock(collected);
+      // Release the memory of the collected rows.
+      collected = IdTable{numColumns, allocator};
+    }
+  }
+  if (!sorter) {
+    sortInMemory(collected);
+    return {std::move(collected), std::move(sortedOn), std::move(localVocab)};
+  }
+  return sortedOutput(std::move(sorter), std::move(localVocab), numColumns,
+                      std::move(sortedOn), requestLaziness, allocator,
+                      std::move(cancellationHandle), runtimeInfo);
+}
+}  // namespace qlever::externalSort
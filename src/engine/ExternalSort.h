@@ -0,0 +1,67 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_ENGINE_EXTERNALSORT_H
+#define QLEVER_SRC_ENGINE_EXTERNALSORT_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/QueryExecutionContext.h"
+#include "engine/Result.h"
+#include "engine/RuntimeInformation.h"
+#include "engine/idTable/CompressedExternalIdTable.h"
+#include "global/RuntimeParameters.h"
+#include "util/CancellationHandle.h"
+
+// Helpers for the `Sort` and `OrderBy` operations to sort results that are
+// larger than the `sort-in-memory-threshold`. Such results are pushed to a
+// `CompressedExternalIdTableSorter`, which sorts them in runs that are
+// compressed and written to disk, and the merged runs are yielded lazily.
+namespace qlever::externalSort {
+
+using SorterPtr =
+    std::unique_ptr<ad_utility::CompressedExternalIdTableSorterTypeErased>;
+
+// Sort a complete `IdTable` in RAM.
+using InMemorySort = std::function<void(IdTable&)>;
+
+// Return true iff a table with the given dimensions is larger than the
+// `sort-in-memory-threshold`.
+bool exceedsInMemoryThreshold(size_t numRows, size_t numColumns);
+
+// Return a name for the file of an external sort that is unique among all the
+// external sorts of the current process.
+std::string makeTemporaryFilename(const QueryExecutionContext& qec);
+
+// Create a sorter for tables with `numColumns` columns that sorts by the
+// `comparator`. The memory of the sorter is the `sort-in-memory-threshold`.
+template <typename Comparator>
+SorterPtr makeSorter(const QueryExecutionContext& qec, size_t numColumns,
+                     Comparator comparator) {
+  return std::make_unique<
+      ad_utility::CompressedExternalIdTableSorter<Comparator, 0>>(
+      makeTemporaryFilename(qec), numColumns,
+      RuntimeParameters().get<"sort-in-memory-threshold">(),
+      qec.getAllocator(), ad_utility::DEFAULT_BLOCKSIZE_EXTERNAL_ID_TABLE,
+      std::move(comparator));
+}
+
+// Sort the rows of the `input`, which may be lazy and has `numColumns`
+// columns. As long as the rows of the `input` don't exceed the
+// `sort-in-memory-threshold`, they are sorted using `sortInMemory`. Otherwise
+// all the rows are pushed to the sorter that is returned by `makeSorter`. Only
+// in this case, the result is lazy if `requestLaziness` is true.
+Result sortResult(std::shared_ptr<const Result> input, size_t numColumns,
+                  std::vector<ColumnIndex> sortedOn,
+                  const InMemorySort& sortInMemory,
+                  const std::function<SorterPtr()>& makeSorter,
+                  bool requestLaziness,
+                  const ad_utility::AllocatorWithLimit<Id>& allocator,
+                  ad_utility::SharedCancellationHandle cancellationHandle,
+                  RuntimeInformation& runtimeInfo);
+}  // namespace qlever::externalSort
+
+#endif  // QLEVER_SRC_ENGINE_EXTERNALSORT_H
@@ -45,6 +45,56 @@ std::vector<TurtleTriple> GraphStoreProtocol::parseTriples(
   }
 }
 
+// ____________________________________________________________________________
+std::vector<SparqlTripleSimpleWithGraph>
+GraphStoreProtocol::parseAndConvertTriples(
+    const string& body, const ad_utility::MediaType contentType,
+    const GraphOrDefault& graph) {
+  // Only N-Triples are parsed in parallel. In Turtle, a statement can span
+  // several lines (e.g. a multi-line literal), so splitting the body at the
+  // end of a line might split a statement.
+  if (contentType == ad_utility::MediaType::ntriples &&
+      body.size() >= DEFAULT_PARSER_BUFFER_SIZE.getBytes()) {
+    auto triples = parseAndConvertTriplesInParallel(body, graph,
+                                                    DEFAULT_PARSER_BUFFER_SIZE);
+    if (triples.has_value()) {
+      return std::move(triples).value();
+    }
+  }
+  return convertTriples(graph, parseTriples(body, contentType));
+}
+
+// ____________________________________________________________________________
+std::optional<std::vector<SparqlTripleSimpleWithGraph>>
+GraphStoreProtocol::parseAndConvertTriplesInParallel(
+    std::string_view body, const GraphOrDefault& graph,
+    ad_utility::MemorySize batchSize) {
+  try {
+    RdfParallelParser<TurtleParser<Tokenizer>> parser;
+    parser.initializeFromString(body, batchSize);
+    std::vector<SparqlTripleSimpleWithGraph> triples;
+    while (auto batch = parser.getBatch()) {
+      ql::ranges::move(convertTriples(graph, std::move(batch).value()),
+                       std::back_inserter(triples));
+    }
+    return triples;
+  } catch (const UnsupportedByParallelParserException& e) {
+    LOG(INFO) << "The body of a Graph Store Protocol request can't be parsed "
+                 "in parallel, parsing it sequentially: "
+              << e.errorMessageWithoutPositionalInfo() << std::endl;
+    return std::nullopt;
+  } catch (const ParseException&) {
+    throw;
+  } catch (const std::exception& e) {
+    // The body couldn't be split into batches, e.g. because a single
+    // statement is longer than the `batchSize`.
+    LOG(INFO) << "The body of a Graph Store Protocol request can't be parsed "
+                 "in parallel, parsing it sequentially: "
+              << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
 // ____________________________________________________________________________
 std::vector<SparqlTripleSimpleWithGraph> GraphStoreProtocol::convertTriples(
     const GraphOrDefault& graph, std::vector<TurtleTriple> triples) {
@@ -78,14 +78,39 @@ class GraphStoreProtocol {
       const GraphOrDefault& graph, std::vector<TurtleTriple> triples);
   FRIEND_TEST(GraphStoreProtocolTest, convertTriples);
 
+  // Parse the triples from the request body according to the content type and
+  // convert them (see `convertTriples`). N-Triples bodies of at least
+  // `DEFAULT_PARSER_BUFFER_SIZE` bytes are parsed in parallel (see
+  // `parseAndConvertTriplesInParallel`). Note: The complete body is in memory
+  // anyway (its size is limited by the `request-body-limit`), and all its
+  // triples form a single update, which keeps a POST atomic.
+  static std::vector<SparqlTripleSimpleWithGraph> parseAndConvertTriples(
+      const std::string& body, const ad_utility::MediaType contentType,
+      const GraphOrDefault& graph);
+
+  // Parse the Turtle or N-Triples `body` with the `RdfParallelParser`, which
+  // splits it into batches of about `batchSize` bytes, and convert the triples
+  // of each batch as soon as it has been parsed. The order of the resulting
+  // triples is not specified. Syntax errors are thrown as `ParseException`s.
+  // Return `std::nullopt` if the `body` can't be parsed in parallel, but might
+  // still be valid, for example, if there are prefix declarations after the
+  // first batch (see `UnsupportedByParallelParserException`), or if a single
+  // statement is longer than the `batchSize`. The body is split at the end of
+  // a line that ends with a `.`, so it must not contain statements that span
+  // several lines.
+  static std::optional<std::vector<SparqlTripleSimpleWithGraph>>
+  parseAndConvertTriplesInParallel(std::string_view body,
+                                   const GraphOrDefault& graph,
+                                   ad_utility::MemorySize batchSize);
+  FRIEND_TEST(GraphStoreProtocolTest, parseAndConvertTriplesInParallel);
+
   // Transform a SPARQL Graph Store Protocol POST to an equivalent ParsedQuery
   // which is an SPARQL Update.
   CPP_template_2(typename RequestT)(
       requires ad_utility::httpUtils::HttpRequest<RequestT>) static ParsedQuery
       transformPost(const RequestT& rawRequest, const GraphOrDefault& graph) {
-    auto triples =
-        parseTriples(rawRequest.body(), extractMediatype(rawRequest));
-    auto convertedTriples = convertTriples(graph, std::move(triples));
+    auto convertedTriples = parseAndConvertTriples(
+        rawRequest.body(), extractMediatype(rawRequest), graph);
     updateClause::GraphUpdate up{std::move(convertedTriples), {}};
     ParsedQuery res;
     res._clause = parsedQuery::UpdateClause{std::move(up)};
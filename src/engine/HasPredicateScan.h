@@ -95,6 +95,12 @@ class HasPredicateScan : public Operation {
     }
   }
 
+  // The patterns are read directly from the index, so the result depends on
+  // all the triples.
+  size_t getLastModificationOfScannedTriples() const override {
+    return locatedTriplesSnapshot().lastModification_;
+  }
+
   // These are made static and public mainly for easier testing
   template <typename HasPattern>
   void computeFreeS(IdTable* resultTable, Id objectId, HasPattern& hasPattern,
@@ -0,0 +1,401 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "engine/HashJoin.h"
+
+#include <sstream>
+
+#include "engine/Join.h"
+#include "engine/JoinHelpers.h"
+#include "global/RuntimeParameters.h"
+#include "util/Exception.h"
+#include "util/RunTasksInParallel.h"
+
+using namespace qlever::joinHelpers;
+
+namespace {
+// The minimal number of rows that are partitioned or probed by a single task.
+constexpr size_t MIN_ROWS_PER_TASK = 10'000;
+
+// The maximal number of bits that are used for the partitioning of the hash
+// table, so there are at most 1024 partitions.
+constexpr size_t MAX_NUM_PARTITION_BITS = 10;
+
+// The number of bits for the partitions of a hash table with `numRows` rows
+// that is built with `numThreads` threads. Small hash tables have a single
+// partition, larger ones have about four partitions per thread.
+size_t computeNumPartitionBits(size_t numRows, size_t numThreads) {
+  if (numRows < MIN_ROWS_PER_TASK || numThreads <= 1) {
+    return 0;
+  }
+  size_t numBits = 0;
+  while ((size_t{1} << numBits) < 4 * numThreads &&
+         numBits < MAX_NUM_PARTITION_BITS) {
+    ++numBits;
+  }
+  return numBits;
+}
+
+// The number of tasks for `numRows` rows (at least one).
+size_t numTasksForRows(size_t numRows) {
+  return std::max(size_t{1}, numRows / MIN_ROWS_PER_TASK);
+}
+
+// A vector whose memory is limited by the allocator of the query.
+template <typename T>
+using VectorWithLimit = std::vector<T, ad_utility::AllocatorWithLimit<T>>;
+
+// The rows `[begin, end)` of the `i`-th of `numTasks` tasks for `numRows` rows.
+std::pair<size_t, size_t> rowsOfTask(size_t i, size_t numTasks,
+                                     size_t numRows) {
+  return {i * numRows / numTasks, (i + 1) * numRows / numTasks};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+HashJoin::HashTable::HashTable(
+    ql::span<const Id> joinColumn, size_t numPartitionBits, size_t numThreads,
+    const ad_utility::SharedCancellationHandle& cancellationHandle,
+    const ad_utility::AllocatorWithLimit<Id>& allocator)
+    : numPartitionBits_{numPartitionBits} {
+  AD_CONTRACT_CHECK(numPartitionBits <= MAX_NUM_PARTITION_BITS);
+  const size_t numRows = joinColumn.size();
+  const size_t numPartitions = size_t{1} << numPartitionBits;
+  partitions_.reserve(numPartitions);
+  for (size_t i = 0; i < numPartitions; ++i) {
+    partitions_.emplace_back(allocator);
+  }
+
+  // Distribute the rows to the partitions (radix partitioning). First count
+  // the rows of each partition separately for each chunk of the rows, then
+  // compute the position of each chunk in each partition and scatter the rows.
+  // That way, the rows of each partition stay in their original order.
+  const size_t numChunks = numTasksForRows(numRows);
+  std::vector<VectorWithLimit<size_t>> positions;
+  positions.reserve(numChunks);
+  for (size_t i = 0; i < numChunks; ++i) {
+    positions.emplace_back(numPartitions, 0, allocator);
+  }
+  ad_utility::runTasksInParallel(numChunks, numThreads, [&](size_t chunk) {
+    cancellationHandle->throwIfCancelled();
+    auto [begin, end] = rowsOfTask(chunk, numChunks, numRows);
+    for (size_t row = begin; row < end; ++row) {
+      ++positions[chunk][partitionOf(joinColumn[row])];
+    }
+  });
+  std::vector<size_t> partitionBegin(numPartitions + 1);
+  size_t numRowsSoFar = 0;
+  for (size_t partition = 0; partition < numPartitions; ++partition) {
+    partitionBegin[partition] = numRowsSoFar;
+    for (auto& positionsOfChunk : positions) {
+      auto numRowsOfChunk = positionsOfChunk[partition];
+      positionsOfChunk[partition] = numRowsSoFar;
+      numRowsSoFar += numRowsOfChunk;
+    }
+  }
+  partitionBegin[numPartitions] = numRowsSoFar;
+  VectorWithLimit<size_t> partitionedRows(numRows, allocator);
+  ad_utility::runTasksInParallel(numChunks, numThreads, [&](size_t chunk) {
+    cancellationHandle->throwIfCancelled();
+    auto [begin, end] = rowsOfTask(chunk, numChunks, numRows);
+    auto& nextPosition = positions[chunk];
+    for (size_t row = begin; row < end; ++row) {
+      partitionedRows[nextPosition[partitionOf(joinColumn[row])]++] = row;
+    }
+  });
+
+  // Build the hash maps of the partitions. The rows with the same `Id` are
+  // grouped using the same counting technique as above.
+  ad_utility::runTasksInParallel(numPartitions, numThreads, [&](size_t i) {
+    cancellationHandle->throwIfCancelled();
+    auto rows = ql::span<const size_t>{partitionedRows}.subspan(
+        partitionBegin[i], partitionBegin[i + 1] - partitionBegin[i]);
+    auto& [ranges, rowsOfPartition] = partitions_[i];
+    for (size_t row : rows) {
+      ++ranges[joinColumn[row]].second;
+    }
+    size_t offset = 0;
+    for (auto& [begin, end] : ql::views::values(ranges)) {
+      begin = offset;
+      offset += end;
+      end = begin;
+    }
+    rowsOfPartition.resize(rows.size());
+    for (size_t row : rows) {
+      rowsOfPartition[ranges.find(joinColumn[row])->second.second++] = row;
+    }
+  });
+}
+
+// _____________________________________________________________________________
+HashJoin::HashJoin(QueryExecutionContext* qec,
+                   std::shared_ptr<QueryExecutionTree> t1,
+                   std::shared_ptr<QueryExecutionTree> t2,
+                   ColumnIndex t1JoinCol, ColumnIndex t2JoinCol,
+                   bool allowSwappingChildrenOnlyForTesting)
+    : Operation(qec) {
+  AD_CONTRACT_CHECK(t1 && t2);
+  AD_CONTRACT_CHECK(isApplicable(*t1, *t2, t1JoinCol, t2JoinCol),
+                    "The join columns of a hash join must not contain UNDEF "
+                    "values");
+  // Make the order of the two subtrees deterministic (see `Join`).
+  if (allowSwappingChildrenOnlyForTesting &&
+      t1->getCacheKey() > t2->getCacheKey()) {
+    std::swap(t1, t2);
+    std::swap(t1JoinCol, t2JoinCol);
+  }
+  left_ = std::move(t1);
+  leftJoinCol_ = t1JoinCol;
+  right_ = std::move(t2);
+  rightJoinCol_ = t2JoinCol;
+  joinVar_ = left_->getVariableAndInfoByColumnIndex(leftJoinCol_).first;
+  AD_CONTRACT_CHECK(
+      joinVar_ ==
+      right_->getVariableAndInfoByColumnIndex(rightJoinCol_).first);
+}
+
+// _____________________________________________________________________________
+bool HashJoin::isApplicable(const QueryExecutionTree& t1,
+                            const QueryExecutionTree& t2, ColumnIndex t1JoinCol,
+                            ColumnIndex t2JoinCol) {
+  auto isAlwaysDefined = [](const QueryExecutionTree& tree,
+                            ColumnIndex joinCol) {
+    return tree.getVariableAndInfoByColumnIndex(joinCol)
+               .second.mightContainUndef_ ==
+           ColumnIndexAndTypeInfo::AlwaysDefined;
+  };
+  return isAlwaysDefined(t1, t1JoinCol) && isAlwaysDefined(t2, t2JoinCol);
+}
+
+// _____________________________________________________________________________
+string HashJoin::getCacheKeyImpl() const {
+  // The result is the same as the one of a `Join` (up to the order of the
+  // rows), but we use a different key, because the results are not sorted.
+  std::ostringstream os;
+  os << "HASH JOIN\n"
+     << left_->getCacheKey() << " join-column: [" << leftJoinCol_ << "]\n";
+  os << "|X|\n"
+     << right_->getCacheKey() << " join-column: [" << rightJoinCol_ << "]";
+  return std::move(os).str();
+}
+
+// _____________________________________________________________________________
+string HashJoin::getDescriptor() const {
+  return "HashJoin on " + joinVar_.name();
+}
+
+// _____________________________________________________________________________
+size_t HashJoin::getResultWidth() const {
+  return left_->getResultWidth() + right_->getResultWidth() - 1;
+}
+
+// _____________________________________________________________________________
+VariableToColumnMap HashJoin::computeVariableToColumnMap() const {
+  return makeVarToColMapForJoinOperation(
+      left_->getVariableColumns(), right_->getVariableColumns(),
+      {{leftJoinCol_, rightJoinCol_}}, BinOpType::Join,
+      left_->getResultWidth());
+}
+
+// _____________________________________________________________________________
+bool HashJoin::columnOriginatesFromGraphOrUndef(
+    const Variable& variable) const {
+  AD_CONTRACT_CHECK(getExternallyVisibleVariableColumns().contains(variable));
+  if (variable == joinVar_) {
+    return doesJoinProduceGuaranteedGraphValuesOrUndef(left_, right_, variable);
+  }
+  return Operation::columnOriginatesFromGraphOrUndef(variable);
+}
+
+// _____________________________________________________________________________
+void HashJoin::computeSizeEstimateAndMultiplicities() {
+  std::tie(sizeEstimate_, multiplicities_) =
+      Join::estimateSizeAndMultiplicities(_executionContext, *left_,
+                                          leftJoinCol_, *right_, rightJoinCol_);
+  sizeEstimateComputed_ = true;
+}
+
+// _____________________________________________________________________________
+uint64_t HashJoin::getSizeEstimateBeforeLimit() {
+  if (!sizeEstimateComputed_) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return sizeEstimate_;
+}
+
+// _____________________________________________________________________________
+float HashJoin::getMultiplicity(size_t col) {
+  if (!sizeEstimateComputed_) {
+    computeSizeEstimateAndMultiplicities();
+  }
+  return multiplicities_.at(col);
+}
+
+// _____________________________________________________________________________
+bool HashJoin::leftIsBuildSide() {
+  return left_->getSizeEstimate() <= right_->getSizeEstimate();
+}
+
+// _____________________________________________________________________________
+size_t HashJoin::getCostEstimate() {
+  auto buildSize = static_cast<double>(
+      std::min(left_->getSizeEstimate(), right_->getSizeEstimate()));
+  auto probeSize = static_cast<double>(
+      std::max(left_->getSizeEstimate(), right_->getSizeEstimate()));
+  auto costFactor = [this](const std::string& key) {
+    return _executionContext ? _executionContext->getCostFactor(key) : 1.0;
+  };
+  auto costJoin = static_cast<size_t>(
+      costFactor("HASH_JOIN_BUILD_COST") * buildSize +
+      costFactor("HASH_JOIN_PROBE_COST") * probeSize);
+  return getSizeEstimateBeforeLimit() + costJoin + left_->getCostEstimate() +
+         right_->getCostEstimate();
+}
+
+// _____________________________________________________________________________
+Result HashJoin::createEmptyResult() const {
+  return {IdTable{getResultWidth(), allocator()},
+          resultSortedOn(), LocalVocab{}};
+}
+
+// _____________________________________________________________________________
+Result HashJoin::computeResult(bool requestLaziness) {
+  if (left_->knownEmptyResult() || right_->knownEmptyResult()) {
+    left_->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    right_->getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    return createEmptyResult();
+  }
+
+  // Materialize the build side and put it into the hash table.
+  bool leftIsBuild = leftIsBuildSide();
+  auto& buildTree = leftIsBuild ? *left_ : *right_;
+  auto& probeTree = leftIsBuild ? *right_ : *left_;
+  auto buildJoinCol = leftIsBuild ? leftJoinCol_ : rightJoinCol_;
+  std::shared_ptr<const Result> buildResult = buildTree.getResult();
+  checkCancellation();
+  const IdTable& buildTable = buildResult->idTable();
+  if (buildTable.empty()) {
+    probeTree.getRootOperation()->updateRuntimeInformationWhenOptimizedOut();
+    return createEmptyResult();
+  }
+  size_t numThreads = RuntimeParameters().get<"hash-join-num-threads">();
+  auto hashTable = std::make_shared<const HashTable>(
+      buildTable.getColumn(buildJoinCol),
+      computeNumPartitionBits(buildTable.size(), numThreads), numThreads,
+      cancellationHandle_, allocator());
+  runtimeInfo().addDetail("build-side", leftIsBuild ? "left" : "right");
+  runtimeInfo().addDetail("num-partitions", hashTable->numPartitions());
+  checkCancellation();
+
+  // Probe the hash table with the (possibly lazy) probe side.
+  std::shared_ptr<const Result> probeResult = probeTree.getResult(true);
+  checkCancellation();
+  if (probeResult->isFullyMaterialized()) {
+    IdTable result =
+        probe(*hashTable, buildTable, probeResult->idTable(), leftIsBuild);
+    return {std::move(result), resultSortedOn(),
+            Result::getMergedLocalVocab(*buildResult, *probeResult)};
+  }
+  auto joinedBlocks =
+      [](const HashJoin* self, std::shared_ptr<const Result> buildResult,
+         std::shared_ptr<const Result> probeResult,
+         std::shared_ptr<const HashTable> hashTable,
+         bool leftIsBuild) -> Result::Generator {
+    for (auto& [idTable, localVocab] : probeResult->idTables()) {
+      IdTable result = self->probe(*hashTable, buildResult->idTable(), idTable,
+                                   leftIsBuild);
+      if (result.empty()) {
+        continue;
+      }
+      localVocab.mergeWith(buildResult->localVocab());
+      co_yield {std::move(result), std::move(localVocab)};
+    }
+  }(this, std::move(buildResult), std::move(probeResult), std::move(hashTable),
+    leftIsBuild);
+  if (requestLaziness) {
+    return {std::move(joinedBlocks), resultSortedOn()};
+  }
+  IdTable result{getResultWidth(), allocator()};
+  LocalVocab localVocab;
+  for (auto& [idTable, blockLocalVocab] : joinedBlocks) {
+    result.insertAtEnd(idTable);
+    localVocab.mergeWith(blockLocalVocab);
+  }
+  return {std::move(result), resultSortedOn(), std::move(localVocab)};
+}
+
+// _____________________________________________________________________________
+IdTable HashJoin::probe(const HashTable& hashTable, const IdTable& buildTable,
+                        const IdTable& probeTable, bool leftIsBuild) const {
+  auto probeColumn =
+      probeTable.getColumn(leftIsBuild ? rightJoinCol_ : leftJoinCol_);
+  const size_t numRows = probeTable.size();
+  const size_t numChunks = numTasksForRows(numRows);
+  std::vector<IdTable> results;
+  results.reserve(numChunks);
+  for (size_t i = 0; i < numChunks; ++i) {
+    results.emplace_back(getResultWidth(), allocator());
+  }
+  ad_utility::runTasksInParallel(
+      numChunks, RuntimeParameters().get<"hash-join-num-threads">(),
+      [&](size_t chunk) {
+        checkCancellation();
+        auto [begin, end] = rowsOfTask(chunk, numChunks, numRows);
+        VectorWithLimit<size_t> buildRows{allocator()};
+        VectorWithLimit<size_t> probeRows{allocator()};
+        for (size_t row = begin; row < end; ++row) {
+          hashTable.forEachMatch(probeColumn[row], [&](size_t buildRow) {
+            buildRows.push_back(buildRow);
+            probeRows.push_back(row);
+          });
+        }
+        checkCancellation();
+        if (leftIsBuild) {
+          writeJoinedRows(buildTable, probeTable, buildRows, probeRows,
+                          results[chunk]);
+        } else {
+          writeJoinedRows(probeTable, buildTable, probeRows, buildRows,
+                          results[chunk]);
+        }
+      });
+  IdTable result = std::move(results.at(0));
+  for (size_t i = 1; i < numChunks; ++i) {
+    result.insertAtEnd(results[i]);
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+void HashJoin::writeJoinedRows(const IdTable& left, const IdTable& right,
+                               ql::span<const size_t> leftRows,
+                               ql::span<const size_t> rightRows,
+                               IdTable& result) const {
+  AD_CORRECTNESS_CHECK(leftRows.size() == rightRows.size());
+  result.resize(leftRows.size());
+  // Gather the result column by column, which is more cache-friendly than
+  // writing the result row by row.
+  ColumnIndex resultCol = 0;
+  auto gather = [&result, &resultCol](ql::span<const Id> input,
+                                      ql::span<const size_t> rows) {
+    auto output = result.getColumn(resultCol++);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      output[i] = input[rows[i]];
+    }
+  };
+  for (ColumnIndex col = 0; col < left.numColumns(); ++col) {
+    gather(left.getColumn(col), leftRows);
+  }
+  for (ColumnIndex col = 0; col < right.numColumns(); ++col) {
+    if (col != rightJoinCol_) {
+      gather(right.getColumn(col), rightRows);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+std::unique_ptr<Operation> HashJoin::cloneImpl() const {
+  auto copy = std::make_unique<HashJoin>(*this);
+  copy->left_ = left_->clone();
+  copy->right_ = right_->clone();
+  return copy;
+}
@@ -0,0 +1,170 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_ENGINE_HASHJOIN_H
+#define QLEVER_SRC_ENGINE_HASHJOIN_H
+
+#include <absl/hash/hash.h>
+
+#include <memory>
+#include <vector>
+
+#include "engine/Operation.h"
+#include "engine/QueryExecutionTree.h"
+#include "util/CancellationHandle.h"
+#include "util/HashMap.h"
+
+// A join on a single column that doesn't require its inputs to be sorted. The
+// smaller input (according to the size estimates) is the build side, which is
+// fully materialized and put into a hash table. The hash table is split into
+// partitions by the (radix of a) hash of the join column, so that the
+// partitions can be built in parallel. The other input is the probe side,
+// which is read lazily and whose blocks are probed in parallel. The result is
+// not sorted, and the query planner only uses this operation if the join
+// columns of both inputs are always defined.
+class HashJoin : public Operation {
+ public:
+  // The hash table for the build side. The rows of the build side are first
+  // distributed to `2^numPartitionBits_` partitions by the highest bits of a
+  // (multiplicative) hash of their join column. Each partition maps an `Id`
+  // to a range of `rows_` that contains the indices of all the rows of the
+  // build side with this `Id`.
+  class HashTable {
+   public:
+    using RowRange = std::pair<size_t, size_t>;
+
+   private:
+    // The memory of the partitions is limited by the allocator of the query.
+    struct Partition {
+      ad_utility::HashMapWithMemoryLimit<Id, RowRange> ranges_;
+      std::vector<size_t, ad_utility::AllocatorWithLimit<size_t>> rows_;
+
+      explicit Partition(const ad_utility::AllocatorWithLimit<Id>& allocator)
+          : ranges_{allocator}, rows_{allocator} {}
+    };
+    size_t numPartitionBits_;
+    std::vector<Partition> partitions_;
+
+   public:
+    // Build the hash table for the given `joinColumn` of the build side using
+    // up to `numThreads` threads. All the memory is allocated with the given
+    // `allocator`.
+    HashTable(ql::span<const Id> joinColumn, size_t numPartitionBits,
+              size_t numThreads,
+              const ad_utility::SharedCancellationHandle& cancellationHandle,
+              const ad_utility::AllocatorWithLimit<Id>& allocator);
+
+    // Call `f(buildRow)` for each row of the build side whose join column is
+    // `id`.
+    template <typename F>
+    void forEachMatch(Id id, const F& f) const {
+      const auto& partition = partitions_[partitionOf(id)];
+      auto it = partition.ranges_.find(id);
+      if (it == partition.ranges_.end()) {
+        return;
+      }
+      auto [begin, end] = it->second;
+      for (size_t i = begin; i < end; ++i) {
+        f(partition.rows_[i]);
+      }
+    }
+
+    // The partition of `id`. It has to be derived from the same hash as the
+    // one of the `HashMap`, because equal `Id`s can have different bits (e.g.
+    // `LocalVocabIndex`es of equal entries from different `LocalVocab`s). The
+    // hash is multiplied by a constant, so that the partition doesn't only
+    // depend on the highest bits of the hash.
+    size_t partitionOf(Id id) const {
+      if (numPartitionBits_ == 0) {
+        return 0;
+      }
+      return (static_cast<uint64_t>(absl::Hash<Id>{}(id)) *
+              0x9E3779B97F4A7C15ULL) >>
+             (64 - numPartitionBits_);
+    }
+
+    size_t numPartitions() const { return partitions_.size(); }
+  };
+
+ private:
+  std::shared_ptr<QueryExecutionTree> left_;
+  std::shared_ptr<QueryExecutionTree> right_;
+
+  ColumnIndex leftJoinCol_;
+  ColumnIndex rightJoinCol_;
+
+  Variable joinVar_{"?notSet"};
+
+  bool sizeEstimateComputed_ = false;
+  size_t sizeEstimate_ = 0;
+  std::vector<float> multiplicities_;
+
+ public:
+  // `allowSwappingChildrenOnlyForTesting` should only ever be changed by tests.
+  HashJoin(QueryExecutionContext* qec, std::shared_ptr<QueryExecutionTree> t1,
+           std::shared_ptr<QueryExecutionTree> t2, ColumnIndex t1JoinCol,
+           ColumnIndex t2JoinCol,
+           bool allowSwappingChildrenOnlyForTesting = true);
+
+  // Return true iff a `HashJoin` of `t1` and `t2` on the given columns is
+  // possible, that is, iff both join columns are always defined.
+  static bool isApplicable(const QueryExecutionTree& t1,
+                           const QueryExecutionTree& t2, ColumnIndex t1JoinCol,
+                           ColumnIndex t2JoinCol);
+
+  string getDescriptor() const override;
+
+  size_t getResultWidth() const override;
+
+  // The result of a hash join is not sorted.
+  vector<ColumnIndex> resultSortedOn() const override { return {}; }
+
+  size_t getCostEstimate() override;
+
+  bool knownEmptyResult() override {
+    return left_->knownEmptyResult() || right_->knownEmptyResult();
+  }
+
+  float getMultiplicity(size_t col) override;
+
+  vector<QueryExecutionTree*> getChildren() override {
+    return {left_.get(), right_.get()};
+  }
+
+  bool columnOriginatesFromGraphOrUndef(
+      const Variable& variable) const override;
+
+  // Return true iff the left child is the build side, that is, iff its size
+  // estimate is not larger than the one of the right child.
+  bool leftIsBuildSide();
+
+ private:
+  uint64_t getSizeEstimateBeforeLimit() override;
+
+  void computeSizeEstimateAndMultiplicities();
+
+  string getCacheKeyImpl() const override;
+
+  std::unique_ptr<Operation> cloneImpl() const override;
+
+  Result computeResult(bool requestLaziness) override;
+
+  VariableToColumnMap computeVariableToColumnMap() const override;
+
+  // Probe the `hashTable` of the `buildTable` with all the rows of the
+  // `probeTable` and return the joined rows. The rows of the `probeTable` are
+  // split into chunks that are probed in parallel.
+  IdTable probe(const HashTable& hashTable, const IdTable& buildTable,
+                const IdTable& probeTable, bool leftIsBuild) const;
+
+  // Write the joined rows for the given pairs of matching `leftRows` and
+  // `rightRows` to `result`.
+  void writeJoinedRows(const IdTable& left, const IdTable& right,
+                       ql::span<const size_t> leftRows,
+                       ql::span<const size_t> rightRows,
+                       IdTable& result) const;
+
+  Result createEmptyResult() const;
+};
+
+#endif  // QLEVER_SRC_ENGINE_HASHJOIN_H
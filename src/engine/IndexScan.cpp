@@ -10,6 +10,7 @@
 #include <sstream>
 #include <string>
 
+#include "global/RuntimeParameters.h"
 #include "index/IndexImpl.h"
 #include "parser/ParsedQuery.h"
 
@@ -125,6 +126,22 @@ string IndexScan::getCacheKeyImpl() const {
   return std::move(os).str();
 }
 
+// _____________________________________________________________________________
+size_t IndexScan::getLastModificationOfScannedTriples() const {
+  const auto& snapshot = locatedTriplesSnapshot();
+  if (predicate_.isVariable()) {
+    return snapshot.lastModification_;
+  }
+  // A predicate that is not contained in the vocabulary (but possibly in the
+  // local vocab of the delta triples) can't be looked up, so we are
+  // conservative.
+  auto predicateId = predicate_.toValueId(getIndex().getVocab());
+  if (!predicateId.has_value()) {
+    return snapshot.lastModification_;
+  }
+  return snapshot.lastModificationOfPredicate(predicateId.value());
+}
+
 // _____________________________________________________________________________
 string IndexScan::getDescriptor() const {
   return "IndexScan " + subject_.toString() + " " + predicate_.toString() +
@@ -166,6 +183,18 @@ IndexScan::setPrefilterGetUpdatedQueryExecutionTree(
     return makeCopyWithAddedPrefilters(
         std::make_pair(it->first->clone(), colIdx));
   }
+  // The remaining (unsorted) variable columns can be prefiltered using the
+  // zone maps of the blocks.
+  const auto& permutedTriple = getPermutedTriple();
+  for (size_t i = colIdx + 1; i < permutedTriple.size(); ++i) {
+    it = ql::ranges::find(prefilterVariablePairs,
+                          permutedTriple.at(i)->getVariable(),
+                          ad_utility::second);
+    if (it != prefilterVariablePairs.end()) {
+      return makeCopyWithAddedPrefilters(
+          std::make_pair(it->first->clone(), i));
+    }
+  }
   return std::nullopt;
 }
 
@@ -353,14 +382,22 @@ std::vector<CompressedBlockMetadata> IndexScan::applyPrefilter(
     ql::span<const CompressedBlockMetadata> blocks) const {
   AD_CORRECTNESS_CHECK(prefilter_.has_value() &&
                        getLimitOffset().isUnconstrained());
-  // Apply the prefilter on given blocks.
+  // Apply the prefilter on given blocks. For the sorted column, we first use
+  // the (cheaper) evaluation based on the first and last triple of the blocks.
+  // The zone maps can then additionally prune blocks with mixed datatypes.
   auto& [prefilterExpr, columnIndex] = prefilter_.value();
-  return prefilterExpr->evaluate(getIndex().getVocab(), blocks, columnIndex);
+  const auto& vocab = getIndex().getVocab();
+  if (columnIndex == 3 - numVariables_) {
+    auto result = prefilterExpr->evaluate(vocab, blocks, columnIndex);
+    return prefilterExpr->evaluateWithZoneMaps(vocab, result, columnIndex);
+  }
+  return prefilterExpr->evaluateWithZoneMaps(vocab, blocks, columnIndex);
 }
 
 // _____________________________________________________________________________
 Permutation::IdTableGenerator IndexScan::getLazyScan(
-    std::vector<CompressedBlockMetadata> blocks) const {
+    std::vector<CompressedBlockMetadata> blocks,
+    std::optional<ql::span<const Id>> joinColumnFilter) const {
   // If there is a LIMIT or OFFSET clause that constrains the scan
   // (which can happen with an explicit subquery), we cannot use the prefiltered
   // blocks, as we currently have no mechanism to include limits and offsets
@@ -375,9 +412,15 @@ Permutation::IdTableGenerator IndexScan::getLazyScan(
     // be applied.
     filteredBlocks = applyPrefilter(filteredBlocks.value());
   }
+  // The late materialization discards rows, which is incompatible with a LIMIT
+  // or OFFSET.
+  if (!getLimitOffset().isUnconstrained()) {
+    joinColumnFilter = std::nullopt;
+  }
   return getScanPermutation().lazyScan(
       getScanSpecification(), filteredBlocks, additionalColumns(),
-      cancellationHandle_, locatedTriplesSnapshot(), getLimitOffset());
+      cancellationHandle_, locatedTriplesSnapshot(), getLimitOffset(),
+      joinColumnFilter);
 };
 
 // _____________________________________________________________________________
@@ -448,7 +491,11 @@ Permutation::IdTableGenerator IndexScan::lazyScanForJoinOfColumnWithScan(
   }
   auto blocks = CompressedRelationReader::getBlocksForJoin(joinColumn,
                                                            metaBlocks.value());
-  auto result = getLazyScan(blocks);
+  auto joinColumnFilter =
+      RuntimeParameters().get<"lazy-index-scan-late-materialization">()
+          ? std::optional{joinColumn}
+          : std::nullopt;
+  auto result = getLazyScan(blocks, joinColumnFilter);
   result.details().numBlocksAll_ = metaBlocks.value().sizeBlockMetadata_;
   return result;
 }
@@ -475,6 +522,12 @@ void IndexScan::updateRuntimeInfoForLazyScan(const LazyScanMetadata& metadata) {
   updateIfPositive(metadata.numBlocksPostprocessed_,
                    "num-blocks-postprocessed");
   updateIfPositive(metadata.numBlocksWithUpdate_, "num-blocks-with-update");
+  updateIfPositive(metadata.numBlockCacheHits_, "num-block-cache-hits");
+  updateIfPositive(metadata.numBlockCacheMisses_, "num-block-cache-misses");
+  updateIfPositive(metadata.numBlocksSkippedByLateMaterialization_,
+                   "num-blocks-skipped-late-materialization");
+  updateIfPositive(metadata.numElementsDiscardedByLateMaterialization_,
+                   "num-elements-discarded-late-materialization");
 }
 
 // Store a Generator and its corresponding iterator as well as unconsumed values
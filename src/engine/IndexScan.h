@@ -78,7 +78,9 @@ class IndexScan final : public Operation {
   vector<ColumnIndex> resultSortedOn() const override;
 
   // Set `PrefilterExpression`s and return updated `QueryExecutionTree` pointer
-  // if necessary.
+  // if necessary. A prefilter for the first sorted variable is preferred, else
+  // the first of the remaining variables that has a prefilter is used (those
+  // are prefiltered via the zone maps of the blocks).
   std::optional<std::shared_ptr<QueryExecutionTree>>
   setPrefilterGetUpdatedQueryExecutionTree(
       const std::vector<PrefilterVariablePair>& prefilterVariablePairs)
@@ -101,6 +103,11 @@ class IndexScan final : public Operation {
   // the blocks that can theoretically contain matching rows when performing a
   // join between the first column of the result with the `joinColumn`.
   // Requires that the `joinColumn` is sorted, else the behavior is undefined.
+  // If the runtime parameter `lazy-index-scan-late-materialization` is set,
+  // then rows without a join partner in the `joinColumn` may be omitted, and
+  // the other columns of a block are only read from disk if the block contains
+  // a row with a join partner. In this case the `joinColumn` must stay valid
+  // while the generator is used.
   Permutation::IdTableGenerator lazyScanForJoinOfColumnWithScan(
       ql::span<const Id> joinColumn) const;
 
@@ -202,6 +209,11 @@ class IndexScan final : public Operation {
 
   std::string getCacheKeyImpl() const override;
 
+  // If the predicate of this scan is fixed, the result only depends on the
+  // triples with this predicate, so updates of other predicates don't
+  // invalidate the cached result.
+  size_t getLastModificationOfScannedTriples() const override;
+
   VariableToColumnMap computeVariableToColumnMap() const override;
 
   // Return an updated QueryExecutionTree containing the new IndexScan which is
@@ -240,8 +252,11 @@ class IndexScan final : public Operation {
 
   // Helper functions for the public `getLazyScanFor...` methods and
   // `chunkedIndexScan` (see above).
+  // If `joinColumnFilter` is specified, then the late materialization is used
+  // (see `CompressedRelationReader::lazyScan` for details).
   Permutation::IdTableGenerator getLazyScan(
-      std::vector<CompressedBlockMetadata> blocks) const;
+      std::vector<CompressedBlockMetadata> blocks,
+      std::optional<ql::span<const Id>> joinColumnFilter = std::nullopt) const;
   std::optional<Permutation::MetadataAndBlocks> getMetadataForScan() const;
 };
 
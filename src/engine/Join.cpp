@@ -213,71 +213,78 @@ size_t Join::getCostEstimate() {
 
 // _____________________________________________________________________________
 void Join::computeSizeEstimateAndMultiplicities() {
-  _multiplicities.clear();
-  if (_left->getSizeEstimate() == 0 || _right->getSizeEstimate() == 0) {
-    for (size_t i = 0; i < getResultWidth(); ++i) {
-      _multiplicities.emplace_back(1);
-    }
-    return;
+  std::tie(_sizeEstimate, _multiplicities) = estimateSizeAndMultiplicities(
+      _executionContext, *_left, _leftJoinCol, *_right, _rightJoinCol);
+}
+
+// _____________________________________________________________________________
+std::pair<size_t, std::vector<float>> Join::estimateSizeAndMultiplicities(
+    const QueryExecutionContext* qec, QueryExecutionTree& left,
+    ColumnIndex leftJoinCol, QueryExecutionTree& right,
+    ColumnIndex rightJoinCol) {
+  std::vector<float> multiplicities;
+  size_t resultWidth = left.getResultWidth() + right.getResultWidth() - 1;
+  if (left.getSizeEstimate() == 0 || right.getSizeEstimate() == 0) {
+    multiplicities.resize(resultWidth, 1);
+    return {0, std::move(multiplicities)};
   }
 
   size_t nofDistinctLeft = std::max(
-      size_t(1), static_cast<size_t>(_left->getSizeEstimate() /
-                                     _left->getMultiplicity(_leftJoinCol)));
+      size_t(1), static_cast<size_t>(left.getSizeEstimate() /
+                                     left.getMultiplicity(leftJoinCol)));
   size_t nofDistinctRight = std::max(
-      size_t(1), static_cast<size_t>(_right->getSizeEstimate() /
-                                     _right->getMultiplicity(_rightJoinCol)));
+      size_t(1), static_cast<size_t>(right.getSizeEstimate() /
+                                     right.getMultiplicity(rightJoinCol)));
 
   size_t nofDistinctInResult = std::min(nofDistinctLeft, nofDistinctRight);
 
   double adaptSizeLeft =
-      _left->getSizeEstimate() *
+      left.getSizeEstimate() *
       (static_cast<double>(nofDistinctInResult) / nofDistinctLeft);
   double adaptSizeRight =
-      _right->getSizeEstimate() *
+      right.getSizeEstimate() *
       (static_cast<double>(nofDistinctInResult) / nofDistinctRight);
 
-  double corrFactor = _executionContext
-                          ? _executionContext->getCostFactor(
-                                "JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR")
-                          : 1.0;
+  double corrFactor =
+      qec ? qec->getCostFactor("JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR") : 1.0;
 
-  double jcMultiplicityInResult = _left->getMultiplicity(_leftJoinCol) *
-                                  _right->getMultiplicity(_rightJoinCol);
-  _sizeEstimate = std::max(
+  double jcMultiplicityInResult =
+      left.getMultiplicity(leftJoinCol) * right.getMultiplicity(rightJoinCol);
+  size_t sizeEstimate = std::max(
       size_t(1), static_cast<size_t>(corrFactor * jcMultiplicityInResult *
                                      nofDistinctInResult));
 
-  LOG(TRACE) << "Estimated size as: " << _sizeEstimate << " := " << corrFactor
+  LOG(TRACE) << "Estimated size as: " << sizeEstimate << " := " << corrFactor
              << " * " << jcMultiplicityInResult << " * " << nofDistinctInResult
              << std::endl;
 
-  for (auto i = ColumnIndex{0}; i < _left->getResultWidth(); ++i) {
-    double oldMult = _left->getMultiplicity(i);
+  for (auto i = ColumnIndex{0}; i < left.getResultWidth(); ++i) {
+    double oldMult = left.getMultiplicity(i);
     double m = std::max(
-        1.0, oldMult * _right->getMultiplicity(_rightJoinCol) * corrFactor);
-    if (i != _leftJoinCol && nofDistinctLeft != nofDistinctInResult) {
-      double oldDist = _left->getSizeEstimate() / oldMult;
+        1.0, oldMult * right.getMultiplicity(rightJoinCol) * corrFactor);
+    if (i != leftJoinCol && nofDistinctLeft != nofDistinctInResult) {
+      double oldDist = left.getSizeEstimate() / oldMult;
       double newDist = std::min(oldDist, adaptSizeLeft);
-      m = (_sizeEstimate / corrFactor) / newDist;
+      m = (sizeEstimate / corrFactor) / newDist;
     }
-    _multiplicities.emplace_back(m);
+    multiplicities.emplace_back(m);
   }
-  for (auto i = ColumnIndex{0}; i < _right->getResultWidth(); ++i) {
-    if (i == _rightJoinCol) {
+  for (auto i = ColumnIndex{0}; i < right.getResultWidth(); ++i) {
+    if (i == rightJoinCol) {
       continue;
     }
-    double oldMult = _right->getMultiplicity(i);
+    double oldMult = right.getMultiplicity(i);
     double m = std::max(
-        1.0, oldMult * _left->getMultiplicity(_leftJoinCol) * corrFactor);
-    if (i != _rightJoinCol && nofDistinctRight != nofDistinctInResult) {
-      double oldDist = _right->getSizeEstimate() / oldMult;
+        1.0, oldMult * left.getMultiplicity(leftJoinCol) * corrFactor);
+    if (i != rightJoinCol && nofDistinctRight != nofDistinctInResult) {
+      double oldDist = right.getSizeEstimate() / oldMult;
       double newDist = std::min(oldDist, adaptSizeRight);
-      m = (_sizeEstimate / corrFactor) / newDist;
+      m = (sizeEstimate / corrFactor) / newDist;
     }
-    _multiplicities.emplace_back(m);
+    multiplicities.emplace_back(m);
   }
-  assert(_multiplicities.size() == getResultWidth());
+  AD_CORRECTNESS_CHECK(multiplicities.size() == resultWidth);
+  return {sizeEstimate, std::move(multiplicities)};
 }
 
 // ______________________________________________________________________________
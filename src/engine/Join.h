@@ -62,6 +62,15 @@ class Join : public Operation {
 
   void computeSizeEstimateAndMultiplicities();
 
+  // Estimate the size and the multiplicities of the columns of the result of
+  // joining `left` and `right` on a single column. The columns of the result
+  // are the columns of `left`, followed by the columns of `right` without the
+  // join column. This is also used by the `HashJoin`.
+  static std::pair<size_t, std::vector<float>> estimateSizeAndMultiplicities(
+      const QueryExecutionContext* qec, QueryExecutionTree& left,
+      ColumnIndex leftJoinCol, QueryExecutionTree& right,
+      ColumnIndex rightJoinCol);
+
   float getMultiplicity(size_t col) override;
 
   vector<QueryExecutionTree*> getChildren() override {
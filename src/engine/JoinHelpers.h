@@ -129,6 +129,131 @@ CPP_template_2(typename ActionT)(
       });
 }
 
+// Yield the rows of the `result` in blocks. A fully materialized result is
+// split into blocks of `CHUNK_SIZE` rows.
+inline Result::Generator resultInBlocks(std::shared_ptr<const Result> result) {
+  if (!result->isFullyMaterialized()) {
+    for (auto& pair : result->idTables()) {
+      co_yield pair;
+    }
+    co_return;
+  }
+  const IdTable& table = result->idTable();
+  for (size_t i = 0; i < table.numRows(); i += CHUNK_SIZE) {
+    IdTable block{table.numColumns(), table.getAllocator()};
+    block.insertAtEnd(table, i, std::min(i + CHUNK_SIZE, table.numRows()));
+    co_yield {std::move(block), result->getCopyOfLocalVocab()};
+  }
+}
+
+// Rows from the left and the right input of a join-like operation that can be
+// processed independently of all the other rows of the inputs, together with
+// a local vocabulary for all of them.
+struct IndependentRanges {
+  IdTable left_;
+  IdTable right_;
+  LocalVocab localVocab_;
+};
+
+// Split the `left` and `right` input of a join-like operation (e.g. a
+// `MultiColumnJoin` or a `Minus`) into `IndependentRanges`. Both inputs may be
+// lazy and have to be sorted by their first join column `leftJoinCol` and
+// `rightJoinCol`, respectively. The ranges are disjoint intervals of the
+// values of the first join column, so all the rows that have the same value in
+// the first join column are yielded together, and the ranges are yielded in
+// sorted order. Only the rows of the current range (at most a block of each
+// input plus the rows with the same value in the first join column) are
+// buffered. If `keepLeftRowsWithoutMatch` is false, no more ranges are yielded
+// once one of the inputs is exhausted.
+inline cppcoro::generator<IndependentRanges> splitIntoIndependentRanges(
+    std::shared_ptr<const Result> left, std::shared_ptr<const Result> right,
+    ColumnIndex leftJoinCol, ColumnIndex rightJoinCol, size_t leftWidth,
+    size_t rightWidth, ad_utility::AllocatorWithLimit<Id> allocator,
+    bool keepLeftRowsWithoutMatch) {
+  auto leftBlocks = resultInBlocks(std::move(left));
+  auto rightBlocks = resultInBlocks(std::move(right));
+  auto leftIt = leftBlocks.begin();
+  auto rightIt = rightBlocks.begin();
+  IdTable leftBuffer{leftWidth, allocator};
+  IdTable rightBuffer{rightWidth, allocator};
+  LocalVocab localVocab;
+  auto readBlock = [&localVocab](auto& it, IdTable& buffer) {
+    auto& [idTable, blockLocalVocab] = *it;
+    buffer.insertAtEnd(idTable);
+    localVocab.mergeWith(blockLocalVocab);
+    ++it;
+  };
+  // Remove the rows with a value `< boundary` in the `joinCol` from the
+  // `buffer` and return them.
+  auto splitOff = [&allocator](IdTable& buffer, ColumnIndex joinCol,
+                               Id boundary) {
+    auto column = buffer.getColumn(joinCol);
+    size_t numRows =
+        ql::ranges::lower_bound(column, boundary) - column.begin();
+    IdTable prefix = std::move(buffer);
+    buffer = IdTable{prefix.numColumns(), allocator};
+    buffer.insertAtEnd(prefix, numRows, prefix.numRows());
+    prefix.resize(numRows);
+    return prefix;
+  };
+
+  while (true) {
+    bool leftExhausted = leftIt == leftBlocks.end();
+    bool rightExhausted = rightIt == rightBlocks.end();
+    // Each buffer must contain at least one row, unless its input is
+    // exhausted.
+    if (leftBuffer.empty() && !leftExhausted) {
+      readBlock(leftIt, leftBuffer);
+      continue;
+    }
+    if (rightBuffer.empty() && !rightExhausted) {
+      readBlock(rightIt, rightBuffer);
+      continue;
+    }
+    if (leftExhausted && rightExhausted) {
+      break;
+    }
+    // Without rows from the left input, there is nothing left to do.
+    if ((leftExhausted && leftBuffer.empty()) ||
+        (!keepLeftRowsWithoutMatch && rightExhausted && rightBuffer.empty())) {
+      co_return;
+    }
+    // All the rows with a value `< boundary` in the first join column are
+    // already contained in the buffers, because the inputs are sorted.
+    std::optional<Id> leftLast;
+    std::optional<Id> rightLast;
+    if (!leftExhausted) {
+      leftLast = leftBuffer.getColumn(leftJoinCol).back();
+    }
+    if (!rightExhausted) {
+      rightLast = rightBuffer.getColumn(rightJoinCol).back();
+    }
+    Id boundary = !leftLast.has_value()    ? rightLast.value()
+                  : !rightLast.has_value() ? leftLast.value()
+                                           : std::min(leftLast.value(),
+                                                      rightLast.value());
+    IndependentRanges ranges{splitOff(leftBuffer, leftJoinCol, boundary),
+                             splitOff(rightBuffer, rightJoinCol, boundary),
+                             localVocab.clone()};
+    if (!ranges.left_.empty() || !ranges.right_.empty()) {
+      co_yield ranges;
+    }
+    // Read the next block of each input that might still contain rows with
+    // the value `boundary` in its first join column.
+    if (leftLast == boundary) {
+      readBlock(leftIt, leftBuffer);
+    }
+    if (rightLast == boundary) {
+      readBlock(rightIt, rightBuffer);
+    }
+  }
+  if (!leftBuffer.empty() || !rightBuffer.empty()) {
+    IndependentRanges ranges{std::move(leftBuffer), std::move(rightBuffer),
+                             std::move(localVocab)};
+    co_yield ranges;
+  }
+}
+
 // Helper function to check if the join of two columns propagate the value
 // returned by `Operation::columnOriginatesFromGraphOrUndef`.
 inline bool doesJoinProduceGuaranteedGraphValuesOrUndef(
@@ -5,6 +5,7 @@
 #include "Minus.h"
 
 #include "engine/CallFixedSize.h"
+#include "engine/JoinHelpers.h"
 #include "engine/Service.h"
 #include "util/Exception.h"
 
@@ -33,7 +34,7 @@ string Minus::getCacheKeyImpl() const {
 string Minus::getDescriptor() const { return "Minus"; }
 
 // _____________________________________________________________________________
-Result Minus::computeResult([[maybe_unused]] bool requestLaziness) {
+Result Minus::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "Minus result computation..." << endl;
 
   // If the right of the RootOperations is a Service, precompute the result of
@@ -45,11 +46,20 @@ Result Minus::computeResult([[maybe_unused]] bool requestLaziness) {
   IdTable idTable{getExecutionContext()->getAllocator()};
   idTable.setNumColumns(getResultWidth());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  // Without a common variable the result is simply the left input, so the
+  // lazy implementation is only needed if there is a join column.
+  bool lazyMinusIsSupported = !_matchedColumns.empty();
+  auto leftResult = _left->getResult(lazyMinusIsSupported);
+  auto rightResult = _right->getResult(lazyMinusIsSupported);
 
   LOG(DEBUG) << "Minus subresult computation done" << std::endl;
 
+  if (!leftResult->isFullyMaterialized() ||
+      !rightResult->isFullyMaterialized()) {
+    return lazyMinus(std::move(leftResult), std::move(rightResult),
+                     requestLaziness);
+  }
+
   LOG(DEBUG) << "Computing minus of results of size "
              << leftResult->idTable().size() << " and "
              << rightResult->idTable().size() << endl;
@@ -67,6 +77,46 @@ Result Minus::computeResult([[maybe_unused]] bool requestLaziness) {
           Result::getMergedLocalVocab(*leftResult, *rightResult)};
 }
 
+// _____________________________________________________________________________
+Result Minus::lazyMinus(std::shared_ptr<const Result> left,
+                        std::shared_ptr<const Result> right,
+                        bool requestLaziness) const {
+  // The rows of the left input can only be removed by rows of the right input
+  // with the same value in the first join column, so the inputs are split into
+  // independent ranges of these values.
+  auto ranges = qlever::joinHelpers::splitIntoIndependentRanges(
+      std::move(left), std::move(right), _matchedColumns.at(0)[0],
+      _matchedColumns.at(0)[1], _left->getResultWidth(),
+      _right->getResultWidth(), allocator(), true);
+  auto resultBlocks =
+      [](const Minus* self,
+         cppcoro::generator<qlever::joinHelpers::IndependentRanges> ranges)
+      -> Result::Generator {
+    for (auto& [leftTable, rightTable, localVocab] : ranges) {
+      IdTable result{self->getResultWidth(), self->allocator()};
+      int leftWidth = leftTable.numColumns();
+      int rightWidth = rightTable.numColumns();
+      CALL_FIXED_SIZE((std::array{leftWidth, rightWidth}),
+                      &Minus::computeMinus, self, leftTable, rightTable,
+                      self->_matchedColumns, &result);
+      if (result.empty()) {
+        continue;
+      }
+      co_yield {std::move(result), std::move(localVocab)};
+    }
+  }(this, std::move(ranges));
+  if (requestLaziness) {
+    return {std::move(resultBlocks), resultSortedOn()};
+  }
+  IdTable result{getResultWidth(), allocator()};
+  LocalVocab localVocab;
+  for (auto& [idTable, blockLocalVocab] : resultBlocks) {
+    result.insertAtEnd(idTable);
+    localVocab.mergeWith(blockLocalVocab);
+  }
+  return {std::move(result), resultSortedOn(), std::move(localVocab)};
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap Minus::computeVariableToColumnMap() const {
   return _left->getVariableColumns();
@@ -79,7 +79,13 @@ class Minus : public Operation {
       const IdTableView<A_WIDTH>& a, const IdTableView<B_WIDTH>& b, size_t ia,
       size_t ib, const vector<std::array<ColumnIndex, 2>>& matchedColumns);
 
-  Result computeResult([[maybe_unused]] bool requestLaziness) override;
+  Result computeResult(bool requestLaziness) override;
+
+  // Compute the result block by block if at least one of the inputs is lazy.
+  // The result is lazy iff `requestLaziness` is true.
+  Result lazyMinus(std::shared_ptr<const Result> left,
+                   std::shared_ptr<const Result> right,
+                   bool requestLaziness) const;
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 };
@@ -64,7 +64,7 @@ string MultiColumnJoin::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-Result MultiColumnJoin::computeResult([[maybe_unused]] bool requestLaziness) {
+Result MultiColumnJoin::computeResult(bool requestLaziness) {
   LOG(DEBUG) << "MultiColumnJoin result computation..." << endl;
 
   IdTable idTable{getExecutionContext()->getAllocator()};
@@ -72,13 +72,30 @@ Result MultiColumnJoin::computeResult([[maybe_unused]] bool requestLaziness) {
 
   AD_CONTRACT_CHECK(idTable.numColumns() >= _joinColumns.size());
 
-  const auto leftResult = _left->getResult();
-  const auto rightResult = _right->getResult();
+  // An UNDEF value in the first join column matches all the values in the
+  // first join column of the other input, so the inputs can then not be split
+  // into independent ranges for the lazy join.
+  auto isAlwaysDefined = [](const QueryExecutionTree& tree,
+                            ColumnIndex joinCol) {
+    return tree.getVariableAndInfoByColumnIndex(joinCol)
+               .second.mightContainUndef_ ==
+           ColumnIndexAndTypeInfo::AlwaysDefined;
+  };
+  bool lazyJoinIsSupported = isAlwaysDefined(*_left, _joinColumns.at(0)[0]) &&
+                             isAlwaysDefined(*_right, _joinColumns.at(0)[1]);
+  auto leftResult = _left->getResult(lazyJoinIsSupported);
+  auto rightResult = _right->getResult(lazyJoinIsSupported);
 
   checkCancellation();
 
   LOG(DEBUG) << "MultiColumnJoin subresult computation done." << std::endl;
 
+  if (!leftResult->isFullyMaterialized() ||
+      !rightResult->isFullyMaterialized()) {
+    return lazyMultiColumnJoin(std::move(leftResult), std::move(rightResult),
+                               requestLaziness);
+  }
+
   LOG(DEBUG) << "Computing a multi column join between results of size "
              << leftResult->idTable().size() << " and "
              << rightResult->idTable().size() << endl;
@@ -95,6 +112,45 @@ Result MultiColumnJoin::computeResult([[maybe_unused]] bool requestLaziness) {
           Result::getMergedLocalVocab(*leftResult, *rightResult)};
 }
 
+// _____________________________________________________________________________
+Result MultiColumnJoin::lazyMultiColumnJoin(
+    std::shared_ptr<const Result> left, std::shared_ptr<const Result> right,
+    bool requestLaziness) {
+  // Rows can only match if they have the same value in the first join column,
+  // so the inputs are split into independent ranges of these values. Rows of
+  // the left input without a match are dropped, so no more ranges are needed
+  // once one of the inputs is exhausted.
+  auto ranges = qlever::joinHelpers::splitIntoIndependentRanges(
+      std::move(left), std::move(right), _joinColumns.at(0)[0],
+      _joinColumns.at(0)[1], _left->getResultWidth(),
+      _right->getResultWidth(), allocator(), false);
+  auto resultBlocks =
+      [](MultiColumnJoin* self,
+         cppcoro::generator<qlever::joinHelpers::IndependentRanges> ranges)
+      -> Result::Generator {
+    for (auto& [leftTable, rightTable, localVocab] : ranges) {
+      IdTable result{self->getResultWidth(), self->allocator()};
+      self->computeMultiColumnJoin(leftTable, rightTable, self->_joinColumns,
+                                   &result);
+      self->checkCancellation();
+      if (result.empty()) {
+        continue;
+      }
+      co_yield {std::move(result), std::move(localVocab)};
+    }
+  }(this, std::move(ranges));
+  if (requestLaziness) {
+    return {std::move(resultBlocks), resultSortedOn()};
+  }
+  IdTable result{getResultWidth(), allocator()};
+  LocalVocab localVocab;
+  for (auto& [idTable, blockLocalVocab] : resultBlocks) {
+    result.insertAtEnd(idTable);
+    localVocab.mergeWith(blockLocalVocab);
+  }
+  return {std::move(result), resultSortedOn(), std::move(localVocab)};
+}
+
 // _____________________________________________________________________________
 VariableToColumnMap MultiColumnJoin::computeVariableToColumnMap() const {
   return makeVarToColMapForJoinOperation(
@@ -72,7 +72,14 @@ class MultiColumnJoin : public Operation {
  private:
   std::unique_ptr<Operation> cloneImpl() const override;
 
-  Result computeResult([[maybe_unused]] bool requestLaziness) override;
+  Result computeResult(bool requestLaziness) override;
+
+  // Compute the join block by block if at least one of the inputs is lazy.
+  // This requires the first join column of both inputs to be always defined.
+  // The result is lazy iff `requestLaziness` is true.
+  Result lazyMultiColumnJoin(std::shared_ptr<const Result> left,
+                             std::shared_ptr<const Result> right,
+                             bool requestLaziness);
 
   VariableToColumnMap computeVariableToColumnMap() const override;
 
@@ -301,8 +301,7 @@ std::shared_ptr<const Result> Operation::getResult(
     signalQueryUpdate();
   }
   auto& cache = _executionContext->getQueryTreeCache();
-  const QueryCacheKey cacheKey = {
-      getCacheKey(), _executionContext->locatedTriplesSnapshot().index_};
+  const QueryCacheKey cacheKey = getQueryCacheKey();
   const bool pinFinalResultButNotSubtrees =
       _executionContext->_pinResult && isRoot;
   const bool pinResult =
@@ -545,8 +544,8 @@ void Operation::createRuntimeInfoFromEstimates(
   }
   _runtimeInfo->multiplicityEstimates_ = multiplicityEstimates;
 
-  auto cachedResult = _executionContext->getQueryTreeCache().getIfContained(
-      {getCacheKey(), locatedTriplesSnapshot().index_});
+  auto cachedResult =
+      _executionContext->getQueryTreeCache().getIfContained(getQueryCacheKey());
   if (cachedResult.has_value()) {
     const auto& [resultPointer, cacheStatus] = cachedResult.value();
     _runtimeInfo->cacheStatus_ = cacheStatus;
@@ -648,6 +647,21 @@ std::string Operation::getCacheKey() const {
   return result;
 }
 
+// _____________________________________________________________________________
+size_t Operation::getLastModificationOfScannedTriples() const {
+  auto children = getChildren();
+  if (children.empty()) {
+    return locatedTriplesSnapshot().lastModification_;
+  }
+  size_t result = 0;
+  for (const auto* child : children) {
+    result = std::max(
+        result,
+        child->getRootOperation()->getLastModificationOfScannedTriples());
+  }
+  return result;
+}
+
 // _____________________________________________________________________________
 uint64_t Operation::getSizeEstimate() {
   if (limitOffset_._limit.has_value()) {
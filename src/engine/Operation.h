@@ -168,6 +168,21 @@ class Operation {
   // Calls  `getCacheKeyImpl` and adds the information about the `LIMIT` clause.
   virtual std::string getCacheKey() const final;
 
+  // The index of the last `LocatedTriplesSnapshot` (up to the current one)
+  // that modified any of the triples on which the result of this operation
+  // depends. The default implementation returns the maximum over all children,
+  // and for operations without children the index of the last modification of
+  // any triple. Operations with children that additionally read triples
+  // directly from the index have to override this function.
+  virtual size_t getLastModificationOfScannedTriples() const;
+
+  // The key of the result of this operation in the query cache. The cached
+  // result stays valid across updates that don't modify any of the triples on
+  // which it depends (see `getLastModificationOfScannedTriples` above).
+  QueryCacheKey getQueryCacheKey() const {
+    return {getCacheKey(), getLastModificationOfScannedTriples()};
+  }
+
   // If this function returns `false`, then the result of this `Operation` will
   // never be stored in the cache. It might however be read from the cache.
   // This can be used, if the operation actually only returns a subset of the
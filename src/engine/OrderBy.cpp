@@ -9,9 +9,11 @@
 
 #include "engine/CallFixedSize.h"
 #include "engine/Engine.h"
+#include "engine/ExternalSort.h"
 #include "engine/QueryExecutionTree.h"
 #include "global/RuntimeParameters.h"
 #include "global/ValueIdComparators.h"
+#include "util/RunTasksInParallel.h"
 #include "util/TransparentFunctors.h"
 
 // _____________________________________________________________________________
@@ -42,6 +44,10 @@ std::string OrderBy::getCacheKeyImpl() const {
   for (auto ind : sortIndices_) {
     os << (ind.second ? "desc(" : "asc(") << ind.first << ") ";
   }
+  // Only the first rows of the result are computed in this case.
+  if (auto k = getTopKSize(); k.has_value()) {
+    os << "top-k(" << k.value() << ") ";
+  }
   os << "\n" << subtree_->getCacheKey();
   return std::move(os).str();
 }
@@ -62,47 +68,34 @@ std::string OrderBy::getDescriptor() const {
   return "OrderBy on" + orderByVars;
 }
 
-// _____________________________________________________________________________
-Result OrderBy::computeResult([[maybe_unused]] bool requestLaziness) {
-  using std::endl;
-  LOG(DEBUG) << "Getting sub-result for OrderBy result computation..." << endl;
-  std::shared_ptr<const Result> subRes = subtree_->getResult();
-
-  // TODO<joka921> proper timeout for sorting operations
-  const auto& subTable = subRes->idTable();
-  getExecutionContext()->getSortPerformanceEstimator().throwIfEstimateTooLong(
-      subTable.numRows(), subTable.numColumns(), deadline_,
-      "Sort for COUNT(DISTINCT *)");
-
-  LOG(DEBUG) << "OrderBy result computation..." << endl;
-  IdTable idTable = subRes->idTable().clone();
+namespace {
+// TODO<joka921> Measure (as soon as we have the benchmark merged)
+// whether it is beneficial to manually instantiate the comparison when
+// sorting by only one or two columns.
 
-  size_t width = idTable.numColumns();
+// TODO<joka921> In the case of a single variable, it might be more efficient
+// to first sort by the ID values and then "repair" the resulting range by
+// some O(n) algorithms, or even by returning lazy generators that yield
+// the repaired order.
 
-  // TODO<joka921> Measure (as soon as we have the benchmark merged)
-  // whether it is beneficial to manually instantiate the comparison when
-  // sorting by only one or two columns.
+// TODO<joka921> For proper sorting of the local vocab we also need to
+// add some logic for the proper sorting.
 
-  // TODO<joka921> In the case of a single variable, it might be more efficient
-  // to first sort by the ID values and then "repair" the resulting range by
-  // some O(n) algorithms, or even by returning lazy generators that yield
-  // the repaired order.
+// TODO<joka921> Undefined values should always be at the end, no matter
+// if the ordering is ascending or descending.
 
-  // TODO<joka921> For proper sorting of the local vocab we also need to
-  // add some logic for the proper sorting.
+// TODO<joka921> If we know, that all the sort columns contain only datatypes
+// for which the `internal` order is also the `semantic` order, or if a column
+// only contains a single datatype, then we can use more efficient
+// implementations here.
 
-  // TODO<joka921> Undefined values should always be at the end, no matter
-  // if the ordering is ascending or descending.
-
-  // TODO<joka921> If we know, that all the sort columns contain only datatypes
-  // for which the `internal` order is also the `semantic` order, or if a column
-  // only contains a single datatype, then we can use more efficient
-  // implementations here.
-
-  // Return true iff `rowA` comes before `rowB` in the sort order specified by
-  // `sortIndices_`.
-  auto comparison = [this](const auto& row1, const auto& row2) -> bool {
-    for (auto& [column, isDescending] : sortIndices_) {
+// Return a function that returns true iff `rowA` comes before `rowB` in the
+// sort order specified by `sortIndices`. The `sortIndices` are stored by value,
+// because the comparison is also stored by the sorter of an external sort.
+auto makeComparison(OrderBy::SortIndices sortIndices) {
+  return [sortIndices = std::move(sortIndices)](const auto& row1,
+                                                const auto& row2) -> bool {
+    for (auto& [column, isDescending] : sortIndices) {
       if (row1[column] == row2[column]) {
         continue;
       }
@@ -115,18 +108,200 @@ Result OrderBy::computeResult([[maybe_unused]] bool requestLaziness) {
     }
     return false;
   };
+}
 
-  // We cannot use the `CALL_FIXED_SIZE` macro here because the `sort` function
-  // is templated not only on the integer `I` (which the `callFixedSize`
-  // function deals with) but also on the `comparison`.
-  ad_utility::callFixedSizeVi(width, [&idTable, &comparison](auto I) {
-    Engine::sort<I>(&idTable, comparison);
-  });
-  // We can't check during sort, so reset status here
-  cancellationHandle_->resetWatchDogState();
-  checkCancellation();
+// The minimal number of rows per task when the top-k rows of a table are
+// computed in parallel.
+constexpr size_t MIN_ROWS_PER_TOP_K_TASK = 10'000;
+}  // namespace
+
+// _____________________________________________________________________________
+std::optional<uint64_t> OrderBy::getTopKSize() const {
+  constexpr uint64_t max = std::numeric_limits<uint64_t>::max();
+  const auto& limitOffset = getLimitOffset();
+  uint64_t k = limitOffset.upperBound(max);
+  // The hint is applied after the LIMIT and OFFSET of this operation.
+  if (limitOffsetHint_.has_value() && limitOffsetHint_->_limit.has_value()) {
+    uint64_t hintUpperBound = limitOffsetHint_->upperBound(max);
+    if (hintUpperBound <= max - limitOffset._offset) {
+      k = std::min(k, limitOffset._offset + hintUpperBound);
+    }
+  }
+  if (k > RuntimeParameters().get<"order-by-top-k-max-size">()) {
+    return std::nullopt;
+  }
+  return k;
+}
+
+// _____________________________________________________________________________
+Result OrderBy::computeResult(bool requestLaziness) {
+  using std::endl;
+  LOG(DEBUG) << "Getting sub-result for OrderBy result computation..." << endl;
+  if (auto k = getTopKSize(); k.has_value()) {
+    // The top-k rows are computed in a single pass over the (possibly lazy)
+    // sub-result.
+    return computeTopK(subtree_->getResult(true), k.value());
+  }
+  // Only request a lazy sub-result if it might be too large to be sorted in
+  // RAM, because collecting the blocks of a lazy result has some overhead.
+  std::shared_ptr<const Result> subRes =
+      subtree_->getResult(qlever::externalSort::exceedsInMemoryThreshold(
+          subtree_->getSizeEstimate(), getResultWidth()));
+
+  auto comparison = makeComparison(sortIndices_);
+  auto sortInMemory = [this, &comparison](IdTable& idTable) {
+    // TODO<joka921> proper timeout for sorting operations
+    getExecutionContext()
+        ->getSortPerformanceEstimator()
+        .throwIfEstimateTooLong(idTable.numRows(), idTable.numColumns(),
+                                deadline_, "Sort for COUNT(DISTINCT *)");
+    LOG(DEBUG) << "OrderBy result computation..." << endl;
+    // We cannot use the `CALL_FIXED_SIZE` macro here because the `sort`
+    // function is templated not only on the integer `I` (which the
+    // `callFixedSize` function deals with) but also on the `comparison`.
+    ad_utility::callFixedSizeVi(
+        idTable.numColumns(), [&idTable, &comparison](auto I) {
+          Engine::sort<I>(&idTable, comparison);
+        });
+    // We can't check during sort, so reset status here
+    cancellationHandle_->resetWatchDogState();
+    checkCancellation();
+  };
+  auto makeSorter = [this, &comparison]() {
+    return qlever::externalSort::makeSorter(*getExecutionContext(),
+                                            getResultWidth(), comparison);
+  };
+  auto result = qlever::externalSort::sortResult(
+      std::move(subRes), getResultWidth(), resultSortedOn(), sortInMemory,
+      makeSorter, requestLaziness, allocator(), cancellationHandle_,
+      runtimeInfo());
   LOG(DEBUG) << "OrderBy result computation done." << endl;
-  return {std::move(idTable), resultSortedOn(), subRes->getSharedLocalVocab()};
+  return result;
+}
+
+// _____________________________________________________________________________
+Result OrderBy::computeTopK(std::shared_ptr<const Result> subRes,
+                            uint64_t k) const {
+  runtimeInfo().addDetail("top-k", k);
+  auto comparison = makeComparison(sortIndices_);
+  const size_t numThreads = std::max(
+      size_t{1}, RuntimeParameters().get<"order-by-top-k-num-threads">());
+  // The (at most) `k` first rows of all the tables processed so far, in sorted
+  // order.
+  IdTable topRows{getResultWidth(), allocator()};
+  // The threads are only created for the first table that is split into
+  // several chunks, and then reused for all the following tables.
+  std::optional<ad_utility::ParallelTaskRunner> runner;
+
+  // Merge the `k` first rows of the `table` into the `topRows`. The `table` is
+  // split into chunks, and each chunk has its own bounded heap that contains
+  // the indices of the `k` first rows of the chunk. The rows that come after
+  // the last of the current `topRows` are skipped early.
+  auto mergeTable = [&](const IdTable& table) {
+    if (k == 0) {
+      return;
+    }
+    const size_t numRows = table.numRows();
+    const size_t numTasks =
+        std::clamp(numRows / MIN_ROWS_PER_TOP_K_TASK, size_t{1}, numThreads);
+    std::optional<size_t> lastTopRow;
+    if (topRows.numRows() == k) {
+      lastTopRow = k - 1;
+    }
+    auto isLess = [&](size_t a, size_t b) {
+      return comparison(table[a], table[b]);
+    };
+    std::vector<std::vector<size_t>> heaps(numTasks);
+    auto computeHeap = [&](size_t task) {
+      checkCancellation();
+      auto& heap = heaps[task];
+      size_t begin = task * numRows / numTasks;
+      size_t end = (task + 1) * numRows / numTasks;
+      for (size_t row = begin; row < end; ++row) {
+        if (lastTopRow.has_value() &&
+            !comparison(table[row], topRows[lastTopRow.value()])) {
+          continue;
+        }
+        // The heap is a max-heap, so its first element is the last of the
+        // rows in the heap.
+        if (heap.size() < k) {
+          heap.push_back(row);
+          ql::ranges::push_heap(heap, isLess);
+        } else if (isLess(row, heap.front())) {
+          ql::ranges::pop_heap(heap, isLess);
+          heap.back() = row;
+          ql::ranges::push_heap(heap, isLess);
+        }
+      }
+      ql::ranges::sort_heap(heap, isLess);
+    };
+    if (numTasks == 1) {
+      computeHeap(0);
+    } else {
+      if (!runner.has_value()) {
+        runner.emplace(numThreads);
+      }
+      runner->run(numTasks, computeHeap);
+    }
+    if (ql::ranges::all_of(heaps,
+                           [](const auto& heap) { return heap.empty(); })) {
+      return;
+    }
+
+    // Merge the sorted rows of all the heaps and the `topRows` (the first
+    // run), and keep the first `k` of them. The heap of `cursors` contains the
+    // next position of each run, the smallest first. For equal rows, the
+    // earlier run comes first.
+    using Cursor = std::pair<size_t, size_t>;
+    auto rowAt = [&](const Cursor& cursor) {
+      auto [run, position] = cursor;
+      return run == 0 ? std::as_const(topRows)[position]
+                      : table[heaps[run - 1][position]];
+    };
+    auto runSize = [&](size_t run) {
+      return run == 0 ? topRows.numRows() : heaps[run - 1].size();
+    };
+    auto comesAfter = [&](const Cursor& a, const Cursor& b) {
+      if (comparison(rowAt(b), rowAt(a))) {
+        return true;
+      }
+      return !comparison(rowAt(a), rowAt(b)) && a.first > b.first;
+    };
+    std::vector<Cursor> cursors;
+    for (size_t run = 0; run <= heaps.size(); ++run) {
+      if (runSize(run) > 0) {
+        cursors.emplace_back(run, 0);
+      }
+    }
+    ql::ranges::make_heap(cursors, comesAfter);
+    IdTable newTopRows{getResultWidth(), allocator()};
+    while (!cursors.empty() && newTopRows.numRows() < k) {
+      ql::ranges::pop_heap(cursors, comesAfter);
+      auto& cursor = cursors.back();
+      newTopRows.push_back(rowAt(cursor));
+      if (++cursor.second < runSize(cursor.first)) {
+        ql::ranges::push_heap(cursors, comesAfter);
+      } else {
+        cursors.pop_back();
+      }
+    }
+    topRows = std::move(newTopRows);
+    checkCancellation();
+  };
+
+  auto makeResult = [&](auto localVocab) -> Result {
+    return {std::move(topRows), resultSortedOn(), std::move(localVocab)};
+  };
+  if (subRes->isFullyMaterialized()) {
+    mergeTable(subRes->idTable());
+    return makeResult(subRes->getSharedLocalVocab());
+  }
+  LocalVocab localVocab;
+  for (auto& [idTable, blockLocalVocab] : subRes->idTables()) {
+    mergeTable(idTable);
+    localVocab.mergeWith(blockLocalVocab);
+  }
+  return makeResult(std::move(localVocab));
 }
 
 // ___________________________________________________________________
@@ -142,6 +317,8 @@ OrderBy::SortedVariables OrderBy::getSortedVariables() const {
 
 // _____________________________________________________________________________
 std::unique_ptr<Operation> OrderBy::cloneImpl() const {
-  return std::make_unique<OrderBy>(_executionContext, subtree_->clone(),
-                                   sortIndices_);
+  auto copy = std::make_unique<OrderBy>(_executionContext, subtree_->clone(),
+                                        sortIndices_);
+  copy->limitOffsetHint_ = limitOffsetHint_;
+  return copy;
 }
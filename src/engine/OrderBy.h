@@ -29,6 +29,8 @@ class OrderBy : public Operation {
  private:
   std::shared_ptr<QueryExecutionTree> subtree_;
   SortIndices sortIndices_;
+  // See `setLimitOffsetHint`.
+  std::optional<LimitOffsetClause> limitOffsetHint_;
 
  public:
   OrderBy(QueryExecutionContext* qec,
@@ -40,6 +42,18 @@ class OrderBy : public Operation {
  public:
   string getDescriptor() const override;
 
+  // Tell this operation that only the rows selected by `limitOffset` will be
+  // used (for example, because it is the root operation, and the LIMIT and
+  // OFFSET of the query are applied by the export). If the LIMIT plus the
+  // OFFSET is small, only the first rows of the sorted result are then
+  // computed (see `computeTopK`). In contrast to `applyLimitOffset`, the LIMIT
+  // and OFFSET are not applied to the result, and the cache key only changes
+  // if the top-k computation is used. This way, the complete sort is still
+  // cached and reused for different LIMITs and OFFSETs.
+  void setLimitOffsetHint(const LimitOffsetClause& limitOffset) {
+    limitOffsetHint_ = limitOffset;
+  }
+
   // The function `resultSortedOn` refers to the `internal` sorting by ID value.
   // This is different from the `semantic` sorting that the ORDER BY operation
   // computes.
@@ -63,9 +77,14 @@ class OrderBy : public Operation {
 
   size_t getCostEstimate() override {
     size_t size = getSizeEstimateBeforeLimit();
+    // If only the first `k` rows are computed, the cost is `n * log(k)`.
+    // The range is clamped to at least 2, because `logb(0)` is `-inf`.
+    size_t sizeOfSortedRange = std::max(
+        size_t{2},
+        std::min(size, static_cast<size_t>(getTopKSize().value_or(size))));
     size_t logSize = std::max(
-        size_t(1), static_cast<size_t>(logb(
-                       static_cast<double>(getSizeEstimateBeforeLimit()))));
+        size_t(1),
+        static_cast<size_t>(logb(static_cast<double>(sizeOfSortedRange))));
     size_t nlogn = size * logSize;
     size_t subcost = subtree_->getCostEstimate();
     return nlogn + subcost;
@@ -82,7 +101,17 @@ class OrderBy : public Operation {
  private:
   std::unique_ptr<Operation> cloneImpl() const override;
 
-  Result computeResult([[maybe_unused]] bool requestLaziness) override;
+  Result computeResult(bool requestLaziness) override;
+
+  // Return the number of rows that have to be computed for the LIMIT and
+  // OFFSET of this operation and the `limitOffsetHint_` if this number is
+  // small enough for `computeTopK`, and `std::nullopt` otherwise.
+  std::optional<uint64_t> getTopKSize() const;
+
+  // Compute only the first `k` rows of the sorted `subRes`. The LIMIT and
+  // OFFSET are applied by the caller (see `Operation::getResult`) or by the
+  // export. The result is always fully materialized.
+  Result computeTopK(std::shared_ptr<const Result> subRes, uint64_t k) const;
 
   VariableToColumnMap computeVariableToColumnMap() const override {
     return subtree_->getVariableColumns();
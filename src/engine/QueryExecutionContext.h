@@ -64,20 +64,22 @@ class CacheValue {
 };
 
 // The key for the `QueryResultCache` below. It consists of a `string` (the
-// actual cache key of a `QueryExecutionTree` and the index of the
-// `LocatedTriplesSnapshot` that was used to create the corresponding value.
-// That way, two identical trees with different snapshot indices will have a
-// different cache key. This has the (desired!) effect that UPDATE requests
-// correctly invalidate preexisting cache results.
+// actual cache key of a `QueryExecutionTree`) and the index of the last
+// `LocatedTriplesSnapshot` that modified any of the triples on which the
+// corresponding value depends (see
+// `Operation::getLastModificationOfScannedTriples`). That way, UPDATE requests
+// correctly invalidate exactly the preexisting cache results that they affect.
+// The invalidated results are never accessed again and are eventually evicted
+// from the cache.
 struct QueryCacheKey {
   std::string key_;
-  size_t locatedTriplesSnapshotIndex_;
+  size_t lastModificationIndex_;
 
   bool operator==(const QueryCacheKey&) const = default;
 
   template <typename H>
   friend H AbslHashValue(H h, const QueryCacheKey& key) {
-    return H::combine(std::move(h), key.key_, key.locatedTriplesSnapshotIndex_);
+    return H::combine(std::move(h), key.key_, key.lastModificationIndex_);
   }
 };
 
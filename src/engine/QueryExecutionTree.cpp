@@ -144,8 +144,7 @@ void QueryExecutionTree::readFromCache() {
     return;
   }
   auto& cache = qec_->getQueryTreeCache();
-  auto res = cache.getIfContained(
-      {getCacheKey(), qec_->locatedTriplesSnapshot().index_});
+  auto res = cache.getIfContained(rootOperation_->getQueryCacheKey());
   if (res.has_value()) {
     cachedResult_ = res->_resultPointer->resultTablePtr();
   }
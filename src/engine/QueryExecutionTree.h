@@ -228,6 +228,10 @@ class QueryExecutionTree {
     sizeEstimate_ = getRootOperation()->getSizeEstimate();
   }
 
+  // Recompute the cache key after the root operation was changed in a way that
+  // affects it (see `OrderBy::setLimitOffsetHint`).
+  void updateCacheKey() { cacheKey_ = getRootOperation()->getCacheKey(); }
+
  private:
   QueryExecutionContext* qec_;  // No ownership
   std::shared_ptr<Operation> rootOperation_ =
@@ -27,6 +27,7 @@
 #include "engine/Distinct.h"
 #include "engine/Filter.h"
 #include "engine/GroupBy.h"
+#include "engine/HashJoin.h"
 #include "engine/HasPredicateScan.h"
 #include "engine/IndexScan.h"
 #include "engine/Join.h"
@@ -215,8 +216,17 @@ std::vector<SubtreePlan> QueryPlanner::createExecutionTrees(ParsedQuery& pq,
     // supported by the `Operation`. Check the documentation of
     // `ExportQueryExecutionTrees::compensateForLimitOffsetClause to see `how
     // this is comphandled in the exporter.
-    if (plan._qet->getRootOperation()->supportsLimitOffset() && !isSubquery) {
+    if (isSubquery) {
+      continue;
+    }
+    auto root = plan._qet->getRootOperation();
+    if (root->supportsLimitOffset()) {
       plan._qet->applyLimit(pq._limitOffset);
+    } else if (auto orderBy = std::dynamic_pointer_cast<OrderBy>(root)) {
+      // The `OrderBy` only uses the LIMIT and OFFSET to compute fewer rows,
+      // they are still applied by the exporter.
+      orderBy->setLimitOffsetHint(pq._limitOffset);
+      plan._qet->updateCacheKey();
     }
   }
 
@@ -2232,6 +2242,12 @@ std::vector<SubtreePlan> QueryPlanner::createJoinCandidates(
     candidates.push_back(std::move(opt.value()));
   }
 
+  // If the inputs would have to be sorted for the `Join`, a `HashJoin` might
+  // be cheaper.
+  if (auto opt = createHashJoin(a, b, jcs)) {
+    candidates.push_back(std::move(opt.value()));
+  }
+
   // "NORMAL" CASE:
   // The join class takes care of sorting the subtrees if necessary
   SubtreePlan plan =
@@ -2445,6 +2461,32 @@ auto QueryPlanner::createJoinWithTransitivePath(const SubtreePlan& a,
   return plan;
 }
 
+// _____________________________________________________________________________
+auto QueryPlanner::createHashJoin(const SubtreePlan& a, const SubtreePlan& b,
+                                  const JoinColumns& jcs) const
+    -> std::optional<SubtreePlan> {
+  AD_CORRECTNESS_CHECK(jcs.size() == 1);
+  auto [aCol, bCol] = jcs[0];
+  auto isSortedOnJoinColumn = [](const SubtreePlan& plan, ColumnIndex col) {
+    auto sortedOn = plan._qet->resultSortedOn();
+    return !sortedOn.empty() && sortedOn[0] == col;
+  };
+  if (isSortedOnJoinColumn(a, aCol) && isSortedOnJoinColumn(b, bCol)) {
+    return std::nullopt;
+  }
+  if (std::max(a._qet->getSizeEstimate(), b._qet->getSizeEstimate()) <
+      RuntimeParameters().get<"hash-join-min-input-size">()) {
+    return std::nullopt;
+  }
+  if (!HashJoin::isApplicable(*a._qet, *b._qet, aCol, bCol)) {
+    return std::nullopt;
+  }
+  SubtreePlan plan =
+      makeSubtreePlan<HashJoin>(_qec, a._qet, b._qet, aCol, bCol);
+  mergeSubtreePlanIds(plan, a, b);
+  return plan;
+}
+
 // ______________________________________________________________________________________
 auto QueryPlanner::createJoinWithHasPredicateScan(const SubtreePlan& a,
                                                   const SubtreePlan& b,
@@ -411,6 +411,15 @@ class QueryPlanner {
   static std::optional<SubtreePlan> createJoinWithPathSearch(
       const SubtreePlan& a, const SubtreePlan& b, const JoinColumns& jcs);
 
+  // Used internally by `createJoinCandidates`. If `a` and `b` are joined on a
+  // single column that is always defined, at least one of them is not sorted
+  // on that column (so a `Join` would have to sort it), and one of them is
+  // sufficiently large (see the runtime parameter `hash-join-min-input-size`),
+  // then returns a `HashJoin` of `a` and `b`. Else returns `std::nullopt`.
+  std::optional<SubtreePlan> createHashJoin(const SubtreePlan& a,
+                                            const SubtreePlan& b,
+                                            const JoinColumns& jcs) const;
+
   // Helper that returns `true` for each of the subtree plans `a` and `b` iff
   // the subtree plan is a spatial join and it is not yet fully constructed
   // (it does not have both children set)
@@ -21,6 +21,11 @@ QueryPlanningCostFactors::QueryPlanningCostFactors() : _factors() {
   _factors["HASH_MAP_OPERATION_COST"] = 50.0;
   _factors["JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR"] = 0.7;
   _factors["DUMMY_JOIN_SIZE_ESTIMATE_CORRECTION_FACTOR"] = 0.7;
+  // The cost of a `HashJoin` per row of the build side (insertion into the
+  // hash table) and per row of the probe side (lookup in the hash table),
+  // relative to the cost of a merge join, which is one per row of each input.
+  _factors["HASH_JOIN_BUILD_COST"] = 10.0;
+  _factors["HASH_JOIN_PROBE_COST"] = 2.0;
 
   // Assume that a random disk seek is 100 times more expensive than an
   // average `O(1)` access to a single ID.
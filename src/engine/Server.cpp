@@ -23,6 +23,7 @@
 #include "engine/QueryPlanner.h"
 #include "engine/SPARQLProtocol.h"
 #include "global/RuntimeParameters.h"
+#include "index/DecompressedBlockCache.h"
 #include "index/IndexImpl.h"
 #include "parser/SparqlParser.h"
 #include "util/AsioHelpers.h"
@@ -345,11 +346,13 @@ CPP_template_def(typename RequestT, typename ResponseT)(
   } else if (auto cmd = checkParameter("cmd", "clear-cache")) {
     logCommand(cmd, "clear the cache (unpinned elements only)");
     cache_.clearUnpinnedOnly();
+    DecompressedBlockCache::get().clear();
     response = createJsonResponse(composeCacheStatsJson(), request);
   } else if (auto cmd = checkParameter("cmd", "clear-cache-complete")) {
     requireValidAccessToken("clear-cache-complete");
     logCommand(cmd, "clear cache completely (including unpinned elements)");
     cache_.clearAll();
+    DecompressedBlockCache::get().clear();
     response = createJsonResponse(composeCacheStatsJson(), request);
   } else if (auto cmd = checkParameter("cmd", "clear-delta-triples")) {
     requireValidAccessToken("clear-delta-triples");
@@ -372,6 +375,9 @@ CPP_template_def(typename RequestT, typename ResponseT)(
         },
         handle);
     auto countAfterClear = co_await std::move(coroutine);
+    // All the cached results are invalidated by the clearing, so they can be
+    // removed right away.
+    cache_.clearAll();
     response = createJsonResponse(nlohmann::json{countAfterClear}, request);
   } else if (auto cmd = checkParameter("cmd", "get-settings")) {
     logCommand(cmd, "get server settings");
@@ -646,6 +652,15 @@ nlohmann::json Server::composeCacheStatsJson() const {
   // converter.
   result["non-pinned-size"] = cache_.nonPinnedSize().getBytes();
   result["pinned-size"] = cache_.pinnedSize().getBytes();
+
+  // Statistics of the cache for decompressed blocks of the permutations.
+  auto blockCacheStats = DecompressedBlockCache::get().getStatistics();
+  result["decompressed-block-cache-num-entries"] = blockCacheStats.numEntries_;
+  result["decompressed-block-cache-size"] = blockCacheStats.size_.getBytes();
+  result["decompressed-block-cache-max-size"] =
+      blockCacheStats.maxSize_.getBytes();
+  result["decompressed-block-cache-hits"] = blockCacheStats.numHits_;
+  result["decompressed-block-cache-misses"] = blockCacheStats.numMisses_;
   return result;
 }
 
@@ -913,14 +928,20 @@ json Server::createResponseMetadataForUpdate(
   response["time"]["update"] = updateTime;
   response["time"]["total"] = formatTime(requestTimer.msecs());
   for (auto permutation : Permutation::ALL) {
+    const auto& locatedTriples =
+        deltaTriples.getLocatedTriplesForPermutation(permutation);
     response["located-triples"][Permutation::toString(
-        permutation)]["blocks-affected"] =
-        deltaTriples.getLocatedTriplesForPermutation(permutation).numBlocks();
-    auto numBlocks = index.getPimpl()
-                         .getPermutation(permutation)
-                         .metaData()
-                         .blockData()
-                         .size();
+        permutation)]["blocks-affected"] = locatedTriples.numBlocks();
+    // The blocks of the permutation change with each compaction of the delta
+    // triples (see `DeltaTriplesManager::compact`).
+    auto numBlocks =
+        locatedTriples.hasOriginalMetadata()
+            ? locatedTriples.getOriginalMetadata()->size()
+            : index.getPimpl()
+                  .getPermutation(permutation)
+                  .metaData()
+                  .blockData()
+                  .size();
     response["located-triples"][Permutation::toString(permutation)]
             ["blocks-total"] = numBlocks;
   }
@@ -930,30 +951,75 @@ json Server::createResponseMetadataForUpdate(
 json Server::processUpdateImpl(
     const PlannedQuery& plannedUpdate, const ad_utility::Timer& requestTimer,
     ad_utility::SharedCancellationHandle cancellationHandle,
-    DeltaTriples& deltaTriples) {
+    DeltaTriplesManager& deltaTriplesManager) {
   const auto& qet = plannedUpdate.queryExecutionTree_;
   AD_CORRECTNESS_CHECK(plannedUpdate.parsedQuery_.hasUpdateClause());
 
-  DeltaTriplesCount countBefore = deltaTriples.getCounts();
-  UpdateMetadata updateMetadata =
-      ExecuteUpdate::executeUpdate(index_, plannedUpdate.parsedQuery_, qet,
-                                   deltaTriples, cancellationHandle);
-  DeltaTriplesCount countAfter = deltaTriples.getCounts();
+  // Create the response after the update has been applied to the
+  // `deltaTriples` (while still holding the lock).
+  auto finishUpdate = [this, &requestTimer, &plannedUpdate, &qet](
+                          const DeltaTriples& deltaTriples,
+                          const DeltaTriplesCount& countBefore,
+                          const UpdateMetadata& updateMetadata) {
+    DeltaTriplesCount countAfter = deltaTriples.getCounts();
 
-  LOG(INFO) << "Done processing update"
-            << ", total time was " << requestTimer.msecs().count() << " ms"
-            << std::endl;
-  LOG(DEBUG) << "Runtime Info:\n"
-             << qet.getRootOperation()->runtimeInfo().toString() << std::endl;
+    LOG(INFO) << "Done processing update"
+              << ", total time was " << requestTimer.msecs().count() << " ms"
+              << std::endl;
+    LOG(DEBUG) << "Runtime Info:\n"
+               << qet.getRootOperation()->runtimeInfo().toString()
+               << std::endl;
+
+    // The cache is not cleared: The cache key of a result contains the index
+    // of the last snapshot that modified the triples it depends on (see
+    // `QueryCacheKey`), so only the results that are affected by the update
+    // are invalidated.
+
+    return createResponseMetadataForUpdate(requestTimer, index_, deltaTriples,
+                                           plannedUpdate, qet, countBefore,
+                                           updateMetadata, countAfter);
+  };
 
-  // Clear the cache, because all cache entries have been invalidated by
-  // the update anyway (The index of the located triples snapshot is
-  // part of the cache key).
-  cache_.clearAll();
+  // For a WHERE clause with a large result, neither the result nor all the
+  // triples to delete and insert are materialized. The update is then applied
+  // in batches, which only become visible when all of them have been applied
+  // (and are rolled back if the update fails or is cancelled). The WHERE
+  // clause is not affected by the batches, because it uses the snapshot from
+  // when the update was planned.
+  const size_t batchSize =
+      RuntimeParameters().get<"update-streaming-batch-size">();
+  if (batchSize > 0 &&
+      qet.getRootOperation()->getSizeEstimate() > batchSize) {
+    DeltaTriplesManager::BatchedModification modification{deltaTriplesManager,
+                                                          allocator_};
+    auto updateMetadata = ExecuteUpdate::executeUpdateStreaming(
+        index_, plannedUpdate.parsedQuery_, qet, modification,
+        cancellationHandle, batchSize);
+    return modification.commit<nlohmann::json>(
+        [&finishUpdate, &modification,
+         &updateMetadata](DeltaTriples& deltaTriples) {
+          return finishUpdate(deltaTriples, modification.countsBefore(),
+                              updateMetadata);
+        });
+  }
 
-  return createResponseMetadataForUpdate(requestTimer, index_, deltaTriples,
-                                         plannedUpdate, qet, countBefore,
-                                         updateMetadata, countAfter);
+  // Evaluate the WHERE clause and locate the triples without holding the lock
+  // for the delta triples, see `DeltaTriplesManager::stageUpdate`.
+  DeltaTriples::StagedUpdate stagedUpdate;
+  UpdateMetadata updateMetadata;
+  std::tie(stagedUpdate, updateMetadata) =
+      ExecuteUpdate::stageUpdate(index_, plannedUpdate.parsedQuery_, qet,
+                                 deltaTriplesManager, cancellationHandle);
+
+  // Apply the update while holding the lock.
+  return deltaTriplesManager.modify<nlohmann::json>(
+      [&finishUpdate, &cancellationHandle, &stagedUpdate,
+       &updateMetadata](DeltaTriples& deltaTriples) {
+        DeltaTriplesCount countBefore = deltaTriples.getCounts();
+        ExecuteUpdate::applyStagedUpdate(deltaTriples, std::move(stagedUpdate),
+                                         updateMetadata, cancellationHandle);
+        return finishUpdate(deltaTriples, countBefore, updateMetadata);
+      });
 }
 
 // ____________________________________________________________________________
@@ -981,21 +1047,15 @@ CPP_template_def(typename RequestT, typename ResponseT)(
           plannedUpdate = planQuery(std::move(update), requestTimer, timeLimit,
                                     qec, cancellationHandle);
           // TODO<qup42>: optimize the case of chained updates
-          // As we have an exclusive lock on the DeltaTriples we the
-          // execution could happen directly against the DeltaTriples
+          // As the updates are executed sequentially, the execution could
+          // happen directly against the DeltaTriples
           // instead of the snapshot that has to be refreshed after each
           // step.
           qec.updateLocatedTriplesSnapshot();
           // Update the delta triples.
-          results.push_back(index_.deltaTriplesManager().modify<nlohmann::json>(
-              [this, &requestTimer, &cancellationHandle,
-               &plannedUpdate](auto& deltaTriples) {
-                // Use `this` explicitly to silence false-positive
-                // errors on captured `this` being unused.
-                return this->processUpdateImpl(plannedUpdate.value(),
-                                               requestTimer, cancellationHandle,
-                                               deltaTriples);
-              }));
+          results.push_back(processUpdateImpl(plannedUpdate.value(),
+                                              requestTimer, cancellationHandle,
+                                              index_.deltaTriplesManager()));
         }
         return results;
       },
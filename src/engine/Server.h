@@ -221,12 +221,16 @@ class Server {
       ad_utility::websocket::MessageSender createMessageSender(
           const std::weak_ptr<ad_utility::websocket::QueryHub>& queryHub,
           const RequestT& request, std::string_view operation);
-  // Execute an update operation. The function must have exclusive access to the
-  // DeltaTriples object.
+  FRIEND_TEST(ServerTest, cachedResultsSurviveUnrelatedUpdates);
+  // Execute an update operation. Only the application of the update to the
+  // delta triples holds the lock for them (see `ExecuteUpdate::stageUpdate`).
+  // If the WHERE clause has a large result, the update is streamed and the
+  // lock is only held while each of its batches is applied (see
+  // `ExecuteUpdate::executeUpdateStreaming`).
   json processUpdateImpl(
       const PlannedQuery& plannedUpdate, const ad_utility::Timer& requestTimer,
       ad_utility::SharedCancellationHandle cancellationHandle,
-      DeltaTriples& deltaTriples);
+      DeltaTriplesManager& deltaTriplesManager);
 
   static json composeErrorResponseJson(
       const string& query, const std::string& errorMsg,
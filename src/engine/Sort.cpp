@@ -9,6 +9,7 @@
 
 #include "engine/CallFixedSize.h"
 #include "engine/Engine.h"
+#include "engine/ExternalSort.h"
 #include "engine/QueryExecutionTree.h"
 #include "global/RuntimeParameters.h"
 
@@ -51,28 +52,49 @@ std::string Sort::getDescriptor() const {
 }
 
 // _____________________________________________________________________________
-Result Sort::computeResult([[maybe_unused]] bool requestLaziness) {
+Result Sort::computeResult(bool requestLaziness) {
   using std::endl;
   LOG(DEBUG) << "Getting sub-result for Sort result computation..." << endl;
-  std::shared_ptr<const Result> subRes = subtree_->getResult();
-
-  // TODO<joka921> proper timeout for sorting operations
-  const auto& subTable = subRes->idTable();
-  getExecutionContext()->getSortPerformanceEstimator().throwIfEstimateTooLong(
-      subTable.numRows(), subTable.numColumns(), deadline_, "Sort operation");
-
-  LOG(DEBUG) << "Sort result computation..." << endl;
-  ad_utility::Timer t{ad_utility::timer::Timer::InitialStatus::Started};
-  IdTable idTable = subRes->idTable().clone();
-  runtimeInfo().addDetail("time-cloning", t.msecs());
-  Engine::sort(idTable, sortColumnIndices_);
-
-  // Don't report missed timeout check because sort is not cancellable
-  cancellationHandle_->resetWatchDogState();
-  checkCancellation();
-
+  // Only request a lazy sub-result if it might be too large to be sorted in
+  // RAM, because collecting the blocks of a lazy result has some overhead.
+  std::shared_ptr<const Result> subRes =
+      subtree_->getResult(qlever::externalSort::exceedsInMemoryThreshold(
+          subtree_->getSizeEstimate(), getResultWidth()));
+
+  auto sortInMemory = [this](IdTable& idTable) {
+    // TODO<joka921> proper timeout for sorting operations
+    getExecutionContext()
+        ->getSortPerformanceEstimator()
+        .throwIfEstimateTooLong(idTable.numRows(), idTable.numColumns(),
+                                deadline_, "Sort operation");
+    LOG(DEBUG) << "Sort result computation..." << endl;
+    Engine::sort(idTable, sortColumnIndices_);
+
+    // Don't report missed timeout check because sort is not cancellable
+    cancellationHandle_->resetWatchDogState();
+    checkCancellation();
+  };
+  // The sorter for the external sort compares the rows by the internal order
+  // of the `sortColumnIndices_`, just like `Engine::sort`.
+  auto makeSorter = [this]() {
+    auto comparison = [sortColumns = sortColumnIndices_](const auto& row1,
+                                                         const auto& row2) {
+      for (auto col : sortColumns) {
+        if (row1[col] != row2[col]) {
+          return row1[col] < row2[col];
+        }
+      }
+      return false;
+    };
+    return qlever::externalSort::makeSorter(
+        *getExecutionContext(), getResultWidth(), std::move(comparison));
+  };
+  auto result = qlever::externalSort::sortResult(
+      std::move(subRes), getResultWidth(), resultSortedOn(), sortInMemory,
+      makeSorter, requestLaziness, allocator(), cancellationHandle_,
+      runtimeInfo());
   LOG(DEBUG) << "Sort result computation done." << endl;
-  return {std::move(idTable), resultSortedOn(), subRes->getSharedLocalVocab()};
+  return result;
 }
 
 // _____________________________________________________________________________
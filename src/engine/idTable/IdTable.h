@@ -590,6 +590,17 @@ class IdTable {
         std::move(viewSpans), numColumns_, numRows_, allocator_};
   }
 
+  // Create a dynamic and const view of the given `columns`, which all must have
+  // `numRows` elements. The view is only valid as long as the memory of the
+  // `columns` is valid and unchanged. This is used for columns that are
+  // directly taken from a memory-mapped file.
+  CPP_template(typename = void)(requires(isView && isDynamic)) static IdTable
+      fromColumnSpans(ViewSpans columns, size_t numRows, Allocator allocator) {
+    auto numColumns = columns.size();
+    return IdTable{std::move(columns), numColumns, numRows,
+                   std::move(allocator)};
+  }
+
   // Obtain a dynamic and const view to this IdTable that contains a subset of
   // the columns that may be permuted. The subset of the columns is specified by
   // the argument `columnIndices`.
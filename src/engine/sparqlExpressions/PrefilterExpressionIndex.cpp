@@ -400,6 +400,50 @@ std::vector<CompressedBlockMetadata> PrefilterExpression::evaluate(
   return result;
 };
 
+//______________________________________________________________________________
+std::vector<CompressedBlockMetadata> PrefilterExpression::evaluateWithZoneMaps(
+    const Vocab& vocab, BlockMetadataSpan blockRange,
+    size_t evaluationColumn) const {
+  AD_CONTRACT_CHECK(evaluationColumn <
+                    CompressedBlockMetadata::numColumnsWithZoneMaps);
+  std::vector<CompressedBlockMetadata> result;
+  // For each block, the `DatatypeRange`s of its zone map are converted to
+  // pseudo blocks (one per range), the first and last triple of which contain
+  // the `min_` and `max_` of the range. These pseudo blocks are sorted and
+  // don't contain mixed datatypes, so they can be evaluated with the usual
+  // `evaluateImpl`. The block is relevant iff at least one of its pseudo
+  // blocks is relevant.
+  std::vector<CompressedBlockMetadata> pseudoBlocks;
+  AccessValueIdFromBlockMetadata accessValueIdOp(evaluationColumn);
+  auto setId = [evaluationColumn](
+                   CompressedBlockMetadata::PermutedTriple& triple, Id id) {
+    auto& target = evaluationColumn == 0   ? triple.col0Id_
+                   : evaluationColumn == 1 ? triple.col1Id_
+                                           : triple.col2Id_;
+    target = id;
+  };
+  for (const auto& block : blockRange) {
+    if (block.zoneMaps_.empty()) {
+      result.push_back(block);
+      continue;
+    }
+    const auto& zoneMap = block.zoneMaps_.at(evaluationColumn);
+    pseudoBlocks.resize(zoneMap.size());
+    for (size_t i = 0; i < zoneMap.size(); ++i) {
+      setId(pseudoBlocks[i].firstTriple_, zoneMap[i].min_);
+      setId(pseudoBlocks[i].lastTriple_, zoneMap[i].max_);
+    }
+    BlockMetadataSpan pseudoSpan{pseudoBlocks};
+    ValueIdSubrange idRange{
+        ValueIdIt{&pseudoSpan, 0, accessValueIdOp},
+        ValueIdIt{&pseudoSpan, pseudoSpan.size() * 2, accessValueIdOp}};
+    if (!evaluateImpl(vocab, idRange, pseudoSpan, false).empty()) {
+      result.push_back(block);
+    }
+  }
+  return result;
+}
+
 //______________________________________________________________________________
 ValueId PrefilterExpression::getValueIdFromIdOrLocalVocabEntry(
     const IdOrLocalVocabEntry& referenceValue, LocalVocab& vocab) {
@@ -138,6 +138,16 @@ class PrefilterExpression {
                                                 BlockMetadataSpan blockRange,
                                                 size_t evaluationColumn) const;
 
+  // Return the blocks from `blockRange` that might contain values for which
+  // this expression is true in the column `evaluationColumn`, using the zone
+  // maps of the blocks (see `CompressedBlockMetadata::zoneMaps_`). In contrast
+  // to `evaluate`, the `evaluationColumn` doesn't have to be sorted, and
+  // blocks with mixed datatypes can also be pruned. Blocks without zone maps
+  // are always kept.
+  std::vector<CompressedBlockMetadata> evaluateWithZoneMaps(
+      const Vocab& vocab, BlockMetadataSpan blockRange,
+      size_t evaluationColumn) const;
+
   // `evaluateImpl` is internally used for the actual pre-filter procedure.
   // `ValueIdSubrange idRange` enables indirect access to all `ValueId`s at
   // column index `evaluationColumn` over the containerized `ql::span<const
@@ -83,6 +83,58 @@ inline auto& RuntimeParameters() {
         // false,
         // the result will be `NaN` or `infinity` respectively.
         Bool<"division-by-zero-is-undef">{true},
+        // The maximum size of the cache for decompressed blocks of the
+        // permutations, which is shared between all queries (see
+        // `DecompressedBlockCache`). A value of zero disables this cache.
+        MemorySizeParameter<"decompressed-block-cache-max-size">{1_GB},
+        // If set to `true`, an index scan that is joined with a fully
+        // materialized input first only reads the join column of each block
+        // and reads the remaining columns only for blocks with at least one
+        // join partner ("late materialization").
+        Bool<"lazy-index-scan-late-materialization">{true},
+        // The number of consecutive blocks that each worker thread of a lazy
+        // index scan reads with a single batch of I/O requests (see
+        // `AsyncFileReader`). Note that the `lazy-index-scan-queue-size` then
+        // refers to the number of such batches.
+        SizeT<"lazy-index-scan-blocks-per-batch">{4},
+        // The number of threads that an index scan which is fully materialized
+        // (and has no LIMIT or OFFSET) uses to read and decompress the columns
+        // of its blocks in parallel.
+        SizeT<"materialized-index-scan-num-threads">{10},
+        // When the number of delta triples has grown by at least this many
+        // triples since the last compaction, the delta triples are folded into
+        // the permutations in the background (see
+        // `DeltaTriplesManager::compact`). A value of zero disables the
+        // automatic compaction.
+        SizeT<"delta-triples-compaction-threshold">{0},
+        // If the estimated size of the result of the WHERE clause of an update
+        // is larger than this number of rows, the update is executed in
+        // batches of this many rows, without materializing the complete result
+        // and all the triples to delete and insert (see
+        // `ExecuteUpdate::executeUpdateStreaming`). A value of zero disables
+        // this streaming mode.
+        SizeT<"update-streaming-batch-size">{1'000'000},
+        // The query planner only considers a `HashJoin` (instead of sorting
+        // the inputs of a `Join`) if the size estimate of the larger input is
+        // at least this number of rows. The `HashJoin` then competes with the
+        // `Join` via the cost estimates.
+        SizeT<"hash-join-min-input-size">{100'000},
+        // The number of threads that a `HashJoin` uses to build its hash table
+        // and to probe it.
+        SizeT<"hash-join-num-threads">{10},
+        // If the result of the child of a `Sort` or `OrderBy` operation is
+        // larger than this, it is not sorted in RAM, but externally in sorted
+        // runs that are written to disk and then merged (see
+        // `ExternalSort.h`). This is also the amount of memory that such an
+        // external sort uses.
+        MemorySizeParameter<"sort-in-memory-threshold">{1_GB},
+        // An `OrderBy` with a LIMIT computes only the first rows of its result
+        // (in a single pass over its input and with bounded memory) if the
+        // LIMIT plus the OFFSET is at most this number.
+        SizeT<"order-by-top-k-max-size">{10'000},
+        // The number of threads that an `OrderBy` with a small LIMIT uses to
+        // compute the first rows of its result.
+        SizeT<"order-by-top-k-num-threads">{10},
     };
   }();
   return params;
@@ -0,0 +1,73 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "index/BlockMetadataSearchIndex.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "util/Exception.h"
+
+// _____________________________________________________________________________
+BlockMetadataSearchIndex::BlockMetadataSearchIndex(BlockMetadataSpan blocks)
+    : firstTriples_(blocks.size() + 1),
+      lastTriples_(blocks.size() + 1),
+      positions_(blocks.size() + 1),
+      nodes_(blocks.size()) {
+  // Fill the tree via an in-order traversal, which visits the nodes in the
+  // sorted order of the blocks.
+  size_t position = 0;
+  auto fill = [this, &blocks, &position](auto& self, size_t node) -> void {
+    if (node > blocks.size()) {
+      return;
+    }
+    self(self, 2 * node);
+    firstTriples_[node] = blocks[position].firstTriple_;
+    lastTriples_[node] = blocks[position].lastTriple_;
+    positions_[node] = position;
+    nodes_[position] = node;
+    ++position;
+    self(self, 2 * node + 1);
+  };
+  fill(fill, 1);
+  AD_CORRECTNESS_CHECK(position == blocks.size());
+}
+
+// _____________________________________________________________________________
+void BlockMetadataSearchIndex::updateBlock(
+    size_t position, const CompressedBlockMetadata& block) {
+  AD_CONTRACT_CHECK(position < size());
+  size_t node = nodes_[position];
+  firstTriples_[node] = block.firstTriple_;
+  lastTriples_[node] = block.lastTriple_;
+}
+
+// _____________________________________________________________________________
+template <typename Pred>
+size_t BlockMetadataSearchIndex::partitionPoint(
+    const std::vector<PermutedTriple>& tree, const Pred& pred) const {
+  // Descend to the right iff `pred` holds for the current node. The search
+  // ends at a (nonexistent) node below a leaf.
+  size_t node = 1;
+  while (node < tree.size()) {
+    node = 2 * node + static_cast<size_t>(pred(tree[node]));
+  }
+  // The result is the node where we last descended to the left. The right
+  // turns after it are the trailing ones in the binary representation of
+  // `node`, and the left turn is the zero before them. If we never descended
+  // to the left, `pred` holds for all the blocks.
+  node >>= std::countr_one(node) + 1;
+  return node == 0 ? size() : positions_[node];
+}
+
+// _____________________________________________________________________________
+std::pair<size_t, size_t> BlockMetadataSearchIndex::equalRange(
+    const PermutedTriple& firstTriple, const PermutedTriple& lastTriple) const {
+  size_t begin = partitionPoint(lastTriples_, [&firstTriple](const auto& t) {
+    return t < firstTriple;
+  });
+  size_t end = partitionPoint(firstTriples_, [&lastTriple](const auto& t) {
+    return !(lastTriple < t);
+  });
+  return {begin, std::max(begin, end)};
+}
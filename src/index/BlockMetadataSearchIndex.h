@@ -0,0 +1,75 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_INDEX_BLOCKMETADATASEARCHINDEX_H
+#define QLEVER_SRC_INDEX_BLOCKMETADATASEARCHINDEX_H
+
+#include <utility>
+#include <vector>
+
+#include "index/CompressedRelation.h"
+
+// A compact search structure over the block boundaries (the first and the last
+// triple of each block) of a permutation. A binary search on the
+// `CompressedBlockMetadata` directly touches a different cache line (and often
+// a different page) in each step, because each entry is large and also owns
+// heap memory (offsets, graph info, zone maps, Bloom filters). This class
+// instead stores only the boundary triples in the Eytzinger layout (the nodes
+// of an implicit binary search tree in breadth-first order), where the first
+// levels of the search share a few cache lines that typically stay in the
+// cache across many searches.
+//
+// The index does not refer to the blocks from which it was built, it only
+// returns positions. It therefore stays valid for copies of these blocks.
+class BlockMetadataSearchIndex {
+ public:
+  using PermutedTriple = CompressedBlockMetadata::PermutedTriple;
+
+ private:
+  // The boundary triples in the Eytzinger layout. The root of the tree is at
+  // index 1, the children of the node at index `k` are at `2k` and `2k + 1`.
+  // Index 0 is unused.
+  std::vector<PermutedTriple> firstTriples_;
+  std::vector<PermutedTriple> lastTriples_;
+  // For each node of the tree, the position of the corresponding block in the
+  // original (sorted) order.
+  std::vector<size_t> positions_;
+  // The inverse of `positions_`: for each block, its node in the tree.
+  std::vector<size_t> nodes_;
+
+ public:
+  // Create an index for zero blocks.
+  BlockMetadataSearchIndex() : BlockMetadataSearchIndex(BlockMetadataSpan{}) {}
+
+  // Create an index for the given `blocks`, which must be sorted.
+  explicit BlockMetadataSearchIndex(BlockMetadataSpan blocks);
+
+  // The number of blocks from which the index was built.
+  size_t size() const { return positions_.size() - 1; }
+
+  // Return the half-open range `[begin, end)` of the positions of the blocks
+  // that possibly contain triples in the range `[firstTriple, lastTriple]`.
+  // This is the same range as the one returned by `ql::ranges::equal_range`
+  // with the comparator "the last triple of the first argument is smaller than
+  // the first triple of the second argument", but much faster for a large
+  // number of blocks.
+  std::pair<size_t, size_t> equalRange(const PermutedTriple& firstTriple,
+                                       const PermutedTriple& lastTriple) const;
+
+  // Replace the boundaries of the block at the given `position` by those of
+  // `block`. The blocks must still be sorted afterwards. This is much cheaper
+  // than building a new index when only a few blocks change (for example,
+  // when the block boundaries are widened for the located triples of an
+  // update).
+  void updateBlock(size_t position, const CompressedBlockMetadata& block);
+
+ private:
+  // Return the position of the first block for which `pred` returns `false`
+  // for its entry in `tree`, assuming that the blocks are partitioned by
+  // `pred`.
+  template <typename Pred>
+  size_t partitionPoint(const std::vector<PermutedTriple>& tree,
+                        const Pred& pred) const;
+};
+
+#endif  // QLEVER_SRC_INDEX_BLOCKMETADATASEARCHINDEX_H
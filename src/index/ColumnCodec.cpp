@@ -0,0 +1,363 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "index/ColumnCodec.h"
+
+#include <absl/numeric/bits.h>
+
+#include <cstring>
+
+#include "backports/algorithm.h"
+#include "util/CompressionUsingZstd/ZstdWrapper.h"
+#include "util/Exception.h"
+#include "util/Simple8bCode.h"
+
+// _____________________________________________________________________________
+std::string_view toString(ColumnCodec codec) {
+  switch (codec) {
+    case ColumnCodec::Zstd:
+      return "zstd";
+    case ColumnCodec::RunLength:
+      return "run-length";
+    case ColumnCodec::FrameOfReference:
+      return "frame-of-reference";
+    case ColumnCodec::DeltaBitPacked:
+      return "delta-bit-packed";
+    case ColumnCodec::Simple8bDelta:
+      return "simple8b-delta";
+    case ColumnCodec::Uncompressed:
+      return "uncompressed";
+  }
+  AD_FAIL();
+}
+
+namespace {
+using Words = std::vector<uint64_t>;
+
+// Convert the `words` to the byte representation that is written to disk.
+std::vector<char> wordsToBytes(const Words& words) {
+  std::vector<char> result(words.size() * sizeof(uint64_t));
+  std::memcpy(result.data(), words.data(), result.size());
+  return result;
+}
+
+// Read the `i`-th 64-bit word from the `bytes`. The `memcpy` is necessary
+// because the `bytes` are not necessarily aligned, it is compiled to a simple
+// load instruction.
+uint64_t readWord(const char* bytes, size_t i) {
+  uint64_t result;
+  std::memcpy(&result, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+  return result;
+}
+
+// Return the number of 64-bit words in the `bytes` and check that the size of
+// the `bytes` is a multiple of 8 and at least `minNumWords`.
+size_t numWords(ql::span<const char> bytes, size_t minNumWords) {
+  AD_CORRECTNESS_CHECK(bytes.size() % sizeof(uint64_t) == 0);
+  size_t result = bytes.size() / sizeof(uint64_t);
+  AD_CORRECTNESS_CHECK(result >= minNumWords);
+  return result;
+}
+
+// The number of words needed to bit-pack `numValues` values with `bitWidth`
+// bits each. This includes one additional padding word, s.t. the decoder can
+// always read the word after the current one without a branch.
+size_t numPackedWords(size_t numValues, size_t bitWidth) {
+  return (numValues * bitWidth + 63) / 64 + 1;
+}
+
+// Append the `values` to the `words`, bit-packed with `bitWidth` bits each.
+// The `bitWidth` must be large enough for all the `values`.
+void appendBitPacked(const Words& values, size_t bitWidth, Words& words) {
+  size_t offset = words.size();
+  words.resize(offset + numPackedWords(values.size(), bitWidth), 0);
+  if (bitWidth == 0) {
+    return;
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    size_t bitPos = i * bitWidth;
+    size_t wordIdx = offset + bitPos / 64;
+    size_t shift = bitPos % 64;
+    words[wordIdx] |= values[i] << shift;
+    if (shift + bitWidth > 64) {
+      words[wordIdx + 1] |= values[i] >> (64 - shift);
+    }
+  }
+}
+
+// Unpack `numValues` values with `bitWidth` bits each from the `words` (which
+// start at the given byte pointer) and call `storeValue(i, value)` for each of
+// them. The loop is branch-free (the padding word that is written by
+// `appendBitPacked` makes the read of `wordIdx + 1` always safe) and can
+// therefore be vectorized by the compiler.
+template <typename F>
+void unpackBitPacked(const char* words, size_t numValues, size_t bitWidth,
+                     F storeValue) {
+  if (bitWidth == 0) {
+    for (size_t i = 0; i < numValues; ++i) {
+      storeValue(i, uint64_t{0});
+    }
+    return;
+  }
+  const uint64_t mask =
+      bitWidth == 64 ? ~uint64_t{0} : (uint64_t{1} << bitWidth) - 1;
+  for (size_t i = 0; i < numValues; ++i) {
+    size_t bitPos = i * bitWidth;
+    size_t wordIdx = bitPos / 64;
+    size_t shift = bitPos % 64;
+    uint64_t low = readWord(words, wordIdx) >> shift;
+    // Equivalent to `<< (64 - shift)`, but also well-defined (and zero) for
+    // `shift == 0`.
+    uint64_t high = (readWord(words, wordIdx + 1) << 1) << (63 - shift);
+    storeValue(i, (low | high) & mask);
+  }
+}
+
+// Return the bits of the `Id`s in the `column`.
+Words getBits(ql::span<const Id> column) {
+  Words result;
+  result.reserve(column.size());
+  for (Id id : column) {
+    result.push_back(id.getBits());
+  }
+  return result;
+}
+
+// Return the (wrapping) differences between all consecutive `values`. The
+// result has one element less than the `values`.
+Words getDeltas(const Words& values) {
+  Words deltas;
+  if (values.empty()) {
+    return deltas;
+  }
+  deltas.reserve(values.size() - 1);
+  for (size_t i = 1; i < values.size(); ++i) {
+    deltas.push_back(values[i] - values[i - 1]);
+  }
+  return deltas;
+}
+
+// Return the number of bits that are needed to store the largest of the
+// `values`.
+size_t maxBitWidth(const Words& values) {
+  uint64_t max = values.empty() ? 0 : ql::ranges::max(values);
+  return absl::bit_width(max);
+}
+
+// The `target` contains the deltas between consecutive values at the indices
+// `1, 2, ...`. Replace them by the actual values, where the first value is
+// `first`.
+void prefixSum(uint64_t first, ql::span<Id> target) {
+  if (target.empty()) {
+    return;
+  }
+  uint64_t current = first;
+  target[0] = Id::fromBits(current);
+  for (size_t i = 1; i < target.size(); ++i) {
+    current += target[i].getBits();
+    target[i] = Id::fromBits(current);
+  }
+}
+
+// _____________________________________________________________________________
+std::vector<char> compressRunLength(const Words& values) {
+  // Layout: numRuns, followed by `numRuns` pairs of (value, length).
+  Words words{0};
+  for (size_t i = 0; i < values.size();) {
+    size_t j = i + 1;
+    while (j < values.size() && values[j] == values[i]) {
+      ++j;
+    }
+    words.push_back(values[i]);
+    words.push_back(j - i);
+    ++words[0];
+    i = j;
+  }
+  return wordsToBytes(words);
+}
+
+void decompressRunLength(ql::span<const char> bytes, ql::span<Id> target) {
+  size_t numTotalWords = numWords(bytes, 1);
+  uint64_t numRuns = readWord(bytes.data(), 0);
+  AD_CORRECTNESS_CHECK(numTotalWords == 1 + 2 * numRuns);
+  size_t pos = 0;
+  for (size_t run = 0; run < numRuns; ++run) {
+    Id value = Id::fromBits(readWord(bytes.data(), 1 + 2 * run));
+    size_t length = readWord(bytes.data(), 2 + 2 * run);
+    AD_CORRECTNESS_CHECK(pos + length <= target.size());
+    std::fill_n(target.begin() + pos, length, value);
+    pos += length;
+  }
+  AD_CORRECTNESS_CHECK(pos == target.size());
+}
+
+// _____________________________________________________________________________
+std::vector<char> compressFrameOfReference(Words values) {
+  // Layout: min, bitWidth, the bit-packed `value - min` for all values.
+  uint64_t min = values.empty() ? 0 : ql::ranges::min(values);
+  for (auto& value : values) {
+    value -= min;
+  }
+  size_t bitWidth = maxBitWidth(values);
+  Words words{min, bitWidth};
+  appendBitPacked(values, bitWidth, words);
+  return wordsToBytes(words);
+}
+
+void decompressFrameOfReference(ql::span<const char> bytes,
+                                ql::span<Id> target) {
+  size_t numTotalWords = numWords(bytes, 2);
+  uint64_t min = readWord(bytes.data(), 0);
+  size_t bitWidth = readWord(bytes.data(), 1);
+  AD_CORRECTNESS_CHECK(bitWidth <= 64);
+  AD_CORRECTNESS_CHECK(numTotalWords ==
+                       2 + numPackedWords(target.size(), bitWidth));
+  unpackBitPacked(bytes.data() + 2 * sizeof(uint64_t), target.size(), bitWidth,
+                  [min, target](size_t i, uint64_t value) {
+                    target[i] = Id::fromBits(min + value);
+                  });
+}
+
+// _____________________________________________________________________________
+std::vector<char> compressDeltaBitPacked(const Words& values) {
+  // Layout: first value, bitWidth, the bit-packed deltas.
+  auto deltas = getDeltas(values);
+  size_t bitWidth = maxBitWidth(deltas);
+  Words words{values.empty() ? 0 : values.front(), bitWidth};
+  appendBitPacked(deltas, bitWidth, words);
+  return wordsToBytes(words);
+}
+
+void decompressDeltaBitPacked(ql::span<const char> bytes,
+                              ql::span<Id> target) {
+  size_t numTotalWords = numWords(bytes, 2);
+  uint64_t first = readWord(bytes.data(), 0);
+  size_t bitWidth = readWord(bytes.data(), 1);
+  AD_CORRECTNESS_CHECK(bitWidth <= 64);
+  size_t numDeltas = target.empty() ? 0 : target.size() - 1;
+  AD_CORRECTNESS_CHECK(numTotalWords ==
+                       2 + numPackedWords(numDeltas, bitWidth));
+  // First unpack the deltas into the `target` (this loop is vectorized), then
+  // compute the prefix sums in place.
+  unpackBitPacked(bytes.data() + 2 * sizeof(uint64_t), numDeltas, bitWidth,
+                  [target](size_t i, uint64_t delta) {
+                    target[i + 1] = Id::fromBits(delta);
+                  });
+  prefixSum(first, target);
+}
+
+// _____________________________________________________________________________
+std::optional<std::vector<char>> compressSimple8bDelta(const Words& values) {
+  // Layout: first value, the `Simple8bCode` of the deltas.
+  auto deltas = getDeltas(values);
+  static constexpr uint64_t maxSimple8bValue = (uint64_t{1} << 60) - 1;
+  if (ql::ranges::any_of(deltas, [](uint64_t delta) {
+        return delta > maxSimple8bValue;
+      })) {
+    return std::nullopt;
+  }
+  // Each codeword encodes at least one value.
+  Words words(1 + deltas.size());
+  words[0] = values.empty() ? 0 : values.front();
+  size_t numBytes = ad_utility::Simple8bCode::encode(
+      deltas.data(), deltas.size(), words.data() + 1);
+  words.resize(1 + numBytes / sizeof(uint64_t));
+  return wordsToBytes(words);
+}
+
+void decompressSimple8bDelta(ql::span<const char> bytes, ql::span<Id> target) {
+  size_t numTotalWords = numWords(bytes, 1);
+  uint64_t first = readWord(bytes.data(), 0);
+  size_t numDeltas = target.empty() ? 0 : target.size() - 1;
+  // The `Simple8bCode` needs aligned and mutable input, and may write up to
+  // 239 values past the end of its output.
+  Words encoded(numTotalWords - 1);
+  std::memcpy(encoded.data(), bytes.data() + sizeof(uint64_t),
+              encoded.size() * sizeof(uint64_t));
+  Words deltas(numDeltas + 239);
+  if (numDeltas > 0) {
+    AD_CORRECTNESS_CHECK(!encoded.empty());
+    ad_utility::Simple8bCode::decode(encoded.data(), numDeltas, deltas.data());
+  }
+  for (size_t i = 0; i < numDeltas; ++i) {
+    target[i + 1] = Id::fromBits(deltas[i]);
+  }
+  prefixSum(first, target);
+}
+}  // namespace
+
+namespace columnCodec {
+// _____________________________________________________________________________
+std::optional<std::vector<char>> compress(ql::span<const Id> column,
+                                          ColumnCodec codec) {
+  switch (codec) {
+    case ColumnCodec::Zstd:
+      return ZstdWrapper::compress(column.data(), column.size() * sizeof(Id));
+    case ColumnCodec::RunLength:
+      return compressRunLength(getBits(column));
+    case ColumnCodec::FrameOfReference:
+      return compressFrameOfReference(getBits(column));
+    case ColumnCodec::DeltaBitPacked:
+      return compressDeltaBitPacked(getBits(column));
+    case ColumnCodec::Simple8bDelta:
+      return compressSimple8bDelta(getBits(column));
+    case ColumnCodec::Uncompressed:
+      return wordsToBytes(getBits(column));
+  }
+  AD_FAIL();
+}
+
+// _____________________________________________________________________________
+CompressedColumn compressWithBestCodec(ql::span<const Id> column) {
+  std::optional<CompressedColumn> bestLightweight;
+  std::optional<CompressedColumn> zstd;
+  for (ColumnCodec codec : allCodecs) {
+    auto compressed = compress(column, codec);
+    if (!compressed.has_value()) {
+      continue;
+    }
+    if (codec == ColumnCodec::Zstd) {
+      zstd = CompressedColumn{codec, std::move(compressed.value())};
+    } else if (!bestLightweight.has_value() ||
+               compressed->size() < bestLightweight->data_.size()) {
+      bestLightweight = CompressedColumn{codec, std::move(compressed.value())};
+    }
+  }
+  AD_CORRECTNESS_CHECK(zstd.has_value() && bestLightweight.has_value());
+  if (static_cast<double>(bestLightweight->data_.size()) <=
+      maxSizeRatioOfLightweightCodecToZstd *
+          static_cast<double>(zstd->data_.size())) {
+    return std::move(bestLightweight.value());
+  }
+  return std::move(zstd.value());
+}
+
+// _____________________________________________________________________________
+void decompress(ColumnCodec codec, ql::span<const char> compressedColumn,
+                ql::span<Id> target) {
+  switch (codec) {
+    case ColumnCodec::Zstd: {
+      auto numBytesActuallyRead = ZstdWrapper::decompressToBuffer(
+          compressedColumn.data(), compressedColumn.size(), target.data(),
+          target.size() * sizeof(Id));
+      AD_CORRECTNESS_CHECK(target.size() * sizeof(Id) == numBytesActuallyRead);
+      return;
+    }
+    case ColumnCodec::RunLength:
+      return decompressRunLength(compressedColumn, target);
+    case ColumnCodec::FrameOfReference:
+      return decompressFrameOfReference(compressedColumn, target);
+    case ColumnCodec::DeltaBitPacked:
+      return decompressDeltaBitPacked(compressedColumn, target);
+    case ColumnCodec::Simple8bDelta:
+      return decompressSimple8bDelta(compressedColumn, target);
+    case ColumnCodec::Uncompressed:
+      AD_CORRECTNESS_CHECK(numWords(compressedColumn, target.size()) ==
+                           target.size());
+      std::memcpy(target.data(), compressedColumn.data(),
+                  compressedColumn.size());
+      return;
+  }
+  AD_FAIL();
+}
+}  // namespace columnCodec
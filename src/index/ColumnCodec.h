@@ -0,0 +1,101 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_INDEX_COLUMNCODEC_H
+#define QLEVER_SRC_INDEX_COLUMNCODEC_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "backports/concepts.h"
+#include "backports/span.h"
+#include "global/Id.h"
+
+// The codecs with which a single column of a block of a permutation can be
+// compressed. The codec of each column is stored in the block metadata (see
+// `CompressedBlockMetadata::OffsetAndCompressedSize`).
+//
+// Apart from `Zstd`, all codecs are lightweight integer codecs that work on the
+// 64-bit representation of the `Id`s and can be decoded at (almost) memory
+// bandwidth. Their decoders are written as simple branch-free loops over
+// 64-bit words that the compiler can auto-vectorize.
+//
+// NOTE: The numeric values of the codecs are stored on disk, so they must not
+// be changed.
+enum class ColumnCodec : uint8_t {
+  // General purpose compression using `ZstdWrapper`, used as a fallback.
+  Zstd = 0,
+  // A sequence of (value, length) runs. Ideal for the first column of a block,
+  // which contains only few distinct values, and for the graph column.
+  RunLength = 1,
+  // Frame of reference: The minimum of the column followed by the
+  // differences of all values to this minimum, bit-packed with a fixed width.
+  FrameOfReference = 2,
+  // The first value followed by the (wrapping) differences between all
+  // consecutive values, bit-packed with a fixed width. Ideal for sorted or
+  // almost sorted columns like the second column of a block.
+  DeltaBitPacked = 3,
+  // Like `DeltaBitPacked`, but the differences are encoded using the
+  // `Simple8bCode`, which adapts the bit width to the local size of the
+  // differences. Only applicable if all differences fit into 60 bits.
+  Simple8bDelta = 4,
+  // The plain 64-bit representation of the `Id`s. This codec is never chosen
+  // by `compressWithBestCodec`, but is used for permutations that are stored
+  // uncompressed, s.t. they can be used directly from a memory mapping of the
+  // file (see `CompressedRelationWriter` and `CompressedRelationReader`).
+  Uncompressed = 5,
+};
+
+// Allow the trivial serialization of the `ColumnCodec`, which is part of the
+// serialized block metadata.
+CPP_template(typename T, typename U)(
+    requires ql::concepts::same_as<T, ColumnCodec>) std::true_type
+    allowTrivialSerialization(T, U&&);
+
+// Return a human-readable name of the `codec`, e.g. for logging and
+// benchmarks.
+std::string_view toString(ColumnCodec codec);
+
+namespace columnCodec {
+// All the codecs that compress, in the order in which they are tried by
+// `compressWithBestCodec`.
+inline constexpr std::array allCodecs{
+    ColumnCodec::RunLength, ColumnCodec::FrameOfReference,
+    ColumnCodec::DeltaBitPacked, ColumnCodec::Simple8bDelta, ColumnCodec::Zstd};
+
+// A lightweight codec is chosen over `Zstd` as long as its result is at most
+// this factor larger than the result of `Zstd`. The lightweight codecs are
+// decoded much faster, which is worth a little more disk space.
+inline constexpr double maxSizeRatioOfLightweightCodecToZstd = 1.25;
+
+// Compress the `column` using the given `codec`. Return `std::nullopt` if the
+// `codec` can't represent the `column` (currently this only happens for the
+// `Simple8bDelta` codec if some of the differences don't fit into 60 bits).
+std::optional<std::vector<char>> compress(ql::span<const Id> column,
+                                          ColumnCodec codec);
+
+// The result of `compressWithBestCodec`.
+struct CompressedColumn {
+  ColumnCodec codec_;
+  std::vector<char> data_;
+};
+
+// Compress the `column` with all the codecs and return the result of the
+// lightweight codec with the smallest result, unless `Zstd` compresses better
+// by more than `maxSizeRatioOfLightweightCodecToZstd`, in which case the result
+// of `Zstd` is returned.
+CompressedColumn compressWithBestCodec(ql::span<const Id> column);
+
+// Decompress the `compressedColumn` which was compressed using the `codec`
+// into the `target`, which must have exactly the size of the original column.
+// Throws if the `compressedColumn` is inconsistent with the size of the
+// `target`.
+void decompress(ColumnCodec codec, ql::span<const char> compressedColumn,
+                ql::span<Id> target);
+}  // namespace columnCodec
+
+#endif  // QLEVER_SRC_INDEX_COLUMNCODEC_H
@@ -6,19 +6,22 @@
 
 #include "CompressedRelation.h"
 
+#include <atomic>
+#include <future>
 #include <ranges>
 
 #include "engine/Engine.h"
 #include "engine/idTable/CompressedExternalIdTable.h"
 #include "engine/idTable/IdTable.h"
 #include "global/RuntimeParameters.h"
+#include "index/BlockMetadataSearchIndex.h"
 #include "index/ConstantsIndexBuilding.h"
 #include "index/LocatedTriples.h"
-#include "util/CompressionUsingZstd/ZstdWrapper.h"
 #include "util/Generator.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
 #include "util/OverloadCallOperator.h"
 #include "util/ProgressBar.h"
+#include "util/RunTasksInParallel.h"
 #include "util/ThreadSafeQueue.h"
 #include "util/Timer.h"
 #include "util/TransparentFunctors.h"
@@ -76,6 +79,119 @@ bool CompressedBlockMetadataNoBlockIndex::isConsistentWith(
          getMaskedTriple(other.firstTriple_, columnIndex);
 };
 
+// Return the datatype by which the `id` is grouped in a zone map (see
+// `CompressedBlockMetadataNoBlockIndex::ZoneMap`).
+static Datatype getZoneMapDatatype(Id id) {
+  auto datatype = id.getDatatype();
+  return datatype == Datatype::LocalVocabIndex ? Datatype::VocabIndex
+                                               : datatype;
+}
+
+// Merge the `range` (all `Id`s of which must have the same zone map datatype)
+// into the `zoneMap`.
+static void mergeIntoZoneMap(
+    CompressedBlockMetadataNoBlockIndex::ZoneMap& zoneMap,
+    const CompressedBlockMetadataNoBlockIndex::DatatypeRange& range) {
+  auto datatype = getZoneMapDatatype(range.min_);
+  auto it = ql::ranges::find_if(zoneMap, [datatype](const auto& r) {
+    return getZoneMapDatatype(r.min_) == datatype;
+  });
+  if (it == zoneMap.end()) {
+    zoneMap.push_back(range);
+    ql::ranges::sort(zoneMap, std::less<>{},
+                     &CompressedBlockMetadataNoBlockIndex::DatatypeRange::min_);
+    return;
+  }
+  it->min_ = std::min(it->min_, range.min_);
+  it->max_ = std::max(it->max_, range.max_);
+  it->count_ += range.count_;
+}
+
+// _____________________________________________________________________________
+void CompressedBlockMetadataNoBlockIndex::addToZoneMap(ZoneMap& zoneMap,
+                                                       Id id) {
+  mergeIntoZoneMap(zoneMap, {id, id, 1});
+}
+
+// _____________________________________________________________________________
+auto CompressedBlockMetadataNoBlockIndex::computeZoneMap(
+    ql::span<const Id> column) -> ZoneMap {
+  ZoneMap zoneMap;
+  // The `Id`s of the same datatype typically form long runs (and are often
+  // sorted), so we handle each such run as a whole.
+  auto beginOfRun = column.begin();
+  while (beginOfRun != column.end()) {
+    auto datatype = getZoneMapDatatype(*beginOfRun);
+    auto endOfRun = std::find_if(beginOfRun, column.end(), [datatype](Id id) {
+      return getZoneMapDatatype(id) != datatype;
+    });
+    auto [min, max] = std::minmax_element(beginOfRun, endOfRun);
+    mergeIntoZoneMap(zoneMap, {*min, *max,
+                               static_cast<size_t>(endOfRun - beginOfRun)});
+    beginOfRun = endOfRun;
+  }
+  return zoneMap;
+}
+
+// Return the key of the `id` in a Bloom filter (see
+// `CompressedBlockMetadataNoBlockIndex::bloomFilters_`). Equal `Id`s always
+// have the same key. In particular, a `LocalVocabIndex` that is equal to a
+// `VocabIndex` gets the key of that `VocabIndex`. For a `LocalVocabIndex` that
+// is not part of the vocabulary, `std::nullopt` is returned, as the bits of
+// such `Id`s depend on the address of the local vocab entry. These `Id`s are
+// never added to a Bloom filter, and are always reported as "may be
+// contained".
+static std::optional<uint64_t> getBloomFilterKey(Id id) {
+  if (id.getDatatype() != Datatype::LocalVocabIndex) {
+    return id.getBits();
+  }
+  auto [lower, upper] = id.getLocalVocabIndex()->positionInVocab();
+  if (lower == upper) {
+    return std::nullopt;
+  }
+  return Id::makeFromVocabIndex(lower).getBits();
+}
+
+// _____________________________________________________________________________
+auto CompressedBlockMetadataNoBlockIndex::computeBloomFilter(
+    ql::span<const Id> column, size_t bitsPerKey) -> ad_utility::BloomFilter {
+  std::vector<uint64_t> keys;
+  keys.reserve(column.size());
+  for (Id id : column) {
+    if (auto key = getBloomFilterKey(id)) {
+      keys.push_back(key.value());
+    }
+  }
+  ql::ranges::sort(keys);
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  ad_utility::BloomFilter bloomFilter{keys.size(), bitsPerKey};
+  for (uint64_t key : keys) {
+    bloomFilter.add(key);
+  }
+  return bloomFilter;
+}
+
+// _____________________________________________________________________________
+void CompressedBlockMetadataNoBlockIndex::addToBloomFilter(
+    ad_utility::BloomFilter& bloomFilter, Id id) {
+  if (auto key = getBloomFilterKey(id)) {
+    bloomFilter.add(key.value());
+  }
+}
+
+// _____________________________________________________________________________
+bool CompressedBlockMetadataNoBlockIndex::mayContain(size_t columnIndex,
+                                                     Id id) const {
+  if (bloomFilters_.empty() || columnIndex < firstColumnWithBloomFilter ||
+      columnIndex >= firstColumnWithBloomFilter + bloomFilters_.size()) {
+    return true;
+  }
+  auto key = getBloomFilterKey(id);
+  return !key.has_value() ||
+         bloomFilters_[columnIndex - firstColumnWithBloomFilter].mayContain(
+             key.value());
+}
+
 // Return true iff the `triple` is contained in the `scanSpec`. For example, the
 // triple ` 42 0 3 ` is contained in the specs `U U U`, `42 U U` and `42 0 U` ,
 // but not in `42 2 U` where `U` means "scan for all possible values".
@@ -140,21 +256,23 @@ CompressedRelationReader::asyncParallelBlockGenerator(
   }
 
   // Preparation.
-  const auto& columnIndices = scanConfig.scanColumns_;
-  const auto& blockGraphFilter = scanConfig.graphFilter_;
   LazyScanMetadata& details = co_await cppcoro::getDetails;
   const size_t queueSize =
       RuntimeParameters().get<"lazy-index-scan-queue-size">();
+  const size_t blocksPerBatch = std::max(
+      size_t{1}, RuntimeParameters().get<"lazy-index-scan-blocks-per-batch">());
   auto blockMetadataIterator = beginBlock;
+  size_t nextBatchIndex = 0;
   std::mutex blockIteratorMutex;
 
-  // Helper lambda that reads and decompessed the next block and returns it
-  // together with its index relative to `beginBlock`. Return `std::nullopt`
-  // when `endBlock` is reached. Returns `std::nullopt` for the block if it
-  // is skipped due to the graph filter.
-  auto readAndDecompressBlock = [&]()
-      -> std::optional<
-          std::pair<size_t, std::optional<DecompressedBlockAndMetadata>>> {
+  // Helper lambda that reads and decompresses the next batch of (up to
+  // `blocksPerBatch` consecutive) blocks and returns it together with its
+  // index. Return `std::nullopt` when `endBlock` is reached. The batch
+  // contains `std::nullopt` for each block that is skipped due to the graph
+  // filter.
+  auto readAndDecompressBatch = [&]()
+      -> std::optional<std::pair<
+          size_t, std::vector<std::optional<DecompressedBlockAndMetadata>>>> {
     cancellationHandle->throwIfCancelled();
     std::unique_lock lock{blockIteratorMutex};
     if (blockMetadataIterator == endBlock) {
@@ -163,27 +281,16 @@ CompressedRelationReader::asyncParallelBlockGenerator(
     // Note: taking a copy here is probably not necessary (the lifetime of
     // all the blocks is long enough, so a `const&` would suffice), but the
     // copy is cheap and makes the code more robust.
-    auto blockMetadata = *blockMetadataIterator;
-    // Note: The order of the following two lines is important: The index
-    // of the current blockMetadata depends on the current value of
-    // `blockMetadataIterator`, so we have to compute it before incrementing the
-    // iterator.
-    auto myIndex = static_cast<size_t>(blockMetadataIterator - beginBlock);
-    ++blockMetadataIterator;
-    if (blockGraphFilter.canBlockBeSkipped(blockMetadata)) {
-      return std::pair{myIndex, std::nullopt};
+    std::vector<CompressedBlockMetadata> blocks;
+    while (blockMetadataIterator != endBlock &&
+           blocks.size() < blocksPerBatch) {
+      blocks.push_back(*blockMetadataIterator);
+      ++blockMetadataIterator;
     }
-    // Note: the reading of the blockMetadata could also happen without holding
-    // the lock. We still perform it inside the lock to avoid contention of the
-    // file. On a fast SSD we could possibly change this, but this has to be
-    // investigated.
-    CompressedBlock compressedBlock =
-        readCompressedBlockFromFile(blockMetadata, columnIndices);
-    lock.unlock();
-    auto decompressedBlockAndMetadata = decompressAndPostprocessBlock(
-        compressedBlock, blockMetadata.numRows_, scanConfig, blockMetadata);
-    return std::pair{myIndex,
-                     std::optional{std::move(decompressedBlockAndMetadata)}};
+    auto myIndex = nextBatchIndex++;
+    // Note: This releases the `lock`.
+    auto batch = readAndDecompressBlockBatch(blocks, scanConfig, lock);
+    return std::pair{myIndex, std::move(batch)};
   };
 
   // Prepare queue for reading and decompressing blocks concurrently using
@@ -197,25 +304,27 @@ CompressedRelationReader::asyncParallelBlockGenerator(
       [&details, &popTimer]() { details.blockingTime_ = popTimer.msecs(); });
   auto queue = ad_utility::data_structures::queueManager<
       ad_utility::data_structures::OrderedThreadSafeQueue<
-          std::optional<DecompressedBlockAndMetadata>>>(queueSize, numThreads,
-                                                        readAndDecompressBlock);
+          std::vector<std::optional<DecompressedBlockAndMetadata>>>>(
+      queueSize, numThreads, readAndDecompressBatch);
 
   // Yield the blocks (in the right order) as soon as they become available.
   // Stop when all the blocks have been yielded or the LIMIT of the query is
   // reached. Keep track of various statistics.
-  for (std::optional<DecompressedBlockAndMetadata>& optBlock : queue) {
+  for (auto& batch : queue) {
     popTimer.stop();
-    cancellationHandle->throwIfCancelled();
-    details.update(optBlock);
-    if (optBlock.has_value()) {
-      auto& block = optBlock.value().block_;
-      pruneBlock(block, limitOffset);
-      details.numElementsYielded_ += block.numRows();
-      if (!block.empty()) {
-        co_yield block;
-      }
-      if (limitOffset._limit.value_or(1) == 0) {
-        co_return;
+    for (std::optional<DecompressedBlockAndMetadata>& optBlock : batch) {
+      cancellationHandle->throwIfCancelled();
+      details.update(optBlock);
+      if (optBlock.has_value()) {
+        auto& block = optBlock.value().block_;
+        pruneBlock(block, limitOffset);
+        details.numElementsYielded_ += block.numRows();
+        if (!block.empty()) {
+          co_yield block;
+        }
+        if (limitOffset._limit.value_or(1) == 0) {
+          co_return;
+        }
       }
     }
     popTimer.cont();
@@ -317,8 +426,11 @@ CompressedRelationReader::IdTableGenerator CompressedRelationReader::lazyScan(
     std::vector<CompressedBlockMetadata> relevantBlockMetadata,
     ColumnIndices additionalColumns, CancellationHandle cancellationHandle,
     const LocatedTriplesPerBlock& locatedTriplesPerBlock,
-    LimitOffsetClause limitOffset) const {
+    LimitOffsetClause limitOffset,
+    std::optional<ql::span<const Id>> joinColumnFilter) const {
   AD_CONTRACT_CHECK(cancellationHandle);
+  AD_CONTRACT_CHECK(!joinColumnFilter.has_value() ||
+                    limitOffset.isUnconstrained());
 
   // We will modify `limitOffset` as we go. We make a copy of the original
   // value for some sanity checks at the end of the function.
@@ -335,6 +447,7 @@ CompressedRelationReader::IdTableGenerator CompressedRelationReader::lazyScan(
   size_t numBlocksTotal = endBlockMetadata - beginBlockMetadata;
   auto config =
       getScanConfig(scanSpec, additionalColumns, locatedTriplesPerBlock);
+  config.joinColumnFilter_ = joinColumnFilter;
 
   // Helper lambda for reading the first and last block, of which only a part
   // is needed.
@@ -490,8 +603,25 @@ std::vector<CompressedBlockMetadata> CompressedRelationReader::getBlocksForJoin(
   // Note that it is tempting to reuse the `zipperJoinWithUndef` routine, but
   // this doesn't work because the implicit equality defined by
   // `!lessThan(a,b) && !lessThan(b, a)` is not transitive.
-  auto blockIsNeeded = [&joinColumn, &lessThan](const auto& block) {
-    return !ql::ranges::equal_range(joinColumn, block, lessThan).empty();
+  //
+  // If the block has a Bloom filter for the join column, we additionally check
+  // whether at least one of the `Id`s from the `joinColumn` that fall into the
+  // range of the block actually occurs in the block. This skips the blocks that
+  // only overlap with a sparse `joinColumn` (e.g. a few thousand entities) in
+  // their range.
+  size_t joinColumnIndex = metadataAndBlocks.scanSpec_.firstFreeColIndex();
+  auto blockIsNeeded = [&joinColumn, &lessThan,
+                        joinColumnIndex](const auto& block) {
+    auto matchingIds = ql::ranges::equal_range(joinColumn, block, lessThan);
+    if (matchingIds.empty()) {
+      return false;
+    }
+    if (block.bloomFilters_.empty()) {
+      return true;
+    }
+    return ql::ranges::any_of(matchingIds, [&block, joinColumnIndex](Id id) {
+      return block.mayContain(joinColumnIndex, id);
+    });
   };
 
   std::vector<CompressedBlockMetadata> result;
@@ -579,6 +709,15 @@ IdTable CompressedRelationReader::scan(
     const LocatedTriplesPerBlock& locatedTriplesPerBlock,
     const LimitOffsetClause& limitOffset) const {
   const auto& scanSpec = scanSpecAndBlocks.scanSpec_;
+  // Without a LIMIT or OFFSET, all the blocks have to be read completely, so
+  // they can be read and decompressed in parallel. Otherwise, we use the
+  // `lazyScan`, which can stop as soon as the LIMIT is reached.
+  if (limitOffset.isUnconstrained()) {
+    return scanInParallel(
+        scanSpec,
+        convertBlockMetadataRangesToVector(scanSpecAndBlocks.blockMetadata_),
+        additionalColumns, cancellationHandle, locatedTriplesPerBlock);
+  }
   auto columnIndices = prepareColumnIndices(scanSpec, additionalColumns);
   IdTable result(columnIndices.size(), allocator_);
   // Compute an upper bound for the size and reserve enough space in the
@@ -603,6 +742,202 @@ IdTable CompressedRelationReader::scan(
   return result;
 }
 
+// _____________________________________________________________________________
+IdTable CompressedRelationReader::scanInParallel(
+    const ScanSpecification& scanSpec,
+    std::vector<CompressedBlockMetadata> blocks,
+    ColumnIndicesRef additionalColumns,
+    const CancellationHandle& cancellationHandle,
+    const LocatedTriplesPerBlock& locatedTriplesPerBlock) const {
+  auto config =
+      getScanConfig(scanSpec, additionalColumns, locatedTriplesPerBlock);
+  IdTable result(prepareColumnIndices(scanSpec, additionalColumns).size(),
+                 allocator_);
+  if (blocks.empty()) {
+    return result;
+  }
+  const size_t numThreads =
+      RuntimeParameters().get<"materialized-index-scan-num-threads">();
+
+  // Read the first and the last block, of which only a part might be needed.
+  auto readIncompleteBlock = [&](const CompressedBlockMetadata& metadata) {
+    auto block = readPossiblyIncompleteBlock(
+        scanSpec, config, metadata, std::nullopt, locatedTriplesPerBlock);
+    cancellationHandle->throwIfCancelled();
+    return block;
+  };
+  auto firstBlock = readIncompleteBlock(blocks.front());
+  std::optional<DecompressedBlock> lastBlock;
+  if (blocks.size() > 1) {
+    lastBlock = readIncompleteBlock(blocks.back());
+  }
+  ql::span<const CompressedBlockMetadata> middleBlocks{blocks};
+  middleBlocks = blocks.size() > 2 ? middleBlocks.subspan(1, blocks.size() - 2)
+                                   : middleBlocks.subspan(0, 0);
+
+  // A block can be decompressed directly into the result iff we know its
+  // number of rows in advance and its columns are exactly the columns of the
+  // result. The other blocks are read first (in parallel), because we need
+  // their sizes to determine the positions of all the blocks in the result.
+  auto canBeDecompressedDirectly = [&config](
+                                       const CompressedBlockMetadata& block) {
+    return !config.locatedTriples_.containsTriples(block.blockIndex_) &&
+           !config.graphFilter_.desiredGraphs_.has_value() &&
+           !block.containsDuplicatesWithDifferentGraphs_;
+  };
+  std::vector<size_t> directBlocks;
+  std::vector<size_t> otherBlocks;
+  for (size_t i = 0; i < middleBlocks.size(); ++i) {
+    (canBeDecompressedDirectly(middleBlocks[i]) ? directBlocks : otherBlocks)
+        .push_back(i);
+  }
+  std::vector<std::optional<DecompressedBlockAndMetadata>>
+      decompressedOtherBlocks(otherBlocks.size());
+  ad_utility::runTasksInParallel(
+      otherBlocks.size(), numThreads, [&](size_t j) {
+        cancellationHandle->throwIfCancelled();
+        decompressedOtherBlocks[j] =
+            readAndDecompressBlock(middleBlocks[otherBlocks[j]], config);
+      });
+
+  // Compute the position of each of the middle blocks in the result.
+  std::vector<size_t> offsets(middleBlocks.size());
+  size_t numRows = firstBlock.numRows();
+  for (size_t i = 0, j = 0; i < middleBlocks.size(); ++i) {
+    offsets[i] = numRows;
+    if (j < otherBlocks.size() && otherBlocks[j] == i) {
+      const auto& block = decompressedOtherBlocks[j++];
+      numRows += block.has_value() ? block.value().block_.numRows() : 0;
+    } else {
+      numRows += middleBlocks[i].numRows_;
+    }
+  }
+  size_t offsetOfLastBlock = numRows;
+  numRows += lastBlock.has_value() ? lastBlock.value().numRows() : 0;
+  result.resize(numRows);
+
+  // Copy the blocks that have already been decompressed to the result.
+  auto copyToResult = [&result](const DecompressedBlock& block,
+                                size_t offset) {
+    AD_CORRECTNESS_CHECK(block.numColumns() == result.numColumns());
+    for (size_t i = 0; i < block.numColumns(); ++i) {
+      ql::ranges::copy(block.getColumn(i),
+                       result.getColumn(i).begin() + offset);
+    }
+  };
+  copyToResult(firstBlock, 0);
+  for (size_t j = 0; j < otherBlocks.size(); ++j) {
+    if (decompressedOtherBlocks[j].has_value()) {
+      copyToResult(decompressedOtherBlocks[j].value().block_,
+                   offsets[otherBlocks[j]]);
+    }
+  }
+  decompressedOtherBlocks.clear();
+  if (lastBlock.has_value()) {
+    copyToResult(lastBlock.value(), offsetOfLastBlock);
+  }
+
+  // Read and decompress the remaining blocks with one task per block and
+  // column, such that even a scan of few large blocks uses all the threads.
+  const size_t numColumns = result.numColumns();
+  AD_CORRECTNESS_CHECK(directBlocks.empty() ||
+                       config.scanColumns_.size() == numColumns);
+  ad_utility::runTasksInParallel(
+      directBlocks.size() * numColumns, numThreads, [&](size_t task) {
+        cancellationHandle->throwIfCancelled();
+        size_t i = directBlocks[task / numColumns];
+        size_t column = task % numColumns;
+        const auto& block = middleBlocks[i];
+        ColumnIndex columnIndex = config.scanColumns_[column];
+        auto compressedColumn = readCompressedBlockFromFile(
+            block, ql::span<const ColumnIndex>{&columnIndex, 1});
+        decompressColumnOfBlock(
+            compressedColumn, 0,
+            result.getColumn(column).subspan(offsets[i], block.numRows_));
+      });
+  cancellationHandle->throwIfCancelled();
+  return result;
+}
+
+// _____________________________________________________________________________
+std::optional<IdTableView<0>> CompressedRelationReader::scanAsView(
+    const ScanSpecAndBlocks& scanSpecAndBlocks,
+    ColumnIndicesRef additionalColumns,
+    const LocatedTriplesPerBlock& locatedTriplesPerBlock) const {
+  if (!memoryMappedFile_.has_value()) {
+    return std::nullopt;
+  }
+  const auto& scanSpec = scanSpecAndBlocks.scanSpec_;
+  auto config =
+      getScanConfig(scanSpec, additionalColumns, locatedTriplesPerBlock);
+  auto blocks =
+      convertBlockMetadataRangesToVector(scanSpecAndBlocks.blockMetadata_);
+  if (blocks.empty()) {
+    return IdTableView<0>::fromColumnSpans(
+        IdTableView<0>::ViewSpans(
+            prepareColumnIndices(scanSpec, additionalColumns).size()),
+        0, allocator_);
+  }
+  // The columns of the block can only be used directly if the result consists
+  // of a contiguous range of rows of a single block.
+  const auto& block = blocks.front();
+  if (blocks.size() > 1 ||
+      locatedTriplesPerBlock.containsTriples(block.blockIndex_) ||
+      config.graphFilter_.desiredGraphs_.has_value() ||
+      block.containsDuplicatesWithDifferentGraphs_) {
+    return std::nullopt;
+  }
+
+  // Return the `column` of the `block` from the memory mapping, or `nullopt`
+  // if it is not contained in the mapping (see `getMappedColumn`).
+  auto getMappedIds =
+      [this, &block](ColumnIndex column) -> std::optional<ql::span<const Id>> {
+    const auto& offset = block.offsetsAndCompressedSize_.at(column);
+    auto bytes = this->getMappedColumn(offset);
+    if (bytes.empty()) {
+      return std::nullopt;
+    }
+    AD_CORRECTNESS_CHECK(offset.compressedSize_ ==
+                         block.numRows_ * sizeof(Id));
+    AD_CORRECTNESS_CHECK(offset.offsetInFile_ % alignof(Id) == 0);
+    return ql::span<const Id>{reinterpret_cast<const Id*>(bytes.data()),
+                              block.numRows_};
+  };
+
+  // Narrow down the rows of the block according to the `scanSpec`, first by
+  // the `col0Id`, then by the `col1Id`, and then by the `col2Id` (this is the
+  // order in which the rows are sorted).
+  size_t beginIdx = 0;
+  size_t endIdx = block.numRows_;
+  std::array relevantIds{scanSpec.col0Id(), scanSpec.col1Id(),
+                         scanSpec.col2Id()};
+  for (size_t i = 0; i < relevantIds.size(); ++i) {
+    if (!relevantIds[i].has_value()) {
+      continue;
+    }
+    auto column = getMappedIds(i);
+    if (!column.has_value()) {
+      return std::nullopt;
+    }
+    auto matchingRange = ql::ranges::equal_range(column->begin() + beginIdx,
+                                                 column->begin() + endIdx,
+                                                 relevantIds[i].value());
+    beginIdx = matchingRange.begin() - column->begin();
+    endIdx = matchingRange.end() - column->begin();
+  }
+
+  IdTableView<0>::ViewSpans columns;
+  for (ColumnIndex columnIndex : config.scanColumns_) {
+    auto column = getMappedIds(columnIndex);
+    if (!column.has_value()) {
+      return std::nullopt;
+    }
+    columns.push_back(column->subspan(beginIdx, endIdx - beginIdx));
+  }
+  return IdTableView<0>::fromColumnSpans(std::move(columns), endIdx - beginIdx,
+                                         allocator_);
+}
+
 // ____________________________________________________________________________
 DecompressedBlock CompressedRelationReader::readPossiblyIncompleteBlock(
     const ScanSpecification& scanSpec, const ScanImplConfig& scanConfig,
@@ -749,19 +1084,37 @@ std::pair<size_t, size_t> CompressedRelationReader::getResultSizeImpl(
     --endBlock;
   }
 
+  // The number of rows of a complete block after merging its located triples
+  // is cached in the located triples of the block (which are replaced by a
+  // copy on each update of the block). Without a graph filter, this number
+  // does not depend on the scan, so it can be reused by all later scans.
+  const bool canUseCachedNumRows = !scanSpec.graphsToFilter().has_value();
   ql::ranges::for_each(
       ql::ranges::subrange{beginBlock, endBlock}, [&](const auto& block) {
         const auto [ins, del] =
             locatedTriplesPerBlock.numTriples(block.blockIndex_);
-        if (!exactSize || (ins == 0 && del == 0)) {
+        if (ins == 0 && del == 0) {
+          numResults += block.numRows_;
+          return;
+        }
+        auto cachedNumRows =
+            canUseCachedNumRows
+                ? locatedTriplesPerBlock.getNumRowsAfterMerge(block.blockIndex_)
+                : std::nullopt;
+        if (cachedNumRows.has_value()) {
+          numResults += cachedNumRows.value();
+        } else if (!exactSize) {
           inserted += ins;
           deleted += del;
           numResults += block.numRows_;
         } else {
-          // TODO<joka921> We could cache the exact size as soon as we
-          // have merged the block once since the last update.
           auto b = readAndDecompressBlock(block, config);
-          numResults += b.has_value() ? b.value().block_.numRows() : 0u;
+          auto numRows = b.has_value() ? b.value().block_.numRows() : 0u;
+          if (canUseCachedNumRows) {
+            locatedTriplesPerBlock.setNumRowsAfterMerge(block.blockIndex_,
+                                                        numRows);
+          }
+          numResults += numRows;
         }
       });
   return {numResults - std::min(deleted, numResults), numResults + inserted};
@@ -913,44 +1266,271 @@ void CompressedRelationWriter::writeBufferedRelationsToSingleBlock() {
   compressAndWriteBlock(
       currentBlockFirstCol0_, currentBlockLastCol0_,
       std::make_shared<IdTable>(std::move(smallRelationsBuffer_).toDynamic()),
-      true);
+      true, blocksize());
   smallRelationsBuffer_.clear();
   smallRelationsBuffer_.reserve(2 * blocksize());
 }
 
 // _____________________________________________________________________________
-CompressedBlock CompressedRelationReader::readCompressedBlockFromFile(
+ql::span<const char> CompressedRelationReader::getMappedColumn(
+    const CompressedBlockMetadata::OffsetAndCompressedSize& offset) const {
+  if (!memoryMappedFile_.has_value() ||
+      offset.codec_ != ColumnCodec::Uncompressed) {
+    return {};
+  }
+  auto bytes = memoryMappedFile_->bytes();
+  if (offset.offsetInFile_ + offset.compressedSize_ > bytes.size()) {
+    return {};
+  }
+  return bytes.subspan(offset.offsetInFile_, offset.compressedSize_);
+}
+
+// _____________________________________________________________________________
+size_t CompressedRelationReader::getNextBlockCacheId() {
+  static std::atomic<size_t> nextId = 0;
+  return nextId++;
+}
+
+// _____________________________________________________________________________
+auto CompressedRelationReader::readCompressedBlockFromFile(
     const CompressedBlockMetadata& blockMetaData,
-    ColumnIndicesRef columnIndices) const {
-  CompressedBlock compressedBuffer;
-  compressedBuffer.resize(columnIndices.size());
+    ColumnIndicesRef columnIndices) const -> CompressedBlockAndCachedColumns {
+  std::vector<ad_utility::AsyncFileReader::ReadRequest> readRequests;
+  auto result =
+      prepareReadOfCompressedBlock(blockMetaData, columnIndices, readRequests);
+  ad_utility::AsyncFileReader::readBatch(file_.fileDescriptor(), readRequests,
+                                         [](size_t) {});
+  return result;
+}
+
+// _____________________________________________________________________________
+auto CompressedRelationReader::prepareReadOfCompressedBlock(
+    const CompressedBlockMetadata& blockMetaData,
+    ColumnIndicesRef columnIndices,
+    std::vector<ad_utility::AsyncFileReader::ReadRequest>& readRequests) const
+    -> CompressedBlockAndCachedColumns {
+  auto& blockCache = DecompressedBlockCache::get();
+  const bool useBlockCache = blockCache.isEnabled();
+  CompressedBlockAndCachedColumns result{
+      std::vector<size_t>(columnIndices.size()),
+      {columnIndices.begin(), columnIndices.end()},
+      CompressedBlock(columnIndices.size()),
+      std::vector<ColumnCodec>(columnIndices.size(), ColumnCodec::Zstd),
+      std::vector<DecompressedBlockCache::ColumnPtr>(columnIndices.size()),
+      std::vector<ql::span<const char>>(columnIndices.size())};
   // TODO<C++23> Use `ql::views::zip`
-  for (size_t i = 0; i < compressedBuffer.size(); ++i) {
+  for (size_t i = 0; i < columnIndices.size(); ++i) {
     const auto& offset =
         blockMetaData.offsetsAndCompressedSize_.at(columnIndices[i]);
-    auto& currentCol = compressedBuffer[i];
+    result.offsetsInFile_[i] = offset.offsetInFile_;
+    if (auto mappedColumn = getMappedColumn(offset); !mappedColumn.empty()) {
+      result.mappedColumns_[i] = mappedColumn;
+      continue;
+    }
+    if (useBlockCache) {
+      auto& cachedColumn = result.cachedColumns_[i];
+      cachedColumn = blockCache.lookup(blockCacheKey(offset.offsetInFile_));
+      if (cachedColumn) {
+        ++result.numBlockCacheHits_;
+        continue;
+      }
+      ++result.numBlockCacheMisses_;
+    }
+    auto& currentCol = result.compressedColumns_[i];
     currentCol.resize(offset.compressedSize_);
-    file_.read(currentCol.data(), offset.compressedSize_, offset.offsetInFile_);
+    readRequests.push_back(
+        {offset.offsetInFile_, offset.compressedSize_, currentCol.data()});
+    result.codecs_[i] = offset.codec_;
   }
-  return compressedBuffer;
+  return result;
+}
+
+// _____________________________________________________________________________
+std::vector<std::optional<DecompressedBlockAndMetadata>>
+CompressedRelationReader::readAndDecompressBlockBatch(
+    ql::span<const CompressedBlockMetadata> blocks,
+    const ScanImplConfig& scanConfig,
+    std::unique_lock<std::mutex>& lock) const {
+  std::vector<std::optional<DecompressedBlockAndMetadata>> result(
+      blocks.size());
+  std::vector<std::optional<CompressedBlockAndCachedColumns>>
+      compressedBlocks(blocks.size());
+  // For each block the number of columns that still have to be read.
+  std::vector<size_t> numPendingReads(blocks.size(), 0);
+  std::vector<ad_utility::AsyncFileReader::ReadRequest> readRequests;
+  // For each read request the index of the corresponding block.
+  std::vector<size_t> blockOfReadRequest;
+  std::vector<size_t> blocksWithLateMaterialization;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const auto& block = blocks[i];
+    if (scanConfig.graphFilter_.canBlockBeSkipped(block)) {
+      continue;
+    }
+    // With late materialization, the reading happens in two phases (first
+    // the join column, then the remaining columns), so it is not part of the
+    // batch.
+    if (scanConfig.joinColumnFilter_.has_value() &&
+        !scanConfig.locatedTriples_.containsTriples(block.blockIndex_)) {
+      blocksWithLateMaterialization.push_back(i);
+      continue;
+    }
+    compressedBlocks[i] = prepareReadOfCompressedBlock(
+        block, scanConfig.scanColumns_, readRequests);
+    numPendingReads[i] = readRequests.size() - blockOfReadRequest.size();
+    blockOfReadRequest.resize(readRequests.size(), i);
+  }
+
+  auto decompress = [&](size_t i) {
+    result[i] = decompressAndPostprocessBlock(compressedBlocks[i].value(),
+                                              blocks[i].numRows_, scanConfig,
+                                              blocks[i]);
+    compressedBlocks[i].reset();
+  };
+  // Note: Without `io_uring`, the reads are synchronous, and we perform them
+  // inside the lock to avoid contention of the file. On a fast SSD we could
+  // possibly change this, but this has to be investigated.
+  const bool decompressWhileReading =
+      ad_utility::AsyncFileReader::usesIoUring();
+  if (decompressWhileReading) {
+    lock.unlock();
+  }
+  ad_utility::AsyncFileReader::readBatch(
+      file_.fileDescriptor(), readRequests, [&](size_t requestIndex) {
+        auto i = blockOfReadRequest[requestIndex];
+        if (--numPendingReads[i] == 0 && decompressWhileReading) {
+          decompress(i);
+        }
+      });
+  if (lock.owns_lock()) {
+    lock.unlock();
+  }
+  // Decompress the remaining blocks (all blocks if the decompression didn't
+  // happen while reading, and the blocks that were completely contained in
+  // the `DecompressedBlockCache`).
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (compressedBlocks[i].has_value()) {
+      decompress(i);
+    }
+  }
+  for (size_t i : blocksWithLateMaterialization) {
+    result[i] =
+        readAndDecompressBlockWithLateMaterialization(blocks[i], scanConfig);
+  }
+  return result;
 }
 
 // ____________________________________________________________________________
 DecompressedBlock CompressedRelationReader::decompressBlock(
-    const CompressedBlock& compressedBlock, size_t numRowsToRead) const {
-  DecompressedBlock decompressedBlock{compressedBlock.size(), allocator_};
+    const CompressedBlockAndCachedColumns& compressedBlock,
+    size_t numRowsToRead) const {
+  const auto& compressedColumns = compressedBlock.compressedColumns_;
+  DecompressedBlock decompressedBlock{compressedColumns.size(), allocator_};
   decompressedBlock.resize(numRowsToRead);
-  for (size_t i = 0; i < compressedBlock.size(); ++i) {
-    auto col = decompressedBlock.getColumn(i);
-    decompressColumn(compressedBlock[i], numRowsToRead, col.data());
+  for (size_t i = 0; i < compressedColumns.size(); ++i) {
+    decompressColumnOfBlock(compressedBlock, i, decompressedBlock.getColumn(i));
   }
   return decompressedBlock;
 }
 
+// ____________________________________________________________________________
+void CompressedRelationReader::decompressColumnOfBlock(
+    const CompressedBlockAndCachedColumns& compressedBlock, size_t i,
+    ql::span<Id> target) const {
+  if (const auto& cachedColumn = compressedBlock.cachedColumns_.at(i)) {
+    AD_CORRECTNESS_CHECK(cachedColumn->size() == target.size());
+    ql::ranges::copy(*cachedColumn, target.begin());
+    return;
+  }
+  // Columns from the memory mapping are not added to the cache, as they can
+  // be accessed just as cheaply.
+  if (const auto& mappedColumn = compressedBlock.mappedColumns_.at(i);
+      !mappedColumn.empty()) {
+    decompressColumn(ColumnCodec::Uncompressed, mappedColumn, target);
+    return;
+  }
+  decompressColumn(compressedBlock.codecs_.at(i),
+                   compressedBlock.compressedColumns_.at(i), target);
+  auto& blockCache = DecompressedBlockCache::get();
+  if (blockCache.isEnabled()) {
+    blockCache.insert(
+        blockCacheKey(compressedBlock.offsetsInFile_.at(i)),
+        DecompressedBlockCache::Column(target.begin(), target.end()));
+  }
+}
+
+// ____________________________________________________________________________
+DecompressedBlockAndMetadata
+CompressedRelationReader::readAndDecompressBlockWithLateMaterialization(
+    const CompressedBlockMetadata& blockMetaData,
+    const ScanImplConfig& scanConfig) const {
+  AD_CORRECTNESS_CHECK(scanConfig.joinColumnFilter_.has_value());
+  AD_CORRECTNESS_CHECK(
+      !scanConfig.locatedTriples_.containsTriples(blockMetaData.blockIndex_));
+  ColumnIndicesRef columnIndices = scanConfig.scanColumns_;
+  AD_CORRECTNESS_CHECK(!columnIndices.empty());
+  const auto numRows = blockMetaData.numRows_;
+
+  // First read and decompress only the join column, which is the first column.
+  auto compressedJoinColumn =
+      readCompressedBlockFromFile(blockMetaData, columnIndices.subspan(0, 1));
+  auto joinColumnBlock = decompressBlock(compressedJoinColumn, numRows);
+  size_t numBlockCacheHits = compressedJoinColumn.numBlockCacheHits_;
+  size_t numBlockCacheMisses = compressedJoinColumn.numBlockCacheMisses_;
+
+  // Determine the rows that have a join partner. Both the join column of the
+  // block and the `joinColumnFilter_` are sorted.
+  ql::span<const Id> joinColumn = joinColumnBlock.getColumn(0);
+  ql::span<const Id> otherJoinColumn = scanConfig.joinColumnFilter_.value();
+  std::vector<size_t> matchingRows;
+  auto it = otherJoinColumn.begin();
+  for (size_t row = 0; row < joinColumn.size(); ++row) {
+    it = std::lower_bound(it, otherJoinColumn.end(), joinColumn[row]);
+    if (it == otherJoinColumn.end()) {
+      break;
+    }
+    if (*it == joinColumn[row]) {
+      matchingRows.push_back(row);
+    }
+  }
+  const size_t numRowsDiscarded = numRows - matchingRows.size();
+  if (matchingRows.empty()) {
+    return {DecompressedBlock{columnIndices.size(), allocator_}, false, false,
+            numBlockCacheHits, numBlockCacheMisses, numRowsDiscarded, true};
+  }
+
+  // Now read and decompress the remaining columns, and only materialize the
+  // rows that have a join partner.
+  DecompressedBlock remainingColumnsBlock{0, allocator_};
+  if (columnIndices.size() > 1) {
+    auto compressedRemainingColumns =
+        readCompressedBlockFromFile(blockMetaData, columnIndices.subspan(1));
+    remainingColumnsBlock =
+        decompressBlock(compressedRemainingColumns, numRows);
+    numBlockCacheHits += compressedRemainingColumns.numBlockCacheHits_;
+    numBlockCacheMisses += compressedRemainingColumns.numBlockCacheMisses_;
+  }
+  DecompressedBlock result{columnIndices.size(), allocator_};
+  result.resize(matchingRows.size());
+  for (size_t i = 0; i < columnIndices.size(); ++i) {
+    ql::span<const Id> sourceColumn =
+        i == 0 ? joinColumnBlock.getColumn(0)
+               : remainingColumnsBlock.getColumn(i - 1);
+    ql::ranges::transform(matchingRows, result.getColumn(i).begin(),
+                          [&sourceColumn](size_t row) {
+                            return sourceColumn[row];
+                          });
+  }
+  bool wasPostprocessed =
+      scanConfig.graphFilter_.postprocessBlock(result, blockMetaData);
+  return {std::move(result), wasPostprocessed, false, numBlockCacheHits,
+          numBlockCacheMisses, numRowsDiscarded, false};
+}
+
 // ____________________________________________________________________________
 DecompressedBlockAndMetadata
 CompressedRelationReader::decompressAndPostprocessBlock(
-    const CompressedBlock& compressedBlock, size_t numRowsToRead,
+    const CompressedBlockAndCachedColumns& compressedBlock,
+    size_t numRowsToRead,
     const CompressedRelationReader::ScanImplConfig& scanConfig,
     const CompressedBlockMetadata& metadata) const {
   auto decompressedBlock = decompressBlock(compressedBlock, numRowsToRead);
@@ -965,19 +1545,16 @@ CompressedRelationReader::decompressAndPostprocessBlock(
   }
   bool wasPostprocessed =
       scanConfig.graphFilter_.postprocessBlock(decompressedBlock, metadata);
-  return {std::move(decompressedBlock), wasPostprocessed, hasUpdates};
+  return {std::move(decompressedBlock), wasPostprocessed, hasUpdates,
+          compressedBlock.numBlockCacheHits_,
+          compressedBlock.numBlockCacheMisses_};
 }
 
 // ____________________________________________________________________________
-template <typename Iterator>
 void CompressedRelationReader::decompressColumn(
-    const std::vector<char>& compressedBlock, size_t numRowsToRead,
-    Iterator iterator) {
-  auto numBytesActuallyRead = ZstdWrapper::decompressToBuffer(
-      compressedBlock.data(), compressedBlock.size(), iterator,
-      numRowsToRead * sizeof(*iterator));
-  static_assert(sizeof(Id) == sizeof(*iterator));
-  AD_CORRECTNESS_CHECK(numRowsToRead * sizeof(Id) == numBytesActuallyRead);
+    ColumnCodec codec, ql::span<const char> compressedColumn,
+    ql::span<Id> target) {
+  columnCodec::decompress(codec, compressedColumn, target);
 }
 
 // ____________________________________________________________________________
@@ -988,7 +1565,7 @@ CompressedRelationReader::readAndDecompressBlock(
   if (scanConfig.graphFilter_.canBlockBeSkipped(blockMetaData)) {
     return std::nullopt;
   }
-  CompressedBlock compressedColumns =
+  auto compressedColumns =
       readCompressedBlockFromFile(blockMetaData, scanConfig.scanColumns_);
   const auto numRowsToRead = blockMetaData.numRows_;
   return decompressAndPostprocessBlock(compressedColumns, numRowsToRead,
@@ -998,13 +1575,26 @@ CompressedRelationReader::readAndDecompressBlock(
 // ____________________________________________________________________________
 CompressedBlockMetadata::OffsetAndCompressedSize
 CompressedRelationWriter::compressAndWriteColumn(ql::span<const Id> column) {
-  std::vector<char> compressedBlock = ZstdWrapper::compress(
-      (void*)(column.data()), column.size() * sizeof(column[0]));
+  auto [codec, compressedBlock] =
+      storeUncompressed_
+          ? columnCodec::CompressedColumn{ColumnCodec::Uncompressed,
+                                          columnCodec::compress(
+                                              column, ColumnCodec::Uncompressed)
+                                              .value()}
+          : columnCodec::compressWithBestCodec(column);
   auto compressedSize = compressedBlock.size();
   auto file = outfile_.wlock();
   auto offsetInFile = file->tell();
+  // Uncompressed columns are aligned, s.t. they can be used directly from a
+  // memory mapping of the file.
+  if (codec == ColumnCodec::Uncompressed && offsetInFile % alignof(Id) != 0) {
+    std::array<char, alignof(Id)> padding{};
+    auto paddingSize = alignof(Id) - offsetInFile % alignof(Id);
+    file->write(padding.data(), paddingSize);
+    offsetInFile += paddingSize;
+  }
   file->write(compressedBlock.data(), compressedBlock.size());
-  return {offsetInFile, compressedSize};
+  return {offsetInFile, compressedSize, codec};
 };
 
 // Find out whether the sorted `block` contains duplicates and whether it
@@ -1049,10 +1639,10 @@ static std::pair<bool, std::optional<std::vector<Id>>> getGraphInfo(
 // _____________________________________________________________________________
 void CompressedRelationWriter::compressAndWriteBlock(
     Id firstCol0Id, Id lastCol0Id, std::shared_ptr<IdTable> block,
-    bool invokeCallback) {
+    bool invokeCallback, size_t blocksize) {
   auto timer = blockWriteQueueTimer_.startMeasurement();
   blockWriteQueue_.push([this, block = std::move(block), firstCol0Id,
-                         lastCol0Id, invokeCallback]() mutable {
+                         lastCol0Id, invokeCallback, blocksize]() mutable {
     std::vector<CompressedBlockMetadata::OffsetAndCompressedSize> offsets;
     for (const auto& column : block->getColumns()) {
       offsets.push_back(compressAndWriteColumn(column));
@@ -1065,13 +1655,32 @@ void CompressedRelationWriter::compressAndWriteBlock(
     AD_CORRECTNESS_CHECK(lastCol0Id == last[0]);
 
     auto [hasDuplicates, graphInfo] = getGraphInfo(block);
+    std::vector<CompressedBlockMetadata::ZoneMap> zoneMaps;
+    for (size_t i = 0; i < CompressedBlockMetadata::numColumnsWithZoneMaps;
+         ++i) {
+      zoneMaps.push_back(
+          CompressedBlockMetadata::computeZoneMap(block->getColumn(i)));
+    }
+    std::vector<ad_utility::BloomFilter> bloomFilters;
+    if (bloomFilterBitsPerKey_ > 0) {
+      for (size_t i = 0;
+           i < CompressedBlockMetadata::numColumnsWithBloomFilters; ++i) {
+        bloomFilters.push_back(CompressedBlockMetadata::computeBloomFilter(
+            block->getColumn(
+                CompressedBlockMetadata::firstColumnWithBloomFilter + i),
+            bloomFilterBitsPerKey_));
+      }
+    }
     blockBuffer_.wlock()->emplace_back(CompressedBlockMetadataNoBlockIndex{
         std::move(offsets),
         numRows,
         {first[0], first[1], first[2], first[3]},
         {last[0], last[1], last[2], last[3]},
         std::move(graphInfo),
-        hasDuplicates});
+        hasDuplicates,
+        std::move(zoneMaps),
+        std::move(bloomFilters),
+        blocksize});
     if (invokeCallback && smallBlocksCallback_) {
       std::invoke(smallBlocksCallback_, std::move(block));
     }
@@ -1079,6 +1688,30 @@ void CompressedRelationWriter::compressAndWriteBlock(
   timer.stop();
 }
 
+// _____________________________________________________________________________
+void CompressedRelationWriter::addCompleteBlock(std::shared_ptr<IdTable> block,
+                                                size_t blocksize) {
+  AD_CONTRACT_CHECK(!block->empty());
+  AD_CONTRACT_CHECK(currentRelationPreviousSize_ == 0 &&
+                    smallRelationsBuffer_.numRows() == 0);
+  Id firstCol0Id = (*block)(0, 0);
+  Id lastCol0Id = (*block)(block->numRows() - 1, 0);
+  compressAndWriteBlock(firstCol0Id, lastCol0Id, std::move(block), false,
+                        blocksize);
+}
+
+// _____________________________________________________________________________
+DecompressedBlock CompressedRelationReader::readCompleteBlock(
+    const CompressedBlockMetadata& blockMetadata) const {
+  size_t numColumns = blockMetadata.offsetsAndCompressedSize_.size();
+  ColumnIndices allColumns;
+  ql::ranges::copy(ql::views::iota(size_t{0}, numColumns),
+                   std::back_inserter(allColumns));
+  return decompressBlock(
+      readCompressedBlockFromFile(blockMetadata, allColumns),
+      blockMetadata.numRows_);
+}
+
 // _____________________________________________________________________________
 size_t CompressedRelationReader::getNumberOfBlockMetadataValues(
     const BlockMetadataRanges& blockMetadata) {
@@ -1098,13 +1731,16 @@ CompressedRelationReader::convertBlockMetadataRangesToVector(
 }
 
 // _____________________________________________________________________________
-BlockMetadataRanges CompressedRelationReader::getRelevantBlocks(
-    const ScanSpecification& scanSpec,
-    const BlockMetadataRanges& blockMetadata) {
-  // Get all the blocks  that possibly might contain our pair of col0Id and
-  // col1Id
-  CompressedBlockMetadata key;
-
+namespace {
+// The smallest and the largest triple that can possibly match the given
+// `scanSpec`. The blocks that might contain our pair of col0Id and col1Id are
+// exactly the blocks that overlap with this range.
+struct ScanKey {
+  CompressedBlockMetadata::PermutedTriple firstTriple_;
+  CompressedBlockMetadata::PermutedTriple lastTriple_;
+};
+ScanKey getScanKey(const ScanSpecification& scanSpec) {
+  ScanKey key;
   auto setOrDefault = [&scanSpec](auto getterA, auto getterB, auto& triple,
                                   auto defaultValue) {
     std::invoke(getterA, triple) =
@@ -1122,6 +1758,15 @@ BlockMetadataRanges CompressedRelationReader::getRelevantBlocks(
   // We currently don't filter by the graph ID here.
   key.firstTriple_.graphId_ = Id::min();
   key.lastTriple_.graphId_ = Id::max();
+  return key;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+BlockMetadataRanges CompressedRelationReader::getRelevantBlocks(
+    const ScanSpecification& scanSpec,
+    const BlockMetadataRanges& blockMetadata) {
+  auto key = getScanKey(scanSpec);
 
   // This comparator only returns true if a block stands completely before
   // another block without any overlap. In other words, the last triple of `a`
@@ -1148,6 +1793,19 @@ BlockMetadataRanges CompressedRelationReader::getRelevantBlocks(
   return resultBlocks;
 }
 
+// _____________________________________________________________________________
+BlockMetadataRanges CompressedRelationReader::getRelevantBlocks(
+    const ScanSpecification& scanSpec, BlockMetadataSpan blocks,
+    const BlockMetadataSearchIndex& searchIndex) {
+  AD_CONTRACT_CHECK(searchIndex.size() == blocks.size());
+  auto key = getScanKey(scanSpec);
+  auto [begin, end] = searchIndex.equalRange(key.firstTriple_, key.lastTriple_);
+  if (begin == end) {
+    return {};
+  }
+  return {{blocks.begin() + begin, blocks.begin() + end}};
+}
+
 // _____________________________________________________________________________
 auto CompressedRelationReader::getFirstAndLastTriple(
     const CompressedRelationReader::ScanSpecAndBlocks& metadataAndBlocks,
@@ -1318,7 +1976,8 @@ CompressedRelationMetadata CompressedRelationWriter::finishLargeRelation(
 
 // _____________________________________________________________________________
 void CompressedRelationWriter::addBlockForLargeRelation(
-    Id col0Id, std::shared_ptr<IdTable> relation) {
+    Id col0Id, std::shared_ptr<IdTable> relation,
+    std::optional<size_t> blocksize) {
   AD_CORRECTNESS_CHECK(!relation->empty());
   AD_CORRECTNESS_CHECK(currentCol0Id_ == col0Id ||
                        currentCol0Id_.isUndefined());
@@ -1328,7 +1987,29 @@ void CompressedRelationWriter::addBlockForLargeRelation(
   // This is a block of a large relation, so we don't invoke the
   // `smallBlocksCallback_`. Hence the last argument is `false`.
   compressAndWriteBlock(currentCol0Id_, currentCol0Id_, std::move(relation),
-                        false);
+                        false, blocksize.value_or(this->blocksize()));
+}
+
+// _____________________________________________________________________________
+size_t CompressedRelationWriter::blocksizeForLargeRelation(
+    size_t numRows, std::optional<size_t> numDistinctCol1) const {
+  if (!adaptiveBlocksize_) {
+    return blocksize();
+  }
+  // Huge relations get large blocks, no matter how many rows per `col1Id` they
+  // have.
+  if (numRows >= minNumRowsForLargeBlocks()) {
+    return blocksize() * adaptiveBlocksizeFactor;
+  }
+  AD_CONTRACT_CHECK(numDistinctCol1.has_value());
+  size_t rowsPerCol1 = numRows / std::max(numDistinctCol1.value(), size_t{1});
+  if (rowsPerCol1 <= maxRowsPerCol1ForSmallBlocks) {
+    return std::max(blocksize() / adaptiveBlocksizeFactor, size_t{1});
+  }
+  if (rowsPerCol1 >= blocksize() / adaptiveBlocksizeFactor) {
+    return blocksize() * adaptiveBlocksizeFactor;
+  }
+  return blocksize();
 }
 
 namespace {
@@ -1398,6 +2079,7 @@ class DistinctIdCounter {
     count_ += static_cast<size_t>(id != lastSeen_);
     lastSeen_ = id;
   }
+  size_t count() const { return count_; }
   size_t getAndReset() {
     size_t count = count_;
     lastSeen_ = std::numeric_limits<Id>::max();
@@ -1405,17 +2087,25 @@ class DistinctIdCounter {
     return count;
   }
 };
+
+// Return the number of distinct IDs in the (not necessarily sorted) `column`.
+size_t numDistinctIds(ql::span<const Id> column) {
+  std::vector<Id> ids(column.begin(), column.end());
+  ql::ranges::sort(ids);
+  return static_cast<size_t>(std::unique(ids.begin(), ids.end()) - ids.begin());
+}
 }  // namespace
 
 // __________________________________________________________________________
 template <typename T>
 CompressedRelationMetadata CompressedRelationWriter::addCompleteLargeRelation(
-    Id col0Id, T&& sortedBlocks) {
+    Id col0Id, T&& sortedBlocks, size_t blocksize) {
   DistinctIdCounter distinctCol1Counter;
   for (auto& block : sortedBlocks) {
     ql::ranges::for_each(block.getColumn(1), std::ref(distinctCol1Counter));
     addBlockForLargeRelation(
-        col0Id, std::make_shared<IdTable>(std::move(block).toDynamic()));
+        col0Id, std::make_shared<IdTable>(std::move(block).toDynamic()),
+        blocksize);
   }
   return finishLargeRelation(distinctCol1Counter.getAndReset());
 }
@@ -1437,6 +2127,8 @@ auto CompressedRelationWriter::createPermutationPair(
   auto& writer2 = writerAndCallback2.writer_;
   const size_t blocksize = writer1.blocksize();
   AD_CORRECTNESS_CHECK(writer2.blocksize() == writer1.blocksize());
+  AD_CORRECTNESS_CHECK(writer2.adaptiveBlocksize_ ==
+                       writer1.adaptiveBlocksize_);
   const size_t numColumns = writer1.numColumns();
   AD_CORRECTNESS_CHECK(writer1.numColumns() == writer2.numColumns());
   MetadataWriter writeMetadata{std::move(writerAndCallback1.callback_),
@@ -1463,7 +2155,12 @@ auto CompressedRelationWriter::createPermutationPair(
   auto alloc = ad_utility::makeUnlimitedAllocator<Id>();
   // TODO<joka921> Use call_fixed_size if there is benefit to it.
   IdTableStatic<0> relation{numColumns, alloc};
-  size_t numBlocksCurrentRel = 0;
+  // The blocksize of the current relation in `writer1` (see
+  // `blocksizeForLargeRelation`). It is chosen once per relation, either from
+  // the complete statistics when the relation is finished, or as soon as the
+  // relation has `minNumRowsForLargeBlocks()` rows, from which on the
+  // statistics don't matter. Until then, the rows are kept in `relation`.
+  std::optional<size_t> blocksizeCurrentRel;
   auto compare = [](const auto& a, const auto& b) {
     return std::tie(a[c1Idx], a[c2Idx], a[ADDITIONAL_COLUMN_GRAPH_ID]) <
            std::tie(b[c1Idx], b[c2Idx], b[ADDITIONAL_COLUMN_GRAPH_ID]);
@@ -1474,23 +2171,48 @@ auto CompressedRelationWriter::createPermutationPair(
                          4_GB, alloc);
 
   DistinctIdCounter distinctCol1Counter;
-  auto addBlockForLargeRelation = [&numBlocksCurrentRel, &writer1,
-                                   &col0IdCurrentRelation, &relation,
-                                   &twinRelationSorter, &blocksize] {
+  // Write the rows of the `relation` as blocks of `blocksizeCurrentRel` rows to
+  // `writer1` and push them to the `twinRelationSorter`. The rows of an
+  // incomplete last block stay in the `relation`, unless
+  // `includeIncompleteBlock` is true.
+  auto addBlocksForLargeRelation = [&blocksizeCurrentRel, &writer1,
+                                    &col0IdCurrentRelation, &relation,
+                                    &twinRelationSorter, &alloc, numColumns](
+                                       bool includeIncompleteBlock) {
     if (relation.empty()) {
       return;
     }
-    auto twinRelation = relation.asStaticView<0>();
-    twinRelation.swapColumns(c1Idx, c2Idx);
-    for (const auto& row : twinRelation) {
-      twinRelationSorter.push(row);
+    const size_t blocksizeRel = blocksizeCurrentRel.value();
+    auto writeBlock = [&](IdTableStatic<0> block) {
+      auto twinRelation = block.asStaticView<0>();
+      twinRelation.swapColumns(c1Idx, c2Idx);
+      for (const auto& row : twinRelation) {
+        twinRelationSorter.push(row);
+      }
+      writer1.addBlockForLargeRelation(
+          col0IdCurrentRelation.value(),
+          std::make_shared<IdTable>(std::move(block).toDynamic()),
+          blocksizeRel);
+    };
+    size_t numRowsToWrite = relation.numRows();
+    if (!includeIncompleteBlock) {
+      numRowsToWrite -= numRowsToWrite % blocksizeRel;
     }
-    writer1.addBlockForLargeRelation(
-        col0IdCurrentRelation.value(),
-        std::make_shared<IdTable>(std::move(relation).toDynamic()));
-    relation.clear();
-    relation.reserve(blocksize);
-    ++numBlocksCurrentRel;
+    if (numRowsToWrite == relation.numRows() &&
+        numRowsToWrite <= blocksizeRel) {
+      // The common case: the `relation` is exactly one block.
+      writeBlock(std::move(relation));
+      relation.clear();
+      relation.reserve(blocksizeRel);
+      return;
+    }
+    for (size_t begin = 0; begin < numRowsToWrite; begin += blocksizeRel) {
+      IdTableStatic<0> block{numColumns, alloc};
+      block.insertAtEnd(relation, begin,
+                        std::min(begin + blocksizeRel, numRowsToWrite));
+      writeBlock(std::move(block));
+    }
+    relation.erase(relation.begin(), relation.begin() + numRowsToWrite);
   };
 
   // Set up the handling of small relations for the twin permutation.
@@ -1516,26 +2238,47 @@ auto CompressedRelationWriter::createPermutationPair(
         AD_CORRECTNESS_CHECK(!relation.empty());
         writer2.compressAndWriteBlock(relation.at(0, 0),
                                       relation.at(relation.size() - 1, 0),
-                                      std::move(relationPtr), false);
+                                      std::move(relationPtr), false,
+                                      writer2.blocksize());
       };
 
   writer1.smallBlocksCallback_ = addBlockOfSmallRelationsToSwitched;
 
   auto finishRelation = [&numDistinctCol0, &twinRelationSorter, &writer2,
-                         &writer1, &numBlocksCurrentRel, &col0IdCurrentRelation,
-                         &relation, &distinctCol1Counter,
-                         &addBlockForLargeRelation, &blocksize, &writeMetadata,
+                         &writer1, &blocksizeCurrentRel,
+                         &col0IdCurrentRelation, &relation,
+                         &distinctCol1Counter,
+                         &addBlocksForLargeRelation, &blocksize, &writeMetadata,
                          &largeTwinRelationTimer]() {
     ++numDistinctCol0;
-    if (numBlocksCurrentRel > 0 || static_cast<double>(relation.numRows()) >
-                                       0.8 * static_cast<double>(blocksize)) {
-      // The relation is large;
-      addBlockForLargeRelation();
+    const size_t numRowsCurrentRel =
+        writer1.currentRelationPreviousSize_ + relation.numRows();
+    if (!blocksizeCurrentRel.has_value()) {
+      // No block has been written yet, so the statistics are complete.
+      blocksizeCurrentRel = writer1.blocksizeForLargeRelation(
+          numRowsCurrentRel, distinctCol1Counter.count());
+    }
+    if (writer1.currentRelationPreviousSize_ > 0 ||
+        static_cast<double>(relation.numRows()) >
+            0.8 * static_cast<double>(
+                      std::min(blocksizeCurrentRel.value(), blocksize))) {
+      // The relation is large. The twin relation gets its own blocksize, which
+      // is chosen from its own statistics. Below `minNumRowsForLargeBlocks()`
+      // rows, these are needed, and all rows are still in `relation`.
+      std::optional<size_t> numDistinctCol2;
+      if (writer2.adaptiveBlocksize_ &&
+          numRowsCurrentRel < writer2.minNumRowsForLargeBlocks()) {
+        AD_CORRECTNESS_CHECK(relation.numRows() == numRowsCurrentRel);
+        numDistinctCol2 = numDistinctIds(relation.getColumn(c2Idx));
+      }
+      const size_t blocksizeTwin =
+          writer2.blocksizeForLargeRelation(numRowsCurrentRel, numDistinctCol2);
+      addBlocksForLargeRelation(true);
       auto md1 = writer1.finishLargeRelation(distinctCol1Counter.getAndReset());
       largeTwinRelationTimer.cont();
       auto md2 = writer2.addCompleteLargeRelation(
           col0IdCurrentRelation.value(),
-          twinRelationSorter.getSortedBlocks(blocksize));
+          twinRelationSorter.getSortedBlocks(blocksizeTwin), blocksizeTwin);
       largeTwinRelationTimer.stop();
       twinRelationSorter.clear();
       writeMetadata(md1, md2);
@@ -1549,7 +2292,7 @@ auto CompressedRelationWriter::createPermutationPair(
       // for us (see above).
     }
     relation.clear();
-    numBlocksCurrentRel = 0;
+    blocksizeCurrentRel.reset();
   };
   // All columns n the order in which they have to be added to
   // the relation.
@@ -1582,8 +2325,16 @@ auto CompressedRelationWriter::createPermutationPair(
       }
       distinctCol1Counter(curRemainingCols[c1Idx]);
       relation.push_back(curRemainingCols);
-      if (relation.size() >= blocksize) {
-        addBlockForLargeRelation();
+      if (!blocksizeCurrentRel.has_value() &&
+          (!writer1.adaptiveBlocksize_ ||
+           relation.size() >= writer1.minNumRowsForLargeBlocks())) {
+        // The blocksize doesn't depend on the number of distinct `col1Id`s.
+        blocksizeCurrentRel =
+            writer1.blocksizeForLargeRelation(relation.size(), std::nullopt);
+      }
+      if (blocksizeCurrentRel.has_value() &&
+          relation.size() >= blocksizeCurrentRel.value()) {
+        addBlocksForLargeRelation(false);
       }
       ++numTriplesProcessed;
       if (progressBar.update()) {
@@ -1605,7 +2356,7 @@ auto CompressedRelationWriter::createPermutationPair(
   }
   LOG(INFO) << progressBar.getFinalProgressString() << std::flush;
   inputWaitTimer.stop();
-  if (!relation.empty() || numBlocksCurrentRel > 0) {
+  if (!relation.empty() || writer1.currentRelationPreviousSize_ > 0) {
     finishRelation();
   }
 
@@ -1815,6 +2566,18 @@ CompressedRelationReader::ScanSpecAndBlocks::ScanSpecAndBlocks(
   sizeBlockMetadata_ = getNumberOfBlockMetadataValues(blockMetadata_);
 }
 
+// _____________________________________________________________________________
+CompressedRelationReader::ScanSpecAndBlocks::ScanSpecAndBlocks(
+    ScanSpecification scanSpec, BlockMetadataSpan blocks,
+    const BlockMetadataSearchIndex& searchIndex)
+    : scanSpec_(std::move(scanSpec)) {
+  blockMetadata_ = getRelevantBlocks(scanSpec_, blocks, searchIndex);
+  checkBlockMetadataInvariantOrderAndUniquenessImpl(getBlockMetadataView());
+  checkBlockMetadataInvariantBlockConsistencyImpl(
+      getBlockMetadataView(), scanSpec_.firstFreeColIndex());
+  sizeBlockMetadata_ = getNumberOfBlockMetadataValues(blockMetadata_);
+}
+
 // _____________________________________________________________________________
 ql::span<const CompressedBlockMetadata>
 CompressedRelationReader::ScanSpecAndBlocks::getBlockMetadataSpan() const {
@@ -1843,6 +2606,12 @@ void CompressedRelationReader::LazyScanMetadata::update(
       static_cast<size_t>(blockAndMetadata.containsUpdates_);
   ++numBlocksRead_;
   numElementsRead_ += blockAndMetadata.block_.numRows();
+  numBlockCacheHits_ += blockAndMetadata.numBlockCacheHits_;
+  numBlockCacheMisses_ += blockAndMetadata.numBlockCacheMisses_;
+  numBlocksSkippedByLateMaterialization_ +=
+      static_cast<size_t>(blockAndMetadata.skippedByLateMaterialization_);
+  numElementsDiscardedByLateMaterialization_ +=
+      blockAndMetadata.numRowsDiscardedByLateMaterialization_;
 }
 
 // _____________________________________________________________________________
@@ -1866,4 +2635,10 @@ void CompressedRelationReader::LazyScanMetadata::aggregate(
   numBlocksSkippedBecauseOfGraph_ += newValue.numBlocksSkippedBecauseOfGraph_;
   numBlocksPostprocessed_ += newValue.numBlocksPostprocessed_;
   numBlocksWithUpdate_ += newValue.numBlocksWithUpdate_;
+  numBlockCacheHits_ += newValue.numBlockCacheHits_;
+  numBlockCacheMisses_ += newValue.numBlockCacheMisses_;
+  numBlocksSkippedByLateMaterialization_ +=
+      newValue.numBlocksSkippedByLateMaterialization_;
+  numElementsDiscardedByLateMaterialization_ +=
+      newValue.numElementsDiscardedByLateMaterialization_;
 }
@@ -5,18 +5,24 @@
 #ifndef QLEVER_SRC_INDEX_COMPRESSEDRELATION_H
 #define QLEVER_SRC_INDEX_COMPRESSEDRELATION_H
 
+#include <mutex>
 #include <type_traits>
 #include <vector>
 
 #include "backports/algorithm.h"
 #include "engine/idTable/IdTable.h"
 #include "global/Id.h"
+#include "index/ColumnCodec.h"
+#include "index/DecompressedBlockCache.h"
 #include "index/KeyOrder.h"
 #include "index/ScanSpecification.h"
 #include "parser/data/LimitOffsetClause.h"
+#include "util/AsyncFileReader.h"
+#include "util/BloomFilter.h"
 #include "util/CancellationHandle.h"
 #include "util/File.h"
 #include "util/Generator.h"
+#include "util/MemoryMappedFile.h"
 #include "util/MemorySize/MemorySize.h"
 #include "util/Serializer/SerializeArrayOrTuple.h"
 #include "util/Serializer/SerializeOptional.h"
@@ -28,6 +34,7 @@
 class IdTable;
 
 class LocatedTriplesPerBlock;
+class BlockMetadataSearchIndex;
 
 // This type is used to buffer small relations that will be stored in the same
 // block.
@@ -46,6 +53,17 @@ struct DecompressedBlockAndMetadata {
   // True iff triples this block had to be merged with the `LocatedTriples`
   // because it contained updates.
   bool containsUpdates_;
+  // The number of columns of this block that were found/not found in the
+  // `DecompressedBlockCache`.
+  size_t numBlockCacheHits_ = 0;
+  size_t numBlockCacheMisses_ = 0;
+  // The number of rows of this block that were discarded by the late
+  // materialization because their value in the join column doesn't occur in
+  // the other input of the join (see `ScanImplConfig::joinColumnFilter_`).
+  size_t numRowsDiscardedByLateMaterialization_ = 0;
+  // True iff none of the rows of this block survived the late materialization,
+  // so only the join column was read from disk and decompressed.
+  bool skippedByLateMaterialization_ = false;
 };
 
 // After compression the columns have different sizes, so we cannot use an
@@ -59,6 +77,8 @@ struct CompressedBlockMetadataNoBlockIndex {
   struct OffsetAndCompressedSize {
     off_t offsetInFile_;
     size_t compressedSize_;
+    // The codec with which the column was compressed (see `ColumnCodec`).
+    ColumnCodec codec_ = ColumnCodec::Zstd;
     bool operator==(const OffsetAndCompressedSize&) const = default;
   };
 
@@ -112,6 +132,81 @@ struct CompressedBlockMetadataNoBlockIndex {
   // blocks.
   bool containsDuplicatesWithDifferentGraphs_;
 
+  // The range of the `Id`s of a single `Datatype` in a column of the block:
+  // the smallest and the largest `Id` (w.r.t. the order of `Id`s) and the
+  // number of `Id`s of this datatype.
+  struct DatatypeRange {
+    Id min_;
+    Id max_;
+    size_t count_;
+    bool operator==(const DatatypeRange&) const = default;
+
+    template <typename T>
+    friend std::true_type allowTrivialSerialization(DatatypeRange, T);
+  };
+  // The "zone map" of a column of the block: one `DatatypeRange` for each
+  // datatype that occurs in the column, sorted by `min_`. Note that
+  // `VocabIndex` and `LocalVocabIndex` (which can only occur via updates)
+  // share a single `DatatypeRange`, because they are interleaved in the order
+  // of `Id`s. This means that the `min_` and `max_` of all the ranges form a
+  // sorted sequence of `Id`s.
+  using ZoneMap = std::vector<DatatypeRange>;
+
+  // The number of columns (the first three, that is, all columns except for
+  // the graph and the payload columns) for which zone maps are stored.
+  static constexpr size_t numColumnsWithZoneMaps = 3;
+
+  // The zone maps of the first `numColumnsWithZoneMaps` columns of the block.
+  // In contrast to `firstTriple_` and `lastTriple_`, these also allow the
+  // pruning of blocks w.r.t. columns that are not sorted (see
+  // `PrefilterExpression::evaluateWithZoneMaps`). Empty if no zone maps are
+  // available, then the block can't be pruned using them.
+  std::vector<ZoneMap> zoneMaps_{};
+
+  // Compute the zone map for the given `column`.
+  static ZoneMap computeZoneMap(ql::span<const Id> column);
+
+  // Add the `id` to the `zoneMap`, e.g. for a triple that is inserted into
+  // the block via an update.
+  static void addToZoneMap(ZoneMap& zoneMap, Id id);
+
+  // The first column and the number of columns for which Bloom filters can be
+  // stored. These are the columns that are used as join columns in
+  // `CompressedRelationReader::getBlocksForJoin` for scans with a fixed
+  // `col0Id` (col1) or fixed `col0Id` and `col1Id` (col2).
+  static constexpr size_t firstColumnWithBloomFilter = 1;
+  static constexpr size_t numColumnsWithBloomFilters = 2;
+
+  // The Bloom filters of the `Id`s in the columns
+  // `firstColumnWithBloomFilter, firstColumnWithBloomFilter + 1, ...` of the
+  // block. They allow skipping blocks in joins if the range of the block
+  // overlaps with the join column, but none of the `Id`s actually occurs in the
+  // block. Empty if no Bloom filters are available (they are optional during
+  // the index build, see `CompressedRelationWriter`).
+  std::vector<ad_utility::BloomFilter> bloomFilters_{};
+
+  // Compute the Bloom filter for the given `column` with `bitsPerKey` bits per
+  // distinct `Id`.
+  static ad_utility::BloomFilter computeBloomFilter(ql::span<const Id> column,
+                                                    size_t bitsPerKey);
+
+  // Add the `id` to the `bloomFilter`, e.g. for a triple that is inserted into
+  // the block via an update.
+  static void addToBloomFilter(ad_utility::BloomFilter& bloomFilter, Id id);
+
+  // Return false if the `id` definitely doesn't occur in the column with the
+  // given `columnIndex` of the block according to its Bloom filters, and true
+  // if it might occur (in particular, if there is no Bloom filter for the
+  // column).
+  bool mayContain(size_t columnIndex, Id id) const;
+
+  // The blocksize (in number of rows) that the `CompressedRelationWriter`
+  // chose for this block (see
+  // `CompressedRelationWriter::blocksizeForLargeRelation`). The actual
+  // `numRows_` can be smaller (e.g. for the last block of a relation) or larger
+  // (for blocks of small relations). 0 if unknown.
+  size_t blocksize_ = 0;
+
   // Check for constant values in `firstTriple_` and `lastTriple` over all
   // columns `< columnIndex`.
   // Returns `true` if the respective column values of `firstTriple_` and
@@ -132,7 +227,8 @@ struct CompressedBlockMetadataNoBlockIndex {
       const CompressedBlockMetadataNoBlockIndex& blockMetadata) {
     str << "#CompressedBlockMetadata\n(first) " << blockMetadata.firstTriple_
         << "(last) " << blockMetadata.lastTriple_
-        << "num. rows: " << blockMetadata.numRows_ << ".\n";
+        << "num. rows: " << blockMetadata.numRows_
+        << ", blocksize: " << blockMetadata.blocksize_ << ".\n";
     if (blockMetadata.graphInfo_.has_value()) {
       str << "Graphs: ";
       ad_utility::lazyStrJoin(&str, blockMetadata.graphInfo_.value(), ", ");
@@ -168,6 +264,7 @@ struct CompressedBlockMetadata : CompressedBlockMetadataNoBlockIndex {
 AD_SERIALIZE_FUNCTION(CompressedBlockMetadata::OffsetAndCompressedSize) {
   serializer | arg.offsetInFile_;
   serializer | arg.compressedSize_;
+  serializer | arg.codec_;
 }
 
 // Serialization of the block metadata.
@@ -178,6 +275,9 @@ AD_SERIALIZE_FUNCTION(CompressedBlockMetadata) {
   serializer | arg.lastTriple_;
   serializer | arg.graphInfo_;
   serializer | arg.containsDuplicatesWithDifferentGraphs_;
+  serializer | arg.zoneMaps_;
+  serializer | arg.bloomFilters_;
+  serializer | arg.blocksize_;
   serializer | arg.blockIndex_;
 }
 
@@ -252,6 +352,18 @@ class CompressedRelationWriter {
   // A buffer for small relations that will be stored in the same block.
   SmallRelationsBuffer smallRelationsBuffer_{numColumns_, allocator_};
   ad_utility::MemorySize uncompressedBlocksizePerColumn_;
+  // The number of bits per distinct `Id` of the Bloom filters that are stored
+  // in the block metadata (see
+  // `CompressedBlockMetadataNoBlockIndex::bloomFilters_`). If 0, then no
+  // Bloom filters are stored.
+  size_t bloomFilterBitsPerKey_;
+  // If true, all columns are stored with `ColumnCodec::Uncompressed` at
+  // offsets that are aligned for `Id`s, s.t. the `CompressedRelationReader` can
+  // use them directly from a memory mapping of the file.
+  bool storeUncompressed_;
+  // If true, the blocksize of each large relation is chosen adaptively, see
+  // `blocksizeForLargeRelation`.
+  bool adaptiveBlocksize_;
 
   // When we store a large relation with multiple blocks then we keep track of
   // its `col0Id`, mostly for sanity checks.
@@ -275,10 +387,15 @@ class CompressedRelationWriter {
   /// Create using a filename, to which the relation data will be written.
   explicit CompressedRelationWriter(
       size_t numColumns, ad_utility::File f,
-      ad_utility::MemorySize uncompressedBlocksizePerColumn)
+      ad_utility::MemorySize uncompressedBlocksizePerColumn,
+      size_t bloomFilterBitsPerKey = 0, bool storeUncompressed = false,
+      bool adaptiveBlocksize = false)
       : outfile_{std::move(f)},
         numColumns_{numColumns},
-        uncompressedBlocksizePerColumn_{uncompressedBlocksizePerColumn} {}
+        uncompressedBlocksizePerColumn_{uncompressedBlocksizePerColumn},
+        bloomFilterBitsPerKey_{bloomFilterBitsPerKey},
+        storeUncompressed_{storeUncompressed},
+        adaptiveBlocksize_{adaptiveBlocksize} {}
   // Two helper types used to make the interface of the function
   // `createPermutationPair` below safer and more explicit.
   using MetadataCallback =
@@ -354,6 +471,44 @@ class CompressedRelationWriter {
     return uncompressedBlocksizePerColumn_.getBytes() / sizeof(Id);
   }
 
+  // For adaptive blocksizes (see `blocksizeForLargeRelation`): The factor by
+  // which the blocks can be smaller or larger than the `blocksize()`.
+  static constexpr size_t adaptiveBlocksizeFactor = 4;
+  // Relations with at most this many rows per distinct `col1Id` get smaller
+  // blocks.
+  static constexpr size_t maxRowsPerCol1ForSmallBlocks = 16;
+  // Relations with at least this many times `blocksize()` rows get larger
+  // blocks.
+  static constexpr size_t minNumBlocksForLargeBlocks = 16;
+  size_t minNumRowsForLargeBlocks() const {
+    return minNumBlocksForLargeBlocks * blocksize();
+  }
+
+  // Return the blocksize (in number of triples) for all blocks of a large
+  // relation with `numRows` rows and `numDistinctCol1` distinct `col1Id`s.
+  // This is chosen once per relation and permutation, so the two permutations
+  // of a pair can have different blocksizes for the same relation. Without
+  // `adaptiveBlocksize_`, this is always the `blocksize()`. Otherwise:
+  // * Huge relations (at least `minNumRowsForLargeBlocks()` rows) are
+  //   typically scanned in large ranges, so they get larger blocks, which
+  //   reduces the number of blocks and the size of their metadata. The
+  //   `numDistinctCol1` is not needed for them and may be `std::nullopt`.
+  // * Relations with few rows per `col1Id` (e.g. functional predicates in PSO)
+  //   are typically queried with a fixed `col1Id`. For such point lookups only
+  //   a few rows are needed, but a complete block has to be decompressed, so
+  //   these relations get smaller blocks.
+  // * Relations with many rows per `col1Id` (e.g. `rdf:type` in POS) are
+  //   typically scanned in large ranges, so they get larger blocks.
+  size_t blocksizeForLargeRelation(size_t numRows,
+                                   std::optional<size_t> numDistinctCol1) const;
+
+  // Write the given `block` (which must be sorted and not empty) as a single
+  // block with the given `blocksize` (see `blocksizeForLargeRelation`), and
+  // without creating any relation metadata. This is used to rewrite single
+  // blocks of an existing permutation (see `Permutation::writeCompactedBlocks`)
+  // and must not be mixed with calls to the functions that add relations.
+  void addCompleteBlock(std::shared_ptr<IdTable> block, size_t blocksize);
+
  private:
   /// Finish writing all relations which have previously been added, but might
   /// still be in some internal buffer.
@@ -371,8 +526,10 @@ class CompressedRelationWriter {
   // data of the written block. Then clear `smallRelationsBuffer_`.
   void writeBufferedRelationsToSingleBlock();
 
-  // Compress the `column` and write it to the `outfile_`. Return the offset and
-  // size of the compressed column in the `outfile_`.
+  // Compress the `column` using the best `ColumnCodec` for its contents (see
+  // `columnCodec::compressWithBestCodec`), or store it uncompressed if
+  // `storeUncompressed_` is set, and write it to the `outfile_`. Return the
+  // offset, size, and codec of the compressed column in the `outfile_`.
   CompressedBlockMetadata::OffsetAndCompressedSize compressAndWriteColumn(
       ql::span<const Id> column);
 
@@ -380,14 +537,14 @@ class CompressedRelationWriter {
   size_t numColumns() const { return numColumns_; }
 
   // Compress the given `block` and write it to the `outfile_`. The
-  // `firstCol0Id` and `lastCol0Id` are needed to set up the block's metadata
-  // which is appended to the internal buffer. If `invokeCallback` is true and
-  // the `smallBlocksCallback_` is not empty, then
+  // `firstCol0Id`, `lastCol0Id`, and `blocksize` are needed to set up the
+  // block's metadata which is appended to the internal buffer. If
+  // `invokeCallback` is true and the `smallBlocksCallback_` is not empty, then
   // `smallBlocksCallback_(std::move(block))` is called AFTER the block has
   // completely been dealt with.
   void compressAndWriteBlock(Id firstCol0Id, Id lastCol0Id,
                              std::shared_ptr<IdTable> block,
-                             bool invokeCallback);
+                             bool invokeCallback, size_t blocksize);
 
   // Add a small relation that will be stored in a single block, possibly
   // together with other small relations.
@@ -402,7 +559,11 @@ class CompressedRelationWriter {
   // `finishLargeRelation`.
   // * The previously called function was `addBlockForLargeRelation` with the
   // same `col0Id`.
-  void addBlockForLargeRelation(Id col0Id, std::shared_ptr<IdTable> relation);
+  // The `blocksize` is the blocksize that was chosen for the block (see
+  // `blocksizeForLargeRelation`), the default is `blocksize()`.
+  void addBlockForLargeRelation(
+      Id col0Id, std::shared_ptr<IdTable> relation,
+      std::optional<size_t> blocksize = std::nullopt);
 
   // This function must be called after all blocks of a large relation have been
   // added via `addBlockForLargeRelation` before any other function may be
@@ -415,10 +576,12 @@ class CompressedRelationWriter {
   // Add a complete large relation by calling `addBlockForLargeRelation` for
   // each block in the `sortedBlocks` and then calling `finishLargeRelation`.
   // The number of distinct col1 entries will be computed from the blocks
-  // directly.
+  // directly. The `blocksize` is the blocksize that was chosen for the
+  // relation (see `blocksizeForLargeRelation`).
   template <typename T>
   CompressedRelationMetadata addCompleteLargeRelation(Id col0Id,
-                                                      T&& sortedBlocks);
+                                                      T&& sortedBlocks,
+                                                      size_t blocksize);
 
   // This is a function in `CompressedRelationsTest.cpp` that tests the
   // internals of this class and therefore needs private access.
@@ -426,7 +589,8 @@ class CompressedRelationWriter {
   friend std::pair<std::vector<CompressedBlockMetadata>,
                    std::vector<CompressedRelationMetadata>>
   compressedRelationTestWriteCompressedRelations(
-      T inputs, std::string filename, ad_utility::MemorySize blocksize);
+      T inputs, std::string filename, ad_utility::MemorySize blocksize,
+      bool storeUncompressed);
 };
 
 using namespace std::string_view_literals;
@@ -486,6 +650,13 @@ class CompressedRelationReader {
     ColumnIndices scanColumns_;
     FilterDuplicatesAndGraphs graphFilter_;
     const LocatedTriplesPerBlock& locatedTriples_;
+    // If set, the scan is only used as an input to a join with this (sorted)
+    // join column. The join column of the scan is its first column (see
+    // `getBlocksForJoin`). Rows of the scan whose value in the join column
+    // doesn't occur in the `joinColumnFilter_` can then be discarded, and the
+    // remaining columns of a block only have to be read and decompressed if at
+    // least one of its rows survives ("late materialization").
+    std::optional<ql::span<const Id>> joinColumnFilter_ = std::nullopt;
   };
 
   // The specification of scan, together with the blocks on which this scan is
@@ -511,6 +682,14 @@ class CompressedRelationReader {
     ScanSpecAndBlocks(ScanSpecification scanSpec,
                       const BlockMetadataRanges& blockMetadataRanges);
 
+    // Same as above, but for all the `blocks` of a permutation, using the
+    // given `searchIndex` (which must have been built from these `blocks` or
+    // from a copy of them) to find the relevant blocks. In this case, the
+    // invariant check (4) is only performed for the relevant blocks, so that
+    // the construction is sublinear in the number of blocks.
+    ScanSpecAndBlocks(ScanSpecification scanSpec, BlockMetadataSpan blocks,
+                      const BlockMetadataSearchIndex& searchIndex);
+
     // Direct view access via `ql::views::join` over all
     // `CompressedBlockMetadata` values contained in `BlockMetadatatRanges
     // blockMetadata_`.
@@ -569,11 +748,23 @@ class CompressedRelationReader {
     // actually yield.
     size_t numElementsRead_ = 0;
     size_t numElementsYielded_ = 0;
+    // The number of block columns that could be taken from the
+    // `DecompressedBlockCache` and the number of block columns that had to be
+    // read from disk and decompressed although the cache was enabled.
+    size_t numBlockCacheHits_ = 0;
+    size_t numBlockCacheMisses_ = 0;
+    // The number of blocks of which only the join column was read, because
+    // none of their rows can match the other input of a join, and the total
+    // number of rows that were discarded for this reason (see
+    // `ScanImplConfig::joinColumnFilter_`).
+    size_t numBlocksSkippedByLateMaterialization_ = 0;
+    size_t numElementsDiscardedByLateMaterialization_ = 0;
     std::chrono::milliseconds blockingTime_ = std::chrono::milliseconds::zero();
 
     // Update this metadata, given the metadata from `blockAndMetadata`.
     // Currently updates: `numBlocksPostprocessed_`, `numBlocksWithUpdate_`,
-    // `numElementsRead_`, and `numBlocksRead_`.
+    // `numElementsRead_`, `numBlocksRead_`, the block cache statistics, and the
+    // statistics of the late materialization.
     void update(const DecompressedBlockAndMetadata& blockAndMetadata);
     // `nullopt` means the block was skipped because of the graph filters, else
     // call the overload directly above.
@@ -593,9 +784,27 @@ class CompressedRelationReader {
   // The file that stores the actual permutations.
   ad_utility::File file_;
 
+  // A process-wide unique ID of this reader, which is used to distinguish the
+  // blocks of different permutations in the `DecompressedBlockCache`.
+  size_t blockCacheId_;
+
+  // A memory mapping of the `file_`, see `enableMemoryMapping`.
+  std::optional<ad_utility::MemoryMappedFile> memoryMappedFile_;
+
  public:
   explicit CompressedRelationReader(Allocator allocator, ad_utility::File file)
-      : allocator_{std::move(allocator)}, file_{std::move(file)} {}
+      : allocator_{std::move(allocator)},
+        file_{std::move(file)},
+        blockCacheId_{getNextBlockCacheId()} {}
+
+  // Map the `file_` into memory. Afterwards, the columns that are stored with
+  // `ColumnCodec::Uncompressed` (see the `storeUncompressed` argument of the
+  // `CompressedRelationWriter`) are not read from the file anymore, but used
+  // directly from the mapping, and `scanAsView` becomes available.
+  void enableMemoryMapping() {
+    memoryMappedFile_.emplace(file_.fileDescriptor());
+  }
+  bool usesMemoryMapping() const { return memoryMappedFile_.has_value(); }
 
   // Get the blocks (an ordered subset of the blocks that are passed in via the
   // `metadataAndBlocks`) where the `col1Id` can theoretically match one of the
@@ -643,15 +852,38 @@ class CompressedRelationReader {
                const LocatedTriplesPerBlock& locatedTriplesPerBlock,
                const LimitOffsetClause& limitOffset = {}) const;
 
+  // Like `scan` (directly above) without a LIMIT or OFFSET, but return a view
+  // of the result that directly refers to the memory mapping of the file
+  // instead of copying it (zero-copy). This is only possible if the memory
+  // mapping is enabled (see `enableMemoryMapping`), and if the result is a
+  // contiguous range of a single block the needed columns of which are stored
+  // uncompressed, and which has no located triples and no duplicates or graph
+  // filters. Otherwise, `std::nullopt` is returned and `scan` has to be used.
+  // The view is valid as long as this reader is alive.
+  std::optional<IdTableView<0>> scanAsView(
+      const ScanSpecAndBlocks& scanSpecAndBlocks,
+      ColumnIndicesRef additionalColumns,
+      const LocatedTriplesPerBlock& locatedTriplesPerBlock) const;
+
   // Similar to `scan` (directly above), but the result of the scan is lazily
   // computed and returned as a generator of the single blocks that are scanned.
   // The blocks are guaranteed to be in order.
+  //
+  // If a `joinColumnFilter` is specified, the result is only used as the input
+  // of a join with this sorted column, where the join column of the scan is
+  // its first column. The generator then may (but doesn't have to) omit rows
+  // that have no join partner in the `joinColumnFilter`, and only reads the
+  // remaining columns of a block from disk if the block contains at least one
+  // row with a join partner (late materialization). The `joinColumnFilter`
+  // must stay valid while the generator is used, and it must be
+  // `std::nullopt` if the `limitOffset` is not unconstrained.
   CompressedRelationReader::IdTableGenerator lazyScan(
       ScanSpecification scanSpec,
       std::vector<CompressedBlockMetadata> relevantBlockMetadata,
       ColumnIndices additionalColumns, CancellationHandle cancellationHandle,
       const LocatedTriplesPerBlock& locatedTriplesPerBlock,
-      LimitOffsetClause limitOffset = {}) const;
+      LimitOffsetClause limitOffset = {},
+      std::optional<ql::span<const Id>> joinColumnFilter = std::nullopt) const;
 
   // Get the exact size of the result of the scan, taking the given located
   // triples into account. This requires locating the triples exactly in each
@@ -713,6 +945,13 @@ class CompressedRelationReader {
       const ScanSpecification& scanSpec,
       const BlockMetadataRanges& blockMetadata);
 
+  // Same as above, but for all the `blocks` of a permutation and with the
+  // lookup done via the given `searchIndex` (see `BlockMetadataSearchIndex`),
+  // which must have been built from these `blocks` or from a copy of them.
+  static BlockMetadataRanges getRelevantBlocks(
+      const ScanSpecification& scanSpec, BlockMetadataSpan blocks,
+      const BlockMetadataSearchIndex& searchIndex);
+
   // Get the first and the last triple that the result of a `scan` with the
   // given arguments would lead to. Return `nullopt` if the scan result would
   // be empty. This function is used to more efficiently filter the blocks of
@@ -726,27 +965,108 @@ class CompressedRelationReader {
   // Get access to the underlying allocator
   const Allocator& allocator() const { return allocator_; }
 
+  // Read and decompress all the columns of the given block, exactly as they
+  // are stored on disk (without merging any located triples).
+  DecompressedBlock readCompleteBlock(
+      const CompressedBlockMetadata& blockMetadata) const;
+
  private:
+  // A block as it is read from disk. Columns that are contained in the
+  // `DecompressedBlockCache` are not read from disk, but are directly taken
+  // from the cache and stored in `cachedColumns_` (the corresponding entry of
+  // `compressedColumns_` then stays empty). For all other columns, the entry in
+  // `cachedColumns_` is `nullptr`.
+  struct CompressedBlockAndCachedColumns {
+    // The offsets of the columns in the file, which identify them in the
+    // `DecompressedBlockCache`.
+    std::vector<size_t> offsetsInFile_;
+    ColumnIndices columnIndices_;
+    CompressedBlock compressedColumns_;
+    // The codecs of the `compressedColumns_`.
+    std::vector<ColumnCodec> codecs_;
+    std::vector<DecompressedBlockCache::ColumnPtr> cachedColumns_;
+    // Uncompressed columns that are directly used from the
+    // `memoryMappedFile_`. For these, the corresponding entries of
+    // `compressedColumns_` and `cachedColumns_` stay empty.
+    std::vector<ql::span<const char>> mappedColumns_{};
+    size_t numBlockCacheHits_ = 0;
+    size_t numBlockCacheMisses_ = 0;
+  };
+
+  // Return a new process-wide unique ID for the `blockCacheId_`.
+  static size_t getNextBlockCacheId();
+
+  // The key of the column at the given offset in the `file_` in the
+  // `DecompressedBlockCache`.
+  DecompressedBlockCache::Key blockCacheKey(size_t offsetInFile) const {
+    return {blockCacheId_, offsetInFile};
+  }
+
+  // Return the bytes of the column with the given `offset` from the
+  // `memoryMappedFile_`, or an empty span if the file is not mapped, if the
+  // column is not stored uncompressed, or if the column was appended to the
+  // file after the mapping was created (see
+  // `Permutation::writeCompactedBlocks`).
+  ql::span<const char> getMappedColumn(
+      const CompressedBlockMetadata::OffsetAndCompressedSize& offset) const;
+
   // Read the block that is identified by the `blockMetaData` from the `file`.
-  // Only the columns specified by `columnIndices` are read.
-  CompressedBlock readCompressedBlockFromFile(
+  // Only the columns specified by `columnIndices` are read. Columns that are
+  // contained in the `DecompressedBlockCache` are not read, but taken from the
+  // cache.
+  CompressedBlockAndCachedColumns readCompressedBlockFromFile(
       const CompressedBlockMetadata& blockMetaData,
       ColumnIndicesRef columnIndices) const;
 
+  // Like `readCompressedBlockFromFile`, but don't read the columns from the
+  // file. Instead, allocate the buffers for the compressed columns and append
+  // the corresponding read requests to the `readRequests`, such that reads
+  // for several blocks can be issued in a single batch. The buffers stay
+  // valid when the returned object is moved.
+  CompressedBlockAndCachedColumns prepareReadOfCompressedBlock(
+      const CompressedBlockMetadata& blockMetaData,
+      ColumnIndicesRef columnIndices,
+      std::vector<ad_utility::AsyncFileReader::ReadRequest>& readRequests)
+      const;
+
   // Decompress the `compressedBlock`. The number of rows that the block will
   // have after decompression must be passed in via the `numRowsToRead`
   // argument. It is typically obtained from the corresponding
-  // `CompressedBlockMetaData`.
-  DecompressedBlock decompressBlock(const CompressedBlock& compressedBlock,
-                                    size_t numRowsToRead) const;
-
-  // Helper function used by `decompressBlock` and
-  // `decompressBlockToExistingIdTable`. Decompress the `compressedColumn` and
-  // store the result at the `iterator`. For the `numRowsToRead` argument, see
-  // the documentation of `decompressBlock`.
-  template <typename Iterator>
-  static void decompressColumn(const std::vector<char>& compressedColumn,
-                               size_t numRowsToRead, Iterator iterator);
+  // `CompressedBlockMetaData`. Columns that had to be decompressed are added
+  // to the `DecompressedBlockCache`.
+  DecompressedBlock decompressBlock(
+      const CompressedBlockAndCachedColumns& compressedBlock,
+      size_t numRowsToRead) const;
+
+  // Helper function used by `decompressBlock`. Decompress the
+  // `compressedColumn`, which was compressed using the `codec`, and store the
+  // result in the `target`, the size of which must be the number of rows of
+  // the block.
+  static void decompressColumn(ColumnCodec codec,
+                               ql::span<const char> compressedColumn,
+                               ql::span<Id> target);
+
+  // Helper function used by `decompressBlock` and `scanInParallel`. Write the
+  // `i`-th column of the `compressedBlock` to the `target`, the size of which
+  // must be the number of rows of the block. The column is either copied from
+  // the `DecompressedBlockCache` or from the `memoryMappedFile_`, or it is
+  // decompressed (and then added to the cache).
+  void decompressColumnOfBlock(
+      const CompressedBlockAndCachedColumns& compressedBlock, size_t i,
+      ql::span<Id> target) const;
+
+  // The implementation of `scan` for scans without a LIMIT or OFFSET. The
+  // first and the last block (which might be incomplete) and the blocks that
+  // need postprocessing (because of located triples, graphs, or duplicates)
+  // are read as usual. All the other blocks are read and decompressed in
+  // parallel, with one task per column and block, directly into their final
+  // position in the preallocated result.
+  IdTable scanInParallel(const ScanSpecification& scanSpec,
+                         std::vector<CompressedBlockMetadata> blocks,
+                         ColumnIndicesRef additionalColumns,
+                         const CancellationHandle& cancellationHandle,
+                         const LocatedTriplesPerBlock& locatedTriplesPerBlock)
+      const;
 
   // Read and decompress the parts of the block given by `blockMetaData` (which
   // identifies the block) and `scanConfig` (which specifies the part of that
@@ -755,11 +1075,36 @@ class CompressedRelationReader {
       const CompressedBlockMetadata& blockMetaData,
       const ScanImplConfig& scanConfig) const;
 
+  // Like `readAndDecompressBlock`, but for a scan with a `joinColumnFilter_`
+  // (see `ScanImplConfig`). First only the join column of the block is read
+  // and decompressed. The remaining columns are only read and decompressed if
+  // at least one row of the block has a join partner, and only the rows with
+  // a join partner are materialized. Must only be called for complete blocks
+  // without located triples, where the join column is sorted.
+  DecompressedBlockAndMetadata readAndDecompressBlockWithLateMaterialization(
+      const CompressedBlockMetadata& blockMetaData,
+      const ScanImplConfig& scanConfig) const;
+
+  // Read, decompress, and postprocess the `blocks` (which are consecutive
+  // blocks of a lazy scan). The reads for all blocks are issued as a single
+  // batch via the `AsyncFileReader`. With `io_uring`, the `lock` (which
+  // protects the iteration over the blocks) is released before reading, and
+  // each block is decompressed as soon as all its columns have been read.
+  // Otherwise, the reads happen while holding the `lock` to avoid contention
+  // of the file, and the decompression happens after releasing it. The
+  // result contains `std::nullopt` for blocks that are skipped because of the
+  // graph filter.
+  std::vector<std::optional<DecompressedBlockAndMetadata>>
+  readAndDecompressBlockBatch(ql::span<const CompressedBlockMetadata> blocks,
+                              const ScanImplConfig& scanConfig,
+                              std::unique_lock<std::mutex>& lock) const;
+
   // Like `readAndDecompressBlock`, and postprocess by merging the located
   // triples (if any) and applying the graph filters (if any), both specified
   // as part of the `scanConfig`.
   DecompressedBlockAndMetadata decompressAndPostprocessBlock(
-      const CompressedBlock& compressedBlock, size_t numRowsToRead,
+      const CompressedBlockAndCachedColumns& compressedBlock,
+      size_t numRowsToRead,
       const CompressedRelationReader::ScanImplConfig& scanConfig,
       const CompressedBlockMetadata& metadata) const;
 
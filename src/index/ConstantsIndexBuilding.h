@@ -110,4 +110,9 @@ constexpr inline size_t NumColumnsIndexBuilding = 4;
 // is stored in the metadata of the block.
 constexpr inline size_t MAX_NUM_GRAPHS_STORED_IN_BLOCK_METADATA = 20;
 
+// The minimal number of triples of an update that are located by a single
+// thread (see `LocatedTriple::locateTriplesInPermutation`). Smaller updates
+// are processed sequentially for all permutations.
+constexpr inline size_t MIN_NUM_TRIPLES_PER_LOCATE_CHUNK = 100'000;
+
 #endif  // QLEVER_SRC_INDEX_CONSTANTSINDEXBUILDING_H
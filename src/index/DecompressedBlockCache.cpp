@@ -0,0 +1,65 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "index/DecompressedBlockCache.h"
+
+#include "global/RuntimeParameters.h"
+
+// _____________________________________________________________________________
+DecompressedBlockCache::DecompressedBlockCache(ad_utility::MemorySize maxSize)
+    : cache_{ad_utility::size_t_max, maxSize, maxSize},
+      maxSizeInBytes_{maxSize.getBytes()} {}
+
+// _____________________________________________________________________________
+DecompressedBlockCache& DecompressedBlockCache::get() {
+  static DecompressedBlockCache cache{
+      RuntimeParameters().get<"decompressed-block-cache-max-size">()};
+  // Register the update action only once. Note: `setOnUpdateAction` directly
+  // triggers the action, which is harmless because the value is already set.
+  static const bool onUpdateActionIsRegistered = []() {
+    RuntimeParameters().setOnUpdateAction<"decompressed-block-cache-max-size">(
+        [](ad_utility::MemorySize newSize) { cache.setMaxSize(newSize); });
+    return true;
+  }();
+  (void)onUpdateActionIsRegistered;
+  return cache;
+}
+
+// _____________________________________________________________________________
+auto DecompressedBlockCache::lookup(const Key& key) -> ColumnPtr {
+  auto result = (*cache_.wlock())[key];
+  if (result) {
+    ++numHits_;
+  } else {
+    ++numMisses_;
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+void DecompressedBlockCache::insert(const Key& key, Column column) {
+  auto lock = cache_.wlock();
+  if (lock->contains(key)) {
+    return;
+  }
+  lock->insert(key, std::move(column));
+}
+
+// _____________________________________________________________________________
+void DecompressedBlockCache::setMaxSize(ad_utility::MemorySize maxSize) {
+  auto lock = cache_.wlock();
+  lock->setMaxSizeSingleEntry(maxSize);
+  lock->setMaxSize(maxSize);
+  maxSizeInBytes_ = maxSize.getBytes();
+}
+
+// _____________________________________________________________________________
+void DecompressedBlockCache::clear() { cache_.wlock()->clearAll(); }
+
+// _____________________________________________________________________________
+auto DecompressedBlockCache::getStatistics() const -> Statistics {
+  auto lock = cache_.rlock();
+  return {lock->numNonPinnedEntries(), lock->nonPinnedSize(),
+          ad_utility::MemorySize::bytes(maxSizeInBytes_.load()),
+          numHits_.load(), numMisses_.load()};
+}
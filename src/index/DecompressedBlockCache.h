@@ -0,0 +1,109 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_INDEX_DECOMPRESSEDBLOCKCACHE_H
+#define QLEVER_SRC_INDEX_DECOMPRESSEDBLOCKCACHE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "global/Id.h"
+#include "util/Cache.h"
+#include "util/MemorySize/MemorySize.h"
+#include "util/Synchronized.h"
+
+// A size-bounded cache for the decompressed columns of the blocks of the
+// permutations. The cache is shared between all `CompressedRelationReader`s
+// and therefore between all concurrent queries, such that hot blocks (e.g.
+// those of `rdf:type` or `rdfs:label`) only have to be read from disk and
+// decompressed once. The cache stores the columns exactly as they are stored
+// on disk, that is, BEFORE merging the located triples and applying the graph
+// filters, so updates never invalidate its contents.
+//
+// The maximum size of the cache is controlled by the runtime parameter
+// `decompressed-block-cache-max-size`. A maximum size of zero disables the
+// cache completely.
+class DecompressedBlockCache {
+ public:
+  // The key of a cached column: A `CompressedRelationReader` (identified by a
+  // process-wide unique ID, see `CompressedRelationReader::blockCacheId_`) and
+  // the offset of the column in the file of that reader. The offset (unlike
+  // the index of the block) stays the same when the blocks of a permutation
+  // are rewritten by a compaction, which only appends new blocks to the file
+  // (see `Permutation::writeCompactedBlocks`).
+  struct Key {
+    size_t readerId_;
+    size_t offsetInFile_;
+
+    bool operator==(const Key&) const = default;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.readerId_, key.offsetInFile_);
+    }
+  };
+
+  using Column = std::vector<Id>;
+  using ColumnPtr = std::shared_ptr<const Column>;
+
+  // Statistics about the cache, e.g. for the `cache-stats` command of the
+  // server.
+  struct Statistics {
+    size_t numEntries_;
+    ad_utility::MemorySize size_;
+    ad_utility::MemorySize maxSize_;
+    size_t numHits_;
+    size_t numMisses_;
+  };
+
+ private:
+  // The memory used by a cached column.
+  struct ColumnSizeGetter {
+    ad_utility::MemorySize operator()(const Column& column) const {
+      return ad_utility::MemorySize::bytes(sizeof(Column) +
+                                           column.size() * sizeof(Id));
+    }
+  };
+  using Cache = ad_utility::LRUCache<Key, Column, ColumnSizeGetter>;
+
+  ad_utility::Synchronized<Cache> cache_;
+  // The maximum size in bytes, stored separately s.t. `isEnabled()` doesn't
+  // have to lock the cache.
+  std::atomic<size_t> maxSizeInBytes_;
+  std::atomic<size_t> numHits_ = 0;
+  std::atomic<size_t> numMisses_ = 0;
+
+ public:
+  // Create a cache with the given maximal size. Only used for testing, all
+  // the readers share the single instance that is obtained via `get()`.
+  explicit DecompressedBlockCache(ad_utility::MemorySize maxSize);
+
+  // Get the global instance that is shared by all `CompressedRelationReader`s.
+  // Its maximum size is kept in sync with the runtime parameter
+  // `decompressed-block-cache-max-size`.
+  static DecompressedBlockCache& get();
+
+  // Return true iff the cache is enabled, i.e. its maximum size is not zero.
+  bool isEnabled() const { return maxSizeInBytes_.load() > 0; }
+
+  // Return the cached column for the `key` or `nullptr` if it is not
+  // contained. Updates the hit/miss statistics.
+  ColumnPtr lookup(const Key& key);
+
+  // Insert the `column` for the given `key`. If the `key` is already contained
+  // (because another thread has decompressed the same column concurrently),
+  // or if the `column` is too large for the cache, nothing happens.
+  void insert(const Key& key, Column column);
+
+  // Change the maximum size of the cache, evicting entries if necessary.
+  void setMaxSize(ad_utility::MemorySize maxSize);
+
+  // Remove all entries from the cache. The statistics are not reset.
+  void clear();
+
+  // Return the current statistics of this cache.
+  Statistics getStatistics() const;
+};
+
+#endif  // QLEVER_SRC_INDEX_DECOMPRESSEDBLOCKCACHE_H
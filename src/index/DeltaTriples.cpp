@@ -13,15 +13,20 @@
 
 #include <absl/strings/str_cat.h>
 
+#include <thread>
+
+#include "global/RuntimeParameters.h"
 #include "index/Index.h"
 #include "index/IndexImpl.h"
 #include "index/LocatedTriples.h"
+#include "util/Algorithm.h"
+#include "util/RunTasksInParallel.h"
 #include "util/Serializer/TripleSerializer.h"
 
 // ____________________________________________________________________________
-LocatedTriples::iterator& DeltaTriples::LocatedTripleHandles::forPermutation(
+size_t& DeltaTriples::LocatedTripleHandles::forPermutation(
     Permutation::Enum permutation) {
-  return handles_[static_cast<size_t>(permutation)];
+  return blockIndices_[static_cast<size_t>(permutation)];
 }
 
 // ____________________________________________________________________________
@@ -29,6 +34,104 @@ void DeltaTriples::clear() {
   triplesInserted_.clear();
   triplesDeleted_.clear();
   ql::ranges::for_each(locatedTriples(), &LocatedTriplesPerBlock::clear);
+  // The update log can't express the clearing, so the next `writeToDisk()`
+  // has to write a checkpoint.
+  updatesNotYetLogged_.clear();
+  needsCheckpoint_ = true;
+  recordModificationOfAllTriples();
+}
+
+namespace {
+// Call `function(permutation, numThreads)` for each of the six permutations,
+// where `numThreads` is the number of threads that the call may use itself.
+// For an update with fewer than `MIN_NUM_TRIPLES_PER_LOCATE_CHUNK` triples,
+// the calls are made sequentially, because starting the threads would cost
+// more than the work itself. Otherwise, the permutations are processed
+// concurrently and share one budget of threads (one per hardware thread). If
+// one of the calls throws, the exception is rethrown after all the running
+// calls have finished (the `function` typically refers to local variables of
+// the caller).
+template <typename F>
+void forAllPermutations(size_t numTriples, const F& function) {
+  const std::vector<Permutation::Enum> permutations{Permutation::ALL};
+  const size_t numThreads =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  if (numTriples < MIN_NUM_TRIPLES_PER_LOCATE_CHUNK || numThreads == 1) {
+    for (auto permutation : permutations) {
+      function(permutation, size_t{1});
+    }
+    return;
+  }
+  const size_t numThreadsPerPermutation =
+      std::max(numThreads / permutations.size(), size_t{1});
+  ad_utility::runTasksInParallel(
+      permutations.size(), numThreads, [&](size_t i) {
+        function(permutations[i], numThreadsPerPermutation);
+      });
+}
+}  // namespace
+
+// ____________________________________________________________________________
+DeltaTriples::BlockMetadataPerPermutation
+DeltaTriples::getBlockMetadataForLocating() const {
+  // The blocks of the permutation change with each compaction (see
+  // `DeltaTriplesManager::compact`), so the triples are located in the
+  // original metadata of the located triples, if it has been set.
+  // TODO<qup42>: replace with `getAugmentedMetadata` once integration
+  //  is done
+  BlockMetadataPerPermutation result;
+  for (auto permutation : Permutation::ALL) {
+    const auto& locatedTriplesPerBlock =
+        getLocatedTriplesForPermutation(permutation);
+    if (locatedTriplesPerBlock.hasOriginalMetadata()) {
+      result[static_cast<size_t>(permutation)] =
+          locatedTriplesPerBlock.getOriginalMetadata();
+    }
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+DeltaTriples::LocatedTriplesPerPermutation DeltaTriples::locateTriples(
+    const IndexImpl& index, const BlockMetadataPerPermutation& blockMetadata,
+    ql::span<const IdTriple<0>> triples, bool insertOrDelete,
+    const CancellationHandle& cancellationHandle) {
+  LocatedTriplesPerPermutation result;
+  forAllPermutations(triples.size(), [&](Permutation::Enum permutation,
+                                         size_t numThreads) {
+    auto i = static_cast<size_t>(permutation);
+    const auto& perm = index.getPermutation(permutation);
+    ql::span<const CompressedBlockMetadata> blocks =
+        blockMetadata[i] != nullptr ? *blockMetadata[i]
+                                    : perm.metaData().blockData();
+    result[i] = LocatedTriple::locateTriplesInPermutation(
+        triples, blocks, perm.keyOrder(), insertOrDelete, cancellationHandle,
+        numThreads);
+  });
+  cancellationHandle->throwIfCancelled();
+  return result;
+}
+
+// ____________________________________________________________________________
+std::vector<DeltaTriples::LocatedTripleHandles>
+DeltaTriples::addLocatedTriples(
+    const LocatedTriplesPerPermutation& locatedTriples) {
+  size_t numTriples = locatedTriples[0].size();
+  std::vector<DeltaTriples::LocatedTripleHandles> handles{numTriples};
+  // Each permutation only modifies its own `LocatedTriplesPerBlock` and its
+  // own entry of each of the `handles`.
+  forAllPermutations(numTriples, [&](Permutation::Enum permutation, size_t) {
+    const auto& locatedTriplesForPermutation =
+        locatedTriples[static_cast<size_t>(permutation)];
+    AD_CORRECTNESS_CHECK(locatedTriplesForPermutation.size() == numTriples);
+    this->locatedTriples()[static_cast<size_t>(permutation)].add(
+        locatedTriplesForPermutation);
+    for (size_t i = 0; i < numTriples; i++) {
+      handles[i].forPermutation(permutation) =
+          locatedTriplesForPermutation[i].blockIndex_;
+    }
+  });
+  return handles;
 }
 
 // ____________________________________________________________________________
@@ -36,39 +139,120 @@ std::vector<DeltaTriples::LocatedTripleHandles>
 DeltaTriples::locateAndAddTriples(CancellationHandle cancellationHandle,
                                   ql::span<const IdTriple<0>> triples,
                                   bool insertOrDelete) {
-  std::array<std::vector<LocatedTriples::iterator>, Permutation::ALL.size()>
-      intermediateHandles;
-  for (auto permutation : Permutation::ALL) {
-    auto& perm = index_.getPermutation(permutation);
-    auto locatedTriples = LocatedTriple::locateTriplesInPermutation(
-        // TODO<qup42>: replace with `getAugmentedMetadata` once integration
-        //  is done
-        triples, perm.metaData().blockData(), perm.keyOrder(), insertOrDelete,
-        cancellationHandle);
-    cancellationHandle->throwIfCancelled();
-    intermediateHandles[static_cast<size_t>(permutation)] =
-        this->locatedTriples()[static_cast<size_t>(permutation)].add(
-            locatedTriples);
-    cancellationHandle->throwIfCancelled();
-  }
-  std::vector<DeltaTriples::LocatedTripleHandles> handles{triples.size()};
+  return addLocatedTriples(locateTriples(index_, getBlockMetadataForLocating(),
+                                         triples, insertOrDelete,
+                                         cancellationHandle));
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::eraseTriplesInAllPermutations(
+    ql::span<const IdTriple<0>> triples,
+    ql::span<const LocatedTripleHandles> handles) {
+  AD_CORRECTNESS_CHECK(triples.size() == handles.size());
+  if (triples.empty()) {
+    return;
+  }
+  // Erase for all permutations, with one batch per permutation.
+  std::vector<LocatedTriple> locatedTriplesToErase;
+  locatedTriplesToErase.reserve(triples.size());
   for (auto permutation : Permutation::ALL) {
-    for (size_t i = 0; i < triples.size(); i++) {
-      handles[i].forPermutation(permutation) =
-          intermediateHandles[static_cast<size_t>(permutation)][i];
+    auto i = static_cast<size_t>(permutation);
+    // Only the `blockIndex_` and the `triple_` of the `LocatedTriple` are
+    // relevant for the erasure.
+    const auto& keyOrder = index_.getPermutation(permutation).keyOrder();
+    locatedTriplesToErase.clear();
+    for (size_t j = 0; j < triples.size(); ++j) {
+      locatedTriplesToErase.push_back(LocatedTriple{
+          handles[j].blockIndices_[i], triples[j].permute(keyOrder), false});
     }
+    locatedTriples()[i].erase(locatedTriplesToErase);
   }
-  return handles;
 }
 
 // ____________________________________________________________________________
-void DeltaTriples::eraseTripleInAllPermutations(LocatedTripleHandles& handles) {
-  // Erase for all permutations.
-  for (auto permutation : Permutation::ALL) {
-    auto ltIter = handles.forPermutation(permutation);
-    locatedTriples()[static_cast<int>(permutation)].erase(ltIter->blockIndex_,
-                                                          ltIter);
+DeltaTriples::Triples DeltaTriples::getCompactableTriples(
+    bool insertOrDelete) const {
+  auto isLocalId = [minLocalBlankNode =
+                        index_.getBlankNodeManager()->minIndex_](Id id) {
+    return id.getDatatype() == Datatype::LocalVocabIndex ||
+           (id.getDatatype() == Datatype::BlankNodeIndex &&
+            id.getBlankNodeIndex().get() >= minLocalBlankNode);
+  };
+  const auto& map = insertOrDelete ? triplesInserted_ : triplesDeleted_;
+  Triples result;
+  for (const auto& triple : map | ql::views::keys) {
+    if (ql::ranges::none_of(triple.ids(), isLocalId)) {
+      result.push_back(triple);
+    }
   }
+  ql::ranges::sort(result);
+  return result;
+}
+
+// ____________________________________________________________________________
+size_t DeltaTriples::finishCompaction(
+    std::vector<std::pair<Permutation::Enum,
+                          std::vector<CompressedBlockMetadata>>>
+        newBlocks,
+    const Triples& insertedTriples, const Triples& deletedTriples) {
+  // The new blocks are only correct if each of the compacted triples is still
+  // contained in the delta triples. If its status has changed (from inserted
+  // to deleted or vice versa), the delta triple is still correct for the new
+  // blocks. If it is missing, the delta triples have been cleared in the
+  // meantime.
+  auto isDeltaTriple = [this](const IdTriple<0>& triple) {
+    return triplesInserted_.contains(triple) ||
+           triplesDeleted_.contains(triple);
+  };
+  if (!ql::ranges::all_of(insertedTriples, isDeltaTriple) ||
+      !ql::ranges::all_of(deletedTriples, isDeltaTriple)) {
+    for (const auto& [permutation, blocks] : newBlocks) {
+      index_.getPermutation(permutation).abortCompaction();
+    }
+    return 0;
+  }
+  for (auto& [permutation, blocks] : newBlocks) {
+    index_.getPermutation(permutation).commitCompaction(blocks);
+    setOriginalMetadata(
+        permutation,
+        std::make_shared<const std::vector<CompressedBlockMetadata>>(
+            std::move(blocks)));
+  }
+
+  // Remove the triples that are now contained in the permutations.
+  size_t numCompacted = 0;
+  for (const auto& triple : insertedTriples) {
+    numCompacted += triplesInserted_.erase(triple);
+  }
+  for (const auto& triple : deletedTriples) {
+    numCompacted += triplesDeleted_.erase(triple);
+  }
+
+  // The block indices of the remaining delta triples refer to the old blocks,
+  // so all of them have to be located again.
+  ql::ranges::for_each(locatedTriples(), &LocatedTriplesPerBlock::clear);
+  auto cancellationHandle =
+      std::make_shared<CancellationHandle::element_type>();
+  for (bool insertOrDelete : {true, false}) {
+    auto& map = insertOrDelete ? triplesInserted_ : triplesDeleted_;
+    Triples triples;
+    ql::ranges::copy(map | ql::views::keys, std::back_inserter(triples));
+    ql::ranges::sort(triples);
+    auto handles =
+        locateAndAddTriples(cancellationHandle, triples, insertOrDelete);
+    for (size_t i = 0; i < triples.size(); ++i) {
+      map.at(triples[i]) = handles[i];
+    }
+  }
+
+  // The update log can't express the compaction, so the next `writeToDisk()`
+  // has to write a checkpoint.
+  needsCheckpoint_ = true;
+  // The blocks of all the permutations have been replaced, so none of the
+  // cached results is reused (like before the compaction, when each snapshot
+  // invalidated all of them).
+  recordModificationOfAllTriples();
+  return numCompacted;
 }
 
 // ____________________________________________________________________________
@@ -82,8 +266,8 @@ void DeltaTriples::insertTriples(CancellationHandle cancellationHandle,
   LOG(DEBUG) << "Inserting"
              << " " << triples.size()
              << " triples (including idempotent triples)." << std::endl;
-  modifyTriplesImpl(std::move(cancellationHandle), std::move(triples), true,
-                    triplesInserted_, triplesDeleted_);
+  modifyTriplesImpl(std::move(cancellationHandle),
+                    stageTriples(std::move(triples), true));
 }
 
 // ____________________________________________________________________________
@@ -92,8 +276,34 @@ void DeltaTriples::deleteTriples(CancellationHandle cancellationHandle,
   LOG(DEBUG) << "Deleting"
              << " " << triples.size()
              << " triples (including idempotent triples)." << std::endl;
-  modifyTriplesImpl(std::move(cancellationHandle), std::move(triples), false,
-                    triplesDeleted_, triplesInserted_);
+  modifyTriplesImpl(std::move(cancellationHandle),
+                    stageTriples(std::move(triples), false));
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::applyStagedTriples(CancellationHandle cancellationHandle,
+                                      StagedTriples stagedTriples) {
+  LOG(DEBUG) << (stagedTriples.insertOrDelete_ ? "Inserting" : "Deleting")
+             << " " << stagedTriples.triples_.size()
+             << " staged triples (including idempotent triples)." << std::endl;
+  modifyTriplesImpl(std::move(cancellationHandle), std::move(stagedTriples));
+}
+
+// ____________________________________________________________________________
+DeltaTriples::StagedTriples DeltaTriples::stageTriples(Triples triples,
+                                                       bool insertOrDelete) {
+  rewriteLocalVocabEntriesAndBlankNodes(triples);
+  return {std::move(triples), insertOrDelete, getBlockMetadataForLocating(),
+          std::nullopt};
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::locateStagedTriples(
+    const IndexImpl& index, StagedTriples& stagedTriples,
+    const CancellationHandle& cancellationHandle) {
+  stagedTriples.locatedTriples_ = locateTriples(
+      index, stagedTriples.blockMetadata_, stagedTriples.triples_,
+      stagedTriples.insertOrDelete_, cancellationHandle);
 }
 
 // ____________________________________________________________________________
@@ -153,30 +363,75 @@ void DeltaTriples::rewriteLocalVocabEntriesAndBlankNodes(Triples& triples) {
 
 // ____________________________________________________________________________
 void DeltaTriples::modifyTriplesImpl(CancellationHandle cancellationHandle,
-                                     Triples triples, bool insertOrDelete,
-                                     TriplesToHandlesMap& targetMap,
-                                     TriplesToHandlesMap& inverseMap) {
-  rewriteLocalVocabEntriesAndBlankNodes(triples);
+                                     StagedTriples stagedTriples) {
+  auto& [triples, insertOrDelete, blockMetadata, locatedTriples] =
+      stagedTriples;
+  auto& targetMap = insertOrDelete ? triplesInserted_ : triplesDeleted_;
+  auto& inverseMap = insertOrDelete ? triplesDeleted_ : triplesInserted_;
   AD_EXPENSIVE_CHECK(ql::ranges::is_sorted(triples));
   AD_EXPENSIVE_CHECK(std::unique(triples.begin(), triples.end()) ==
                      triples.end());
-  std::erase_if(triples, [&targetMap](const IdTriple<0>& triple) {
-    return targetMap.contains(triple);
-  });
-  ql::ranges::for_each(triples, [this, &inverseMap](const IdTriple<0>& triple) {
+  // The triples that are already contained in the `targetMap` are idempotent.
+  // They are removed from the `triples` and (if the triples have already been
+  // located) from the located triples for each permutation.
+  std::vector<bool> isIdempotent = ad_utility::transform(
+      triples, [&targetMap](const IdTriple<0>& triple) {
+        return targetMap.contains(triple);
+      });
+  auto eraseIdempotent = [&isIdempotent](auto& elements) {
+    size_t numKept = 0;
+    for (size_t i = 0; i < elements.size(); ++i) {
+      if (!isIdempotent[i]) {
+        elements[numKept] = std::move(elements[i]);
+        ++numKept;
+      }
+    }
+    elements.erase(elements.begin() + numKept, elements.end());
+  };
+  if (std::find(isIdempotent.begin(), isIdempotent.end(), true) !=
+      isIdempotent.end()) {
+    eraseIdempotent(triples);
+    if (locatedTriples.has_value()) {
+      ql::ranges::for_each(locatedTriples.value(), eraseIdempotent);
+    }
+  }
+  recordModification(triples);
+  // Remember the effective updates for the update log (see `writeToDisk()`).
+  if (filenameForPersisting_.has_value() && !triples.empty()) {
+    auto& record = updatesNotYetLogged_.emplace_back();
+    record.insertOrDelete_ = insertOrDelete;
+    record.ids_.reserve(triples.size() * IdTriple<0>::NumCols);
+    for (const auto& triple : triples) {
+      ql::ranges::copy(triple.ids(), std::back_inserter(record.ids_));
+    }
+  }
+  // The triples that are contained in the `inverseMap` cancel out.
+  Triples triplesToErase;
+  std::vector<LocatedTripleHandles> handlesToErase;
+  for (const auto& triple : triples) {
     auto handle = inverseMap.find(triple);
     if (handle != inverseMap.end()) {
-      eraseTripleInAllPermutations(handle->second);
-      inverseMap.erase(triple);
+      triplesToErase.push_back(triple);
+      handlesToErase.push_back(handle->second);
+      inverseMap.erase(handle);
     }
-  });
-  // Manually update the block metadata, because `eraseTripleInAllPermutations`
+  }
+  eraseTriplesInAllPermutations(triplesToErase, handlesToErase);
+  // Manually update the block metadata, because `eraseTriplesInAllPermutations`
   // does not update them for performance reason.
-  ql::ranges::for_each(locatedTriples(),
+  ql::ranges::for_each(this->locatedTriples(),
                        &LocatedTriplesPerBlock::updateAugmentedMetadata);
 
-  std::vector<LocatedTripleHandles> handles = locateAndAddTriples(
-      std::move(cancellationHandle), triples, insertOrDelete);
+  // If the triples were staged before a compaction replaced the blocks of the
+  // permutations, they have to be located again.
+  if (!locatedTriples.has_value() ||
+      blockMetadata != getBlockMetadataForLocating()) {
+    blockMetadata = getBlockMetadataForLocating();
+    locatedTriples = locateTriples(index_, blockMetadata, triples,
+                                   insertOrDelete, cancellationHandle);
+  }
+  std::vector<LocatedTripleHandles> handles =
+      addLocatedTriples(locatedTriples.value());
 
   AD_CORRECTNESS_CHECK(triples.size() == handles.size());
   // TODO<qup42>: replace with ql::views::zip in C++23
@@ -185,6 +440,94 @@ void DeltaTriples::modifyTriplesImpl(CancellationHandle cancellationHandle,
   }
 }
 
+// ____________________________________________________________________________
+void DeltaTriples::addToUndo(const StagedTriples& stagedTriples,
+                             ModificationUndo& undo) const {
+  bool insertOrDelete = stagedTriples.insertOrDelete_;
+  const auto& targetMap = insertOrDelete ? triplesInserted_ : triplesDeleted_;
+  const auto& inverseMap = insertOrDelete ? triplesDeleted_ : triplesInserted_;
+  auto& wereInInverseMap =
+      insertOrDelete ? undo.wereDeleted_ : undo.wereInserted_;
+  for (const auto& triple : stagedTriples.triples_) {
+    if (inverseMap.contains(triple)) {
+      wereInInverseMap.push_back(triple);
+    } else if (!targetMap.contains(triple)) {
+      undo.wereNoDeltaTriples_.push_back(triple);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::applyUndo(const ModificationUndo& undo) {
+  auto toSortedTriples = [](const auto& triples) {
+    Triples result{triples.begin(), triples.end()};
+    ql::ranges::sort(result);
+    return result;
+  };
+  auto cancellationHandle =
+      std::make_shared<CancellationHandle::element_type>();
+  eraseTriples(toSortedTriples(undo.wereNoDeltaTriples_));
+  insertTriples(cancellationHandle, toSortedTriples(undo.wereInserted_));
+  deleteTriples(cancellationHandle, toSortedTriples(undo.wereDeleted_));
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::eraseTriples(const Triples& triples) {
+  Triples triplesToErase;
+  std::vector<LocatedTripleHandles> handlesToErase;
+  for (const auto& triple : triples) {
+    for (auto* map : {&triplesInserted_, &triplesDeleted_}) {
+      auto handle = map->find(triple);
+      if (handle != map->end()) {
+        triplesToErase.push_back(triple);
+        handlesToErase.push_back(handle->second);
+        map->erase(handle);
+      }
+    }
+  }
+  eraseTriplesInAllPermutations(triplesToErase, handlesToErase);
+  ql::ranges::for_each(this->locatedTriples(),
+                       &LocatedTriplesPerBlock::updateAugmentedMetadata);
+  recordModification(triplesToErase);
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::recordModification(const Triples& triples) {
+  if (triples.empty()) {
+    return;
+  }
+  lastModification_ = nextSnapshotIndex_;
+  // The map is shared with the existing snapshots, so it is copied.
+  auto lastModificationPerPredicate =
+      std::make_shared<ad_utility::HashMap<Id, size_t>>(
+          *lastModificationPerPredicate_);
+  for (const auto& triple : triples) {
+    (*lastModificationPerPredicate)[triple.ids()[1]] = nextSnapshotIndex_;
+  }
+  lastModificationPerPredicate_ = std::move(lastModificationPerPredicate);
+}
+
+// ____________________________________________________________________________
+void DeltaTriples::recordModificationOfAllTriples() {
+  lastModificationPerPredicate_ =
+      std::make_shared<const ad_utility::HashMap<Id, size_t>>();
+  lastModificationOfAllPredicates_ = nextSnapshotIndex_;
+  lastModification_ = nextSnapshotIndex_;
+}
+
+// ____________________________________________________________________________
+size_t LocatedTriplesSnapshot::lastModificationOfPredicate(Id predicate) const {
+  // The IDs of the local vocab are not stable, so they are not looked up.
+  if (predicate.getDatatype() == Datatype::LocalVocabIndex) {
+    return lastModification_;
+  }
+  auto it = lastModificationPerPredicate_->find(predicate);
+  if (it == lastModificationPerPredicate_->end()) {
+    return lastModificationOfAllPredicates_;
+  }
+  return std::max(it->second, lastModificationOfAllPredicates_);
+}
+
 // ____________________________________________________________________________
 const LocatedTriplesPerBlock&
 LocatedTriplesSnapshot::getLocatedTriplesForPermutation(
@@ -196,11 +539,14 @@ LocatedTriplesSnapshot::getLocatedTriplesForPermutation(
 SharedLocatedTriplesSnapshot DeltaTriples::getSnapshot() {
   // NOTE: Both members of the `LocatedTriplesSnapshot` are copied, but the
   // `localVocab_` has no copy constructor (in order to avoid accidental
-  // copies), hence the explicit `clone`.
+  // copies), hence the explicit `clone`. Copying the `locatedTriples()` only
+  // copies one pointer per block with updates.
   auto snapshotIndex = nextSnapshotIndex_;
   ++nextSnapshotIndex_;
   return SharedLocatedTriplesSnapshot{std::make_shared<LocatedTriplesSnapshot>(
-      locatedTriples(), localVocab_.getLifetimeExtender(), snapshotIndex)};
+      locatedTriples(), localVocab_.getLifetimeExtender(), snapshotIndex,
+      lastModificationPerPredicate_, lastModificationOfAllPredicates_,
+      lastModification_)};
 }
 
 // ____________________________________________________________________________
@@ -226,6 +572,11 @@ DeltaTriplesManager::DeltaTriplesManager(const IndexImpl& index)
     : deltaTriples_{index},
       currentLocatedTriplesSnapshot_{deltaTriples_.wlock()->getSnapshot()} {}
 
+// _____________________________________________________________________________
+DeltaTriplesManager::~DeltaTriplesManager() {
+  compactionCancellationHandle_->cancel(ad_utility::CancellationState::MANUAL);
+}
+
 // _____________________________________________________________________________
 template <typename ReturnType>
 ReturnType DeltaTriplesManager::modify(
@@ -257,9 +608,11 @@ ReturnType DeltaTriplesManager::modify(
         if constexpr (std::is_void_v<ReturnType>) {
           function(deltaTriples);
           writeAndUpdateSnapshot();
+          maybeStartCompaction(deltaTriples);
         } else {
           ReturnType returnValue = function(deltaTriples);
           writeAndUpdateSnapshot();
+          maybeStartCompaction(deltaTriples);
           return returnValue;
         }
       });
@@ -273,6 +626,8 @@ template nlohmann::json DeltaTriplesManager::modify<nlohmann::json>(
 template DeltaTriplesCount DeltaTriplesManager::modify<DeltaTriplesCount>(
     const std::function<DeltaTriplesCount(DeltaTriples&)>&,
     bool writeToDiskAfterRequest);
+template size_t DeltaTriplesManager::modify<size_t>(
+    const std::function<size_t(DeltaTriples&)>&, bool writeToDiskAfterRequest);
 
 // _____________________________________________________________________________
 void DeltaTriplesManager::clear() { modify<void>(&DeltaTriples::clear); }
@@ -292,10 +647,38 @@ void DeltaTriples::setOriginalMetadata(
 }
 
 // _____________________________________________________________________________
-void DeltaTriples::writeToDisk() const {
+std::filesystem::path DeltaTriples::filenameOfUpdateLog() const {
+  AD_CONTRACT_CHECK(filenameForPersisting_.has_value());
+  return absl::StrCat(filenameForPersisting_.value(), ".wal");
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::writeToDisk() {
   if (!filenameForPersisting_.has_value()) {
     return;
   }
+  size_t numTriplesNotYetLogged = 0;
+  for (const auto& record : updatesNotYetLogged_) {
+    numTriplesNotYetLogged += record.ids_.size() / IdTriple<0>::NumCols;
+  }
+  size_t numTriplesInUpdateLog =
+      numTriplesInUpdateLog_ + numTriplesNotYetLogged;
+  size_t maxNumTriplesInUpdateLog =
+      std::max(static_cast<size_t>(numInserted() + numDeleted()),
+               minNumTriplesInUpdateLogForCheckpoint);
+  if (needsCheckpoint_ ||
+      !std::filesystem::exists(filenameForPersisting_.value()) ||
+      numTriplesInUpdateLog > maxNumTriplesInUpdateLog) {
+    writeCheckpoint();
+  } else if (!updatesNotYetLogged_.empty()) {
+    ad_utility::appendToUpdateLog(filenameOfUpdateLog(), updatesNotYetLogged_);
+    numTriplesInUpdateLog_ = numTriplesInUpdateLog;
+  }
+  updatesNotYetLogged_.clear();
+}
+
+// _____________________________________________________________________________
+void DeltaTriples::writeCheckpoint() {
   auto toRange = [](const TriplesToHandlesMap& map) {
     return map | ql::views::keys |
            ql::views::transform(
@@ -310,6 +693,12 @@ void DeltaTriples::writeToDisk() const {
       tempPath, localVocab_,
       std::array{toRange(triplesDeleted_), toRange(triplesInserted_)});
   std::filesystem::rename(tempPath, filenameForPersisting_.value());
+  // If we crash before the update log is removed, it is replayed on top of the
+  // new checkpoint after the restart. This is harmless because the state of a
+  // triple only depends on the last update that affected it.
+  std::filesystem::remove(filenameOfUpdateLog());
+  numTriplesInUpdateLog_ = 0;
+  needsCheckpoint_ = false;
 }
 
 // _____________________________________________________________________________
@@ -318,12 +707,11 @@ void DeltaTriples::readFromDisk() {
     return;
   }
   AD_CONTRACT_CHECK(localVocab_.empty());
+  // The checkpoint and the update log refer to the same blank nodes.
+  ad_utility::BlankNodeMapping blankNodeMapping;
   auto [vocab, idRanges] = ad_utility::deserializeIds(
-      filenameForPersisting_.value(), index_.getBlankNodeManager());
-  if (idRanges.empty()) {
-    return;
-  }
-  AD_CORRECTNESS_CHECK(idRanges.size() == 2);
+      filenameForPersisting_.value(), index_.getBlankNodeManager(),
+      blankNodeMapping);
   auto toTriples = [](const std::vector<Id>& ids) {
     Triples triples;
     static_assert(Triples::value_type::PayloadSize == 0);
@@ -338,11 +726,47 @@ void DeltaTriples::readFromDisk() {
   };
   auto cancellationHandle =
       std::make_shared<CancellationHandle::element_type>();
-  insertTriples(cancellationHandle, toTriples(idRanges.at(1)));
-  deleteTriples(cancellationHandle, toTriples(idRanges.at(0)));
-  AD_LOG_INFO << "Done, #inserted triples = " << idRanges.at(1).size()
-              << ", #deleted triples = " << idRanges.at(0).size() << std::endl;
+  if (!idRanges.empty()) {
+    AD_CORRECTNESS_CHECK(idRanges.size() == 2);
+    // Use the local vocab of the checkpoint, so that its blank nodes are kept
+    // as they are (see `rewriteLocalVocabEntriesAndBlankNodes`) and the blank
+    // nodes of the update log are mapped to the same ones.
+    localVocab_ = std::move(vocab);
+    insertTriples(cancellationHandle, toTriples(idRanges.at(1)));
+    deleteTriples(cancellationHandle, toTriples(idRanges.at(0)));
+    AD_LOG_INFO << "Done, #inserted triples = " << idRanges.at(1).size()
+                << ", #deleted triples = " << idRanges.at(0).size()
+                << std::endl;
+  }
+
+  auto updateLog = ad_utility::readUpdateLog(
+      filenameOfUpdateLog(), localVocab_, index_.getBlankNodeManager(),
+      blankNodeMapping);
+  for (const auto& record : updateLog) {
+    if (record.insertOrDelete_) {
+      insertTriples(cancellationHandle, toTriples(record.ids_));
+    } else {
+      deleteTriples(cancellationHandle, toTriples(record.ids_));
+    }
+  }
+  // The replayed updates are already persisted.
+  updatesNotYetLogged_.clear();
+  if (!updateLog.empty()) {
+    AD_LOG_INFO << "Replayed " << updateLog.size()
+                << " updates from the update log, #inserted triples = "
+                << numInserted() << ", #deleted triples = " << numDeleted()
+                << std::endl;
+  }
+  // The blank nodes were assigned new indices when reading them, but updates
+  // that are appended to the log from now on refer to the new indices. The
+  // checkpoint therefore has to be rewritten with the new indices as well,
+  // otherwise both files could not be mapped consistently after the next
+  // restart.
+  if (!updateLog.empty() || !blankNodeMapping.empty()) {
+    writeCheckpoint();
+  }
 }
+
 // _____________________________________________________________________________
 void DeltaTriples::setPersists(std::optional<std::string> filename) {
   filenameForPersisting_ = std::move(filename);
@@ -358,3 +782,186 @@ void DeltaTriplesManager::setFilenameForPersistentUpdatesAndReadFromDisk(
       },
       false);
 }
+
+// _____________________________________________________________________________
+size_t DeltaTriplesManager::compact(CancellationHandle cancellationHandle) {
+  std::lock_guard compactionLock{compactionMutex_};
+
+  // Get the triples that can be compacted and the current blocks of each
+  // permutation.
+  Triples insertedTriples;
+  Triples deletedTriples;
+  std::vector<std::pair<Permutation::Enum, LocatedTriplesPerBlock>>
+      locatedTriplesPerPermutation;
+  const IndexImpl* index = nullptr;
+  deltaTriples_.withWriteLock([&](const DeltaTriples& deltaTriples) {
+    AD_CONTRACT_CHECK(deltaTriples.filenameForPersisting_.has_value(),
+                      "The delta triples can only be compacted if they are "
+                      "persisted");
+    index = &deltaTriples.index_;
+    insertedTriples = deltaTriples.getCompactableTriples(true);
+    deletedTriples = deltaTriples.getCompactableTriples(false);
+    for (auto permutation : Permutation::ALL) {
+      const auto& locatedTriples =
+          deltaTriples.getLocatedTriplesForPermutation(permutation);
+      if (index->getPermutation(permutation).isLoaded() &&
+          locatedTriples.hasOriginalMetadata()) {
+        locatedTriplesPerPermutation.emplace_back(permutation,
+                                                  LocatedTriplesPerBlock{});
+        locatedTriplesPerPermutation.back().second.setOriginalMetadata(
+            locatedTriples.getOriginalMetadata());
+      }
+    }
+  });
+  if ((insertedTriples.empty() && deletedTriples.empty()) ||
+      locatedTriplesPerPermutation.empty()) {
+    return 0;
+  }
+
+  // Write the new blocks without holding the lock.
+  std::vector<
+      std::pair<Permutation::Enum, std::vector<CompressedBlockMetadata>>>
+      newBlocks;
+  try {
+    for (auto& [permutation, locatedTriples] : locatedTriplesPerPermutation) {
+      const auto& perm = index->getPermutation(permutation);
+      for (bool insertOrDelete : {true, false}) {
+        locatedTriples.add(LocatedTriple::locateTriplesInPermutation(
+            insertOrDelete ? insertedTriples : deletedTriples,
+            *locatedTriples.getOriginalMetadata(), perm.keyOrder(),
+            insertOrDelete, cancellationHandle,
+            std::max(std::thread::hardware_concurrency(), 1u)));
+      }
+      newBlocks.emplace_back(
+          permutation,
+          perm.writeCompactedBlocks(locatedTriples, cancellationHandle));
+    }
+  } catch (...) {
+    // Also abort the compaction of the permutation that failed.
+    for (const auto& [permutation, locatedTriples] :
+         locatedTriplesPerPermutation) {
+      index->getPermutation(permutation).abortCompaction();
+    }
+    throw;
+  }
+
+  // Install the new blocks and remove the compacted triples.
+  return modify<size_t>([&](DeltaTriples& deltaTriples) {
+    size_t numCompacted = deltaTriples.finishCompaction(
+        std::move(newBlocks), insertedTriples, deletedTriples);
+    numDeltaTriplesAfterLastCompaction_ = static_cast<size_t>(
+        deltaTriples.numInserted() + deltaTriples.numDeleted());
+    AD_LOG_INFO << "Compacted " << numCompacted
+                << " delta triples into the permutations, #inserted triples = "
+                << deltaTriples.numInserted()
+                << ", #deleted triples = " << deltaTriples.numDeleted()
+                << std::endl;
+    return numCompacted;
+  });
+}
+
+// _____________________________________________________________________________
+DeltaTriples::StagedUpdate DeltaTriplesManager::stageUpdate(
+    CancellationHandle cancellationHandle, Triples toDelete,
+    Triples toInsert) {
+  const IndexImpl* index = nullptr;
+  auto stagedUpdate = deltaTriples_.withWriteLock(
+      [&index, &toDelete, &toInsert](DeltaTriples& deltaTriples) {
+        index = &deltaTriples.index_;
+        return DeltaTriples::StagedUpdate{
+            deltaTriples.stageTriples(std::move(toDelete), false),
+            deltaTriples.stageTriples(std::move(toInsert), true)};
+      });
+  // Locate the triples without holding the lock.
+  DeltaTriples::locateStagedTriples(*index, stagedUpdate.toDelete_,
+                                    cancellationHandle);
+  DeltaTriples::locateStagedTriples(*index, stagedUpdate.toInsert_,
+                                    cancellationHandle);
+  return stagedUpdate;
+}
+
+// _____________________________________________________________________________
+DeltaTriplesManager::BatchedModification::BatchedModification(
+    DeltaTriplesManager& manager,
+    ad_utility::AllocatorWithLimit<IdTriple<0>> allocator)
+    : manager_{manager},
+      compactionLock_{manager.compactionMutex_},
+      allocator_{std::move(allocator)} {
+  manager_.deltaTriples_.withWriteLock([this](DeltaTriples& deltaTriples) {
+    countsBefore_ = deltaTriples.getCounts();
+    numUpdatesNotYetLoggedBefore_ = deltaTriples.updatesNotYetLogged_.size();
+  });
+}
+
+// _____________________________________________________________________________
+DeltaTriplesManager::BatchedModification::~BatchedModification() {
+  if (isCommitted_) {
+    return;
+  }
+  try {
+    rollBack();
+  } catch (const std::exception& e) {
+    AD_LOG_ERROR << "Rolling back a modification of the delta triples failed: "
+                 << e.what() << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+void DeltaTriplesManager::BatchedModification::applyBatch(
+    CancellationHandle cancellationHandle, Triples toDelete,
+    Triples toInsert) {
+  AD_CONTRACT_CHECK(!isCommitted_);
+  auto stagedUpdate = manager_.stageUpdate(
+      cancellationHandle, std::move(toDelete), std::move(toInsert));
+  auto& undo = undoPerBatch_.emplace_back(allocator_);
+  manager_.deltaTriples_.withWriteLock([&](DeltaTriples& deltaTriples) {
+    // The undo is complete before the batch is applied, so that a batch that
+    // is only partially applied (because of an exception) is rolled back
+    // correctly.
+    deltaTriples.addToUndo(stagedUpdate.toDelete_, undo);
+    deltaTriples.addToUndo(stagedUpdate.toInsert_, undo);
+    deltaTriples.applyStagedTriples(cancellationHandle,
+                                    std::move(stagedUpdate.toDelete_));
+    deltaTriples.applyStagedTriples(cancellationHandle,
+                                    std::move(stagedUpdate.toInsert_));
+  });
+}
+
+// _____________________________________________________________________________
+void DeltaTriplesManager::BatchedModification::rollBack() {
+  manager_.deltaTriples_.withWriteLock([this](DeltaTriples& deltaTriples) {
+    for (const auto& undo : undoPerBatch_ | ql::views::reverse) {
+      deltaTriples.applyUndo(undo);
+    }
+    auto& updatesNotYetLogged = deltaTriples.updatesNotYetLogged_;
+    updatesNotYetLogged.erase(
+        updatesNotYetLogged.begin() + numUpdatesNotYetLoggedBefore_,
+        updatesNotYetLogged.end());
+  });
+}
+
+// _____________________________________________________________________________
+void DeltaTriplesManager::maybeStartCompaction(
+    const DeltaTriples& deltaTriples) {
+  size_t threshold =
+      RuntimeParameters().get<"delta-triples-compaction-threshold">();
+  auto numDeltaTriples = static_cast<size_t>(deltaTriples.numInserted() +
+                                             deltaTriples.numDeleted());
+  if (threshold == 0 || !deltaTriples.filenameForPersisting_.has_value() ||
+      numDeltaTriples < numDeltaTriplesAfterLastCompaction_ + threshold ||
+      compactionIsRunning_.exchange(true)) {
+    return;
+  }
+  // The previous thread (if any) has already finished, see below.
+  compactionThread_ = ad_utility::JThread{[this]() {
+    try {
+      compact(compactionCancellationHandle_);
+    } catch (const ad_utility::CancellationException&) {
+      // The server is shutting down.
+    } catch (const std::exception& e) {
+      AD_LOG_ERROR << "The compaction of the delta triples failed: "
+                   << e.what() << std::endl;
+    }
+    compactionIsRunning_ = false;
+  }};
+}
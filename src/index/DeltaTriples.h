@@ -12,13 +12,20 @@
 #ifndef QLEVER_SRC_INDEX_DELTATRIPLES_H
 #define QLEVER_SRC_INDEX_DELTATRIPLES_H
 
+#include <atomic>
+#include <mutex>
+
 #include "engine/LocalVocab.h"
 #include "global/IdTriple.h"
 #include "index/Index.h"
 #include "index/IndexBuilderTypes.h"
 #include "index/LocatedTriples.h"
 #include "index/Permutation.h"
+#include "util/AllocatorWithLimit.h"
+#include "util/HashMap.h"
+#include "util/Serializer/TripleSerializer.h"
 #include "util/Synchronized.h"
+#include "util/jthread.h"
 
 // Typedef for one `LocatedTriplesPerBlock` object for each of the six
 // permutations.
@@ -35,11 +42,30 @@ struct LocatedTriplesSnapshot {
   // The `DeltaTriples` class may concurrently add new entries under the hood,
   // but this is safe because the `LifetimeExtender` prevents access entirely.
   LocalVocab::LifetimeExtender localVocabLifetimeExtender_;
-  // A unique index for this snapshot that is used in the query cache.
+  // A unique index for this snapshot.
   size_t index_;
+  // For each predicate, the index of the last snapshot that contains a
+  // modification of a triple with this predicate. Predicates of triples that
+  // were never modified are not contained.
+  std::shared_ptr<const ad_utility::HashMap<Id, size_t>>
+      lastModificationPerPredicate_ =
+          std::make_shared<const ad_utility::HashMap<Id, size_t>>();
+  // The index of the last snapshot that modified the triples of all predicates
+  // at once (for example, by clearing the delta triples).
+  size_t lastModificationOfAllPredicates_ = 0;
+  // The index of the last snapshot that contains any modification.
+  size_t lastModification_ = 0;
+
   // Get `TripleWithPosition` objects for given permutation.
   const LocatedTriplesPerBlock& getLocatedTriplesForPermutation(
       Permutation::Enum permutation) const;
+
+  // The index of the last snapshot (up to this one) that contains a
+  // modification of a triple with the given `predicate`. This is used in the
+  // query cache, so that a cached result that only depends on triples with
+  // certain predicates stays valid across updates of other predicates (see
+  // `Operation::getLastModificationOfScannedTriples`).
+  size_t lastModificationOfPredicate(Id predicate) const;
 };
 
 // A shared pointer to a constant `LocatedTriplesSnapshot`, but as an explicit
@@ -82,6 +108,9 @@ class DeltaTriples {
   FRIEND_TEST(DeltaTriplesTest, clear);
   FRIEND_TEST(DeltaTriplesTest, addTriplesToLocalVocab);
   FRIEND_TEST(DeltaTriplesTest, storeAndRestoreData);
+  FRIEND_TEST(DeltaTriplesTest, storeAndRestoreWithUpdateLog);
+  FRIEND_TEST(DeltaTriplesTest, restoreBlankNodesWithoutUpdateLog);
+  FRIEND_TEST(DeltaTriplesTest, stageUpdate);
 
  public:
   using Triples = std::vector<IdTriple<0>>;
@@ -92,6 +121,15 @@ class DeltaTriples {
   const IndexImpl& index_;
   size_t nextSnapshotIndex_ = 0;
 
+  // See the members of the same name in `LocatedTriplesSnapshot`. The entries
+  // refer to the index of the next snapshot, which is the first one that
+  // contains the modification.
+  std::shared_ptr<const ad_utility::HashMap<Id, size_t>>
+      lastModificationPerPredicate_ =
+          std::make_shared<const ad_utility::HashMap<Id, size_t>>();
+  size_t lastModificationOfAllPredicates_ = 0;
+  size_t lastModification_ = 0;
+
   // The located triples for all the 6 permutations.
   LocatedTriplesPerBlockAllPermutations locatedTriples_;
 
@@ -102,6 +140,16 @@ class DeltaTriples {
   // See the documentation of `setPersist()` below.
   std::optional<std::string> filenameForPersisting_;
 
+  // The updates since the last call to `writeToDisk()`, which have not yet
+  // been appended to the update log (see `writeToDisk()` below).
+  std::vector<ad_utility::UpdateLogRecord> updatesNotYetLogged_;
+  // The number of triples in the update log (the updates since the last
+  // checkpoint).
+  size_t numTriplesInUpdateLog_ = 0;
+  // True if the next call to `writeToDisk()` has to write a checkpoint, even
+  // if the update log is small (e.g. after `clear()`).
+  bool needsCheckpoint_ = false;
+
   // Assert that the Permutation Enum values have the expected int values.
   // This is used to store and lookup items that exist for permutation in an
   // array.
@@ -114,16 +162,69 @@ class DeltaTriples {
   static_assert(Permutation::ALL.size() == 6);
 
   // Each delta triple needs to know where it is stored in each of the six
-  // `LocatedTriplesPerBlock` above.
+  // `LocatedTriplesPerBlock` above. We store the index of the block and not an
+  // iterator, because the located triples of a block are copied when they are
+  // modified while being shared with a snapshot.
   struct LocatedTripleHandles {
-    using It = LocatedTriples::iterator;
-    std::array<It, Permutation::ALL.size()> handles_;
+    std::array<size_t, Permutation::ALL.size()> blockIndices_;
 
-    LocatedTriples::iterator& forPermutation(Permutation::Enum permutation);
+    size_t& forPermutation(Permutation::Enum permutation);
   };
   using TriplesToHandlesMap =
       ad_utility::HashMap<IdTriple<0>, LocatedTripleHandles>;
 
+ public:
+  // For each permutation, the block metadata in which new triples are located
+  // (see `getBlockMetadataForLocating`). A `nullptr` stands for the blocks of
+  // the permutation itself.
+  using BlockMetadataPerPermutation =
+      std::array<std::shared_ptr<const std::vector<CompressedBlockMetadata>>,
+                 Permutation::ALL.size()>;
+  // For each permutation, the located triples of a sequence of triples (in
+  // the order of these triples).
+  using LocatedTriplesPerPermutation =
+      std::array<std::vector<LocatedTriple>, Permutation::ALL.size()>;
+
+  // Triples that are to be inserted or deleted, and that have been prepared
+  // for this as far as possible without modifying the delta triples (see
+  // `DeltaTriplesManager::stageUpdate`). The located triples are only valid
+  // as long as the block metadata in which they were located is still the
+  // current one; `applyStagedTriples` locates the triples again otherwise.
+  struct StagedTriples {
+    Triples triples_;
+    bool insertOrDelete_;
+    BlockMetadataPerPermutation blockMetadata_;
+    // `std::nullopt` if the triples have not been located yet.
+    std::optional<LocatedTriplesPerPermutation> locatedTriples_;
+  };
+
+  // The deletion and insertion of a single update (the deletion happens
+  // first).
+  struct StagedUpdate {
+    StagedTriples toDelete_;
+    StagedTriples toInsert_;
+  };
+
+  // The state of the triples of a modification before it was applied, which is
+  // needed to roll it back (see `DeltaTriplesManager::BatchedModification`).
+  // Triples whose state was not changed by the modification are not stored.
+  // The memory is limited, because a modification can be arbitrarily large.
+  struct ModificationUndo {
+    using TriplesWithMemoryLimit =
+        std::vector<IdTriple<0>, ad_utility::AllocatorWithLimit<IdTriple<0>>>;
+    TriplesWithMemoryLimit wereInserted_;
+    TriplesWithMemoryLimit wereDeleted_;
+    TriplesWithMemoryLimit wereNoDeltaTriples_;
+
+    explicit ModificationUndo(
+        const ad_utility::AllocatorWithLimit<IdTriple<0>>& allocator)
+        : wereInserted_{allocator},
+          wereDeleted_{allocator},
+          wereNoDeltaTriples_{allocator} {}
+  };
+
+ private:
+
   // The sets of triples added to and subtracted from the original index. Any
   // triple can be at most in one of the sets. The information whether a triple
   // is in the index is missing. This means that a triple that is in the index
@@ -173,20 +274,40 @@ class DeltaTriples {
   // Delete triples.
   void deleteTriples(CancellationHandle cancellationHandle, Triples triples);
 
+  // Insert or delete the `stagedTriples` (see `StagedTriples` above). This
+  // has the same effect as `insertTriples` or `deleteTriples` for the
+  // original triples, but is much cheaper if the triples have already been
+  // located.
+  void applyStagedTriples(CancellationHandle cancellationHandle,
+                          StagedTriples stagedTriples);
+
   // If the `filename` is set, then `writeToDisk()` will write these
-  // `DeltaTriples` to `filename.value()`. If `filename` is `nullopt`, then
-  // `writeToDisk` will be a nullop.
+  // `DeltaTriples` to `filename.value()` (the checkpoint) and
+  // `filename.value() + ".wal"` (the update log). If `filename` is `nullopt`,
+  // then `writeToDisk` will be a nullop.
   void setPersists(std::optional<std::string> filename);
 
-  // Write the delta triples to disk to persist them between restarts.
-  void writeToDisk() const;
-
-  // Read the delta triples from disk to restore them after a restart.
+  // Write the delta triples to disk to persist them between restarts. The
+  // updates since the last call are appended to the update log, so that the
+  // cost is proportional to the size of the updates. When the update log
+  // becomes larger than the delta triples (but has at least
+  // `minNumTriplesInUpdateLogForCheckpoint` triples), all the delta triples
+  // are written to the checkpoint instead, and the update log is removed.
+  void writeToDisk();
+
+  // Read the delta triples from disk to restore them after a restart, that is,
+  // read the checkpoint and replay the update log. If the update log is not
+  // empty, a new checkpoint is written afterward.
   void readFromDisk();
 
-  // Return a deep copy of the `LocatedTriples` and the corresponding
-  // `LocalVocab` which form a snapshot of the current status of this
-  // `DeltaTriples` object.
+  // See `writeToDisk()` above.
+  static constexpr size_t minNumTriplesInUpdateLogForCheckpoint = 1'000'000;
+
+  // Return a copy of the `LocatedTriples` and the corresponding `LocalVocab`
+  // which form a snapshot of the current status of this `DeltaTriples` object.
+  // The copy is cheap because the located triples of each block and the
+  // augmented block metadata are shared with the snapshot (and copied on write
+  // by later updates, see `LocatedTriplesPerBlock`).
   SharedLocatedTriplesSnapshot getSnapshot();
 
   // Register the original `metadata` for the given `permutation`. This has to
@@ -199,21 +320,70 @@ class DeltaTriples {
   // Find the position of the given triple in the given permutation and add it
   // to each of the six `LocatedTriplesPerBlock` maps (one per permutation).
   // When `insertOrDelete` is `true`, the triples are inserted, otherwise
-  // deleted. Return the iterators of where it was added (so that we can easily
-  // delete it again from these maps later).
+  // deleted. Return the indices of the blocks where it was added (so that we
+  // can easily delete it again from these maps later). The six permutations
+  // are processed concurrently.
   std::vector<LocatedTripleHandles> locateAndAddTriples(
       CancellationHandle cancellationHandle,
       ql::span<const IdTriple<0>> triples, bool insertOrDelete);
 
-  // Common implementation for `insertTriples` and `deleteTriples`. When
-  // `insertOrDelete` is `true`, the triples are inserted, `targetMap` contains
-  // the already inserted triples, and `inverseMap` contains the already deleted
-  // triples. When `insertOrDelete` is `false`, the triples are deleted, and it
-  // is the other way around:. This is used to resolve insertions or deletions
-  // that are idempotent or cancel each other out.
-  void modifyTriplesImpl(CancellationHandle cancellationHandle, Triples triples,
-                         bool insertOrDelete, TriplesToHandlesMap& targetMap,
-                         TriplesToHandlesMap& inverseMap);
+  // Return the block metadata in which new triples are currently located
+  // (see `BlockMetadataPerPermutation` above).
+  BlockMetadataPerPermutation getBlockMetadataForLocating() const;
+
+  // Locate the `triples` in each of the six permutations of the `index` (in
+  // the given `blockMetadata`) concurrently. This does not modify the delta
+  // triples and therefore doesn't require the lock for them.
+  static LocatedTriplesPerPermutation locateTriples(
+      const IndexImpl& index, const BlockMetadataPerPermutation& blockMetadata,
+      ql::span<const IdTriple<0>> triples, bool insertOrDelete,
+      const CancellationHandle& cancellationHandle);
+
+  // Add the `locatedTriples` to the `LocatedTriplesPerBlock` of their
+  // permutation and return the handles (see `locateAndAddTriples` below).
+  std::vector<LocatedTripleHandles> addLocatedTriples(
+      const LocatedTriplesPerPermutation& locatedTriples);
+
+  // Rewrite the local vocab entries and blank nodes of the `triples` (see
+  // `rewriteLocalVocabEntriesAndBlankNodes`), and return them as
+  // `StagedTriples` that have not yet been located. This is the part of the
+  // staging that modifies the delta triples (their `localVocab_`).
+  StagedTriples stageTriples(Triples triples, bool insertOrDelete);
+
+  // Locate the `stagedTriples` in their block metadata. This doesn't access the
+  // delta triples, so it can be done without holding the lock for them.
+  static void locateStagedTriples(const IndexImpl& index,
+                                  StagedTriples& stagedTriples,
+                                  const CancellationHandle& cancellationHandle);
+
+  // Record that the `triples` are modified in the next snapshot (see
+  // `LocatedTriplesSnapshot::lastModificationOfPredicate`).
+  void recordModification(const Triples& triples);
+
+  // Record that all the triples are modified in the next snapshot, e.g. by
+  // `clear()`, which invalidates all the cached results.
+  void recordModificationOfAllTriples();
+
+  // Common implementation for `insertTriples`, `deleteTriples`, and
+  // `applyStagedTriples`. The triples are inserted if `insertOrDelete_` is
+  // `true`, and deleted otherwise. Triples that are already inserted (or
+  // deleted) are ignored, and inserting a deleted triple (or vice versa)
+  // cancels out both.
+  void modifyTriplesImpl(CancellationHandle cancellationHandle,
+                         StagedTriples stagedTriples);
+
+  // Add the current state of those of the `stagedTriples` whose state will be
+  // changed when they are applied to the `undo`.
+  void addToUndo(const StagedTriples& stagedTriples,
+                 ModificationUndo& undo) const;
+
+  // Restore the state of the triples that is stored in the `undo`.
+  void applyUndo(const ModificationUndo& undo);
+
+  // Remove the `triples` from the delta triples, no matter whether they are
+  // inserted or deleted. This can't be expressed in the update log, so it must
+  // only be used for modifications that have not been logged yet.
+  void eraseTriples(const Triples& triples);
 
   // Rewrite each triple in `triples` such that all local vocab entries and all
   // local blank nodes are managed by the `localVocab_` of this class.
@@ -225,14 +395,44 @@ class DeltaTriples {
   void rewriteLocalVocabEntriesAndBlankNodes(Triples& triples);
   FRIEND_TEST(DeltaTriplesTest, rewriteLocalVocabEntriesAndBlankNodes);
 
-  // Erase `LocatedTriple` object from each `LocatedTriplesPerBlock` list. The
-  // argument are iterators for each list, as returned by the method
-  // `locateTripleInAllPermutations` above.
+  // Write all the delta triples to the checkpoint (see `writeToDisk()`) and
+  // remove the update log.
+  void writeCheckpoint();
+
+  // The filename of the update log (see `writeToDisk()`).
+  std::filesystem::path filenameOfUpdateLog() const;
+
+  // Erase the `LocatedTriple` objects for the given `triples` from each
+  // `LocatedTriplesPerBlock` list (as one batch per list). The `handles` are
+  // the block indices of each triple for each list, as returned by the method
+  // `locateAndAddTriples` above.
   //
-  // NOTE: The iterators are invalid afterward. That is OK, as long as we also
-  // delete the respective entry in `triplesInserted_` or `triplesDeleted_`,
-  // which stores these iterators.
-  void eraseTripleInAllPermutations(LocatedTripleHandles& handles);
+  // NOTE: The respective entries in `triplesInserted_` or `triplesDeleted_`,
+  // which store these handles, must also be deleted.
+  void eraseTriplesInAllPermutations(
+      ql::span<const IdTriple<0>> triples,
+      ql::span<const LocatedTripleHandles> handles);
+
+  // Return the inserted triples (if `insertOrDelete` is `true`) or the deleted
+  // triples (otherwise) that can be folded into the permutations by a
+  // compaction (see `DeltaTriplesManager::compact`), in sorted order. These
+  // are the triples that contain neither local vocab entries nor local blank
+  // nodes, which are only valid together with the `localVocab_`.
+  Triples getCompactableTriples(bool insertOrDelete) const;
+
+  // The last step of `DeltaTriplesManager::compact`: The `newBlocks` for each
+  // of the given permutations have been written to disk, with the
+  // `insertedTriples` and the `deletedTriples` merged in. Commit them, use them
+  // as the new original metadata, and remove those of these triples from the
+  // delta triples whose status hasn't changed in the meantime. If one of these
+  // triples is no longer a delta triple (because of a call to `clear()` in the
+  // meantime), the compaction is aborted instead. Return the number of triples
+  // that were removed from the delta triples.
+  size_t finishCompaction(
+      std::vector<std::pair<Permutation::Enum,
+                            std::vector<CompressedBlockMetadata>>>
+          newBlocks,
+      const Triples& insertedTriples, const Triples& deletedTriples);
 
   friend class DeltaTriplesManager;
 };
@@ -248,8 +448,30 @@ class DeltaTriplesManager {
   using CancellationHandle = DeltaTriples::CancellationHandle;
   using Triples = DeltaTriples::Triples;
 
+ private:
+  // Only one compaction (see `compact` below) can run at a time.
+  std::mutex compactionMutex_;
+  // True while a compaction that was started automatically by `modify` is
+  // running in the `compactionThread_`.
+  std::atomic<bool> compactionIsRunning_ = false;
+  // The number of delta triples right after the last compaction. This is only
+  // accessed while holding the lock for the `deltaTriples_`.
+  size_t numDeltaTriplesAfterLastCompaction_ = 0;
+  CancellationHandle compactionCancellationHandle_ =
+      std::make_shared<CancellationHandle::element_type>();
+  // This member is declared last, s.t. the thread is joined before any of the
+  // other members are destroyed.
+  ad_utility::JThread compactionThread_;
+
+ public:
   explicit DeltaTriplesManager(const IndexImpl& index);
   FRIEND_TEST(DeltaTriplesTest, DeltaTriplesManager);
+  FRIEND_TEST(DeltaTriplesTest, compaction);
+  FRIEND_TEST(DeltaTriplesTest, stageUpdate);
+  FRIEND_TEST(DeltaTriplesTest, batchedModification);
+
+  // Cancel a running compaction and wait for it to finish.
+  ~DeltaTriplesManager();
 
   // Modify the underlying `DeltaTriples` by applying `function` and then update
   // the current snapshot. Concurrent calls to `modify` and `clear` will be
@@ -266,9 +488,106 @@ class DeltaTriplesManager {
   // update the current snapshot.
   void clear();
 
-  // Return a shared pointer to a deep copy of the current snapshot. This can
-  // be safely used to execute a query without interfering with future updates.
+  // Return a shared pointer to the current snapshot. This can be safely used to
+  // execute a query without interfering with future updates.
   SharedLocatedTriplesSnapshot getCurrentSnapshot() const;
+
+  // Fold the delta triples into the permutations (compaction), so that scans
+  // don't have to merge them anymore. For each permutation, the blocks that
+  // contain delta triples are rewritten (with these triples merged in) and
+  // appended to the file of the permutation as a new generation of its blocks
+  // (see `Permutation::writeCompactedBlocks`). This happens without holding the
+  // lock for the delta triples, so queries and updates can continue in the
+  // meantime. Afterward, the new generation is installed and the compacted
+  // triples are removed from the delta triples, both while holding the lock.
+  // Snapshots that were taken before still see the old generation, which stays
+  // valid. Triples with local vocab entries or local blank nodes stay delta
+  // triples. Requires that the delta triples are persisted (see
+  // `setFilenameForPersistentUpdatesAndReadFromDisk`). Return the number of
+  // triples that were removed from the delta triples.
+  //
+  // NOTE: The metadata of the relations (e.g. their sizes) and the patterns are
+  // not updated, and the blocks of the old generations are only removed from
+  // the files by rebuilding the index.
+  size_t compact(CancellationHandle cancellationHandle);
+
+  // Prepare an update (the deletion of `toDelete`, followed by the insertion
+  // of `toInsert`), such that it can afterward be applied in a short critical
+  // section by calling `DeltaTriples::applyStagedTriples` from `modify`. Only
+  // the rewriting of the local vocab entries and blank nodes holds the lock;
+  // the expensive locating of the triples in the permutations happens without
+  // the lock, so that concurrent snapshots, compactions, and other accesses
+  // aren't blocked by a large update. A compaction that finishes in the
+  // meantime invalidates the located triples, which are then located again
+  // when they are applied. Idempotent triples and triples that cancel each
+  // other out are only resolved when the triples are applied, so other
+  // modifications may happen in between.
+  DeltaTriples::StagedUpdate stageUpdate(CancellationHandle cancellationHandle,
+                                         Triples toDelete, Triples toInsert);
+
+  // A modification of the delta triples that is applied in several batches,
+  // e.g. by an update with a large WHERE clause (see
+  // `ExecuteUpdate::executeUpdateStreaming`). The lock for the delta triples
+  // is only held while a batch is applied, so the next batch can be computed
+  // without blocking other accesses. The batches only become visible (in a new
+  // snapshot and on disk) when the modification is committed. If it is
+  // destroyed without having been committed (e.g. because the computation of
+  // a batch failed or was cancelled), all its batches are rolled back.
+  //
+  // NOTE: No compaction can run while the modification exists (a running
+  // compaction is waited for when it is created), and the delta triples must
+  // not be modified otherwise in the meantime. The latter holds for the
+  // server, which executes all updates in a single thread.
+  class BatchedModification {
+    DeltaTriplesManager& manager_;
+    std::unique_lock<std::mutex> compactionLock_;
+    ad_utility::AllocatorWithLimit<IdTriple<0>> allocator_;
+    // The information to roll back each of the batches (in order).
+    std::vector<DeltaTriples::ModificationUndo> undoPerBatch_;
+    DeltaTriplesCount countsBefore_;
+    // The batches are not logged before the commit, so they are removed from
+    // the updates that are not yet logged when they are rolled back.
+    size_t numUpdatesNotYetLoggedBefore_;
+    bool isCommitted_ = false;
+
+   public:
+    // The memory for the rollback is allocated with the `allocator`.
+    BatchedModification(DeltaTriplesManager& manager,
+                        ad_utility::AllocatorWithLimit<IdTriple<0>> allocator);
+    ~BatchedModification();
+    BatchedModification(const BatchedModification&) = delete;
+    BatchedModification& operator=(const BatchedModification&) = delete;
+
+    // The counts of the delta triples before the first batch.
+    const DeltaTriplesCount& countsBefore() const { return countsBefore_; }
+
+    // Delete `toDelete` and then insert `toInsert`, which must be disjoint.
+    // Like for `stageUpdate`, the triples are located without holding the lock.
+    void applyBatch(CancellationHandle cancellationHandle, Triples toDelete,
+                    Triples toInsert);
+
+    // Commit the modification: Like `modify`, call `function` while holding
+    // the lock, then write the delta triples to disk and update the current
+    // snapshot.
+    template <typename ReturnType>
+    ReturnType commit(
+        const std::function<ReturnType(DeltaTriples&)>& function) {
+      AD_CONTRACT_CHECK(!isCommitted_);
+      ReturnType result = manager_.modify<ReturnType>(function);
+      isCommitted_ = true;
+      return result;
+    }
+
+   private:
+    void rollBack();
+  };
+
+ private:
+  // Start a compaction in the `compactionThread_` if the number of delta
+  // triples has grown by at least the `delta-triples-compaction-threshold`
+  // since the last compaction. Must be called while holding the lock for the
+  // `deltaTriples_`.
+  void maybeStartCompaction(const DeltaTriples& deltaTriples);
 };
 
 #endif  // QLEVER_SRC_INDEX_DELTATRIPLES_H
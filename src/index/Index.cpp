@@ -190,6 +190,19 @@ ad_utility::MemorySize& Index::blocksizePermutationsPerColumn() {
   return pimpl_->blocksizePermutationPerColumn();
 }
 
+// ____________________________________________________________________________
+size_t& Index::bloomFilterBitsPerKey() {
+  return pimpl_->bloomFilterBitsPerKey();
+}
+
+// ____________________________________________________________________________
+std::vector<Permutation::Enum>& Index::uncompressedPermutations() {
+  return pimpl_->uncompressedPermutations();
+}
+
+// ____________________________________________________________________________
+bool& Index::adaptiveBlocksize() { return pimpl_->adaptiveBlocksize(); }
+
 // ____________________________________________________________________________
 void Index::setOnDiskBase(const std::string& onDiskBase) {
   return pimpl_->setOnDiskBase(onDiskBase);
@@ -195,6 +195,12 @@ class Index {
 
   ad_utility::MemorySize& blocksizePermutationsPerColumn();
 
+  size_t& bloomFilterBitsPerKey();
+
+  std::vector<Permutation::Enum>& uncompressedPermutations();
+
+  bool& adaptiveBlocksize();
+
   void setOnDiskBase(const std::string& onDiskBase);
 
   void setSettingsFile(const std::string& filename);
@@ -6,6 +6,8 @@
 //
 // Copyright 2025, Bayerische Motoren Werke Aktiengesellschaft (BMW AG)
 
+#include <absl/strings/str_split.h>
+
 #include <boost/program_options.hpp>
 #include <cstdlib>
 #include <exception>
@@ -146,6 +148,9 @@ int main(int argc, char** argv) {
   float kScoringParam = 1.75;
   std::optional<ad_utility::MemorySize> indexMemoryLimit;
   std::optional<ad_utility::MemorySize> parserBufferSize;
+  size_t bloomFilterBitsPerKey = 0;
+  std::string uncompressedPermutations;
+  bool adaptiveBlocksize = false;
   std::optional<ad_utility::VocabularyType> vocabType;
   optind = 1;
 
@@ -230,6 +235,25 @@ int main(int argc, char** argv) {
       "large enough to hold a single input triple. Default: 10 MB.");
   add("keep-temporary-files,k", po::bool_switch(&keepTemporaryFiles),
       "Do not delete temporary files from index creation for debugging.");
+  add("bloom-filter-bits-per-key", po::value(&bloomFilterBitsPerKey),
+      "If nonzero, store a Bloom filter with this many bits per distinct "
+      "value for the second and third column of each block of the "
+      "permutations. These allow skipping blocks in joins with a sparse "
+      "join column, but are kept in memory together with the block "
+      "metadata. A typical value is 10 (about 1% false positives). "
+      "Default: 0 (no Bloom filters).");
+  add("uncompressed-permutations", po::value(&uncompressedPermutations),
+      "A comma-separated list of permutations (e.g. \"pso,pos\") that are "
+      "stored uncompressed. These are read via a memory mapping and can be "
+      "scanned without copying, which makes sense for permutations that are "
+      "scanned very frequently, but they need considerably more disk space. "
+      "Default: none.");
+  add("adaptive-block-size", po::bool_switch(&adaptiveBlocksize),
+      "Choose the block size of the permutations per relation: relations with "
+      "few triples per value of the second column (which are typically used "
+      "for point lookups) get smaller blocks, and relations with many "
+      "triples per value of the second column or very large relations (which "
+      "are typically scanned completely) get larger blocks.");
 
   // Process command line arguments.
   po::variables_map optionsMap;
@@ -260,6 +284,18 @@ int main(int argc, char** argv) {
   if (parserBufferSize.has_value()) {
     index.parserBufferSize() = parserBufferSize.value();
   }
+  index.bloomFilterBitsPerKey() = bloomFilterBitsPerKey;
+  index.adaptiveBlocksize() = adaptiveBlocksize;
+  try {
+    for (std::string_view name :
+         absl::StrSplit(uncompressedPermutations, ',', absl::SkipEmpty())) {
+      index.uncompressedPermutations().push_back(
+          Permutation::fromString(name));
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error in command-line argument: " << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
 
   if (vocabType.has_value()) {
     index.getImpl().setVocabularyTypeForIndexBuilding(vocabType.value());
@@ -19,6 +19,7 @@
 #include "index/IndexFormatVersion.h"
 #include "index/VocabularyMerger.h"
 #include "parser/ParallelParseBuffer.h"
+#include "util/Algorithm.h"
 #include "util/BatchedPipeline.h"
 #include "util/CachingMemoryResource.h"
 #include "util/HashMap.h"
@@ -786,6 +787,7 @@ std::tuple<size_t, IndexImpl::IndexMetaDataMmapDispatcher::WriteType,
 IndexImpl::createPermutationPairImpl(size_t numColumns, const string& fileName1,
                                      const string& fileName2, T&& sortedTriples,
                                      Permutation::KeyOrder permutation,
+                                     std::array<bool, 2> storeUncompressed,
                                      Callbacks&&... perTripleCallbacks) {
   using MetaData = IndexMetaDataMmapDispatcher::WriteType;
   MetaData metaData1, metaData2;
@@ -794,9 +796,15 @@ IndexImpl::createPermutationPairImpl(size_t numColumns, const string& fileName1,
   metaData2.setup(fileName2 + MMAP_FILE_SUFFIX, ad_utility::CreateTag{});
 
   CompressedRelationWriter writer1{numColumns, ad_utility::File(fileName1, "w"),
-                                   blocksizePermutationPerColumn_};
+                                   blocksizePermutationPerColumn_,
+                                   bloomFilterBitsPerKey_,
+                                   storeUncompressed[0],
+                                   adaptiveBlocksize_};
   CompressedRelationWriter writer2{numColumns, ad_utility::File(fileName2, "w"),
-                                   blocksizePermutationPerColumn_};
+                                   blocksizePermutationPerColumn_,
+                                   bloomFilterBitsPerKey_,
+                                   storeUncompressed[1],
+                                   adaptiveBlocksize_};
 
   // Lift a callback that works on single elements to a callback that works on
   // blocks.
@@ -822,9 +830,11 @@ IndexImpl::createPermutationPairImpl(size_t numColumns, const string& fileName1,
 
   // There previously was a bug in the CompressedIdTableSorter that lead to
   // semantically correct blocks, but with too large block sizes for the twin
-  // relation. This assertion would have caught this bug.
-  AD_CORRECTNESS_CHECK(metaData1.blockData().size() ==
-                       metaData2.blockData().size());
+  // relation. This assertion would have caught this bug. With adaptive
+  // blocksizes, the blocksize of a relation is chosen separately for each of
+  // the two permutations, so the number of blocks can differ.
+  AD_CORRECTNESS_CHECK(adaptiveBlocksize_ || metaData1.blockData().size() ==
+                                                 metaData2.blockData().size());
 
   return {numDistinctCol0, std::move(metaData1), std::move(metaData2)};
 }
@@ -838,10 +848,14 @@ IndexImpl::createPermutations(size_t numColumns, T&& sortedTriples,
                               Callbacks&&... perTripleCallbacks) {
   AD_LOG_INFO << "Creating permutations " << p1.readableName() << " and "
               << p2.readableName() << " ..." << std::endl;
+  auto isUncompressed = [this](const Permutation& p) {
+    return ad_utility::contains(uncompressedPermutations_, p.permutation());
+  };
   auto metaData = createPermutationPairImpl(
       numColumns, onDiskBase_ + ".index" + p1.fileSuffix(),
       onDiskBase_ + ".index" + p2.fileSuffix(), AD_FWD(sortedTriples),
-      p1.keyOrder(), AD_FWD(perTripleCallbacks)...);
+      p1.keyOrder(), {isUncompressed(p1), isUncompressed(p2)},
+      AD_FWD(perTripleCallbacks)...);
 
   auto& [numDistinctCol0, meta1, meta2] = metaData;
   meta1.calculateStatistics(numDistinctCol0);
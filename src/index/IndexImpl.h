@@ -132,6 +132,17 @@ class IndexImpl {
   ad_utility::MemorySize parserBufferSize_ = DEFAULT_PARSER_BUFFER_SIZE;
   ad_utility::MemorySize blocksizePermutationPerColumn_ =
       UNCOMPRESSED_BLOCKSIZE_COMPRESSED_METADATA_PER_COLUMN;
+  // The number of bits per distinct `Id` of the per-block Bloom filters of the
+  // permutations. If 0, then no Bloom filters are built.
+  size_t bloomFilterBitsPerKey_ = 0;
+  // The permutations that are stored uncompressed, s.t. they are read via a
+  // memory mapping of the file and can be scanned without copying (see
+  // `CompressedRelationReader::scanAsView`). This is useful for permutations
+  // that are scanned very frequently, at the cost of more disk space.
+  std::vector<Permutation::Enum> uncompressedPermutations_;
+  // If true, the blocksizes of the permutations are chosen adaptively per
+  // relation, see `CompressedRelationWriter::blocksizeForLargeRelation`.
+  bool adaptiveBlocksize_ = false;
   json configurationJson_;
   Index::Vocab vocab_;
   Index::TextVocab textVocab_;
@@ -421,6 +432,14 @@ class IndexImpl {
     return blocksizePermutationPerColumn_;
   }
 
+  size_t& bloomFilterBitsPerKey() { return bloomFilterBitsPerKey_; }
+
+  std::vector<Permutation::Enum>& uncompressedPermutations() {
+    return uncompressedPermutations_;
+  }
+
+  bool& adaptiveBlocksize() { return adaptiveBlocksize_; }
+
   void setOnDiskBase(const std::string& onDiskBase);
 
   void setSettingsFile(const std::string& filename);
@@ -529,6 +548,7 @@ class IndexImpl {
   createPermutationPairImpl(size_t numColumns, const string& fileName1,
                             const string& fileName2, T&& sortedTriples,
                             Permutation::KeyOrder permutation,
+                            std::array<bool, 2> storeUncompressed,
                             Callbacks&&... perTripleCallbacks);
 
   // _______________________________________________________________________
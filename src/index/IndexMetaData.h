@@ -164,6 +164,8 @@ class IndexMetaData {
 
   size_t getVersion() const { return version_; }
 
+  size_t getNumDistinctCol0() const { return numDistinctCol0_; }
+
   const MapType& data() const { return data_; }
 
   BlocksType& blockData() { return *blockData_; }
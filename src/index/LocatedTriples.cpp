@@ -10,36 +10,108 @@
 
 #include "index/LocatedTriples.h"
 
+#include <numeric>
+
 #include "backports/algorithm.h"
 #include "index/CompressedRelation.h"
 #include "index/ConstantsIndexBuilding.h"
+#include "util/Algorithm.h"
 #include "util/ChunkedForLoop.h"
+#include "util/RunTasksInParallel.h"
 #include "util/ValueIdentity.h"
 
-// ____________________________________________________________________________
-std::vector<LocatedTriple> LocatedTriple::locateTriplesInPermutation(
-    ql::span<const IdTriple<0>> triples,
+namespace {
+// Locate the sorted `triples` (in the order of the permutation) in the
+// `blockMetadata` in a single merge-style pass, and write the block index of
+// `triples[i]` to `blockIndices[order[i]]`. A triple belongs to the first
+// block that contains at least one triple that is larger than or equal to the
+// triple. See `LocatedTriples.h` for a discussion of the corner cases.
+//
+// The block of the first triple is found via binary search. For each following
+// triple, the search starts at the block of the previous triple and gallops
+// forward (with exponentially growing steps), so that the cost per triple is
+// logarithmic in the distance to the previous block, and the block metadata is
+// traversed in order.
+void locateSortedTriples(
+    ql::span<const IdTriple<0>> triples, ql::span<const size_t> order,
     ql::span<const CompressedBlockMetadata> blockMetadata,
-    const qlever::KeyOrder& keyOrder, bool insertOrDelete,
-    ad_utility::SharedCancellationHandle cancellationHandle) {
-  std::vector<LocatedTriple> out;
-  out.reserve(triples.size());
+    std::vector<size_t>& blockIndices,
+    const ad_utility::SharedCancellationHandle& cancellationHandle) {
+  size_t numBlocks = blockMetadata.size();
+  // Return true iff the block at `pos` lies completely before the `triple`.
+  auto isBefore = [&blockMetadata](size_t pos, const auto& triple) {
+    return blockMetadata[pos].lastTriple_ < triple;
+  };
+  size_t blockIndex = 0;
   ad_utility::chunkedForLoop<10'000>(
       0, triples.size(),
-      [&triples, &out, &blockMetadata, &keyOrder, &insertOrDelete](size_t i) {
-        auto triple = triples[i].permute(keyOrder);
-        // A triple belongs to the first block that contains at least one triple
-        // that larger than or equal to the triple. See `LocatedTriples.h` for a
-        // discussion of the corner cases.
-        size_t blockIndex =
-            ql::ranges::lower_bound(blockMetadata, triple.toPermutedTriple(),
-                                    std::less<>{},
+      [&](size_t i) {
+        auto triple = triples[i].toPermutedTriple();
+        size_t step = 1;
+        size_t low = blockIndex;
+        while (blockIndex + step <= numBlocks &&
+               isBefore(blockIndex + step - 1, triple)) {
+          low = blockIndex + step;
+          step *= 2;
+        }
+        size_t high = std::min(blockIndex + step, numBlocks);
+        blockIndex =
+            ql::ranges::lower_bound(blockMetadata.subspan(low, high - low),
+                                    triple, std::less<>{},
                                     &CompressedBlockMetadata::lastTriple_) -
             blockMetadata.begin();
-        out.emplace_back(blockIndex, triple, insertOrDelete);
+        blockIndices[order[i]] = blockIndex;
       },
       [&cancellationHandle]() { cancellationHandle->throwIfCancelled(); });
+}
+}  // namespace
+
+// ____________________________________________________________________________
+std::vector<LocatedTriple> LocatedTriple::locateTriplesInPermutation(
+    ql::span<const IdTriple<0>> triples,
+    ql::span<const CompressedBlockMetadata> blockMetadata,
+    const qlever::KeyOrder& keyOrder, bool insertOrDelete,
+    ad_utility::SharedCancellationHandle cancellationHandle,
+    size_t numThreads) {
+  // Permute the triples and sort them (via their positions, because the
+  // result has to be in the order of the input).
+  auto permuted = ad_utility::transform(
+      triples, [&keyOrder](const auto& triple) {
+        return triple.permute(keyOrder);
+      });
+  std::vector<size_t> order(triples.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  if (!ql::ranges::is_sorted(permuted)) {
+    ql::ranges::sort(order, [&permuted](size_t a, size_t b) {
+      return permuted[a] < permuted[b];
+    });
+  }
+  std::vector<IdTriple<0>> sorted;
+  sorted.reserve(permuted.size());
+  for (size_t i : order) {
+    sorted.push_back(permuted[i]);
+  }
+  cancellationHandle->throwIfCancelled();
+
+  // Locate contiguous chunks of the sorted triples concurrently.
+  std::vector<size_t> blockIndices(triples.size());
+  size_t numChunks =
+      std::clamp<size_t>(triples.size() / MIN_NUM_TRIPLES_PER_LOCATE_CHUNK, 1,
+                         std::max(numThreads, size_t{1}));
+  size_t chunkSize = (triples.size() + numChunks - 1) / numChunks;
+  ad_utility::runTasksInParallel(numChunks, numThreads, [&](size_t chunk) {
+    size_t begin = std::min(chunk * chunkSize, sorted.size());
+    size_t end = std::min(begin + chunkSize, sorted.size());
+    locateSortedTriples(ql::span{sorted}.subspan(begin, end - begin),
+                        ql::span{order}.subspan(begin, end - begin),
+                        blockMetadata, blockIndices, cancellationHandle);
+  });
 
+  std::vector<LocatedTriple> out;
+  out.reserve(triples.size());
+  for (size_t i = 0; i < triples.size(); ++i) {
+    out.emplace_back(blockIndices[i], permuted[i], insertOrDelete);
+  }
   return out;
 }
 
@@ -53,10 +125,8 @@ NumAddedAndDeleted LocatedTriplesPerBlock::numTriples(size_t blockIndex) const {
   if (!hasUpdates(blockIndex)) {
     return {0, 0};
   } else {
-    const auto& blockUpdateTriples = map_.at(blockIndex);
-    // Simply return the number of located triples twice. See the comment in the
-    // header file for the reasons and potential improvements.
-    return {blockUpdateTriples.size(), blockUpdateTriples.size()};
+    const auto& blockUpdateTriples = *map_.at(blockIndex);
+    return {blockUpdateTriples.numInserted(), blockUpdateTriples.numDeleted()};
   }
 }
 
@@ -124,7 +194,7 @@ IdTable LocatedTriplesPerBlock::mergeTriplesImpl(size_t blockIndex,
   IdTable result{block.numColumns(), block.getAllocator()};
   result.resize(block.numRows() + numInsertsAndDeletes.numAdded_);
 
-  const auto& locatedTriples = map_.at(blockIndex);
+  const auto& locatedTriples = *map_.at(blockIndex);
 
   auto lessThan = [](const auto& lt, const auto& row) {
     return tieLocatedTriple<numIndexColumns, includeGraphColumn>(lt) <
@@ -223,42 +293,183 @@ IdTable LocatedTriplesPerBlock::mergeTriples(size_t blockIndex,
 }
 
 // ____________________________________________________________________________
-std::vector<LocatedTriples::iterator> LocatedTriplesPerBlock::add(
-    ql::span<const LocatedTriple> locatedTriples) {
-  std::vector<LocatedTriples::iterator> handles;
-  handles.reserve(locatedTriples.size());
-  for (auto triple : locatedTriples) {
-    LocatedTriples& locatedTriplesInBlock = map_[triple.blockIndex_];
-    auto [handle, wasInserted] = locatedTriplesInBlock.emplace(triple);
-    AD_CORRECTNESS_CHECK(wasInserted == true);
-    AD_CORRECTNESS_CHECK(handle != locatedTriplesInBlock.end());
-    ++numTriples_;
-    handles.emplace_back(handle);
+LocatedTriples& LocatedTriplesPerBlock::getLocatedTriplesForModification(
+    size_t blockIndex) {
+  auto& locatedTriples = map_[blockIndex];
+  if (locatedTriples == nullptr) {
+    locatedTriples = std::make_shared<LocatedTriples>();
+  } else if (locatedTriples.use_count() > 1) {
+    // The set is shared with at least one copy of this object. Note that new
+    // owners can only be created by copying an object that owns the set, so if
+    // this object is the only owner, the count can't increase concurrently,
+    // and the set can safely be modified in place.
+    locatedTriples = std::make_shared<LocatedTriples>(*locatedTriples);
   }
+  return *locatedTriples;
+}
 
-  updateAugmentedMetadata();
+// ____________________________________________________________________________
+LocatedTriples::LocatedTriples(std::initializer_list<LocatedTriple> triples) {
+  insert(std::vector<LocatedTriple>(triples));
+}
+
+// ____________________________________________________________________________
+LocatedTriples::LocatedTriples(const LocatedTriples& other)
+    : triples_{other.triples_},
+      numInserted_{other.numInserted_},
+      numDeleted_{other.numDeleted_},
+      numRowsAfterMerge_{other.numRowsAfterMerge_.load()} {}
 
-  return handles;
+// ____________________________________________________________________________
+LocatedTriples& LocatedTriples::operator=(const LocatedTriples& other) {
+  triples_ = other.triples_;
+  numInserted_ = other.numInserted_;
+  numDeleted_ = other.numDeleted_;
+  numRowsAfterMerge_ = other.numRowsAfterMerge_.load();
+  return *this;
+}
+
+// ____________________________________________________________________________
+std::optional<size_t> LocatedTriples::getNumRowsAfterMerge() const {
+  auto numRows = numRowsAfterMerge_.load();
+  if (numRows == noNumRowsAfterMerge) {
+    return std::nullopt;
+  }
+  return numRows;
+}
+
+// ____________________________________________________________________________
+void LocatedTriples::setNumRowsAfterMerge(size_t numRows) const {
+  numRowsAfterMerge_ = numRows;
+}
+
+// ____________________________________________________________________________
+void LocatedTriples::insert(std::vector<LocatedTriple> triples) {
+  if (triples.empty()) {
+    return;
+  }
+  numRowsAfterMerge_ = noNumRowsAfterMerge;
+  auto numInserted = static_cast<size_t>(
+      ql::ranges::count(triples, true, &LocatedTriple::insertOrDelete_));
+  numInserted_ += numInserted;
+  numDeleted_ += triples.size() - numInserted;
+  LocatedTripleCompare less;
+  ql::ranges::sort(triples, less);
+  auto numOldTriples = static_cast<ptrdiff_t>(triples_.size());
+  triples_.insert(triples_.end(), triples.begin(), triples.end());
+  std::inplace_merge(triples_.begin(), triples_.begin() + numOldTriples,
+                     triples_.end(), less);
+  auto sameTriple = [](const LocatedTriple& x, const LocatedTriple& y) {
+    return x.triple_ == y.triple_;
+  };
+  AD_CORRECTNESS_CHECK(ql::ranges::adjacent_find(triples_, sameTriple) ==
+                       triples_.end());
+}
+
+// ____________________________________________________________________________
+size_t LocatedTriples::erase(std::vector<LocatedTriple> triples) {
+  LocatedTripleCompare less;
+  ql::ranges::sort(triples, less);
+  // Compact the remaining triples in a single pass, in which the `triples`
+  // are found in order.
+  auto toErase = triples.begin();
+  auto out = triples_.begin();
+  for (auto& triple : triples_) {
+    while (toErase != triples.end() && less(*toErase, triple)) {
+      ++toErase;
+    }
+    if (toErase != triples.end() && !less(triple, *toErase)) {
+      ++toErase;
+      --(triple.insertOrDelete_ ? numInserted_ : numDeleted_);
+      continue;
+    }
+    *out = std::move(triple);
+    ++out;
+  }
+  auto numErased = static_cast<size_t>(triples_.end() - out);
+  triples_.erase(out, triples_.end());
+  if (numErased > 0) {
+    numRowsAfterMerge_ = noNumRowsAfterMerge;
+  }
+  return numErased;
+}
+
+// ____________________________________________________________________________
+void LocatedTriplesPerBlock::add(ql::span<const LocatedTriple> locatedTriples) {
+  // Group the triples by block, so that each block is only modified once.
+  ad_utility::HashMap<size_t, std::vector<LocatedTriple>> triplesPerBlock;
+  for (const auto& triple : locatedTriples) {
+    triplesPerBlock[triple.blockIndex_].push_back(triple);
+  }
+  for (auto& [blockIndex, triples] : triplesPerBlock) {
+    numTriples_ += triples.size();
+    getLocatedTriplesForModification(blockIndex).insert(std::move(triples));
+    dirtyBlocks_.insert(blockIndex);
+  }
+
+  updateAugmentedMetadata();
 }
 
 // ____________________________________________________________________________
 void LocatedTriplesPerBlock::erase(size_t blockIndex,
-                                   LocatedTriples::iterator iter) {
-  auto blockIter = map_.find(blockIndex);
-  AD_CONTRACT_CHECK(blockIter != map_.end(), "Block ", blockIndex,
+                                   const LocatedTriple& locatedTriple) {
+  AD_CONTRACT_CHECK(map_.contains(blockIndex), "Block ", blockIndex,
                     " is not contained.");
-  auto& block = blockIter->second;
-  block.erase(iter);
+  auto& block = getLocatedTriplesForModification(blockIndex);
+  AD_CONTRACT_CHECK(block.erase({locatedTriple}) == 1,
+                    "The located triple is not contained in block ",
+                    blockIndex);
   numTriples_--;
+  dirtyBlocks_.insert(blockIndex);
   if (block.empty()) {
     map_.erase(blockIndex);
   }
 }
 
+// ____________________________________________________________________________
+void LocatedTriplesPerBlock::erase(
+    ql::span<const LocatedTriple> locatedTriples) {
+  ad_utility::HashMap<size_t, std::vector<LocatedTriple>> triplesPerBlock;
+  for (const auto& triple : locatedTriples) {
+    triplesPerBlock[triple.blockIndex_].push_back(triple);
+  }
+  for (auto& [blockIndex, triples] : triplesPerBlock) {
+    AD_CONTRACT_CHECK(map_.contains(blockIndex), "Block ", blockIndex,
+                      " is not contained.");
+    auto& block = getLocatedTriplesForModification(blockIndex);
+    size_t numTriplesToErase = triples.size();
+    AD_CONTRACT_CHECK(block.erase(std::move(triples)) == numTriplesToErase,
+                      "Not all of the located triples are contained in block ",
+                      blockIndex);
+    numTriples_ -= numTriplesToErase;
+    dirtyBlocks_.insert(blockIndex);
+    if (block.empty()) {
+      map_.erase(blockIndex);
+    }
+  }
+}
+
 // ____________________________________________________________________________
 void LocatedTriplesPerBlock::setOriginalMetadata(
     std::shared_ptr<const std::vector<CompressedBlockMetadata>> metadata) {
+  originalMetadataSearchIndex_ =
+      std::make_shared<const BlockMetadataSearchIndex>(*metadata);
   originalMetadata_ = std::move(metadata);
+  // The augmented metadata was computed from the previous original metadata.
+  augmentedMetadata_.reset();
+  previousAugmentedMetadata_ = {};
+  dirtyBlocks_.clear();
+  if (!map_.empty()) {
+    computeAugmentedMetadata();
+  }
+}
+
+// ____________________________________________________________________________
+BlockMetadataSpan LocatedTriplesPerBlock::getOriginalMetadataIfSet() const {
+  if (!originalMetadata_.has_value()) {
+    return {};
+  }
+  return *originalMetadata_.value();
 }
 
 // Update the `blockMetadata`, such that its graph info is consistent with the
@@ -303,55 +514,192 @@ static auto updateGraphMetadata(CompressedBlockMetadata& blockMetadata,
   ql::ranges::sort(graphs.value());
 }
 
+// Update the zone maps of the `blockMetadata`, such that they also contain the
+// values of all the triples that are inserted via the `locatedTriples`. The
+// zone maps are not narrowed for deleted triples, so they stay correct (but
+// possibly not tight) upper bounds for the contents of the block.
+static void updateZoneMaps(CompressedBlockMetadata& blockMetadata,
+                           const LocatedTriples& locatedTriples) {
+  auto& zoneMaps = blockMetadata.zoneMaps_;
+  if (zoneMaps.empty()) {
+    // There are no zone maps for the original block.
+    return;
+  }
+  for (auto& lt : locatedTriples) {
+    if (!lt.insertOrDelete_) {
+      continue;
+    }
+    for (size_t i = 0; i < zoneMaps.size(); ++i) {
+      CompressedBlockMetadata::addToZoneMap(zoneMaps[i],
+                                            lt.triple_.ids().at(i));
+    }
+  }
+}
+
+// Add the values of all the triples that are inserted via the
+// `locatedTriples` to the Bloom filters of the `blockMetadata` (if any), such
+// that they don't exclude the inserted `Id`s.
+static void updateBloomFilters(CompressedBlockMetadata& blockMetadata,
+                               const LocatedTriples& locatedTriples) {
+  auto& bloomFilters = blockMetadata.bloomFilters_;
+  for (auto& lt : locatedTriples) {
+    if (!lt.insertOrDelete_) {
+      continue;
+    }
+    for (size_t i = 0; i < bloomFilters.size(); ++i) {
+      CompressedBlockMetadata::addToBloomFilter(
+          bloomFilters[i],
+          lt.triple_.ids().at(
+              CompressedBlockMetadata::firstColumnWithBloomFilter + i));
+    }
+  }
+}
+
+// Widen the borders of the `blockMetadata` for the `locatedTriples` of that
+// block and update its graph info, zone maps, and Bloom filters accordingly.
+static void augmentBlockMetadata(CompressedBlockMetadata& blockMetadata,
+                                 const LocatedTriples& locatedTriples) {
+  blockMetadata.firstTriple_ =
+      std::min(blockMetadata.firstTriple_,
+               locatedTriples.begin()->triple_.toPermutedTriple());
+  blockMetadata.lastTriple_ =
+      std::max(blockMetadata.lastTriple_,
+               locatedTriples.rbegin()->triple_.toPermutedTriple());
+  updateGraphMetadata(blockMetadata, locatedTriples);
+  updateZoneMaps(blockMetadata, locatedTriples);
+  updateBloomFilters(blockMetadata, locatedTriples);
+}
+
+// Create the metadata of the additional last block with the given
+// `blockIndex`, which contains the `locatedTriples` that are larger than all
+// the triples of the original blocks.
+static CompressedBlockMetadata makeLastBlockMetadata(
+    size_t blockIndex, const LocatedTriples& locatedTriples) {
+  auto firstTriple = locatedTriples.begin()->triple_.toPermutedTriple();
+  auto lastTriple = locatedTriples.rbegin()->triple_.toPermutedTriple();
+
+  using O = CompressedBlockMetadata::OffsetAndCompressedSize;
+  O emptyBlock{0, 0};
+
+  // TODO<joka921> We need the appropriate number of columns here, or we need
+  // to make the reading code work regardless of the number of columns.
+  CompressedBlockMetadataNoBlockIndex lastBlockN{
+      std::vector<O>(4, emptyBlock), 0, firstTriple, lastTriple, std::nullopt,
+      true};
+  lastBlockN.graphInfo_.emplace();
+  CompressedBlockMetadata lastBlock{lastBlockN, blockIndex};
+  updateGraphMetadata(lastBlock, locatedTriples);
+  return lastBlock;
+}
+
 // ____________________________________________________________________________
-void LocatedTriplesPerBlock::updateAugmentedMetadata() {
-  // TODO<C++23> use view::enumerate
-  size_t blockIndex = 0;
-  // Copy to preserve originalMetadata_.
+void LocatedTriplesPerBlock::computeAugmentedMetadata() {
   if (!originalMetadata_.has_value()) {
     AD_LOG_WARN << "The original metadata has not been set, but updates are "
                    "being performed. This should only happen in unit tests\n";
-    augmentedMetadata_.emplace();
-  } else {
-    augmentedMetadata_ = *originalMetadata_.value();
-  }
-  for (auto& blockMetadata : augmentedMetadata_.value()) {
-    if (hasUpdates(blockIndex)) {
-      const auto& blockUpdates = map_.at(blockIndex);
-      blockMetadata.firstTriple_ =
-          std::min(blockMetadata.firstTriple_,
-                   blockUpdates.begin()->triple_.toPermutedTriple());
-      blockMetadata.lastTriple_ =
-          std::max(blockMetadata.lastTriple_,
-                   blockUpdates.rbegin()->triple_.toPermutedTriple());
-      updateGraphMetadata(blockMetadata, blockUpdates);
+  }
+  auto originalMetadata = getOriginalMetadataIfSet();
+  auto augmented = std::make_shared<AugmentedMetadata>();
+  auto& blocks = augmented->blocks_;
+  blocks.assign(originalMetadata.begin(), originalMetadata.end());
+  for (const auto& [blockIndex, locatedTriples] : map_) {
+    if (blockIndex < blocks.size()) {
+      augmentBlockMetadata(blocks[blockIndex], *locatedTriples);
     }
-    blockIndex++;
   }
   // Also account for the last block that contains the triples that are larger
   // than all the inserted triples.
-  if (hasUpdates(blockIndex)) {
-    const auto& blockUpdates = map_.at(blockIndex);
-    auto firstTriple = blockUpdates.begin()->triple_.toPermutedTriple();
-    auto lastTriple = blockUpdates.rbegin()->triple_.toPermutedTriple();
-
-    using O = CompressedBlockMetadata::OffsetAndCompressedSize;
-    O emptyBlock{0, 0};
-
-    // TODO<joka921> We need the appropriate number of columns here, or we need
-    // to make the reading code work regardless of the number of columns.
-    CompressedBlockMetadataNoBlockIndex lastBlockN{
-        std::vector<O>(4, emptyBlock),
-        0,
-        firstTriple,
-        lastTriple,
-        std::nullopt,
-        true};
-    lastBlockN.graphInfo_.emplace();
-    CompressedBlockMetadata lastBlock{lastBlockN, blockIndex};
-    updateGraphMetadata(lastBlock, blockUpdates);
-    augmentedMetadata_->push_back(lastBlock);
+  size_t lastBlockIndex = originalMetadata.size();
+  if (hasUpdates(lastBlockIndex)) {
+    blocks.push_back(
+        makeLastBlockMetadata(lastBlockIndex, *map_.at(lastBlockIndex)));
+  }
+  augmented->searchIndex_ = BlockMetadataSearchIndex{blocks};
+  augmentedMetadata_ = std::move(augmented);
+}
+
+// ____________________________________________________________________________
+void LocatedTriplesPerBlock::updateAugmentedBlocks(
+    AugmentedMetadata& augmented,
+    const ad_utility::HashSet<size_t>& blockIndices) const {
+  auto originalMetadata = getOriginalMetadataIfSet();
+  auto& blocks = augmented.blocks_;
+  // The additional last block (see `computeAugmentedMetadata`) exists iff
+  // there are located triples after the last original block.
+  size_t lastBlockIndex = originalMetadata.size();
+  size_t numBlocksBefore = blocks.size();
+  if (hasUpdates(lastBlockIndex)) {
+    if (blocks.size() == lastBlockIndex) {
+      blocks.push_back(
+          makeLastBlockMetadata(lastBlockIndex, *map_.at(lastBlockIndex)));
+    }
+  } else if (blocks.size() > lastBlockIndex) {
+    blocks.pop_back();
+  }
+  bool numBlocksChanged = blocks.size() != numBlocksBefore;
+  for (size_t blockIndex : blockIndices) {
+    if (blockIndex >= blocks.size()) {
+      continue;
+    }
+    if (blockIndex == lastBlockIndex) {
+      blocks[blockIndex] =
+          makeLastBlockMetadata(blockIndex, *map_.at(blockIndex));
+    } else {
+      blocks[blockIndex] = originalMetadata[blockIndex];
+      if (hasUpdates(blockIndex)) {
+        augmentBlockMetadata(blocks[blockIndex], *map_.at(blockIndex));
+      }
+    }
+    if (!numBlocksChanged) {
+      augmented.searchIndex_.updateBlock(blockIndex, blocks[blockIndex]);
+    }
+  }
+  // Only if a block was added or removed, the search index has to be rebuilt.
+  if (numBlocksChanged) {
+    augmented.searchIndex_ = BlockMetadataSearchIndex{blocks};
+  }
+}
+
+// ____________________________________________________________________________
+void LocatedTriplesPerBlock::updateAugmentedMetadata() {
+  if (augmentedMetadata_ == nullptr) {
+    dirtyBlocks_.clear();
+    // Without located triples, the augmented metadata is the original one.
+    if (!map_.empty()) {
+      computeAugmentedMetadata();
+    }
+    return;
+  }
+  if (dirtyBlocks_.empty()) {
+    return;
+  }
+  // Choose the metadata to update. As for the located triples (see
+  // `getLocatedTriplesForModification`), a use count of one means that no
+  // copy of this object can access the metadata anymore.
+  auto& previous = previousAugmentedMetadata_;
+  std::shared_ptr<AugmentedMetadata> augmented;
+  ad_utility::HashSet<size_t> blocksToUpdate = dirtyBlocks_;
+  if (augmentedMetadata_.use_count() == 1) {
+    // Not shared with a snapshot, update in place.
+    augmented = std::move(augmentedMetadata_);
+    if (previous.metadata_ != nullptr) {
+      previous.changedBlocks_.insert(dirtyBlocks_.begin(), dirtyBlocks_.end());
+    }
+  } else {
+    if (previous.metadata_ != nullptr && previous.metadata_.use_count() == 1) {
+      // Reuse the previous version, which also lacks the changes since then.
+      augmented = std::move(previous.metadata_);
+      blocksToUpdate.insert(previous.changedBlocks_.begin(),
+                            previous.changedBlocks_.end());
+    } else {
+      augmented = std::make_shared<AugmentedMetadata>(*augmentedMetadata_);
+    }
+    previous.metadata_ = std::move(augmentedMetadata_);
+    previous.changedBlocks_ = std::move(dirtyBlocks_);
   }
+  updateAugmentedBlocks(*augmented, blocksToUpdate);
+  augmentedMetadata_ = std::move(augmented);
+  dirtyBlocks_.clear();
 }
 
 // ____________________________________________________________________________
@@ -380,6 +728,6 @@ bool LocatedTriplesPerBlock::isLocatedTriple(const IdTriple<0>& triple,
 
   return ql::ranges::any_of(map_, [&blockContains](auto& indexAndBlock) {
     const auto& [index, block] = indexAndBlock;
-    return blockContains(block, index);
+    return blockContains(*block, index);
   });
 }
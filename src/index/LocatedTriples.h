@@ -11,13 +11,17 @@
 #ifndef QLEVER_SRC_INDEX_LOCATEDTRIPLES_H
 #define QLEVER_SRC_INDEX_LOCATEDTRIPLES_H
 
+#include <atomic>
 #include <boost/optional.hpp>
+#include <limits>
 
 #include "engine/idTable/IdTable.h"
 #include "global/IdTriple.h"
+#include "index/BlockMetadataSearchIndex.h"
 #include "index/CompressedRelation.h"
 #include "index/KeyOrder.h"
 #include "util/HashMap.h"
+#include "util/HashSet.h"
 
 class Permutation;
 
@@ -42,12 +46,18 @@ struct LocatedTriple {
   // If `true`, the triple is inserted, otherwise it is deleted.
   bool insertOrDelete_;
 
-  // Locate the given triples in the given permutation.
+  // Locate the given triples in the given permutation. The result contains
+  // one `LocatedTriple` per triple, in the order of the input. The triples are
+  // sorted in the order of the permutation and then located in a single
+  // merge-style pass over the `blockMetadata` (for large inputs, in several
+  // chunks that are processed concurrently by up to `numThreads` threads,
+  // including the calling thread).
   static std::vector<LocatedTriple> locateTriplesInPermutation(
       ql::span<const IdTriple<0>> triples,
       ql::span<const CompressedBlockMetadata> blockMetadata,
       const qlever::KeyOrder& keyOrder, bool insertOrDelete,
-      ad_utility::SharedCancellationHandle cancellationHandle);
+      ad_utility::SharedCancellationHandle cancellationHandle,
+      size_t numThreads = 1);
   bool operator==(const LocatedTriple&) const = default;
 
   // This operator is only for debugging and testing. It returns a
@@ -59,8 +69,7 @@ struct LocatedTriple {
   }
 };
 
-// A sorted set of located triples. In `LocatedTriplesPerBlock` below, we use
-// this to store all located triples with the same `blockIndex_`.
+// The order of the located triples of a block.
 //
 // NOTE: We could also overload `std::less` here, but the explicit specification
 // of the order makes it clearer.
@@ -69,7 +78,83 @@ struct LocatedTripleCompare {
     return x.triple_ < y.triple_;
   }
 };
-using LocatedTriples = std::set<LocatedTriple, LocatedTripleCompare>;
+
+// A sorted set of located triples (without two located triples with the same
+// `triple_`). In `LocatedTriplesPerBlock` below, we use this to store all
+// located triples with the same `blockIndex_`.
+//
+// The triples are stored in a sorted vector instead of a `std::set`, because
+// the most frequent operation is iterating over them, when they are merged
+// with the triples of a block for each scan (see
+// `LocatedTriplesPerBlock::mergeTriples`). The triples of an update are
+// inserted or erased as a batch with a single merge pass, so the cost of an
+// update is linear in the size of the affected blocks.
+//
+// Note that the number of located triples per block is not bounded: The
+// compaction is disabled by default (`delta-triples-compaction-threshold` is
+// 0), and triples that contain entries of the local vocabulary are never
+// compacted. In the worst case, inserting a batch of `k` triples into a block
+// with `n` located triples costs O(n + k log k), that is O(n) per update even
+// for a single triple. Many small updates of the same block are therefore
+// quadratic in total, which a tree would avoid at the price of slower scans.
+class LocatedTriples {
+ private:
+  std::vector<LocatedTriple> triples_;
+  // The number of triples with `insertOrDelete_ == true` and `false`.
+  size_t numInserted_ = 0;
+  size_t numDeleted_ = 0;
+  // See `getNumRowsAfterMerge`. The cache is only valid as long as the triples
+  // are not modified, which is fine because the `LocatedTriples` of a block
+  // are copied before they are modified (see `LocatedTriplesPerBlock`).
+  static constexpr size_t noNumRowsAfterMerge =
+      std::numeric_limits<size_t>::max();
+  mutable std::atomic<size_t> numRowsAfterMerge_ = noNumRowsAfterMerge;
+
+ public:
+  using value_type = LocatedTriple;
+  using const_iterator = std::vector<LocatedTriple>::const_iterator;
+  using iterator = const_iterator;
+
+  LocatedTriples() = default;
+  // The `triples` can be given in any order, but there must not be two
+  // triples with the same `triple_`.
+  LocatedTriples(std::initializer_list<LocatedTriple> triples);
+  LocatedTriples(const LocatedTriples& other);
+  LocatedTriples& operator=(const LocatedTriples& other);
+
+  const_iterator begin() const { return triples_.begin(); }
+  const_iterator end() const { return triples_.end(); }
+  auto rbegin() const { return triples_.rbegin(); }
+  auto rend() const { return triples_.rend(); }
+  size_t size() const { return triples_.size(); }
+  bool empty() const { return triples_.empty(); }
+
+  // Insert the `triples` (in any order). Neither the `triples` nor the triples
+  // that are already contained may have a `triple_` in common.
+  void insert(std::vector<LocatedTriple> triples);
+
+  // Erase the located triples with the same `triple_` as one of the `triples`
+  // (in any order). Return the number of erased triples. Triples that are not
+  // contained are ignored.
+  size_t erase(std::vector<LocatedTriple> triples);
+
+  // The number of inserted and deleted triples.
+  size_t numInserted() const { return numInserted_; }
+  size_t numDeleted() const { return numDeleted_; }
+
+  // The number of rows of the block after merging these triples into it
+  // (comparing only the first three columns, and without any filtering by
+  // graphs). This is cached when the size of a scan is computed exactly (see
+  // `CompressedRelationReader::getResultSizeImpl`), so that the block only
+  // has to be read once per update. Returns `std::nullopt` if nothing has been
+  // cached yet.
+  std::optional<size_t> getNumRowsAfterMerge() const;
+  void setNumRowsAfterMerge(size_t numRows) const;
+
+  bool operator==(const LocatedTriples& other) const {
+    return triples_ == other.triples_;
+  }
+};
 
 // This operator is only for debugging and testing. It returns a
 // human-readable representation.
@@ -83,42 +168,97 @@ class LocatedTriplesPerBlock {
   size_t numTriples_ = 0;
 
   // For each block with a non-empty set of located triples, the located triples
-  // in that block.
-  ad_utility::HashMap<size_t, LocatedTriples> map_;
+  // in that block. The sets are shared between copies of this object (in
+  // particular, the snapshots, see `DeltaTriples::getSnapshot`) and copied on
+  // write, so that copying this object only costs a pointer per block and an
+  // update only pays for the blocks that it touches.
+  ad_utility::HashMap<size_t, std::shared_ptr<LocatedTriples>> map_;
 
   FRIEND_TEST(LocatedTriplesTest, numTriplesInBlock);
+  FRIEND_TEST(LocatedTriplesTest, copyOnWrite);
 
   // Implementation of the `mergeTriples` function (which has `numIndexColumns`
   // as a normal argument, and translates it into a template argument).
   template <size_t numIndexColumns, bool includeGraphColumn>
   IdTable mergeTriplesImpl(size_t blockIndex, const IdTable& block) const;
 
-  // Stores the block metadata where the block borders have been adjusted for
-  // the updated triples.
-  std::optional<std::vector<CompressedBlockMetadata>> augmentedMetadata_;
+  // Return the located triples of the block with the given index for
+  // modification (an empty set if there are none yet). If they are shared with
+  // a copy of this object, they are copied first.
+  LocatedTriples& getLocatedTriplesForModification(size_t blockIndex);
+
+  // The block metadata where the block borders (and the graph info, zone maps,
+  // and Bloom filters) have been adjusted for the updated triples, together
+  // with the search index for its block boundaries (see
+  // `BlockMetadataSearchIndex`).
+  struct AugmentedMetadata {
+    std::vector<CompressedBlockMetadata> blocks_;
+    BlockMetadataSearchIndex searchIndex_;
+  };
+
+  // The current augmented metadata. Like the located triples, it is shared
+  // between the copies of this object, and copied on write. It is `nullptr` if
+  // it hasn't been computed yet or equals the original metadata.
+  std::shared_ptr<AugmentedMetadata> augmentedMetadata_;
+
+  // The previous version of the augmented metadata (before the last update
+  // that had to copy it, because it was shared), and the blocks in which it
+  // differs from the current version. Once the previous version is not used by
+  // a snapshot anymore, it is reused for the next update, so that an update
+  // typically only recomputes the blocks it touches instead of copying all the
+  // metadata. This is not copied along with this object, because a copy would
+  // keep the previous version alive.
+  struct PreviousAugmentedMetadata {
+    std::shared_ptr<AugmentedMetadata> metadata_;
+    ad_utility::HashSet<size_t> changedBlocks_;
+
+    PreviousAugmentedMetadata() = default;
+    PreviousAugmentedMetadata(const PreviousAugmentedMetadata&) {}
+    PreviousAugmentedMetadata& operator=(const PreviousAugmentedMetadata&) {
+      metadata_.reset();
+      changedBlocks_.clear();
+      return *this;
+    }
+    PreviousAugmentedMetadata(PreviousAugmentedMetadata&&) = default;
+    PreviousAugmentedMetadata& operator=(PreviousAugmentedMetadata&&) =
+        default;
+  };
+  PreviousAugmentedMetadata previousAugmentedMetadata_;
+
+  // The blocks whose located triples were changed by `add` or `erase` since
+  // the last call to `updateAugmentedMetadata`.
+  ad_utility::HashSet<size_t> dirtyBlocks_;
+
   std::optional<std::shared_ptr<const std::vector<CompressedBlockMetadata>>>
       originalMetadata_;
+  // The search index for the block boundaries of the original metadata.
+  std::shared_ptr<const BlockMetadataSearchIndex> originalMetadataSearchIndex_;
+
+  // Return the original metadata, or an empty span if it hasn't been set.
+  BlockMetadataSpan getOriginalMetadataIfSet() const;
+
+  // Compute the augmented metadata of all blocks from the original metadata.
+  void computeAugmentedMetadata();
+
+  // Recompute the entries of the `augmented` metadata for the blocks with the
+  // given indices from the original metadata and their located triples.
+  void updateAugmentedBlocks(
+      AugmentedMetadata& augmented,
+      const ad_utility::HashSet<size_t>& blockIndices) const;
 
  public:
+  // Update the augmented metadata for the blocks whose located triples have
+  // changed since the last call. This is called by `add`, but must be called
+  // explicitly after `erase`. Only the entries of these blocks are recomputed.
   void updateAugmentedMetadata();
 
- public:
-  // Get upper limits for the number of inserted and deleted located triples
-  // for the given block.
-  //
-  // NOTE: This currently returns the total number of triples in the block
-  // twice, in order to avoid counting the triples with `insertOrDelete_ ==
-  // true` and `insertOrDelete_ == false` separately, which turned out to
-  // be very expensive for a `std::set`, which is the underlying data
-  // structure.
+  // Get the number of inserted and deleted located triples for the given
+  // block. These counts are maintained for each update, so this is cheap.
   //
-  // TODO: Since the average number of located triples per block is usually
-  // small, this estimate is usually fine. We could get better estimates in
-  // constant time by maintaining a counter for each of these two numbers in
-  // `LocatedTriplesPerBlock` and update these counters for each update
-  // operatoin. However, note that that would still be an estimate because at
-  // this point we do not know whether an insertion or deletion is actually
-  // effective.
+  // NOTE: These are only upper bounds for the effect of the located triples on
+  // the size of the block, because at this point we do not know whether an
+  // insertion or deletion is actually effective (an inserted triple may
+  // already be contained in the block, a deleted one may not).
   NumAddedAndDeleted numTriples(size_t blockIndex) const;
 
   // Returns whether there are updates triples for the block with the index
@@ -153,21 +293,35 @@ class LocatedTriplesPerBlock {
     return map_.contains(blockIndex);
   }
 
-  // Add `locatedTriples` to the `LocatedTriplesPerBlock` and return handles to
-  // where they were added (`LocatedTriples` is a sorted set, see above). Using
-  // these handles, we can easily remove the `locatedTriples` from the set again
-  // when we need to.
+  // Add `locatedTriples` to the `LocatedTriplesPerBlock`. To remove one of
+  // them again, call `erase` with its `blockIndex_`.
   //
   // PRECONDITION: The `locatedTriples` must not already exist in
   // `LocatedTriplesPerBlock`.
-  std::vector<LocatedTriples::iterator> add(
-      ql::span<const LocatedTriple> locatedTriples);
+  void add(ql::span<const LocatedTriple> locatedTriples);
 
-  // Removes the given `LocatedTriple` from the `LocatedTriplesPerBlock`.
+  // Removes the given `LocatedTriple` (only its `triple_` is relevant) from the
+  // block with the given index. The `locatedTriple` must be contained in that
+  // block.
   //
   // NOTE: `updateAugmentedMetadata()` must be called to update the block
   // metadata.
-  void erase(size_t blockIndex, LocatedTriples::iterator iter);
+  void erase(size_t blockIndex, const LocatedTriple& locatedTriple);
+
+  // Like the function above, but for a batch of `locatedTriples`, each of
+  // which must be contained in the block with its `blockIndex_`. Each affected
+  // block is only traversed once.
+  void erase(ql::span<const LocatedTriple> locatedTriples);
+
+  // The cached number of rows of the block with the given index after merging
+  // its located triples, see `LocatedTriples::getNumRowsAfterMerge`. The
+  // block must contain located triples.
+  std::optional<size_t> getNumRowsAfterMerge(size_t blockIndex) const {
+    return map_.at(blockIndex)->getNumRowsAfterMerge();
+  }
+  void setNumRowsAfterMerge(size_t blockIndex, size_t numRows) const {
+    map_.at(blockIndex)->setNumRowsAfterMerge(numRows);
+  }
 
   // Get the total number of `LocatedTriple`s (for all blocks).
   size_t numTriples() const { return numTriples_; }
@@ -177,7 +331,9 @@ class LocatedTriplesPerBlock {
 
   // Must be called initially before using the `LocatedTriplesPerBlock` to
   // initialize the original block metadata that is augmented for updated
-  // triples. This is currently done in `Permutation::loadFromDisk`.
+  // triples. This is currently done in `Permutation::loadFromDisk`, and again
+  // after each compaction (see `DeltaTriplesManager::compact`). If there are
+  // located triples, the augmented metadata is recomputed for all blocks.
   void setOriginalMetadata(
       std::shared_ptr<const std::vector<CompressedBlockMetadata>> metadata);
   void setOriginalMetadata(std::vector<CompressedBlockMetadata> metadata) {
@@ -186,22 +342,44 @@ class LocatedTriplesPerBlock {
             std::move(metadata)));
   }
 
+  // Return true iff the original block metadata has been set.
+  bool hasOriginalMetadata() const { return originalMetadata_.has_value(); }
+
+  // Return the original block metadata (see `setOriginalMetadata`).
+  const std::shared_ptr<const std::vector<CompressedBlockMetadata>>&
+  getOriginalMetadata() const {
+    AD_CONTRACT_CHECK(originalMetadata_.has_value());
+    return originalMetadata_.value();
+  }
+
   // Returns the block metadata where the block borders have been updated to
   // account for the update triples. All triples (both insert and delete) will
   // enlarge the block borders.
   const std::vector<CompressedBlockMetadata>& getAugmentedMetadata() const {
-    if (augmentedMetadata_.has_value()) {
-      return augmentedMetadata_.value();
+    if (augmentedMetadata_ != nullptr) {
+      return augmentedMetadata_->blocks_;
     }
     AD_CONTRACT_CHECK(originalMetadata_.has_value());
     return *originalMetadata_.value();
   };
 
+  // Return the search index for the block boundaries of the metadata returned
+  // by `getAugmentedMetadata()`.
+  const BlockMetadataSearchIndex& getAugmentedMetadataSearchIndex() const {
+    if (augmentedMetadata_ != nullptr) {
+      return augmentedMetadata_->searchIndex_;
+    }
+    AD_CONTRACT_CHECK(originalMetadata_.has_value());
+    return *originalMetadataSearchIndex_;
+  }
+
   // Remove all located triples.
   void clear() {
     map_.clear();
     numTriples_ = 0;
     augmentedMetadata_.reset();
+    previousAugmentedMetadata_ = {};
+    dirtyBlocks_.clear();
   }
 
   // Return `true` iff one of the blocks contains `triple` with the given
@@ -221,8 +399,8 @@ class LocatedTriplesPerBlock {
                      std::back_inserter(blockIndices));
     ql::ranges::sort(blockIndices);
     for (auto blockIndex : blockIndices) {
-      os << "LTs in Block #" << blockIndex << ": " << ltpb.map_.at(blockIndex)
-         << std::endl;
+      os << "LTs in Block #" << blockIndex << ": "
+         << *ltpb.map_.at(blockIndex) << std::endl;
     }
     return os;
   };
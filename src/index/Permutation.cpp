@@ -5,6 +5,10 @@
 #include "index/Permutation.h"
 
 #include <absl/strings/str_cat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
 
 #include "index/ConstantsIndexBuilding.h"
 #include "index/DeltaTriples.h"
@@ -36,13 +40,47 @@ CompressedRelationReader::ScanSpecAndBlocks Permutation::getScanSpecAndBlocks(
     const LocatedTriplesSnapshot& locatedTriplesSnapshot,
     const std::optional<std::vector<CompressedBlockMetadata>>& optBlocks)
     const {
-  // Set the `checkInvariant` flag of `ScanSpecAndBlocks` to false given that we
-  // access a single `BlockMetadataRange` directly from the permutation here
-  // (over `getBlockMetdataRanges`) when `optBlocks = std::nullopt`.
+  // If no blocks are given, we use all the blocks of the permutation, for
+  // which we have a search index. In this case, the order of all the blocks
+  // doesn't have to be checked again for each scan.
+  if (!optBlocks.has_value()) {
+    return {scanSpec, perm.getAugmentedMetadataSpan(locatedTriplesSnapshot),
+            perm.getAugmentedMetadataSearchIndex(locatedTriplesSnapshot)};
+  }
   return {scanSpec,
           getBlockMetadataRanges(perm, locatedTriplesSnapshot, optBlocks)};
 }
 
+namespace {
+// The file that stores the size of the file of a permutation before a
+// compaction (see `Permutation::writeCompactedBlocks`) until this compaction
+// is committed.
+std::string compactionFilename(const std::string& filename) {
+  return filename + ".compaction";
+}
+
+// If there is an uncommitted compaction of the permutation with the given
+// `filename`, truncate the file to its size before the compaction. Return
+// `true` iff there was such a compaction.
+bool rollBackCompaction(const std::string& filename) {
+  auto sizeFilename = compactionFilename(filename);
+  if (!std::filesystem::exists(sizeFilename)) {
+    return false;
+  }
+  uintmax_t sizeBeforeCompaction = 0;
+  {
+    std::ifstream sizeFile{sizeFilename};
+    sizeFile >> sizeBeforeCompaction;
+    AD_CORRECTNESS_CHECK(sizeFile.good() || sizeFile.eof(), [&]() {
+      return absl::StrCat("Could not read the file ", sizeFilename);
+    });
+  }
+  std::filesystem::resize_file(filename, sizeBeforeCompaction);
+  std::filesystem::remove(sizeFilename);
+  return true;
+}
+}  // namespace
+
 // _____________________________________________________________________
 void Permutation::loadFromDisk(const std::string& onDiskBase,
                                std::function<bool(Id)> isInternalId,
@@ -51,16 +89,21 @@ void Permutation::loadFromDisk(const std::string& onDiskBase,
   if (loadInternalPermutation) {
     internalPermutation_ =
         std::make_unique<Permutation>(permutation_, allocator_);
+    internalPermutation_->isInternalPermutation_ = true;
     internalPermutation_->loadFromDisk(
         absl::StrCat(onDiskBase, QLEVER_INTERNAL_INDEX_INFIX), isInternalId_,
         false);
-    internalPermutation_->isInternalPermutation_ = true;
   }
   if constexpr (MetaData::isMmapBased_) {
     meta_.setup(onDiskBase + ".index" + fileSuffix_ + MMAP_FILE_SUFFIX,
                 ad_utility::ReuseTag(), ad_utility::AccessPattern::Random);
   }
   auto filename = string(onDiskBase + ".index" + fileSuffix_);
+  if (rollBackCompaction(filename)) {
+    AD_LOG_WARN << "Removed the blocks of an incomplete compaction from "
+                << filename << std::endl;
+  }
+  filename_ = filename;
   ad_utility::File file;
   try {
     file.open(filename, "r");
@@ -73,6 +116,17 @@ void Permutation::loadFromDisk(const std::string& onDiskBase,
   }
   meta_.readFromFile(&file);
   reader_.emplace(allocator_, std::move(file));
+  // Permutations that were stored uncompressed (see
+  // `IndexImpl::uncompressedPermutations()`) are read via a memory mapping.
+  const auto& blocks = meta_.blockData();
+  if (!blocks.empty() &&
+      blocks.front().offsetsAndCompressedSize_.at(0).codec_ ==
+          ColumnCodec::Uncompressed) {
+    reader_->enableMemoryMapping();
+  }
+  if (isInternalPermutation_) {
+    internalMetadataSearchIndex_.emplace(blocks);
+  }
   LOG(INFO) << "Registered " << readableName_
             << " permutation: " << meta_.statistics() << std::endl;
   isLoaded_ = true;
@@ -189,6 +243,18 @@ std::string_view Permutation::toString(Permutation::Enum permutation) {
   AD_FAIL();
 }
 
+// _____________________________________________________________________
+Permutation::Enum Permutation::fromString(std::string_view name) {
+  auto upperCaseName = ad_utility::utf8ToUpper(name);
+  for (auto permutation : ALL) {
+    if (toString(permutation) == upperCaseName) {
+      return permutation;
+    }
+  }
+  throw std::runtime_error(
+      absl::StrCat("\"", name, "\" is not a valid permutation"));
+}
+
 // _____________________________________________________________________
 std::optional<CompressedRelationMetadata> Permutation::getMetadata(
     Id col0Id, const LocatedTriplesSnapshot& locatedTriplesSnapshot) const {
@@ -227,20 +293,20 @@ Permutation::IdTableGenerator Permutation::lazyScan(
     ColumnIndicesRef additionalColumns,
     ad_utility::SharedCancellationHandle cancellationHandle,
     const LocatedTriplesSnapshot& locatedTriplesSnapshot,
-    const LimitOffsetClause& limitOffset) const {
+    const LimitOffsetClause& limitOffset,
+    std::optional<ql::span<const Id>> joinColumnFilter) const {
   const auto& p = getActualPermutation(scanSpec);
   ColumnIndices columns{additionalColumns.begin(), additionalColumns.end()};
   if (!optBlocks.has_value()) {
     optBlocks = CompressedRelationReader::convertBlockMetadataRangesToVector(
-        // TODO: Simplify once a ScanSpecAndBlocks value is provided.
-        CompressedRelationReader::getRelevantBlocks(
-            scanSpec,
-            getBlockMetadataRanges(p, locatedTriplesSnapshot, optBlocks)));
+        getScanSpecAndBlocks(p, scanSpec, locatedTriplesSnapshot, std::nullopt)
+            .blockMetadata_);
   }
   return p.reader().lazyScan(
       scanSpec, std::move(optBlocks.value()), std::move(columns),
       std::move(cancellationHandle),
-      p.getLocatedTriplesForPermutation(locatedTriplesSnapshot), limitOffset);
+      p.getLocatedTriplesForPermutation(locatedTriplesSnapshot), limitOffset,
+      joinColumnFilter);
 }
 
 // ______________________________________________________________________
@@ -285,13 +351,146 @@ const LocatedTriplesPerBlock& Permutation::getLocatedTriplesForPermutation(
   return actualSnapshot.getLocatedTriplesForPermutation(permutation_);
 }
 
+// ______________________________________________________________________
+BlockMetadataSpan Permutation::getAugmentedMetadataSpan(
+    const LocatedTriplesSnapshot& locatedTriplesSnapshot) const {
+  return isInternalPermutation_
+             ? BlockMetadataSpan{meta_.blockData()}
+             : BlockMetadataSpan{
+                   getLocatedTriplesForPermutation(locatedTriplesSnapshot)
+                       .getAugmentedMetadata()};
+}
+
 // ______________________________________________________________________
 BlockMetadataRanges Permutation::getAugmentedMetadataForPermutation(
     const LocatedTriplesSnapshot& locatedTriplesSnapshot) const {
-  BlockMetadataSpan blocks(
-      isInternalPermutation_
-          ? meta_.blockData()
-          : getLocatedTriplesForPermutation(locatedTriplesSnapshot)
-                .getAugmentedMetadata());
+  BlockMetadataSpan blocks = getAugmentedMetadataSpan(locatedTriplesSnapshot);
   return {{blocks.begin(), blocks.end()}};
 }
+
+// ______________________________________________________________________
+const BlockMetadataSearchIndex& Permutation::getAugmentedMetadataSearchIndex(
+    const LocatedTriplesSnapshot& locatedTriplesSnapshot) const {
+  if (isInternalPermutation_) {
+    AD_CORRECTNESS_CHECK(internalMetadataSearchIndex_.has_value());
+    return internalMetadataSearchIndex_.value();
+  }
+  return getLocatedTriplesForPermutation(locatedTriplesSnapshot)
+      .getAugmentedMetadataSearchIndex();
+}
+
+// ______________________________________________________________________
+std::vector<CompressedBlockMetadata> Permutation::writeCompactedBlocks(
+    const LocatedTriplesPerBlock& locatedTriples,
+    const CancellationHandle& cancellationHandle) const {
+  AD_CONTRACT_CHECK(isLoaded_ && !isInternalPermutation_);
+  const auto& blocks = *locatedTriples.getOriginalMetadata();
+  const auto& augmentedBlocks = locatedTriples.getAugmentedMetadata();
+
+  // Remember the current size of the file, s.t. the new blocks can be removed
+  // again if the compaction is not committed (see `rollBackCompaction`).
+  auto sizeFilename = compactionFilename(filename_);
+  AD_CONTRACT_CHECK(!std::filesystem::exists(sizeFilename), [&]() {
+    return absl::StrCat("There already is a compaction of the permutation ",
+                        readableName_, " in progress");
+  });
+  {
+    std::ofstream sizeFile{sizeFilename + ".tmp"};
+    sizeFile << std::filesystem::file_size(filename_);
+    sizeFile.flush();
+    AD_CORRECTNESS_CHECK(sizeFile.good());
+  }
+  std::filesystem::rename(sizeFilename + ".tmp", sizeFilename);
+
+  // The new blocks have the same columns and are stored in the same way as the
+  // existing blocks.
+  size_t numColumns = blocks.empty()
+                          ? ADDITIONAL_COLUMN_GRAPH_ID + 1
+                          : blocks.front().offsetsAndCompressedSize_.size();
+  bool storeUncompressed =
+      !blocks.empty() &&
+      blocks.front().offsetsAndCompressedSize_.at(0).codec_ ==
+          ColumnCodec::Uncompressed;
+  ad_utility::File file{filename_, "r+"};
+  file.seek(0, SEEK_END);
+  CompressedRelationWriter writer{
+      numColumns, std::move(file),
+      UNCOMPRESSED_BLOCKSIZE_COMPRESSED_METADATA_PER_COLUMN, 0,
+      storeUncompressed};
+
+  // Blocks without located triples are kept as they are. The block after the
+  // last block (which only exists in the `locatedTriples`) is written like all
+  // the other affected blocks.
+  std::vector<CompressedBlockMetadata> result;
+  for (size_t blockIndex = 0; blockIndex <= blocks.size(); ++blockIndex) {
+    cancellationHandle->throwIfCancelled();
+    if (!locatedTriples.containsTriples(blockIndex)) {
+      if (blockIndex < blocks.size()) {
+        result.push_back(blocks.at(blockIndex));
+      }
+      continue;
+    }
+    bool isBlockAfterLastBlock = blockIndex == blocks.size();
+    auto block = isBlockAfterLastBlock
+                     ? DecompressedBlock{numColumns, reader().allocator()}
+                     : reader().readCompleteBlock(blocks.at(blockIndex));
+    auto merged = locatedTriples.mergeTriples(blockIndex, block, 3, true);
+    size_t blocksize = isBlockAfterLastBlock ||
+                               blocks.at(blockIndex).blocksize_ == 0
+                           ? writer.blocksize()
+                           : blocks.at(blockIndex).blocksize_;
+    // Split a block that has grown too large into pieces of (almost) equal
+    // size. Blocks of small relations may already be larger than their
+    // `blocksize_`, they are only split when they grow.
+    size_t maxNumRows = std::max(blocksize, block.numRows());
+    size_t numPieces =
+        std::max(size_t{1}, (merged.numRows() + maxNumRows - 1) / maxNumRows);
+    size_t pieceSize = (merged.numRows() + numPieces - 1) / numPieces;
+    for (size_t begin = 0; begin < merged.numRows(); begin += pieceSize) {
+      auto piece = std::make_shared<IdTable>(numColumns, reader().allocator());
+      piece->insertAtEnd(merged, begin,
+                         std::min(begin + pieceSize, merged.numRows()));
+      writer.addCompleteBlock(std::move(piece), blocksize);
+    }
+  }
+
+  // The Bloom filters of a new block are those of the augmented metadata of
+  // the block from which it was created, which already contain the inserted
+  // triples. The new block is found the same way as the block of a located
+  // triple (see the end of `LocatedTriples.h`).
+  for (auto& newBlock : std::move(writer).getFinishedBlocks()) {
+    auto it = ql::ranges::lower_bound(blocks, newBlock.firstTriple_, {},
+                                      &CompressedBlockMetadata::lastTriple_);
+    newBlock.bloomFilters_ =
+        augmentedBlocks.at(it - blocks.begin()).bloomFilters_;
+    result.push_back(std::move(newBlock));
+  }
+  ql::ranges::sort(result, {}, &CompressedBlockMetadata::firstTriple_);
+  for (size_t i = 0; i < result.size(); ++i) {
+    result.at(i).blockIndex_ = i;
+  }
+  return result;
+}
+
+// ______________________________________________________________________
+void Permutation::commitCompaction(
+    const std::vector<CompressedBlockMetadata>& blocks) const {
+  MetaData metadata;
+  metadata.setName(meta_.getName());
+  metadata.blockData() = blocks;
+  metadata.calculateStatistics(meta_.getNumDistinctCol0());
+  // The metadata that is appended last is the one that is read by
+  // `loadFromDisk`. Only after it is on disk, the compaction is committed by
+  // removing the file with the previous size.
+  ad_utility::File file{filename_, "r+"};
+  metadata.appendToFile(&file);
+  file.flush();
+  AD_CORRECTNESS_CHECK(::fsync(file.fileDescriptor()) == 0);
+  file.close();
+  std::filesystem::remove(compactionFilename(filename_));
+}
+
+// ______________________________________________________________________
+void Permutation::abortCompaction() const {
+  rollBackCompaction(filename_);
+}
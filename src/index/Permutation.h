@@ -9,6 +9,7 @@
 #include <string>
 
 #include "global/Constants.h"
+#include "index/BlockMetadataSearchIndex.h"
 #include "index/CompressedRelation.h"
 #include "index/IndexMetaData.h"
 #include "index/KeyOrder.h"
@@ -52,6 +53,10 @@ class Permutation {
   // to "PSO".
   static std::string_view toString(Enum permutation);
 
+  // The inverse of `toString`, but case-insensitive, so "pso" and "PSO" are
+  // both converted to `PSO`. Throws if the `name` is not a permutation.
+  static Enum fromString(std::string_view name);
+
   // Convert a permutation to the corresponding permutation of [0, 1, 2], etc.
   // `PSO` is converted to [1, 0, 2].
   static KeyOrder toKeyOrder(Enum permutation);
@@ -108,7 +113,8 @@ class Permutation {
       std::optional<std::vector<CompressedBlockMetadata>> optBlocks,
       ColumnIndicesRef additionalColumns, CancellationHandle cancellationHandle,
       const LocatedTriplesSnapshot& locatedTriplesSnapshot,
-      const LimitOffsetClause& limitOffset = {}) const;
+      const LimitOffsetClause& limitOffset = {},
+      std::optional<ql::span<const Id>> joinColumnFilter = std::nullopt) const;
 
   // Returns the corresponding `CompressedRelationReader::ScanSpecAndBlocks`
   // with relevant `BlockMetadataRanges`.
@@ -181,10 +187,40 @@ class Permutation {
   BlockMetadataRanges getAugmentedMetadataForPermutation(
       const LocatedTriplesSnapshot& locatedTriplesSnapshot) const;
 
+  // From the given snapshot, get the search index for the block boundaries of
+  // the augmented block metadata of this permutation (see above).
+  const BlockMetadataSearchIndex& getAugmentedMetadataSearchIndex(
+      const LocatedTriplesSnapshot& locatedTriplesSnapshot) const;
+
   const CompressedRelationReader& reader() const { return reader_.value(); }
 
   Enum permutation() const { return permutation_; }
 
+  // The following three functions fold the delta triples into the permutation
+  // (see `DeltaTriplesManager::compact`).
+  //
+  // Write new versions of all the blocks that contain any of the
+  // `locatedTriples` (with these triples merged in) to the end of the file of
+  // this permutation and return the block metadata of the resulting new
+  // generation of the permutation. This is the original metadata of the
+  // `locatedTriples`, where each affected block is replaced by its new
+  // version(s). The existing blocks are neither changed nor removed, so scans
+  // that still use an older generation are not affected.
+  std::vector<CompressedBlockMetadata> writeCompactedBlocks(
+      const LocatedTriplesPerBlock& locatedTriples,
+      const CancellationHandle& cancellationHandle) const;
+
+  // Append the metadata of the new generation (as returned by
+  // `writeCompactedBlocks`) to the file, s.t. it is used when the permutation
+  // is loaded the next time.
+  void commitCompaction(
+      const std::vector<CompressedBlockMetadata>& blocks) const;
+
+  // Remove the blocks that were written by `writeCompactedBlocks` from the
+  // file again (if there are any). This also happens automatically in
+  // `loadFromDisk` if the server crashed before the compaction was committed.
+  void abortCompaction() const;
+
  private:
   // Readable name for this permutation, e.g., `POS`.
   std::string readableName_;
@@ -195,6 +231,8 @@ class Permutation {
   KeyOrder keyOrder_;
   // The metadata for this permutation.
   MetaData meta_;
+  // The name of the file that contains the blocks and the metadata.
+  std::string filename_;
 
   // This member is `optional` because we initialize it in a deferred way in the
   // `loadFromDisk` method.
@@ -209,6 +247,17 @@ class Permutation {
   std::function<bool(Id)> isInternalId_;
 
   bool isInternalPermutation_ = false;
+
+  // The search index for the block boundaries in `meta_`. It is only needed
+  // (and only built) for the internal permutation, which is never updated. For
+  // all other permutations, the search index is part of the
+  // `LocatedTriplesPerBlock`.
+  std::optional<BlockMetadataSearchIndex> internalMetadataSearchIndex_;
+
+  // The augmented block metadata as a single span (see
+  // `getAugmentedMetadataForPermutation`).
+  BlockMetadataSpan getAugmentedMetadataSpan(
+      const LocatedTriplesSnapshot& locatedTriplesSnapshot) const;
 };
 
 #endif  // QLEVER_SRC_INDEX_PERMUTATION_H
@@ -38,6 +38,16 @@ std::optional<ParallelBuffer::BufferType> ParallelFileBuffer::getNextBlock() {
   return ret;
 }
 
+// ____________________________________________________________________________
+std::optional<ParallelBuffer::BufferType> ParallelStringBuffer::getNextBlock() {
+  if (input_.empty()) {
+    return std::nullopt;
+  }
+  auto block = input_.substr(0, blocksize_);
+  input_.remove_prefix(block.size());
+  return BufferType(block.begin(), block.end());
+}
+
 // ____________________________________________________________________________
 std::optional<size_t> ParallelBufferWithEndRegex::findRegexNearEnd(
     const BufferType& vec, const re2::RE2& regex) {
@@ -74,7 +84,7 @@ std::optional<ParallelBuffer::BufferType>
 ParallelBufferWithEndRegex::getNextBlock() {
   // Get the block of data read asynchronously after the previous call
   // to `getNextBlock`.
-  auto rawInput = rawBuffer_.getNextBlock();
+  auto rawInput = rawBuffer_->getNextBlock();
 
   // If there was no more data, return the remainder or `std::nullopt` if
   // it is empty.
@@ -100,7 +110,7 @@ ParallelBufferWithEndRegex::getNextBlock() {
   // last block (then `getNextBlock` will return `std::nullopt`, and we simply
   // concatenate it to the remainder).
   if (!endPosition) {
-    if (rawBuffer_.getNextBlock()) {
+    if (rawBuffer_->getNextBlock()) {
       throw std::runtime_error(absl::StrCat(
           "The regex ", endRegexAsString_,
           " which marks the end of a statement was not found in the current "
@@ -9,8 +9,10 @@
 #include <re2/re2.h>
 
 #include <future>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../util/File.h"
@@ -81,12 +83,41 @@ class ParallelFileBuffer : public ParallelBuffer {
   std::future<size_t> fut_;
 };
 
+// Pass the bytes of a string that is already in memory in blocks of
+// `blocksize_` bytes (the last block might be smaller). The string is not
+// copied, so it has to outlive the buffer.
+class ParallelStringBuffer : public ParallelBuffer {
+ public:
+  ParallelStringBuffer(size_t blocksize, std::string_view input)
+      : ParallelBuffer{blocksize}, input_{input} {}
+
+  // The input is already specified in the constructor, so there is nothing to
+  // open. The `filename` is ignored.
+  void open([[maybe_unused]] const std::string& filename) override {}
+
+  // _____________________________________________________
+  std::optional<BufferType> getNextBlock() override;
+
+ private:
+  std::string_view input_;
+};
+
 // A parallel buffer that reads input from the file in blocks, where each block,
 // except possibly the last, ends with `endRegex`.
 class ParallelBufferWithEndRegex : public ParallelBuffer {
  public:
   ParallelBufferWithEndRegex(size_t blocksize, std::string endRegex)
       : ParallelBuffer{blocksize},
+        rawBuffer_{std::make_unique<ParallelFileBuffer>(blocksize)},
+        endRegex_{endRegex},
+        endRegexAsString_{std::move(endRegex)} {}
+
+  // Read the input from the given `rawBuffer` instead of from a file. The
+  // `rawBuffer` has to be ready for reading, so `open` must not be called.
+  ParallelBufferWithEndRegex(std::unique_ptr<ParallelBuffer> rawBuffer,
+                             std::string endRegex)
+      : ParallelBuffer{rawBuffer->getBlocksize()},
+        rawBuffer_{std::move(rawBuffer)},
         endRegex_{endRegex},
         endRegexAsString_{std::move(endRegex)} {}
 
@@ -97,7 +128,9 @@ class ParallelBufferWithEndRegex : public ParallelBuffer {
   std::optional<BufferType> getNextBlock() override;
 
   // Open the file from which the blocks are read.
-  void open(const std::string& filename) override { rawBuffer_.open(filename); }
+  void open(const std::string& filename) override {
+    rawBuffer_->open(filename);
+  }
 
  private:
   // Find `regex` near the end of `vec` by searching in blocks of 1000, 2000,
@@ -106,7 +139,7 @@ class ParallelBufferWithEndRegex : public ParallelBuffer {
   // of the regex match, or std::nullopt if the regex was not found at all.
   static std::optional<size_t> findRegexNearEnd(const BufferType& vec,
                                                 const re2::RE2& regex);
-  ParallelFileBuffer rawBuffer_{blocksize_};
+  std::unique_ptr<ParallelBuffer> rawBuffer_;
   BufferType remainder_;
   re2::RE2 endRegex_;
   std::string endRegexAsString_;
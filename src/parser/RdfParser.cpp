@@ -50,7 +50,8 @@ bool TurtleParser<T>::statement() {
 
 // _____________________________________________________________________________
 template <class Tokenizer_T>
-void TurtleParser<Tokenizer_T>::raise(std::string_view error_message) const {
+void TurtleParser<Tokenizer_T>::raise(std::string_view error_message,
+                                      bool unsupportedByParallelParser) const {
   auto d = tok_.view();
   std::stringstream errorMessage;
   errorMessage << "Parse error at byte position " << getParsePosition() << ": "
@@ -61,6 +62,9 @@ void TurtleParser<Tokenizer_T>::raise(std::string_view error_message) const {
     errorMessage << "The next " << num_bytes << " bytes are:\n"
                  << std::string_view(d.data(), s) << '\n';
   }
+  if (unsupportedByParallelParser) {
+    throw UnsupportedByParallelParserException{std::move(errorMessage).str()};
+  }
   throw ParseException{std::move(errorMessage).str()};
 }
 
@@ -603,7 +607,8 @@ void TurtleParser<Tokenizer_T>::raiseDisallowedPrefixOrBaseError() const {
       "fine. Use '--parse-parallel false' if you can't guarantee this. If "
       "the reason for this error is that the input is a concatenation of "
       "Turtle files, each of which has the prefixes at the beginning, you "
-      "should feed the files to QLever separately instead of concatenated");
+      "should feed the files to QLever separately instead of concatenated",
+      true);
 }
 
 // _____________________________________________________________________________
@@ -768,9 +773,11 @@ template <class Tokenizer_T>
 TripleComponent::Iri TurtleParser<Tokenizer_T>::expandPrefix(
     const std::string& prefix) {
   if (!prefixMap_.count(prefix)) {
+    // With the parallel parser, the declaration might be in a later batch.
     raise("Prefix " + prefix +
-          " was not previously defined using a PREFIX or @prefix "
-          "declaration");
+              " was not previously defined using a PREFIX or @prefix "
+              "declaration",
+          prefixAndBaseDisabled_);
   } else {
     return prefixMap_[prefix];
   }
@@ -1158,8 +1165,24 @@ void RdfParallelParser<T>::initialize(const string& filename,
                                       ad_utility::MemorySize bufferSize) {
   fileBuffer_ = std::make_unique<ParallelBufferWithEndRegex>(
       bufferSize.getBytes(), "\\.[\\t ]*([\\r\\n]+)");
-  ParallelBuffer::BufferType remainingBatchFromInitialization;
   fileBuffer_->open(filename);
+  startParsing();
+}
+
+// _______________________________________________________________________
+template <class T>
+void RdfParallelParser<T>::initializeFromString(
+    std::string_view input, ad_utility::MemorySize bufferSize) {
+  fileBuffer_ = std::make_unique<ParallelBufferWithEndRegex>(
+      std::make_unique<ParallelStringBuffer>(bufferSize.getBytes(), input),
+      "\\.[\\t ]*([\\r\\n]+)");
+  startParsing();
+}
+
+// _______________________________________________________________________
+template <class T>
+void RdfParallelParser<T>::startParsing() {
+  ParallelBuffer::BufferType remainingBatchFromInitialization;
   if (auto batch = fileBuffer_->getNextBlock(); !batch) {
     LOG(WARN) << "Empty input to the TURTLE parser, is this what you intended?"
               << std::endl;
@@ -34,6 +34,15 @@ enum class TurtleParserIntegerOverflowBehavior {
   AllToDouble
 };
 
+// Thrown by a `TurtleParser` that is used by the `RdfParallelParser` (see
+// `disablePrefixParsing`) if a `@prefix` or `@base` directive is not at the
+// beginning of the input, or if a prefix is not declared there. Such an input
+// might still be valid and can then be parsed by a sequential parser.
+class UnsupportedByParallelParserException : public ParseException {
+ public:
+  using ParseException::ParseException;
+};
+
 struct TurtleTriple {
   // TODO<joka921> The subject can only be IRI or BlankNode.
   TripleComponent subject_;
@@ -239,8 +248,11 @@ class TurtleParser : public RdfParserBase {
 
   virtual bool statement();
 
-  // Log error message (with parse position) and throw parse exception.
-  [[noreturn]] void raise(std::string_view error_message) const;
+  // Log error message (with parse position) and throw parse exception. If
+  // `unsupportedByParallelParser` is true, the exception is an
+  // `UnsupportedByParallelParserException`.
+  [[noreturn]] void raise(std::string_view error_message,
+                          bool unsupportedByParallelParser = false) const;
 
   // Throw an exception or simply ignore the current triple, depending on the
   // setting of `invalidLiteralsAreSkipped()`.
@@ -616,6 +628,13 @@ class RdfParallelParser : public Parser {
   void initialize(const std::string& filename,
                   ad_utility::MemorySize bufferSize);
 
+  // Parse the `input`, which is already in memory, instead of a file. The
+  // `input` is split into batches of about `bufferSize` bytes, which are
+  // parsed in parallel, just like the batches of a file. The `input` has to
+  // outlive the parser.
+  void initializeFromString(std::string_view input,
+                            ad_utility::MemorySize bufferSize);
+
   size_t getParsePosition() const override {
     // TODO: can we really define this position here?
     return 0;
@@ -635,6 +654,11 @@ class RdfParallelParser : public Parser {
   template <typename Batch>
   void parseBatch(size_t parsePosition, Batch batch);
 
+  // Parse the prefix declarations at the beginning of the input of the
+  // `fileBuffer_` and start feeding the batches to the parallel parser
+  // threads. The `fileBuffer_` has to be ready for reading.
+  void startParsing();
+
   // Read all the batches from the file and feed them to the parallel parser
   // threads. The argument is the first batch which might have been leftover
   // from the initialization phase where the prefixes are parsed.
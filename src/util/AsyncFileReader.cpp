@@ -0,0 +1,265 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "util/AsyncFileReader.h"
+
+#include <absl/strings/str_cat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "util/Exception.h"
+
+#ifdef QLEVER_USE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace ad_utility {
+
+namespace {
+// Return the exception for a failed read with the given (positive) `errnum`.
+std::runtime_error readError(int errnum) {
+  return std::runtime_error(
+      absl::StrCat("Reading from a file failed: ", std::strerror(errnum)));
+}
+
+// Throw an exception for a failed read with the given (positive) `errnum`.
+[[noreturn]] void throwReadError(int errnum) { throw readError(errnum); }
+
+// Throw an exception for a read that hit the end of the file.
+[[noreturn]] void throwUnexpectedEndOfFile() {
+  throw std::runtime_error(
+      "Reading from a file failed: Unexpected end of file");
+}
+
+#ifdef QLEVER_USE_IO_URING
+// An `io_uring` that is created on first use for each thread and destroyed
+// when the thread exits.
+class ThreadLocalRing {
+  io_uring ring_;
+  bool isValid_ = false;
+
+ public:
+  ThreadLocalRing() {
+    isValid_ =
+        io_uring_queue_init(AsyncFileReader::queueDepth, &ring_, 0) == 0;
+  }
+  ~ThreadLocalRing() {
+    if (isValid_) {
+      io_uring_queue_exit(&ring_);
+    }
+  }
+  ThreadLocalRing(const ThreadLocalRing&) = delete;
+  ThreadLocalRing& operator=(const ThreadLocalRing&) = delete;
+
+  // Return the ring, or `nullptr` if it couldn't be created (e.g. because
+  // `io_uring` is disabled in the kernel) or has been invalidated.
+  io_uring* get() { return isValid_ ? &ring_ : nullptr; }
+
+  // Destroy the ring. Afterwards, `get()` returns `nullptr`, so the thread
+  // falls back to `pread`.
+  void invalidate() {
+    if (isValid_) {
+      io_uring_queue_exit(&ring_);
+      isValid_ = false;
+    }
+  }
+};
+
+ThreadLocalRing& getThreadLocalRing() {
+  static thread_local ThreadLocalRing ring;
+  return ring;
+}
+
+// The `user_data` of the request that cancels all the requests in flight.
+constexpr uint64_t cancelUserData = std::numeric_limits<uint64_t>::max();
+
+// Submit the prepared requests of the `ring` and wait for at least one
+// completion. Return a negative error code on failure (see
+// `io_uring_submit_and_wait`).
+int submitAndWait(io_uring* ring) {
+  if (AsyncFileReader::numFailingSubmissionsForTesting_ > 0) {
+    --AsyncFileReader::numFailingSubmissionsForTesting_;
+    return -EIO;
+  }
+  return io_uring_submit_and_wait(ring, 1);
+}
+
+// The implementation of `readBatch` using the `threadLocalRing`. Short reads
+// are resubmitted for the remaining bytes. If an error occurs (this includes
+// exceptions thrown by `onCompletion` and failures of the ring itself), no
+// further requests are submitted, but we wait for all the requests that are in
+// flight (they write to buffers that are owned by the caller) before
+// rethrowing. This also leaves no stale completions in the ring.
+void readBatchWithIoUring(
+    ThreadLocalRing& threadLocalRing, int fileDescriptor,
+    ql::span<const AsyncFileReader::ReadRequest> requests,
+    const std::function<void(size_t)>& onCompletion) {
+  io_uring* ring = threadLocalRing.get();
+  AD_CORRECTNESS_CHECK(ring != nullptr);
+  std::vector<size_t> bytesRead(requests.size(), 0);
+  std::vector<size_t> toResubmit;
+  size_t nextRequest = 0;
+  size_t numInFlight = 0;
+  std::exception_ptr error = nullptr;
+  bool ringHasFailed = false;
+
+  auto submit = [&](size_t i) {
+    io_uring_sqe* sqe = io_uring_get_sqe(ring);
+    AD_CORRECTNESS_CHECK(sqe != nullptr);
+    const auto& request = requests[i];
+    io_uring_prep_read(sqe, fileDescriptor, request.target_ + bytesRead[i],
+                       request.size_ - bytesRead[i],
+                       request.offset_ + static_cast<off_t>(bytesRead[i]));
+    sqe->user_data = i;
+    ++numInFlight;
+  };
+
+  auto hasPendingRequests = [&]() {
+    return !toResubmit.empty() || nextRequest < requests.size();
+  };
+
+  std::vector<size_t> completed;
+  while (numInFlight > 0 || (!error && hasPendingRequests())) {
+    while (!error && numInFlight < AsyncFileReader::queueDepth &&
+           hasPendingRequests()) {
+      if (!toResubmit.empty()) {
+        submit(toResubmit.back());
+        toResubmit.pop_back();
+      } else {
+        submit(nextRequest++);
+      }
+    }
+    int ret = submitAndWait(ring);
+    if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+      if (!error) {
+        error = std::make_exception_ptr(readError(-ret));
+      }
+      if (ringHasFailed) {
+        // The ring has failed again, so we can't wait for the requests in
+        // flight. Destroy it, which makes the kernel cancel them, and don't
+        // use it for this thread anymore.
+        threadLocalRing.invalidate();
+        std::rethrow_exception(error);
+      }
+      // Cancel all the requests in flight and wait for their completions.
+      // The submission queue might be full with requests that still have to
+      // be submitted, then we simply wait for them to complete.
+      ringHasFailed = true;
+      if (io_uring_sqe* sqe = io_uring_get_sqe(ring)) {
+        io_uring_prep_cancel64(sqe, 0, IORING_ASYNC_CANCEL_ANY);
+        sqe->user_data = cancelUserData;
+        ++numInFlight;
+      }
+      continue;
+    }
+
+    // Process all the available completions.
+    io_uring_cqe* cqe;
+    unsigned head;
+    unsigned numSeen = 0;
+    io_uring_for_each_cqe(ring, head, cqe) {
+      ++numSeen;
+      --numInFlight;
+      if (cqe->user_data == cancelUserData) {
+        continue;
+      }
+      auto i = static_cast<size_t>(cqe->user_data);
+      int result = cqe->res;
+      if (result == -EAGAIN || result == -EINTR) {
+        toResubmit.push_back(i);
+      } else if (result < 0) {
+        if (!error) {
+          error = std::make_exception_ptr(readError(-result));
+        }
+      } else if (result == 0 && bytesRead[i] < requests[i].size_) {
+        if (!error) {
+          error = std::make_exception_ptr(std::runtime_error(
+              "Reading from a file failed: Unexpected end of file"));
+        }
+      } else {
+        bytesRead[i] += static_cast<size_t>(result);
+        if (bytesRead[i] < requests[i].size_) {
+          toResubmit.push_back(i);
+        } else {
+          completed.push_back(i);
+        }
+      }
+    }
+    io_uring_cq_advance(ring, numSeen);
+
+    // Call the `onCompletion` handlers after advancing the completion queue,
+    // so an exception doesn't leave the ring in an inconsistent state.
+    for (size_t i : completed) {
+      if (error) {
+        break;
+      }
+      try {
+        onCompletion(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    completed.clear();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+#endif
+}  // namespace
+
+// _____________________________________________________________________________
+void AsyncFileReader::readBatch(
+    int fileDescriptor, ql::span<const ReadRequest> requests,
+    const std::function<void(size_t)>& onCompletion) {
+#ifdef QLEVER_USE_IO_URING
+  if (auto& ring = getThreadLocalRing(); ring.get() != nullptr) {
+    readBatchWithIoUring(ring, fileDescriptor, requests, onCompletion);
+    return;
+  }
+#endif
+  readBatchWithPread(fileDescriptor, requests, onCompletion);
+}
+
+// _____________________________________________________________________________
+bool AsyncFileReader::usesIoUring() {
+#ifdef QLEVER_USE_IO_URING
+  return getThreadLocalRing().get() != nullptr;
+#else
+  return false;
+#endif
+}
+
+// _____________________________________________________________________________
+void AsyncFileReader::readBatchWithPread(
+    int fileDescriptor, ql::span<const ReadRequest> requests,
+    const std::function<void(size_t)>& onCompletion) {
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto& request = requests[i];
+    size_t bytesRead = 0;
+    while (bytesRead < request.size_) {
+      ssize_t ret = pread(fileDescriptor, request.target_ + bytesRead,
+                          request.size_ - bytesRead,
+                          request.offset_ + static_cast<off_t>(bytesRead));
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throwReadError(errno);
+      }
+      if (ret == 0) {
+        throwUnexpectedEndOfFile();
+      }
+      bytesRead += static_cast<size_t>(ret);
+    }
+    onCompletion(i);
+  }
+}
+}  // namespace ad_utility
@@ -0,0 +1,67 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_UTIL_ASYNCFILEREADER_H
+#define QLEVER_SRC_UTIL_ASYNCFILEREADER_H
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <functional>
+
+#include "backports/span.h"
+
+namespace ad_utility {
+
+// Read many (possibly non-contiguous) ranges of a file with a single call. If
+// QLever is compiled with `USE_IO_URING` (which requires `liburing`) and the
+// kernel supports it, all the reads are submitted to an `io_uring` at once, so
+// that a single thread can keep the I/O queue of the device deep. Otherwise
+// (and if the creation of the `io_uring` fails at runtime) the reads are
+// performed one after the other using `pread`.
+//
+// Each thread uses its own `io_uring` which is created on first use and then
+// reused, so the functions of this class can be called concurrently from
+// different threads.
+class AsyncFileReader {
+ public:
+  // A single read request: Read `size_` bytes starting at `offset_` in the
+  // file into the `target_`, which must have space for at least `size_` bytes.
+  struct ReadRequest {
+    off_t offset_;
+    size_t size_;
+    char* target_;
+  };
+
+  // The maximal number of requests that are in flight at the same time.
+  static constexpr size_t queueDepth = 64;
+
+  // Read all the `requests` from the file with the given `fileDescriptor`.
+  // The `onCompletion` function is called with the index of each request (in
+  // the `requests`) as soon as the request has been completely read. The order
+  // of these calls is unspecified. The calls happen on the calling thread, so
+  // they may perform expensive work (e.g. decompression) while the remaining
+  // reads are still in flight. Throws if one of the reads fails or if the file
+  // is too short.
+  static void readBatch(int fileDescriptor,
+                        ql::span<const ReadRequest> requests,
+                        const std::function<void(size_t)>& onCompletion);
+
+  // Return true iff the batches are read via `io_uring`. This is false if
+  // QLever was compiled without `USE_IO_URING` or if the kernel doesn't
+  // support `io_uring`.
+  static bool usesIoUring();
+
+  // For testing: The number of the next submissions to the `io_uring` of the
+  // current thread that fail with `EIO` (without submitting anything).
+  static inline thread_local size_t numFailingSubmissionsForTesting_ = 0;
+
+ private:
+  // The fallback implementation via `pread`.
+  static void readBatchWithPread(
+      int fileDescriptor, ql::span<const ReadRequest> requests,
+      const std::function<void(size_t)>& onCompletion);
+};
+}  // namespace ad_utility
+
+#endif  // QLEVER_SRC_UTIL_ASYNCFILEREADER_H
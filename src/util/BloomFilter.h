@@ -0,0 +1,109 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_UTIL_BLOOMFILTER_H
+#define QLEVER_SRC_UTIL_BLOOMFILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "util/Exception.h"
+#include "util/Serializer/SerializeVector.h"
+#include "util/Serializer/Serializer.h"
+
+namespace ad_utility {
+
+// A simple Bloom filter for 64-bit keys. A default-constructed filter has no
+// bits and is interpreted as "no information", so `mayContain` always returns
+// true for it. The bit positions of a key are derived from a single 64-bit
+// hash via double hashing (Kirsch and Mitzenmacher), which makes the filter
+// deterministic, so it can be stored on disk.
+class BloomFilter {
+ private:
+  std::vector<uint64_t> words_;
+  uint64_t numHashFunctions_ = 0;
+
+ public:
+  // The maximal number of hash functions. More hash functions don't decrease
+  // the false positive rate significantly for any reasonable `bitsPerKey`.
+  static constexpr uint64_t maxNumHashFunctions = 16;
+
+  // Create an empty filter ("no information", see above).
+  BloomFilter() = default;
+
+  // Create a filter that is dimensioned for `numKeys` keys with `bitsPerKey`
+  // bits each. For example, 10 bits per key yield a false positive rate of
+  // about 1%.
+  BloomFilter(size_t numKeys, size_t bitsPerKey) {
+    AD_CONTRACT_CHECK(bitsPerKey > 0);
+    size_t numWords = std::max(size_t{1}, (numKeys * bitsPerKey + 63) / 64);
+    words_.resize(numWords, 0);
+    auto k = static_cast<uint64_t>(std::round(bitsPerKey * std::log(2.0)));
+    numHashFunctions_ = std::clamp(k, uint64_t{1}, maxNumHashFunctions);
+  }
+
+  // Return true iff this filter has no bits (see above).
+  bool empty() const { return words_.empty(); }
+
+  // Add the `key` to the filter. Must not be called on an empty filter.
+  void add(uint64_t key) {
+    AD_CORRECTNESS_CHECK(!empty());
+    forEachBit(key, [this](uint64_t bit) {
+      words_[bit / 64] |= uint64_t{1} << (bit % 64);
+      return true;
+    });
+  }
+
+  // Return false if the `key` was definitely not added to this filter, and
+  // true if it may have been added.
+  bool mayContain(uint64_t key) const {
+    if (empty()) {
+      return true;
+    }
+    return forEachBit(key, [this](uint64_t bit) {
+      return ((words_[bit / 64] >> (bit % 64)) & 1) != 0;
+    });
+  }
+
+  // Return the size of the filter in bytes.
+  size_t sizeInBytes() const { return words_.size() * sizeof(uint64_t); }
+
+  bool operator==(const BloomFilter&) const = default;
+
+  AD_SERIALIZE_FRIEND_FUNCTION(BloomFilter) {
+    serializer | arg.words_;
+    serializer | arg.numHashFunctions_;
+  }
+
+ private:
+  // The finalizer of the `SplitMix64` generator, which maps keys that differ
+  // only in a few bits (as is the case for neighboring `Id`s) to very
+  // different hashes.
+  static uint64_t hash(uint64_t key) {
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+  }
+
+  // Call `function` for each of the bit positions of the `key` as long as it
+  // returns true. Return false iff one of the calls returned false.
+  template <typename F>
+  bool forEachBit(uint64_t key, const F& function) const {
+    uint64_t numBits = words_.size() * 64;
+    uint64_t h = hash(key);
+    uint64_t h1 = h & 0xffffffff;
+    // Make the second hash odd, so that it is never zero.
+    uint64_t h2 = (h >> 32) | 1;
+    for (uint64_t i = 0; i < numHashFunctions_; ++i) {
+      if (!function((h1 + i * h2) % numBits)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+}  // namespace ad_utility
+
+#endif  // QLEVER_SRC_UTIL_BLOOMFILTER_H
@@ -141,6 +141,13 @@ class File {
     return fseeko(file_, seekOffset, seekOrigin) == 0;
   }
 
+  //! Return the underlying file descriptor, e.g. for reading from the file
+  //! via `AsyncFileReader`.
+  int fileDescriptor() const {
+    assert(file_);
+    return fileno(file_);
+  }
+
   //! Read nofBytesToRead bytes from file starting at the given offset.
   //! Returns the number of bytes read or the error returned by pread()
   //! which is < 0
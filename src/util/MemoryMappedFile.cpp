@@ -0,0 +1,45 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include "util/MemoryMappedFile.h"
+
+#include <absl/strings/str_cat.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace ad_utility {
+
+// _____________________________________________________________________________
+MemoryMappedFile::MemoryMappedFile(int fileDescriptor) {
+  auto throwError = [](std::string_view what) {
+    throw std::runtime_error(absl::StrCat("Memory mapping a file failed (", what,
+                                          "): ", std::strerror(errno)));
+  };
+  struct stat fileStatus;
+  if (fstat(fileDescriptor, &fileStatus) != 0) {
+    throwError("fstat");
+  }
+  size_ = static_cast<size_t>(fileStatus.st_size);
+  // `mmap` doesn't allow empty mappings.
+  if (size_ == 0) {
+    return;
+  }
+  void* ptr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+  if (ptr == MAP_FAILED) {
+    size_ = 0;
+    throwError("mmap");
+  }
+  data_ = static_cast<const char*>(ptr);
+}
+
+// _____________________________________________________________________________
+MemoryMappedFile::~MemoryMappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+}  // namespace ad_utility
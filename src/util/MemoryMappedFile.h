@@ -0,0 +1,49 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_UTIL_MEMORYMAPPEDFILE_H
+#define QLEVER_SRC_UTIL_MEMORYMAPPEDFILE_H
+
+#include <cstddef>
+#include <utility>
+
+#include "backports/span.h"
+
+namespace ad_utility {
+
+// A read-only memory mapping of a complete file. The mapping stays valid
+// independently of the file descriptor from which it was created, until the
+// `MemoryMappedFile` is destroyed.
+class MemoryMappedFile {
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+
+ public:
+  // Create an empty mapping.
+  MemoryMappedFile() = default;
+
+  // Map the complete file with the given `fileDescriptor` (which must be open
+  // for reading) into memory. Throws if the mapping fails.
+  explicit MemoryMappedFile(int fileDescriptor);
+
+  ~MemoryMappedFile();
+
+  // Movable, but not copyable.
+  MemoryMappedFile(MemoryMappedFile&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+  MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  // The contents of the file.
+  ql::span<const char> bytes() const { return {data_, size_}; }
+};
+}  // namespace ad_utility
+
+#endif  // QLEVER_SRC_UTIL_MEMORYMAPPEDFILE_H
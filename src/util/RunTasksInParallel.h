@@ -0,0 +1,145 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#ifndef QLEVER_SRC_UTIL_RUNTASKSINPARALLEL_H
+#define QLEVER_SRC_UTIL_RUNTASKSINPARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ad_utility {
+
+// A fixed set of threads that runs batches of tasks. In contrast to
+// `runTasksInParallel` below, the threads are only created once, so this is
+// suitable for many small batches (for example, one batch for each block of a
+// lazy result).
+class ParallelTaskRunner {
+ private:
+  std::mutex mutex_;
+  std::condition_variable batchStarted_;
+  std::condition_variable batchFinished_;
+  // The current batch. It is only changed while no worker processes it.
+  const std::function<void(size_t)>* task_ = nullptr;
+  size_t numTasks_ = 0;
+  std::atomic<size_t> nextTask_ = 0;
+  size_t batchNumber_ = 0;
+  size_t numBusyWorkers_ = 0;
+  bool shutdown_ = false;
+  // The first exception thrown by a task of the current batch.
+  std::exception_ptr error_ = nullptr;
+  std::vector<std::thread> workers_;
+
+ public:
+  // Use `numThreads` threads, including the thread that calls `run`.
+  explicit ParallelTaskRunner(size_t numThreads) {
+    for (size_t i = 1; i < numThreads; ++i) {
+      workers_.emplace_back([this]() { workerLoop(); });
+    }
+  }
+
+  ~ParallelTaskRunner() {
+    {
+      std::lock_guard lock{mutex_};
+      shutdown_ = true;
+    }
+    batchStarted_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ParallelTaskRunner(const ParallelTaskRunner&) = delete;
+  ParallelTaskRunner& operator=(const ParallelTaskRunner&) = delete;
+
+  // The number of threads, including the thread that calls `run`.
+  size_t numThreads() const { return workers_.size() + 1; }
+
+  // Run `task(i)` for all `i` in `[0, numTasks)` and return when all of them
+  // have finished. If one of the tasks throws, no further tasks are started,
+  // and the exception is rethrown as soon as all the running tasks have
+  // finished.
+  void run(size_t numTasks, const std::function<void(size_t)>& task) {
+    if (numTasks == 0) {
+      return;
+    }
+    {
+      std::lock_guard lock{mutex_};
+      task_ = &task;
+      numTasks_ = numTasks;
+      nextTask_ = 0;
+      numBusyWorkers_ = workers_.size();
+      ++batchNumber_;
+    }
+    batchStarted_.notify_all();
+    processTasks();
+    std::unique_lock lock{mutex_};
+    batchFinished_.wait(lock, [this]() { return numBusyWorkers_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+      std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+  }
+
+ private:
+  // Process the tasks of the current batch until there are none left.
+  void processTasks() {
+    try {
+      for (size_t i = nextTask_++; i < numTasks_; i = nextTask_++) {
+        (*task_)(i);
+      }
+    } catch (...) {
+      nextTask_ = numTasks_;
+      std::lock_guard lock{mutex_};
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+  }
+
+  // Wait for the next batch, take part in it, and repeat until shutdown.
+  void workerLoop() {
+    size_t lastBatch = 0;
+    while (true) {
+      {
+        std::unique_lock lock{mutex_};
+        batchStarted_.wait(lock, [this, lastBatch]() {
+          return shutdown_ || batchNumber_ != lastBatch;
+        });
+        if (shutdown_) {
+          return;
+        }
+        lastBatch = batchNumber_;
+      }
+      processTasks();
+      std::lock_guard lock{mutex_};
+      if (--numBusyWorkers_ == 0) {
+        batchFinished_.notify_one();
+      }
+    }
+  }
+};
+
+// Run `task(i)` for all `i` in `[0, numTasks)` using up to `numThreads`
+// threads (including the calling thread). If one of the tasks throws, no
+// further tasks are started, and the exception is rethrown as soon as all the
+// running tasks have finished. The threads are created for this call only, use
+// a `ParallelTaskRunner` to run many batches of tasks.
+inline void runTasksInParallel(size_t numTasks, size_t numThreads,
+                               const std::function<void(size_t)>& task) {
+  if (numTasks == 0) {
+    return;
+  }
+  ParallelTaskRunner runner{std::clamp(numThreads, size_t{1}, numTasks)};
+  runner.run(numTasks, task);
+}
+
+}  // namespace ad_utility
+
+#endif  // QLEVER_SRC_UTIL_RUNTASKSINPARALLEL_H
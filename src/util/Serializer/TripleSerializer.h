@@ -5,6 +5,7 @@
 #pragma once
 
 #include <absl/container/flat_hash_map.h>
+#include <unistd.h>
 
 #include <array>
 #include <filesystem>
@@ -15,7 +16,9 @@
 #include "backports/concepts.h"
 #include "engine/LocalVocab.h"
 #include "global/Id.h"
+#include "util/Algorithm.h"
 #include "util/Exception.h"
+#include "util/Serializer/ByteBufferSerializer.h"
 #include "util/Serializer/FileSerializer.h"
 #include "util/Serializer/SerializeArrayOrTuple.h"
 #include "util/Serializer/SerializeString.h"
@@ -24,6 +27,20 @@
 
 namespace ad_utility {
 
+// A mapping from the (serialized) blank nodes of a file to the blank nodes that
+// were created for them when deserializing the file. When several files (or
+// records) refer to the same blank nodes, they must be deserialized with the
+// same mapping.
+using BlankNodeMapping = absl::flat_hash_map<Id, BlankNodeIndex>;
+
+// One batch of inserted or deleted triples in an update log (see
+// `appendToUpdateLog` below). The `ids_` of the triples are stored
+// consecutively, like in the other functions of this file.
+struct UpdateLogRecord {
+  bool insertOrDelete_;
+  std::vector<Id> ids_;
+};
+
 namespace detail {
 
 constexpr std::array magicBytes{'Q', 'L', 'E', 'V', 'E', 'R', '.',
@@ -76,12 +93,13 @@ CPP_template(typename Serializer)(
   });
 }
 
-// Deserialize the local vocabulary from the input stream.
+// Deserialize the local vocabulary from the input stream and add its entries to
+// the given `vocab`. Returns a mapping from the serialized Ids to the Ids of
+// the entries in `vocab`.
 CPP_template(typename Serializer)(
-    requires serialization::ReadSerializer<Serializer>) std::
-    tuple<LocalVocab, absl::flat_hash_map<Id::T, Id>> deserializeLocalVocab(
-        Serializer& serializer) {
-  LocalVocab vocab;
+    requires serialization::ReadSerializer<Serializer>)
+    absl::flat_hash_map<Id::T, Id> deserializeLocalVocab(
+        Serializer& serializer, LocalVocab& vocab) {
   auto size = readValue<uint64_t>(serializer);
   // Note:: It might happen that the `size` is zero because the local vocab was
   // empty.
@@ -94,6 +112,16 @@ CPP_template(typename Serializer)(
         LocalVocabEntry::fromStringRepresentation(std::move(s)));
     mapping.emplace(id, Id::makeFromLocalVocabIndex(localVocabIndex));
   }
+  return mapping;
+}
+
+// Deserialize the local vocabulary from the input stream.
+CPP_template(typename Serializer)(
+    requires serialization::ReadSerializer<Serializer>) std::
+    tuple<LocalVocab, absl::flat_hash_map<Id::T, Id>> deserializeLocalVocab(
+        Serializer& serializer) {
+  LocalVocab vocab;
+  auto mapping = deserializeLocalVocab(serializer, vocab);
   return {std::move(vocab), std::move(mapping)};
 }
 
@@ -112,15 +140,16 @@ CPP_template(typename Range, typename Serializer)(
 }
 
 // Deserialize a range of Ids from the input stream. If an Id is of type
-// LocalVocabIndex, apply the mapping to the Id after reading it.
+// LocalVocabIndex, apply the mapping to the Id after reading it. Blank nodes
+// are mapped via the `blankNodeMapping`, new blank nodes are created via
+// `newBlankNodeIndex`.
 CPP_template(typename Serializer, typename BlankNodeFunc)(
     requires ad_utility::InvocableWithConvertibleReturnType<BlankNodeFunc,
                                                             BlankNodeIndex>)
     std::vector<Id> deserializeIds(
         Serializer& serializer, const absl::flat_hash_map<Id::T, Id>& mapping,
-        BlankNodeFunc newBlankNodeIndex) {
+        BlankNodeMapping& blankNodeMapping, BlankNodeFunc newBlankNodeIndex) {
   std::vector<Id> ids = readValue<std::vector<Id>>(serializer);
-  absl::flat_hash_map<Id, BlankNodeIndex> blankNodeMapping;
   for (Id& id : ids) {
     if (id.getDatatype() == Datatype::LocalVocabIndex) {
       id = mapping.at(id.getBits());
@@ -149,8 +178,13 @@ CPP_template(typename Range)(
   }
 }
 
+// Deserialize the local vocabulary and the ranges of Ids from the given path
+// (as written by `serializeIds` above). If the file doesn't exist, return
+// empty results. The blank nodes are mapped via the `blankNodeMapping` (see
+// above).
 inline std::tuple<LocalVocab, std::vector<std::vector<Id>>> deserializeIds(
-    const std::filesystem::path& path, BlankNodeManager* blankNodeManager) {
+    const std::filesystem::path& path, BlankNodeManager* blankNodeManager,
+    BlankNodeMapping& blankNodeMapping) {
   // This is a minor TOCTOU issue, the file might be gone after this check and
   // before the call to `fopen`, done by `FileReadSerializer`, so ideally we'd
   // handle this as a special exception type of our own `File` class, which
@@ -177,10 +211,99 @@ inline std::tuple<LocalVocab, std::vector<std::vector<Id>>> deserializeIds(
   auto numRanges = detail::readValue<uint64_t>(serializer);
   for ([[maybe_unused]] auto i : ad_utility::integerRange(numRanges)) {
     idVectors.push_back(detail::deserializeIds(
-        serializer, mapping, [blankNodeManager, &vocab]() {
+        serializer, mapping, blankNodeMapping, [blankNodeManager, &vocab]() {
           return vocab.getBlankNodeIndex(blankNodeManager);
         }));
   }
   return {std::move(vocab), std::move(idVectors)};
 }
+
+// Same as above, with a fresh `BlankNodeMapping`.
+inline std::tuple<LocalVocab, std::vector<std::vector<Id>>> deserializeIds(
+    const std::filesystem::path& path, BlankNodeManager* blankNodeManager) {
+  BlankNodeMapping blankNodeMapping;
+  return deserializeIds(path, blankNodeManager, blankNodeMapping);
+}
+
+// Append the given `records` to the update log at the given `path`, which is
+// created if it doesn't exist yet. Each record is self-contained, that is, it
+// contains the words of all the local vocab entries to which its `ids_` refer.
+// In the file, each record is preceded by its size in bytes, so that a record
+// that was only partially written (e.g. because of a crash) can be detected
+// when reading the log.
+inline void appendToUpdateLog(const std::filesystem::path& path,
+                              ql::span<const UpdateLogRecord> records) {
+  bool isNewFile = !std::filesystem::exists(path);
+  serialization::FileWriteSerializer serializer{File{path.c_str(), "a"}};
+  if (isNewFile) {
+    detail::writeHeader(serializer);
+  }
+  for (const auto& record : records) {
+    // Collect the local vocab entries of this record.
+    LocalVocab recordVocab;
+    auto ids = ad_utility::transform(record.ids_, [&recordVocab](Id id) {
+      if (id.getDatatype() != Datatype::LocalVocabIndex) {
+        return id;
+      }
+      return Id::makeFromLocalVocabIndex(
+          recordVocab.getIndexAndAddIfNotContained(*id.getLocalVocabIndex()));
+    });
+    serialization::ByteBufferWriteSerializer recordSerializer;
+    recordSerializer << record.insertOrDelete_;
+    detail::serializeLocalVocab(recordSerializer, recordVocab);
+    recordSerializer << ids;
+    const auto& bytes = recordSerializer.data();
+    serializer << uint64_t{bytes.size()};
+    serializer.serializeBytes(bytes.data(), bytes.size());
+  }
+  // The update is only acknowledged after it is on disk.
+  File file = std::move(serializer).file();
+  file.flush();
+  AD_CORRECTNESS_CHECK(::fsync(file.fileDescriptor()) == 0);
+}
+
+// Read all the records from the update log at the given `path` (as written by
+// `appendToUpdateLog` above). If the file doesn't exist, return no records.
+// The local vocab entries of the records are added to the given `vocab`, and
+// the blank nodes are mapped via the `blankNodeMapping` (new ones are also
+// added to the `vocab`). A record that was only partially written is ignored
+// and removed from the file, so that records that are appended later can be
+// read again.
+inline std::vector<UpdateLogRecord> readUpdateLog(
+    const std::filesystem::path& path, LocalVocab& vocab,
+    BlankNodeManager* blankNodeManager, BlankNodeMapping& blankNodeMapping) {
+  if (!std::filesystem::exists(path)) {
+    return {};
+  }
+  auto fileSize = std::filesystem::file_size(path);
+  serialization::FileReadSerializer serializer{path.string()};
+  detail::readHeader(serializer);
+  uint64_t position = sizeof(detail::magicBytes) + sizeof(uint16_t);
+  std::vector<UpdateLogRecord> records;
+  while (position + sizeof(uint64_t) <= fileSize) {
+    auto recordSize = detail::readValue<uint64_t>(serializer);
+    if (position + sizeof(uint64_t) + recordSize > fileSize) {
+      break;
+    }
+    position += sizeof(uint64_t);
+    std::vector<char> bytes(recordSize);
+    serializer.serializeBytes(bytes.data(), bytes.size());
+    position += recordSize;
+    serialization::ByteBufferReadSerializer recordSerializer{std::move(bytes)};
+    auto& record = records.emplace_back();
+    recordSerializer >> record.insertOrDelete_;
+    auto mapping = detail::deserializeLocalVocab(recordSerializer, vocab);
+    record.ids_ = detail::deserializeIds(
+        recordSerializer, mapping, blankNodeMapping,
+        [blankNodeManager, &vocab]() {
+          return vocab.getBlankNodeIndex(blankNodeManager);
+        });
+  }
+  if (position != fileSize) {
+    AD_LOG_WARN << "The last record of the update log " << path
+                << " is incomplete and was removed" << std::endl;
+    std::filesystem::resize_file(path, position);
+  }
+  return records;
+}
 }  // namespace ad_utility
@@ -0,0 +1,146 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "./util/GTestHelpers.h"
+#include "util/AsyncFileReader.h"
+#include "util/File.h"
+#include "util/Random.h"
+
+using ad_utility::AsyncFileReader;
+
+namespace {
+// Write a file with `size` pseudo-random bytes and return its contents.
+std::string writeTestFile(const std::string& filename, size_t size) {
+  std::string contents;
+  ad_utility::SlowRandomIntGenerator<int> randomChar{0, 255};
+  for (size_t i = 0; i < size; ++i) {
+    contents.push_back(static_cast<char>(randomChar()));
+  }
+  ad_utility::File file{filename, "w"};
+  file.write(contents.data(), contents.size());
+  file.close();
+  return contents;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(AsyncFileReader, readBatch) {
+  std::string filename = "asyncFileReaderTest.readBatch.dat";
+  const size_t fileSize = 100'000;
+  auto contents = writeTestFile(filename, fileSize);
+
+  // More requests than the `queueDepth`, including empty ones and ones that
+  // overlap.
+  const size_t numRequests = 3 * AsyncFileReader::queueDepth + 7;
+  ad_utility::SlowRandomIntGenerator<size_t> randomOffset{0, fileSize - 1};
+  std::vector<std::string> targets(numRequests);
+  std::vector<AsyncFileReader::ReadRequest> requests;
+  for (size_t i = 0; i < numRequests; ++i) {
+    auto a = randomOffset();
+    auto b = randomOffset();
+    auto begin = std::min(a, b);
+    auto size = i % 10 == 0 ? 0 : std::max(a, b) - begin;
+    targets[i].resize(size);
+    requests.push_back({static_cast<off_t>(begin), size, targets[i].data()});
+  }
+
+  ad_utility::File file{filename, "r"};
+  std::vector<size_t> numCompletions(numRequests, 0);
+  AsyncFileReader::readBatch(file.fileDescriptor(), requests,
+                             [&](size_t i) { ++numCompletions.at(i); });
+  EXPECT_THAT(numCompletions, ::testing::Each(1u));
+  for (size_t i = 0; i < numRequests; ++i) {
+    EXPECT_EQ(targets[i], contents.substr(requests[i].offset_,
+                                          requests[i].size_));
+  }
+
+  // An empty batch.
+  AsyncFileReader::readBatch(file.fileDescriptor(), {},
+                             [](size_t) { FAIL(); });
+  ad_utility::deleteFile(filename);
+}
+
+// _____________________________________________________________________________
+TEST(AsyncFileReader, errors) {
+  std::string filename = "asyncFileReaderTest.errors.dat";
+  auto contents = writeTestFile(filename, 100);
+  ad_utility::File file{filename, "r"};
+  std::string target(50, 'x');
+
+  // Reading beyond the end of the file.
+  std::vector<AsyncFileReader::ReadRequest> requests{{80, 50, target.data()}};
+  EXPECT_ANY_THROW(AsyncFileReader::readBatch(file.fileDescriptor(), requests,
+                                              [](size_t) {}));
+
+  // An exception in the `onCompletion` handler is propagated after all the
+  // requests in flight have completed.
+  requests.clear();
+  std::vector<std::string> targets(10, std::string(10, 'x'));
+  for (size_t i = 0; i < targets.size(); ++i) {
+    requests.push_back({static_cast<off_t>(i * 10), 10, targets[i].data()});
+  }
+  EXPECT_THROW(AsyncFileReader::readBatch(
+                   file.fileDescriptor(), requests,
+                   [](size_t) { throw std::runtime_error{"handler"}; }),
+               std::runtime_error);
+
+  // An invalid file descriptor.
+  requests.resize(1);
+  EXPECT_ANY_THROW(AsyncFileReader::readBatch(-1, requests, [](size_t) {}));
+  ad_utility::deleteFile(filename);
+}
+
+// _____________________________________________________________________________
+TEST(AsyncFileReader, failingSubmission) {
+  if (!AsyncFileReader::usesIoUring()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  std::string filename = "asyncFileReaderTest.failingSubmission.dat";
+  auto contents = writeTestFile(filename, 1000);
+  ad_utility::File file{filename, "r"};
+  std::vector<std::string> targets(10);
+  std::vector<AsyncFileReader::ReadRequest> requests;
+  for (size_t i = 0; i < targets.size(); ++i) {
+    targets[i].assign(100, 'x');
+    requests.push_back({static_cast<off_t>(i * 100), 100, targets[i].data()});
+  }
+  auto readAndCheck = [&]() {
+    std::vector<size_t> numCompletions(requests.size(), 0);
+    AsyncFileReader::readBatch(file.fileDescriptor(), requests,
+                               [&](size_t i) { ++numCompletions.at(i); });
+    EXPECT_THAT(numCompletions, ::testing::Each(1u));
+    for (size_t i = 0; i < targets.size(); ++i) {
+      EXPECT_EQ(targets[i], contents.substr(i * 100, 100));
+    }
+  };
+
+  // A single failing submission is reported after all the requests have
+  // completed or have been cancelled. The ring can still be used and contains
+  // no stale completions.
+  AsyncFileReader::numFailingSubmissionsForTesting_ = 1;
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      AsyncFileReader::readBatch(file.fileDescriptor(), requests,
+                                 [](size_t) {}),
+      ::testing::HasSubstr(std::strerror(EIO)));
+  EXPECT_EQ(AsyncFileReader::numFailingSubmissionsForTesting_, 0);
+  EXPECT_TRUE(AsyncFileReader::usesIoUring());
+  readAndCheck();
+
+  // If the ring fails again while waiting for the requests in flight, it is
+  // destroyed and the thread falls back to `pread`.
+  AsyncFileReader::numFailingSubmissionsForTesting_ = 2;
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      AsyncFileReader::readBatch(file.fileDescriptor(), requests,
+                                 [](size_t) {}),
+      ::testing::HasSubstr(std::strerror(EIO)));
+  EXPECT_EQ(AsyncFileReader::numFailingSubmissionsForTesting_, 0);
+  EXPECT_FALSE(AsyncFileReader::usesIoUring());
+  readAndCheck();
+  ad_utility::deleteFile(filename);
+}
@@ -0,0 +1,150 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "./util/IdTestHelpers.h"
+#include "index/BlockMetadataSearchIndex.h"
+#include "index/CompressedRelation.h"
+#include "util/Random.h"
+
+namespace {
+auto V = ad_utility::testing::VocabId;
+using PermutedTriple = CompressedBlockMetadata::PermutedTriple;
+
+PermutedTriple PT(int64_t c0, int64_t c1, int64_t c2) {
+  return {V(c0), V(c1), V(c2), V(0)};
+}
+
+// Create `numBlocks` sorted blocks, where the first and last triple of
+// each block differ only in the `col2Id_` (which is even for the first and odd
+// for the last triple), and the `col1Id_` changes every few blocks.
+std::vector<CompressedBlockMetadata> makeBlocks(size_t numBlocks) {
+  std::vector<CompressedBlockMetadata> blocks;
+  for (size_t i = 0; i < numBlocks; ++i) {
+    auto col0 = static_cast<int64_t>(i / 7);
+    auto col1 = static_cast<int64_t>(i / 3);
+    auto col2 = static_cast<int64_t>(2 * i + 2);
+    blocks.push_back(CompressedBlockMetadata{
+        {{}, 0, PT(col0, col1, col2), PT(col0, col1, col2 + 1), std::nullopt,
+         false},
+        i});
+  }
+  return blocks;
+}
+
+// Compare the result of the `searchIndex` to the result of a binary search on
+// the `blocks` for the given `first` and `last` triple.
+void checkEqualRange(const std::vector<CompressedBlockMetadata>& blocks,
+                     const BlockMetadataSearchIndex& searchIndex,
+                     const PermutedTriple& first, const PermutedTriple& last) {
+  struct Key {
+    PermutedTriple firstTriple_;
+    PermutedTriple lastTriple_;
+  };
+  auto comp = [](const auto& a, const auto& b) {
+    return a.lastTriple_ < b.firstTriple_;
+  };
+  auto expected = std::equal_range(blocks.begin(), blocks.end(),
+                                   Key{first, last}, comp);
+  auto [begin, end] = searchIndex.equalRange(first, last);
+  EXPECT_EQ(begin, expected.first - blocks.begin());
+  EXPECT_EQ(end, expected.second - blocks.begin());
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(BlockMetadataSearchIndex, emptyIndex) {
+  BlockMetadataSearchIndex searchIndex;
+  EXPECT_EQ(searchIndex.size(), 0);
+  EXPECT_EQ(searchIndex.equalRange(PT(0, 0, 0), PT(10, 10, 10)),
+            (std::pair<size_t, size_t>{0, 0}));
+}
+
+// _____________________________________________________________________________
+TEST(BlockMetadataSearchIndex, equalRangeIsSameAsBinarySearch) {
+  // Test all tree sizes up to a few complete levels, including the complete
+  // trees (e.g. 7 or 15 blocks) and the trees with an incomplete last level.
+  for (size_t numBlocks = 0; numBlocks < 70; ++numBlocks) {
+    auto blocks = makeBlocks(numBlocks);
+    BlockMetadataSearchIndex searchIndex{blocks};
+    ASSERT_EQ(searchIndex.size(), numBlocks);
+    auto maxCol2 = static_cast<int64_t>(2 * numBlocks + 4);
+    for (int64_t col0 = 0; col0 <= static_cast<int64_t>(numBlocks / 7) + 1;
+         ++col0) {
+      // All the blocks of a `col0Id`.
+      checkEqualRange(blocks, searchIndex, PT(col0, 0, 0),
+                      PT(col0, maxCol2, maxCol2));
+      for (int64_t col1 = 0; col1 <= static_cast<int64_t>(numBlocks / 3) + 1;
+           ++col1) {
+        // All the blocks of a `col0Id` and `col1Id`.
+        checkEqualRange(blocks, searchIndex, PT(col0, col1, 0),
+                        PT(col0, col1, maxCol2));
+      }
+    }
+    // Single triples at the boundaries of the blocks and between two blocks.
+    for (const auto& block : blocks) {
+      for (int64_t offset : {-1, 0, 1, 2}) {
+        auto triple = block.firstTriple_;
+        triple.col2Id_ = V(triple.col2Id_.getVocabIndex().get() + offset);
+        checkEqualRange(blocks, searchIndex, triple, triple);
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+TEST(BlockMetadataSearchIndex, getRelevantBlocks) {
+  auto blocks = makeBlocks(1000);
+  BlockMetadataSearchIndex searchIndex{blocks};
+  BlockMetadataSpan span{blocks};
+  BlockMetadataRanges allBlocks{{span.begin(), span.end()}};
+  ad_utility::SlowRandomIntGenerator<int64_t> randomCol{0, 400};
+  for (size_t i = 0; i < 200; ++i) {
+    auto col0 = V(randomCol() / 7);
+    auto col1 = V(randomCol());
+    for (const auto& scanSpec :
+         {ScanSpecification{col0, std::nullopt, std::nullopt},
+          ScanSpecification{col0, col1, std::nullopt}}) {
+      auto expected = CompressedRelationReader::getRelevantBlocks(
+          scanSpec, allBlocks);
+      auto actual = CompressedRelationReader::getRelevantBlocks(
+          scanSpec, span, searchIndex);
+      EXPECT_EQ(CompressedRelationReader::convertBlockMetadataRangesToVector(
+                    actual),
+                CompressedRelationReader::convertBlockMetadataRangesToVector(
+                    expected));
+    }
+  }
+
+  // The index must have been built from the given blocks.
+  EXPECT_ANY_THROW(CompressedRelationReader::getRelevantBlocks(
+      ScanSpecification{V(1), std::nullopt, std::nullopt},
+      span.subspan(1), searchIndex));
+}
+
+// _____________________________________________________________________________
+TEST(BlockMetadataSearchIndex, updateBlock) {
+  for (size_t numBlocks : {1, 6, 7, 8, 50}) {
+    auto blocks = makeBlocks(numBlocks);
+    BlockMetadataSearchIndex searchIndex{blocks};
+    // Widen every other block up to the boundaries of its neighbors, such
+    // that the blocks stay sorted.
+    for (size_t i = 0; i < numBlocks; i += 2) {
+      if (i > 0) {
+        blocks[i].firstTriple_ = blocks[i - 1].lastTriple_;
+      }
+      if (i + 1 < numBlocks) {
+        blocks[i].lastTriple_ = blocks[i + 1].firstTriple_;
+      }
+      searchIndex.updateBlock(i, blocks[i]);
+    }
+    for (const auto& block : blocks) {
+      checkEqualRange(blocks, searchIndex, block.firstTriple_,
+                      block.firstTriple_);
+      checkEqualRange(blocks, searchIndex, block.lastTriple_,
+                      block.lastTriple_);
+    }
+    EXPECT_ANY_THROW(searchIndex.updateBlock(numBlocks, blocks[0]));
+  }
+}
@@ -0,0 +1,67 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include "util/BloomFilter.h"
+#include "util/Serializer/ByteBufferSerializer.h"
+
+using ad_utility::BloomFilter;
+
+// _____________________________________________________________________________
+TEST(BloomFilter, emptyFilterContainsEverything) {
+  BloomFilter filter;
+  EXPECT_TRUE(filter.empty());
+  EXPECT_EQ(filter.sizeInBytes(), 0);
+  EXPECT_TRUE(filter.mayContain(0));
+  EXPECT_TRUE(filter.mayContain(42));
+  EXPECT_ANY_THROW(filter.add(42));
+}
+
+// _____________________________________________________________________________
+TEST(BloomFilter, noFalseNegativesAndFewFalsePositives) {
+  BloomFilter filter{1000, 10};
+  EXPECT_FALSE(filter.empty());
+  EXPECT_EQ(filter.sizeInBytes(), 1256);
+  // Add the even numbers, these are similar to neighboring `Id`s.
+  for (uint64_t i = 0; i < 2000; i += 2) {
+    filter.add(i);
+  }
+  size_t numFalsePositives = 0;
+  for (uint64_t i = 0; i < 2000; ++i) {
+    if (i % 2 == 0) {
+      EXPECT_TRUE(filter.mayContain(i));
+    } else if (filter.mayContain(i)) {
+      ++numFalsePositives;
+    }
+  }
+  // With 10 bits per key, the expected false positive rate is about 1%.
+  EXPECT_LT(numFalsePositives, 50);
+
+  // A filter for zero keys still has one word.
+  BloomFilter tiny{0, 10};
+  EXPECT_FALSE(tiny.empty());
+  EXPECT_EQ(tiny.sizeInBytes(), 8);
+  EXPECT_FALSE(tiny.mayContain(17));
+  tiny.add(17);
+  EXPECT_TRUE(tiny.mayContain(17));
+
+  EXPECT_ANY_THROW((BloomFilter{10, 0}));
+}
+
+// _____________________________________________________________________________
+TEST(BloomFilter, serialization) {
+  BloomFilter filter{10, 8};
+  filter.add(3);
+  filter.add(1ULL << 60);
+  ad_utility::serialization::ByteBufferWriteSerializer writer;
+  writer << filter;
+  ad_utility::serialization::ByteBufferReadSerializer reader{
+      std::move(writer).data()};
+  BloomFilter result;
+  reader >> result;
+  EXPECT_EQ(result, filter);
+  EXPECT_TRUE(result.mayContain(3));
+  EXPECT_TRUE(result.mayContain(1ULL << 60));
+  EXPECT_NE(result, BloomFilter{});
+}
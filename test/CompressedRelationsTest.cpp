@@ -10,6 +10,7 @@
 #include "index/IndexImpl.h"
 #include "util/IndexTestHelpers.h"
 #include "util/OnDestructionDontThrowDuringStackUnwinding.h"
+#include "util/RuntimeParametersTestHelpers.h"
 #include "util/Serializer/ByteBufferSerializer.h"
 #include "util/SourceLocation.h"
 
@@ -133,7 +134,8 @@ template <typename T>
 std::pair<std::vector<CompressedBlockMetadata>,
           std::vector<CompressedRelationMetadata>>
 compressedRelationTestWriteCompressedRelations(
-    T inputs, std::string filename, ad_utility::MemorySize blocksize) {
+    T inputs, std::string filename, ad_utility::MemorySize blocksize,
+    bool storeUncompressed) {
   // First check the invariants of the `inputs`. They must be sorted by the
   // `col0_` and for each of the `inputs` the `col1And2_` must also be sorted.
   AD_CONTRACT_CHECK(ql::ranges::is_sorted(
@@ -149,7 +151,7 @@ compressedRelationTestWriteCompressedRelations(
   size_t numColumns = getNumColumns(inputs) + 1;
   AD_CORRECTNESS_CHECK(numColumns >= 4);
   CompressedRelationWriter writer{numColumns, ad_utility::File{filename, "w"},
-                                  blocksize};
+                                  blocksize, 0, storeUncompressed};
   vector<CompressedRelationMetadata> metaData;
   {
     size_t i = 0;
@@ -262,12 +264,15 @@ makeLocatedTriplesFromPartOfInput(float locatedProbab,
 // Write the relations specified by the `inputs` to a compressed permutation at
 // `filename`. Return the created metadata for blocks and large relations, as
 // well as a `CompressedRelationReader`. These are exactly the datastructures
-// that are required to test the `CompressedRelationReader` class.
+// that are required to test the `CompressedRelationReader` class. If
+// `storeUncompressed` is set, all columns are stored with
+// `ColumnCodec::Uncompressed`.
 auto writeAndOpenRelations(const std::vector<RelationInput>& inputs,
                            std::string filename,
-                           ad_utility::MemorySize blocksize) {
+                           ad_utility::MemorySize blocksize,
+                           bool storeUncompressed = false) {
   auto [blocks, metaData] = compressedRelationTestWriteCompressedRelations(
-      inputs, filename, blocksize);
+      inputs, filename, blocksize, storeUncompressed);
   auto reader = [&]() {
     return std::make_unique<CompressedRelationReader>(
         ad_utility::makeUnlimitedAllocator<Id>(),
@@ -746,6 +751,75 @@ TEST(CompressedRelationReader, getBlocksForJoinWithColumn) {
   test({V(13)}, {block3});
 }
 
+// Test that the Bloom filters of the blocks are used to skip blocks in
+// `getBlocksForJoin` whose range overlaps with the join column, but which
+// don't contain any of its `Id`s.
+TEST(CompressedRelationReader, getBlocksForJoinWithBloomFilters) {
+  using SpecBlocksBounds = CompressedRelationReader::ScanSpecAndBlocksAndBounds;
+  auto bloomFilter = [](const std::vector<Id>& column) {
+    return CompressedBlockMetadata::computeBloomFilter(column, 10);
+  };
+  // The blocks contain the following (col1, col2) pairs for col0 `42`:
+  // block1: (3, 0), (3, 7), (4, 12), block2: (4, 13), (6, 9).
+  CompressedBlockMetadata block1{
+      {{}, 0, {V(42), V(3), V(0), g}, {V(42), V(4), V(12), g}, {}, false}, 0};
+  block1.bloomFilters_ = {bloomFilter({V(3), V(3), V(4)}),
+                          bloomFilter({V(0), V(7), V(12)})};
+  CompressedBlockMetadata block2{
+      {{}, 0, {V(42), V(4), V(13), g}, {V(42), V(6), V(9), g}, {}, false}, 1};
+  block2.bloomFilters_ = {bloomFilter({V(4), V(6)}),
+                          bloomFilter({V(13), V(9)})};
+
+  EXPECT_TRUE(block1.mayContain(1, V(3)));
+  EXPECT_FALSE(block1.mayContain(1, V(6)));
+  EXPECT_TRUE(block1.mayContain(2, V(7)));
+  EXPECT_FALSE(block1.mayContain(2, V(5)));
+  // There are no Bloom filters for the first column.
+  EXPECT_TRUE(block1.mayContain(0, V(17)));
+
+  auto scanSpec = ScanSpecification{V(42), std::nullopt, std::nullopt};
+  std::vector<CompressedBlockMetadata> blocks{block1, block2};
+  std::optional<SpecBlocksBounds> metadataAndBlocks;
+  metadataAndBlocks.emplace(
+      SpecBlocksBounds{{scanSpec, getBlockMetadataRangesfromVec(blocks)},
+                       {{V(42), V(3), V(0), g}, {V(42), V(6), V(9), g}}});
+
+  auto test = [&metadataAndBlocks](
+                  const std::vector<Id>& joinColumn,
+                  const std::vector<CompressedBlockMetadata>& expectedBlocks,
+                  source_location l = source_location::current()) {
+    auto t = generateLocationTrace(l);
+    auto result = CompressedRelationReader::getBlocksForJoin(
+        joinColumn, *metadataAndBlocks);
+    EXPECT_THAT(result, ::testing::ElementsAreArray(expectedBlocks));
+  };
+
+  // Join on the middle column. `V(5)` lies in the range of `block2`, but
+  // doesn't occur in it.
+  test({V(5)}, {});
+  test({V(3), V(5)}, {block1});
+  test({V(4)}, {block1, block2});
+  test({V(5), V(6)}, {block2});
+
+  // Join on the last column with a fixed `col1Id` of `4`.
+  scanSpec.setCol1Id(V(4));
+  metadataAndBlocks.emplace(
+      SpecBlocksBounds{{scanSpec, getBlockMetadataRangesfromVec(blocks)},
+                       {{V(42), V(4), V(12), g}, {V(42), V(4), V(13), g}}});
+  test({V(12)}, {block1});
+  test({V(13)}, {block2});
+  test({V(12), V(13)}, {block1, block2});
+
+  // Without Bloom filters, only the ranges are used.
+  block2.bloomFilters_.clear();
+  blocks.at(1) = block2;
+  scanSpec.setCol1Id(std::nullopt);
+  metadataAndBlocks.emplace(
+      SpecBlocksBounds{{scanSpec, getBlockMetadataRangesfromVec(blocks)},
+                       {{V(42), V(3), V(0), g}, {V(42), V(6), V(9), g}}});
+  test({V(5)}, {block2});
+}
+
 TEST(CompressedRelationReader, getBlocksForJoin) {
   using SpecBlocksBounds = CompressedRelationReader::ScanSpecAndBlocksAndBounds;
   CompressedBlockMetadata block1{
@@ -1034,6 +1108,43 @@ TEST(CompressedRelationWriter, graphInfoInBlockMetadata) {
   }
 }
 
+// Test the zone maps that are stored in the block metadata.
+TEST(CompressedRelationWriter, zoneMapsInBlockMetadata) {
+  using Range = CompressedBlockMetadata::DatatypeRange;
+  using ZoneMap = CompressedBlockMetadata::ZoneMap;
+  std::vector<RelationInput> inputs;
+  inputs.push_back(RelationInput{3, {{1, 10}, {2, 5}, {4, 7}}});
+  inputs.push_back(RelationInput{4, {{0, 12}}});
+  auto [blocks, metadata, reader] =
+      writeAndOpenRelations(inputs, "zoneMaps", 100_MB);
+  ASSERT_EQ(blocks.size(), 1);
+  EXPECT_THAT(blocks.at(0).zoneMaps_,
+              ::testing::ElementsAre(ZoneMap{Range{V(3), V(4), 4}},
+                                     ZoneMap{Range{V(0), V(4), 4}},
+                                     ZoneMap{Range{V(5), V(12), 4}}));
+
+  // Columns with mixed datatypes. The ranges are sorted by their minimum. Note
+  // that in the order of the `Id`s, the negative integers come after the
+  // positive ones.
+  auto I = ad_utility::testing::IntId;
+  auto D = ad_utility::testing::DoubleId;
+  auto B = ad_utility::testing::BoolId;
+  std::vector<Id> column{V(7), I(3), I(-2), D(1.5), V(2), I(0), V(5)};
+  auto zoneMap = CompressedBlockMetadata::computeZoneMap(column);
+  EXPECT_THAT(zoneMap, ::testing::ElementsAre(Range{I(0), I(-2), 3},
+                                              Range{D(1.5), D(1.5), 1},
+                                              Range{V(2), V(7), 3}));
+  EXPECT_TRUE(CompressedBlockMetadata::computeZoneMap({}).empty());
+
+  // Add single values, e.g. for updates.
+  CompressedBlockMetadata::addToZoneMap(zoneMap, V(12));
+  CompressedBlockMetadata::addToZoneMap(zoneMap, I(4));
+  CompressedBlockMetadata::addToZoneMap(zoneMap, B(true));
+  EXPECT_THAT(zoneMap, ::testing::ElementsAre(
+                           Range{B(true), B(true), 1}, Range{I(0), I(-2), 4},
+                           Range{D(1.5), D(1.5), 1}, Range{V(2), V(12), 4}));
+}
+
 // Test the correct setting of the metadata for the contained graphs.
 TEST(CompressedRelationWriter, scanWithGraphs) {
   using ScanSpecAndBlocks = CompressedRelationReader::ScanSpecAndBlocks;
@@ -1070,3 +1181,369 @@ TEST(CompressedRelationWriter, scanWithGraphs) {
                 matchesIdTableFromVector({{3, 4}, {8, 5}, {9, 4}, {9, 5}}));
   }
 }
+
+// Test that repeated scans of the same blocks take the decompressed columns
+// from the `DecompressedBlockCache`.
+TEST(CompressedRelationReader, scanUsesDecompressedBlockCache) {
+  auto cleanup =
+      setRuntimeParameterForTest<"decompressed-block-cache-max-size">(10_MB);
+  std::string filename = "scanUsesDecompressedBlockCache";
+  auto fileCleanup = makeCleanup(filename);
+  std::vector<RelationInput> inputs;
+  inputs.push_back(RelationInput{42, {}});
+  for (int i = 0; i < 200; ++i) {
+    inputs.back().col1And2_.push_back({i / 3, i, 0});
+  }
+  auto [blocks, metadata, reader] =
+      writeAndOpenRelations(inputs, filename, 64_B);
+  ASSERT_GT(blocks.size(), 3);
+  ScanSpecification spec{V(42), std::nullopt, std::nullopt};
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+
+  auto scanLazily = [&, &blocks = blocks, &reader = reader]() {
+    auto generator = reader->lazyScan(spec, blocks, {}, handle,
+                                      emptyLocatedTriples);
+    IdTable result{2, ad_utility::makeUnlimitedAllocator<Id>()};
+    for (const auto& block : generator) {
+      result.insertAtEnd(block);
+    }
+    return std::pair{std::move(result), generator.details()};
+  };
+
+  auto [result1, details1] = scanLazily();
+  EXPECT_EQ(details1.numBlockCacheHits_, 0);
+  EXPECT_GT(details1.numBlockCacheMisses_, 0);
+
+  // The second scan reads all the columns from the cache and yields the same
+  // result.
+  auto [result2, details2] = scanLazily();
+  EXPECT_THAT(result2, matchesIdTable(result1));
+  EXPECT_EQ(details2.numBlockCacheMisses_, 0);
+  EXPECT_EQ(details2.numBlockCacheHits_, details1.numBlockCacheMisses_);
+
+  // A different reader for the same file doesn't share the cached columns.
+  CompressedRelationReader otherReader{ad_utility::makeUnlimitedAllocator<Id>(),
+                                       ad_utility::File{filename, "r"}};
+  auto generator =
+      otherReader.lazyScan(spec, blocks, {}, handle, emptyLocatedTriples);
+  for ([[maybe_unused]] const auto& block : generator) {
+  }
+  EXPECT_EQ(generator.details().numBlockCacheHits_, 0);
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationReader, lazyScanWithLateMaterialization) {
+  std::string filename = "lazyScanWithLateMaterialization";
+  auto fileCleanup = makeCleanup(filename);
+  std::vector<RelationInput> inputs;
+  inputs.push_back(RelationInput{42, {}});
+  for (int i = 0; i < 200; ++i) {
+    inputs.back().col1And2_.push_back({i / 3, i, 0});
+  }
+  auto [blocks, metadata, reader] =
+      writeAndOpenRelations(inputs, filename, 64_B);
+  ASSERT_GT(blocks.size(), 5);
+  ScanSpecification spec{V(42), std::nullopt, std::nullopt};
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+
+  auto scanLazily = [&, &blocks = blocks, &reader = reader](
+                        std::optional<ql::span<const Id>> joinColumnFilter) {
+    auto generator =
+        reader->lazyScan(spec, blocks, {}, handle, emptyLocatedTriples, {},
+                         joinColumnFilter);
+    IdTable result{2, ad_utility::makeUnlimitedAllocator<Id>()};
+    for (const auto& block : generator) {
+      result.insertAtEnd(block);
+    }
+    return std::pair{std::move(result), generator.details()};
+  };
+
+  // Only keep the rows of the `table` where the first column is contained in
+  // the `joinColumn`.
+  auto filterByJoinColumn = [](const IdTable& table,
+                               const std::vector<Id>& joinColumn) {
+    IdTable result{table.numColumns(),
+                   ad_utility::makeUnlimitedAllocator<Id>()};
+    for (const auto& row : table) {
+      if (ad_utility::contains(joinColumn, row[0])) {
+        result.push_back(row);
+      }
+    }
+    return result;
+  };
+
+  auto [fullResult, fullDetails] = scanLazily(std::nullopt);
+  EXPECT_EQ(fullDetails.numBlocksSkippedByLateMaterialization_, 0);
+  EXPECT_EQ(fullDetails.numElementsDiscardedByLateMaterialization_, 0);
+
+  std::vector<Id> joinColumn{V(0), V(30), V(31), V(1000)};
+  auto [result, details] = scanLazily(joinColumn);
+  // All the rows with a join partner are contained in the result (together
+  // with their second column), but many of the rows without a join partner
+  // have been discarded, and several blocks were skipped without reading the
+  // second column.
+  EXPECT_THAT(filterByJoinColumn(result, joinColumn),
+              matchesIdTable(filterByJoinColumn(fullResult, joinColumn)));
+  EXPECT_LT(result.numRows(), fullResult.numRows());
+  EXPECT_GT(details.numBlocksSkippedByLateMaterialization_, 0);
+  EXPECT_EQ(details.numElementsDiscardedByLateMaterialization_,
+            fullResult.numRows() - result.numRows());
+  EXPECT_EQ(details.numBlocksRead_, fullDetails.numBlocksRead_);
+
+  // An empty join column discards all rows except for those of the first and
+  // the last block, which are always fully materialized.
+  auto emptyDetails = scanLazily(std::vector<Id>{}).second;
+  EXPECT_EQ(emptyDetails.numBlocksSkippedByLateMaterialization_,
+            blocks.size() - 2);
+
+  // The late materialization can't be combined with a LIMIT.
+  LimitOffsetClause limit{1};
+  auto generator = reader->lazyScan(spec, blocks, {}, handle,
+                                    emptyLocatedTriples, limit, joinColumn);
+  EXPECT_ANY_THROW(generator.begin());
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationReader, scanInParallel) {
+  using ScanSpecAndBlocks = CompressedRelationReader::ScanSpecAndBlocks;
+  std::string filename = "scanInParallel";
+  auto fileCleanup = makeCleanup(filename);
+  std::vector<RelationInput> inputs;
+  inputs.push_back(RelationInput{42, {}});
+  for (int i = 0; i < 500; ++i) {
+    inputs.back().col1And2_.push_back({i / 3, i, 7});
+  }
+  auto [blocks, metadata, reader] =
+      writeAndOpenRelations(inputs, filename, 64_B);
+  ASSERT_GT(blocks.size(), 10);
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+
+  // The expected result is computed by the lazy scan.
+  auto scanLazily = [&, &blocks = blocks, &reader = reader](
+                        const ScanSpecification& spec,
+                        std::vector<ColumnIndex> additionalColumns) {
+    IdTable result{2 + additionalColumns.size() -
+                       static_cast<size_t>(spec.col1Id().has_value()),
+                   ad_utility::makeUnlimitedAllocator<Id>()};
+    for (const auto& block : reader->lazyScan(spec, blocks, additionalColumns,
+                                              handle, emptyLocatedTriples)) {
+      result.insertAtEnd(block);
+    }
+    return result;
+  };
+
+  for (size_t numThreads : {1, 3, 16}) {
+    auto cleanup =
+        setRuntimeParameterForTest<"materialized-index-scan-num-threads">(
+            numThreads);
+    for (auto spec : {ScanSpecification{V(42), std::nullopt, std::nullopt},
+                      ScanSpecification{V(42), V(50), std::nullopt}}) {
+      for (auto additionalColumns :
+           {std::vector<ColumnIndex>{},
+            std::vector<ColumnIndex>{ADDITIONAL_COLUMN_GRAPH_ID}}) {
+        auto result = reader->scan(
+            ScanSpecAndBlocks{spec, getBlockMetadataRangesfromVec(blocks)},
+            additionalColumns, handle, emptyLocatedTriples);
+        EXPECT_THAT(result,
+                    matchesIdTable(scanLazily(spec, additionalColumns)));
+      }
+    }
+  }
+
+  // The scan respects the cancellation handle.
+  handle->cancel(ad_utility::CancellationState::MANUAL);
+  EXPECT_THROW(
+      reader->scan(ScanSpecAndBlocks{ScanSpecification{V(42), std::nullopt,
+                                                       std::nullopt},
+                                     getBlockMetadataRangesfromVec(blocks)},
+                   {}, handle, emptyLocatedTriples),
+      ad_utility::CancellationException);
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationReader, memoryMappedUncompressedColumns) {
+  using ScanSpecAndBlocks = CompressedRelationReader::ScanSpecAndBlocks;
+  std::string filename = "memoryMappedUncompressedColumns";
+  std::string filenameCompressed = filename + ".compressed";
+  auto cleanup = makeCleanup(filename);
+  auto cleanupCompressed = makeCleanup(filenameCompressed);
+  std::vector<RelationInput> inputs;
+  inputs.push_back(RelationInput{42, {}});
+  for (int i = 0; i < 500; ++i) {
+    inputs.back().col1And2_.push_back({i / 3, i, 7});
+  }
+  // A small relation, which is stored in a single block.
+  inputs.push_back(RelationInput{43, {{1, 2, 3}, {1, 3, 4}, {2, 0, 0}}});
+  auto [blocks, metadata, reader] =
+      writeAndOpenRelations(inputs, filename, 64_B, true);
+  auto [blocksCompressed, metadataCompressed, readerCompressed] =
+      writeAndOpenRelations(inputs, filenameCompressed, 64_B);
+  ASSERT_GT(blocks.size(), 10);
+  for (const auto& block : blocks) {
+    for (const auto& offset : block.offsetsAndCompressedSize_) {
+      EXPECT_EQ(offset.codec_, ColumnCodec::Uncompressed);
+      EXPECT_EQ(offset.compressedSize_, block.numRows_ * sizeof(Id));
+      EXPECT_EQ(offset.offsetInFile_ % alignof(Id), 0);
+    }
+  }
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+  auto scan = [&](const auto& reader, const auto& blocks,
+                  const ScanSpecification& spec) {
+    return reader->scan(
+        ScanSpecAndBlocks{spec, getBlockMetadataRangesfromVec(blocks)},
+        std::vector<ColumnIndex>{}, handle, emptyLocatedTriples);
+  };
+  auto scanAsView = [&](const auto& reader, const auto& blocks,
+                        const ScanSpecification& spec) {
+    return reader->scanAsView(
+        ScanSpecAndBlocks{spec, getBlockMetadataRangesfromVec(blocks)},
+        std::vector<ColumnIndex>{}, emptyLocatedTriples);
+  };
+  auto specs = std::vector{ScanSpecification{V(42), std::nullopt, std::nullopt},
+                           ScanSpecification{V(42), V(50), std::nullopt},
+                           ScanSpecification{V(42), V(50), V(151)},
+                           ScanSpecification{V(43), std::nullopt, std::nullopt},
+                           ScanSpecification{V(43), V(1), std::nullopt}};
+
+  // Without the memory mapping, no views can be created, but the uncompressed
+  // columns can still be read from the file.
+  EXPECT_FALSE(reader->usesMemoryMapping());
+  EXPECT_FALSE(scanAsView(reader, blocks, specs.back()).has_value());
+  for (const auto& spec : specs) {
+    EXPECT_THAT(scan(reader, blocks, spec),
+                matchesIdTable(scan(readerCompressed, blocksCompressed, spec)));
+  }
+
+  reader->enableMemoryMapping();
+  EXPECT_TRUE(reader->usesMemoryMapping());
+  for (const auto& spec : specs) {
+    auto expected = scan(readerCompressed, blocksCompressed, spec);
+    EXPECT_THAT(scan(reader, blocks, spec), matchesIdTable(expected.clone()));
+    auto view = scanAsView(reader, blocks, spec);
+    // The complete relation `42` consists of several blocks, so it can't be
+    // returned as a view.
+    if (spec.col0Id() == V(42) && !spec.col1Id().has_value()) {
+      EXPECT_FALSE(view.has_value());
+      continue;
+    }
+    ASSERT_TRUE(view.has_value());
+    EXPECT_THAT(IdTable{view.value().clone()}, matchesIdTable(expected));
+  }
+
+  // Compressed columns can't be returned as a view.
+  readerCompressed->enableMemoryMapping();
+  EXPECT_FALSE(
+      scanAsView(readerCompressed, blocksCompressed, specs.back()).has_value());
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationWriter, blocksizeForLargeRelation) {
+  auto makeWriter = [](bool adaptiveBlocksize) {
+    return CompressedRelationWriter{
+        4, ad_utility::File{"blocksizeForLargeRelation.dat", "w"}, 800_B, 0,
+        false, adaptiveBlocksize};
+  };
+  auto cleanup = makeCleanup("blocksizeForLargeRelation.dat");
+  {
+    auto writer = makeWriter(false);
+    ASSERT_EQ(writer.blocksize(), 100);
+    EXPECT_EQ(writer.blocksizeForLargeRelation(100, 100), 100);
+    EXPECT_EQ(writer.blocksizeForLargeRelation(1000, 1), 100);
+    EXPECT_EQ(writer.blocksizeForLargeRelation(100, std::nullopt), 100);
+  }
+  auto writer = makeWriter(true);
+  ASSERT_EQ(writer.minNumRowsForLargeBlocks(), 1600);
+  // Few rows per `col1Id`.
+  EXPECT_EQ(writer.blocksizeForLargeRelation(100, 100), 25);
+  EXPECT_EQ(writer.blocksizeForLargeRelation(1500, 100), 25);
+  // Many rows per `col1Id`.
+  EXPECT_EQ(writer.blocksizeForLargeRelation(1000, 1), 400);
+  EXPECT_EQ(writer.blocksizeForLargeRelation(500, 20), 400);
+  // In between.
+  EXPECT_EQ(writer.blocksizeForLargeRelation(400, 20), 100);
+  // Huge relations get large blocks, no matter how many rows per `col1Id` they
+  // have, and the number of distinct `col1Id`s is not needed for them.
+  EXPECT_EQ(writer.blocksizeForLargeRelation(1600, 100), 400);
+  EXPECT_EQ(writer.blocksizeForLargeRelation(1600, 1600), 400);
+  EXPECT_EQ(writer.blocksizeForLargeRelation(1600, std::nullopt), 400);
+  EXPECT_ANY_THROW(writer.blocksizeForLargeRelation(1599, std::nullopt));
+}
+
+// _____________________________________________________________________________
+TEST(CompressedRelationWriter, adaptiveBlocksize) {
+  using ScanSpecAndBlocks = CompressedRelationReader::ScanSpecAndBlocks;
+  std::string filename = "adaptiveBlocksize.dat";
+  std::string filenameTwin = filename + ".twin";
+  auto cleanup = makeCleanup(filename);
+  auto cleanupTwin = makeCleanup(filenameTwin);
+
+  // Relation `1` has a single row per `col1Id`, relation `2` has 500 rows per
+  // `col1Id`, and relation `3` is huge (at least 1600 rows for the blocksize of
+  // 100), but has a single row per `col1Id`.
+  IdTableStatic<0> triples{4, ad_utility::makeUnlimitedAllocator<Id>()};
+  for (int i = 0; i < 200; ++i) {
+    triples.push_back(std::array{V(1), V(i), V(i % 7), V(0)});
+  }
+  for (int i = 0; i < 1000; ++i) {
+    triples.push_back(std::array{V(2), V(i / 500), V(i), V(0)});
+  }
+  for (int i = 0; i < 2000; ++i) {
+    triples.push_back(std::array{V(3), V(i), V(0), V(0)});
+  }
+  auto makeTriples = [&triples]() -> cppcoro::generator<IdTableStatic<0>> {
+    co_yield triples;
+  };
+  CompressedRelationWriter writer1{4, ad_utility::File{filename, "w"}, 800_B,
+                                   0, false, true};
+  CompressedRelationWriter writer2{4, ad_utility::File{filenameTwin, "w"},
+                                   800_B, 0, false, true};
+  auto ignoreMetadata = [](ql::span<const CompressedRelationMetadata>) {};
+  auto [numDistinctCol0, blocks, blocksTwin] =
+      CompressedRelationWriter::createPermutationPair(
+          filename, {writer1, ignoreMetadata}, {writer2, ignoreMetadata},
+          makeTriples(), qlever::KeyOrder{0, 1, 2, 3}, {});
+  EXPECT_EQ(numDistinctCol0, 3);
+
+  // Relation `1` gets small blocks, relations `2` and `3` get large blocks. The
+  // blocksize of the twin permutation is chosen from its own statistics:
+  // relation `1` has 28 rows per `col2Id` and gets large blocks, relation `2`
+  // has a single row per `col2Id` and gets small blocks.
+  auto getSizes = [](const std::vector<CompressedBlockMetadata>& blocks) {
+    std::vector<std::pair<size_t, size_t>> sizes;
+    for (const auto& block : blocks) {
+      sizes.emplace_back(block.numRows_, block.blocksize_);
+    }
+    return sizes;
+  };
+  std::vector<std::pair<size_t, size_t>> expectedSizes(8, {25, 25});
+  expectedSizes.insert(expectedSizes.end(),
+                       {{400, 400}, {400, 400}, {200, 400}});
+  expectedSizes.insert(expectedSizes.end(), 5, {400, 400});
+  EXPECT_EQ(getSizes(blocks), expectedSizes);
+  std::vector<std::pair<size_t, size_t>> expectedSizesTwin{{200, 400}};
+  expectedSizesTwin.insert(expectedSizesTwin.end(), 40, {25, 25});
+  expectedSizesTwin.insert(expectedSizesTwin.end(), 5, {400, 400});
+  EXPECT_EQ(getSizes(blocksTwin), expectedSizesTwin);
+
+  // The contents of the permutations are not affected.
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+  auto scan = [&handle](const std::string& filename,
+                        const std::vector<CompressedBlockMetadata>& blocks,
+                        int col0) {
+    CompressedRelationReader reader{ad_utility::makeUnlimitedAllocator<Id>(),
+                                    ad_utility::File{filename, "r"}};
+    return reader.scan(
+        ScanSpecAndBlocks{ScanSpecification{V(col0), std::nullopt,
+                                            std::nullopt},
+                          getBlockMetadataRangesfromVec(blocks)},
+        {}, handle, emptyLocatedTriples);
+  };
+  auto result = scan(filename, blocks, 2);
+  ASSERT_EQ(result.numRows(), 1000);
+  EXPECT_EQ(result(499, 0), V(0));
+  EXPECT_EQ(result(500, 0), V(1));
+  EXPECT_EQ(result(500, 1), V(500));
+  auto resultTwin = scan(filenameTwin, blocksTwin, 1);
+  ASSERT_EQ(resultTwin.numRows(), 200);
+  EXPECT_TRUE(ql::ranges::is_sorted(resultTwin.getColumn(0)));
+}
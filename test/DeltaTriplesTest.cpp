@@ -439,6 +439,196 @@ TEST_F(DeltaTriplesTest, DeltaTriplesManager) {
                                      3 * numThreads + 2));
 }
 
+// Test that a staged update (see `DeltaTriplesManager::stageUpdate`) has the
+// same effect as the corresponding `deleteTriples` and `insertTriples`.
+TEST_F(DeltaTriplesTest, stageUpdate) {
+  DeltaTriplesManager deltaTriplesManager(testQec->getIndex().getImpl());
+  auto& vocab = testQec->getIndex().getVocab();
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  LocalVocab localVocab;
+  auto apply = [&](DeltaTriples::StagedUpdate stagedUpdate) {
+    deltaTriplesManager.modify<void>([&](DeltaTriples& deltaTriples) {
+      deltaTriples.applyStagedTriples(cancellationHandle,
+                                      std::move(stagedUpdate.toDelete_));
+      deltaTriples.applyStagedTriples(cancellationHandle,
+                                      std::move(stagedUpdate.toInsert_));
+    });
+  };
+  auto numTriplesAre = [&deltaTriplesManager](int64_t inserted,
+                                              int64_t deleted, size_t total) {
+    EXPECT_THAT(*deltaTriplesManager.deltaTriples_.rlock(),
+                NumTriples(inserted, deleted, total));
+  };
+
+  auto stagedUpdate = deltaTriplesManager.stageUpdate(
+      cancellationHandle, makeIdTriples(vocab, localVocab, {"<A> <low> <a>"}),
+      makeIdTriples(vocab, localVocab,
+                    {"<a> <UPP> <A>", "<b> <UPP> <B>", "<c> <UPP> <new>"}));
+  // The triples are already located, but the delta triples are not modified
+  // before the update is applied.
+  ASSERT_TRUE(stagedUpdate.toInsert_.locatedTriples_.has_value());
+  EXPECT_EQ(stagedUpdate.toInsert_.locatedTriples_.value()[0].size(), 3);
+  numTriplesAre(0, 0, 0);
+  apply(std::move(stagedUpdate));
+  numTriplesAre(3, 1, 4);
+
+  // Idempotent triples and triples that cancel each other out are resolved
+  // when the update is applied, also if the delta triples were modified after
+  // the update was staged.
+  stagedUpdate = deltaTriplesManager.stageUpdate(
+      cancellationHandle, makeIdTriples(vocab, localVocab, {"<a> <UPP> <A>"}),
+      makeIdTriples(vocab, localVocab, {"<b> <UPP> <B>", "<A> <low> <a>"}));
+  deltaTriplesManager.modify<void>([&](DeltaTriples& deltaTriples) {
+    deltaTriples.insertTriples(
+        cancellationHandle,
+        makeIdTriples(vocab, localVocab, {"<a> <next> <c>"}));
+  });
+  numTriplesAre(4, 1, 5);
+  apply(std::move(stagedUpdate));
+  numTriplesAre(4, 1, 5);
+  // The deleted triple `<A> <low> <a>` has been inserted again.
+  auto triples =
+      makeIdTriples(vocab, localVocab, {"<A> <low> <a>", "<a> <next> <c>"});
+  auto deltaTriples = deltaTriplesManager.deltaTriples_.rlock();
+  EXPECT_TRUE(deltaTriples->triplesInserted_.contains(triples[0]));
+  EXPECT_FALSE(deltaTriples->triplesDeleted_.contains(triples[0]));
+  EXPECT_TRUE(deltaTriples->triplesInserted_.contains(triples[1]));
+}
+
+// _____________________________________________________________________________
+TEST_F(DeltaTriplesTest, batchedModification) {
+  DeltaTriplesManager deltaTriplesManager(testQec->getIndex().getImpl());
+  auto& vocab = testQec->getIndex().getVocab();
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  LocalVocab localVocab;
+  auto triples = [&](const std::vector<std::string>& triples) {
+    return makeIdTriples(vocab, localVocab, triples);
+  };
+  auto numTriplesAre = [&deltaTriplesManager](int64_t inserted,
+                                              int64_t deleted, size_t total) {
+    EXPECT_THAT(*deltaTriplesManager.deltaTriples_.rlock(),
+                NumTriples(inserted, deleted, total));
+  };
+  using BatchedModification = DeltaTriplesManager::BatchedModification;
+  auto allocator = ad_utility::testing::makeAllocator();
+
+  deltaTriplesManager.modify<void>([&](DeltaTriples& deltaTriples) {
+    deltaTriples.insertTriples(cancellationHandle,
+                               triples({"<a> <UPP> <A>", "<b> <UPP> <B>"}));
+    deltaTriples.deleteTriples(cancellationHandle, triples({"<A> <low> <a>"}));
+  });
+  numTriplesAre(2, 1, 3);
+  auto snapshot = deltaTriplesManager.getCurrentSnapshot();
+
+  // The batches of a modification that is not committed are applied, but not
+  // visible in the current snapshot, and they are rolled back in the end.
+  {
+    BatchedModification modification{deltaTriplesManager, allocator};
+    EXPECT_EQ(modification.countsBefore(), (DeltaTriplesCount{2, 1}));
+    modification.applyBatch(cancellationHandle, triples({"<a> <UPP> <A>"}),
+                            triples({"<A> <low> <a>", "<c> <UPP> <new>"}));
+    numTriplesAre(3, 1, 4);
+    modification.applyBatch(cancellationHandle,
+                            triples({"<b> <UPP> <B>", "<c> <UPP> <new>"}),
+                            triples({"<a> <next> <b>"}));
+    numTriplesAre(2, 3, 5);
+    EXPECT_EQ(deltaTriplesManager.getCurrentSnapshot(), snapshot);
+  }
+  numTriplesAre(2, 1, 3);
+  {
+    auto deltaTriples = deltaTriplesManager.deltaTriples_.rlock();
+    auto expected = triples({"<a> <UPP> <A>", "<b> <UPP> <B>"});
+    EXPECT_TRUE(deltaTriples->triplesInserted_.contains(expected[0]));
+    EXPECT_TRUE(deltaTriples->triplesInserted_.contains(expected[1]));
+    EXPECT_TRUE(deltaTriples->triplesDeleted_.contains(
+        triples({"<A> <low> <a>"})[0]));
+  }
+  EXPECT_EQ(deltaTriplesManager.getCurrentSnapshot(), snapshot);
+
+  // The memory for the rollback is limited. If it is exceeded, the batch (and
+  // all the previous ones) are rolled back.
+  {
+    BatchedModification modification{
+        deltaTriplesManager,
+        ad_utility::testing::makeAllocator(ad_utility::MemorySize::bytes(40))};
+    modification.applyBatch(cancellationHandle, {},
+                            triples({"<a> <next> <b>"}));
+    numTriplesAre(3, 1, 4);
+    EXPECT_THROW(
+        modification.applyBatch(cancellationHandle, {},
+                                triples({"<a> <next> <c>", "<b> <next> <c>"})),
+        ad_utility::detail::AllocationExceedsLimitException);
+  }
+  numTriplesAre(2, 1, 3);
+
+  // A committed modification becomes visible.
+  {
+    BatchedModification modification{deltaTriplesManager, allocator};
+    modification.applyBatch(cancellationHandle, triples({"<a> <UPP> <A>"}),
+                            triples({"<c> <UPP> <new>"}));
+    auto counts = modification.commit<DeltaTriplesCount>(
+        [](DeltaTriples& deltaTriples) { return deltaTriples.getCounts(); });
+    EXPECT_EQ(counts, (DeltaTriplesCount{2, 2}));
+  }
+  numTriplesAre(2, 2, 4);
+  EXPECT_NE(deltaTriplesManager.getCurrentSnapshot(), snapshot);
+}
+
+// Test that the snapshots record the last modification of each predicate.
+TEST_F(DeltaTriplesTest, lastModificationOfPredicate) {
+  DeltaTriples deltaTriples(testQec->getIndex());
+  auto& vocab = testQec->getIndex().getVocab();
+  auto& localVocab = deltaTriples.localVocab();
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  auto triples = makeIdTriples(
+      vocab, localVocab, {"<a> <upp> <A>", "<A> <low> <a>", "<a> <next> <b>"});
+  Id upp = triples[0].ids()[1];
+  Id low = triples[1].ids()[1];
+  Id next = triples[2].ids()[1];
+
+  auto snapshot0 = deltaTriples.getSnapshot();
+  EXPECT_EQ(snapshot0->lastModificationOfPredicate(upp), 0);
+  EXPECT_EQ(snapshot0->lastModification_, 0);
+
+  // Modify `<upp>`.
+  deltaTriples.insertTriples(cancellationHandle, {triples[0]});
+  auto snapshot1 = deltaTriples.getSnapshot();
+  EXPECT_EQ(snapshot1->lastModificationOfPredicate(upp), 1);
+  EXPECT_EQ(snapshot1->lastModificationOfPredicate(low), 0);
+  EXPECT_EQ(snapshot1->lastModification_, 1);
+
+  // Idempotent updates and snapshots without updates don't modify anything.
+  deltaTriples.insertTriples(cancellationHandle, {triples[0]});
+  auto snapshot2 = deltaTriples.getSnapshot();
+  EXPECT_EQ(snapshot2->lastModificationOfPredicate(upp), 1);
+  EXPECT_EQ(snapshot2->lastModification_, 1);
+
+  // Modify `<low>`, the earlier snapshots are unaffected.
+  deltaTriples.deleteTriples(cancellationHandle, {triples[1]});
+  auto snapshot3 = deltaTriples.getSnapshot();
+  EXPECT_EQ(snapshot3->lastModificationOfPredicate(upp), 1);
+  EXPECT_EQ(snapshot3->lastModificationOfPredicate(low), 3);
+  EXPECT_EQ(snapshot3->lastModificationOfPredicate(next), 0);
+  EXPECT_EQ(snapshot3->lastModification_, 3);
+  EXPECT_EQ(snapshot1->lastModificationOfPredicate(low), 0);
+
+  // Clearing the delta triples modifies all predicates.
+  deltaTriples.clear();
+  auto snapshot4 = deltaTriples.getSnapshot();
+  EXPECT_EQ(snapshot4->lastModificationOfPredicate(upp), 4);
+  EXPECT_EQ(snapshot4->lastModificationOfPredicate(next), 4);
+  EXPECT_EQ(snapshot4->lastModification_, 4);
+
+  // The IDs of the local vocab are never looked up.
+  auto localTriples =
+      makeIdTriples(vocab, localVocab, {"<a> <notInVocab> <b>"});
+  EXPECT_EQ(snapshot4->lastModificationOfPredicate(localTriples[0].ids()[1]),
+            4);
+}
+
 // _____________________________________________________________________________
 TEST_F(DeltaTriplesTest, restoreFromNonExistingFile) {
   DeltaTriples deltaTriples{testQec->getIndex()};
@@ -604,3 +794,245 @@ TEST_F(DeltaTriplesTest, storeAndRestoreData) {
              Id::makeFromBool(false)}})));
   }
 }
+
+// _____________________________________________________________________________
+TEST_F(DeltaTriplesTest, storeAndRestoreWithUpdateLog) {
+  using namespace ::testing;
+  using ad_utility::triple_component::LiteralOrIri;
+  auto tmpFile =
+      std::filesystem::temp_directory_path() / "testDeltaTriplesUpdateLog";
+  auto updateLogFile = tmpFile;
+  updateLogFile += ".wal";
+  // Make sure no artifacts from previous crashed runs exist.
+  auto removeFiles = [&tmpFile, &updateLogFile]() {
+    std::filesystem::remove(tmpFile);
+    std::filesystem::remove(updateLogFile);
+  };
+  removeFiles();
+  absl::Cleanup cleanup{removeFiles};
+
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  LocalVocabEntry entry1{LiteralOrIri::fromStringRepresentation("<test>")};
+  LocalVocabEntry entry2{LiteralOrIri::fromStringRepresentation("<logged>")};
+  IdTriple<> triple1{{Id::makeFromInt(1), Id::makeFromLocalVocabIndex(&entry1),
+                      Id::makeFromBool(true)}};
+  IdTriple<> triple2{{Id::makeFromInt(2), Id::makeFromLocalVocabIndex(&entry2),
+                      Id::makeFromBool(false)}};
+  {
+    DeltaTriples deltaTriples{testQec->getIndex()};
+    deltaTriples.setPersists(tmpFile);
+    deltaTriples.readFromDisk();
+
+    // The first write creates the checkpoint.
+    deltaTriples.insertTriples(cancellationHandle, {triple1});
+    deltaTriples.writeToDisk();
+    EXPECT_TRUE(std::filesystem::exists(tmpFile));
+    EXPECT_FALSE(std::filesystem::exists(updateLogFile));
+    auto checkpointSize = std::filesystem::file_size(tmpFile);
+
+    // Small updates are only appended to the update log.
+    deltaTriples.insertTriples(cancellationHandle, {triple2});
+    deltaTriples.writeToDisk();
+    deltaTriples.deleteTriples(cancellationHandle, {triple1});
+    // Updates without an effect are not logged.
+    deltaTriples.deleteTriples(cancellationHandle, {triple1});
+    deltaTriples.writeToDisk();
+    EXPECT_EQ(std::filesystem::file_size(tmpFile), checkpointSize);
+    EXPECT_TRUE(std::filesystem::exists(updateLogFile));
+    EXPECT_EQ(deltaTriples.numInserted(), 1);
+    EXPECT_EQ(deltaTriples.numDeleted(), 1);
+  }
+  {
+    // Restoring replays the update log and then writes a new checkpoint.
+    DeltaTriples deltaTriples{testQec->getIndex()};
+    deltaTriples.setPersists(tmpFile);
+    deltaTriples.readFromDisk();
+    EXPECT_FALSE(std::filesystem::exists(updateLogFile));
+    EXPECT_EQ(deltaTriples.numInserted(), 1);
+    EXPECT_EQ(deltaTriples.numDeleted(), 1);
+    EXPECT_THAT(deltaTriples.localVocab().getAllWordsForTesting(),
+                UnorderedElementsAre(
+                    AD_PROPERTY(LocalVocabEntry, toStringRepresentation,
+                                Eq("<test>")),
+                    AD_PROPERTY(LocalVocabEntry, toStringRepresentation,
+                                Eq("<logged>"))));
+    auto getIndex = [&deltaTriples](const LocalVocabEntry& entry) {
+      return Id::makeFromLocalVocabIndex(
+          deltaTriples.localVocab().getIndexOrNullopt(entry).value());
+    };
+    EXPECT_TRUE(deltaTriples.triplesInserted_.contains(IdTriple<>{
+        {Id::makeFromInt(2), getIndex(entry2), Id::makeFromBool(false)}}));
+    EXPECT_TRUE(deltaTriples.triplesDeleted_.contains(IdTriple<>{
+        {Id::makeFromInt(1), getIndex(entry1), Id::makeFromBool(true)}}));
+
+    // The clearing can't be logged, so it writes a new checkpoint.
+    deltaTriples.insertTriples(cancellationHandle, {triple1});
+    deltaTriples.writeToDisk();
+    EXPECT_TRUE(std::filesystem::exists(updateLogFile));
+    deltaTriples.clear();
+    deltaTriples.writeToDisk();
+    EXPECT_FALSE(std::filesystem::exists(updateLogFile));
+  }
+  {
+    DeltaTriples deltaTriples{testQec->getIndex()};
+    deltaTriples.setPersists(tmpFile);
+    deltaTriples.readFromDisk();
+    EXPECT_EQ(deltaTriples.numInserted(), 0);
+    EXPECT_EQ(deltaTriples.numDeleted(), 0);
+  }
+}
+
+// _____________________________________________________________________________
+TEST_F(DeltaTriplesTest, restoreBlankNodesWithoutUpdateLog) {
+  auto tmpFile =
+      std::filesystem::temp_directory_path() / "testDeltaTriplesBlankNodes";
+  auto updateLogFile = tmpFile;
+  updateLogFile += ".wal";
+  auto removeFiles = [&tmpFile, &updateLogFile]() {
+    std::filesystem::remove(tmpFile);
+    std::filesystem::remove(updateLogFile);
+  };
+  removeFiles();
+  absl::Cleanup cleanup{removeFiles};
+
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  auto restore = [&tmpFile](DeltaTriples& deltaTriples) {
+    deltaTriples.setPersists(tmpFile);
+    deltaTriples.readFromDisk();
+  };
+  {
+    // Write a checkpoint that contains a blank node.
+    DeltaTriples deltaTriples{testQec->getIndex()};
+    restore(deltaTriples);
+    deltaTriples.insertTriples(
+        cancellationHandle,
+        {IdTriple<>{{Id::makeFromInt(1),
+                     Id::makeFromBlankNodeIndex(BlankNodeIndex::make(42)),
+                     Id::makeFromBool(true)}}});
+    deltaTriples.writeToDisk();
+    EXPECT_FALSE(std::filesystem::exists(updateLogFile));
+  }
+  {
+    // Restore the checkpoint (without an update log) and delete the triple
+    // with the blank node, which is only appended to the update log.
+    DeltaTriples deltaTriples{testQec->getIndex()};
+    restore(deltaTriples);
+    ASSERT_EQ(deltaTriples.numInserted(), 1);
+    auto triple = deltaTriples.triplesInserted_.begin()->first;
+    deltaTriples.deleteTriples(cancellationHandle, {triple});
+    deltaTriples.writeToDisk();
+    EXPECT_TRUE(std::filesystem::exists(updateLogFile));
+  }
+  {
+    // The deletion refers to the same blank node as the checkpoint.
+    DeltaTriples deltaTriples{testQec->getIndex()};
+    restore(deltaTriples);
+    EXPECT_EQ(deltaTriples.numInserted(), 0);
+    EXPECT_EQ(deltaTriples.numDeleted(), 1);
+  }
+}
+
+// _____________________________________________________________________________
+TEST_F(DeltaTriplesTest, compaction) {
+  // Use a separate index, because the compaction modifies its permutations.
+  const std::string indexBasename = "DeltaTriplesTest_compaction";
+  auto index = ad_utility::testing::makeTestIndex(
+      indexBasename,
+      "<a> <p> <b> . <a> <p> <c> . <b> <p> <c> . <c> <q> <a> . <d> <q> <e> .");
+  auto& manager = index.deltaTriplesManager();
+  auto tmpFile =
+      std::filesystem::temp_directory_path() / "testDeltaTriplesCompaction";
+  auto removeFiles = [&tmpFile, &indexBasename]() {
+    std::filesystem::remove(tmpFile);
+    std::filesystem::remove(tmpFile.string() + ".wal");
+    for (const auto& filename :
+         ad_utility::testing::getAllIndexFilenames(indexBasename)) {
+      std::filesystem::remove(filename);
+    }
+  };
+  removeFiles();
+  absl::Cleanup cleanup{removeFiles};
+  manager.setFilenameForPersistentUpdatesAndReadFromDisk(tmpFile.string());
+
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  LocalVocab localVocab;
+  const auto& vocab = index.getVocab();
+  // The last inserted triple contains a local vocab entry and therefore can't
+  // be compacted.
+  auto triplesToInsert = makeIdTriples(
+      vocab, localVocab, {"<a> <p> <e>", "<d> <q> <a>", "<a> <p> <new>"});
+  auto triplesToDelete =
+      makeIdTriples(vocab, localVocab, {"<a> <p> <c>", "<d> <q> <e>"});
+  manager.modify<void>([&](DeltaTriples& deltaTriples) {
+    deltaTriples.insertTriples(cancellationHandle, triplesToInsert);
+    deltaTriples.deleteTriples(cancellationHandle, triplesToDelete);
+  });
+
+  // Scan some relations of several permutations with the given snapshot.
+  auto getId = ad_utility::testing::makeGetId(index);
+  auto scanAll = [&](const SharedLocatedTriplesSnapshot& snapshot) {
+    std::vector<IdTable> result;
+    for (auto [permutation, col0] :
+         std::vector<std::pair<Permutation::Enum, std::string>>{
+             {Permutation::PSO, "<p>"},
+             {Permutation::PSO, "<q>"},
+             {Permutation::SPO, "<a>"},
+             {Permutation::SPO, "<d>"},
+             {Permutation::OPS, "<a>"},
+             {Permutation::OPS, "<e>"}}) {
+      result.push_back(index.getImpl().getPermutation(permutation).scan(
+          ScanSpecification{getId(col0), std::nullopt, std::nullopt}, {},
+          cancellationHandle, *snapshot));
+    }
+    return result;
+  };
+  auto snapshotBefore = manager.getCurrentSnapshot();
+  auto resultBefore = scanAll(snapshotBefore);
+  const auto& pso = index.getImpl().getPermutation(Permutation::PSO);
+  auto psoFilename = indexBasename + ".index.pso";
+  auto psoSizeBefore = std::filesystem::file_size(psoFilename);
+
+  // All triples except for the one with the local vocab entry are compacted.
+  EXPECT_EQ(manager.compact(cancellationHandle), 4);
+  EXPECT_THAT(*manager.deltaTriples_.rlock(), NumTriples(1, 0, 1));
+  EXPECT_GT(std::filesystem::file_size(psoFilename), psoSizeBefore);
+  EXPECT_FALSE(std::filesystem::exists(psoFilename + ".compaction"));
+  // The result is the same with the new snapshot and the old one.
+  auto snapshotAfter = manager.getCurrentSnapshot();
+  EXPECT_NE(snapshotAfter, snapshotBefore);
+  // The compaction invalidates the cached results of all the predicates.
+  EXPECT_GT(snapshotAfter->lastModification_,
+            snapshotBefore->lastModification_);
+  EXPECT_EQ(snapshotAfter->lastModificationOfPredicate(getId("<b>")),
+            snapshotAfter->lastModification_);
+  EXPECT_EQ(scanAll(snapshotAfter), resultBefore);
+  EXPECT_EQ(scanAll(snapshotBefore), resultBefore);
+  EXPECT_EQ(snapshotAfter->getLocatedTriplesForPermutation(Permutation::PSO)
+                .numTriples(),
+            1);
+
+  // Without compactable triples, nothing happens.
+  EXPECT_EQ(manager.compact(cancellationHandle), 0);
+
+  // Blocks that were written, but not committed are removed again.
+  psoSizeBefore = std::filesystem::file_size(psoFilename);
+  LocatedTriplesPerBlock locatedTriples;
+  locatedTriples.setOriginalMetadata(
+      snapshotAfter->getLocatedTriplesForPermutation(Permutation::PSO)
+          .getOriginalMetadata());
+  locatedTriples.add(LocatedTriple::locateTriplesInPermutation(
+      makeIdTriples(vocab, localVocab, {"<b> <q> <b>"}),
+      *locatedTriples.getOriginalMetadata(), pso.keyOrder(), true,
+      cancellationHandle));
+  pso.writeCompactedBlocks(locatedTriples, cancellationHandle);
+  EXPECT_TRUE(std::filesystem::exists(psoFilename + ".compaction"));
+  EXPECT_ANY_THROW(
+      pso.writeCompactedBlocks(locatedTriples, cancellationHandle));
+  EXPECT_GT(std::filesystem::file_size(psoFilename), psoSizeBefore);
+  pso.abortCompaction();
+  EXPECT_EQ(std::filesystem::file_size(psoFilename), psoSizeBefore);
+  EXPECT_FALSE(std::filesystem::exists(psoFilename + ".compaction"));
+}
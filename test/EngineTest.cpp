@@ -12,6 +12,7 @@
 #include "engine/idTable/IdTable.h"
 #include "util/AllocatorTestHelpers.h"
 #include "util/IdTableHelpers.h"
+#include "util/IdTestHelpers.h"
 #include "util/IndexTestHelpers.h"
 
 // _____________________________________________________________________________
@@ -43,3 +44,96 @@ TEST(Engine, countDistinct) {
                                  ::testing::HasSubstr("must be sorted"));
   }
 }
+
+// _____________________________________________________________________________
+TEST(Engine, sortByPermutation) {
+  using namespace ad_utility::testing;
+  auto getRows = [](const IdTable& table) {
+    std::vector<std::vector<Id>> rows;
+    for (size_t i = 0; i < table.numRows(); ++i) {
+      auto& row = rows.emplace_back();
+      for (size_t j = 0; j < table.numColumns(); ++j) {
+        row.push_back(table(i, j));
+      }
+    }
+    return rows;
+  };
+  auto isSortedBy = [](const IdTable& table,
+                       const std::vector<ColumnIndex>& sortCols) {
+    for (size_t i = 1; i < table.numRows(); ++i) {
+      for (ColumnIndex col : sortCols) {
+        if (table(i - 1, col) != table(i, col)) {
+          if (table(i, col) < table(i - 1, col)) {
+            return false;
+          }
+          break;
+        }
+      }
+    }
+    return true;
+  };
+
+  // A wide table with many duplicates in the sort columns. If
+  // `withLocalVocab` is true, column 2 consists of `LocalVocabIndex`es,
+  // which are not ordered by their bits, so the radix sort is not possible.
+  constexpr size_t numRows = 20'000;
+  for (bool withLocalVocab : {false, true}) {
+    IdTable table{8, makeAllocator()};
+    for (size_t i = 0; i < numRows; ++i) {
+      auto j = static_cast<int64_t>(i);
+      table.push_back({IntId((j * 7919) % 101 - 50),
+                       DoubleId(static_cast<double>((j * 31) % 17) - 8.5),
+                       withLocalVocab ? LocalVocabId((j * 13) % 47)
+                                      : VocabId((j * 13) % 47),
+                       IntId(j % 3), VocabId(j), IntId(-j), UndefId(),
+                       BoolId(j % 2 == 0)});
+    }
+    // Some undefined values, which are smaller than all other values.
+    table(17, 0) = UndefId();
+    table(4242, 0) = UndefId();
+    auto expectedRows = getRows(table);
+    ql::ranges::sort(expectedRows);
+
+    for (const auto& sortCols : std::vector<std::vector<ColumnIndex>>{
+             {0}, {2}, {1, 0}, {3, 2, 0}, {7, 3, 1, 2}}) {
+      IdTable sorted = table.clone();
+      Engine::sortByPermutation(sorted, sortCols);
+      EXPECT_TRUE(isSortedBy(sorted, sortCols));
+      auto rows = getRows(sorted);
+      ql::ranges::sort(rows);
+      EXPECT_EQ(rows, expectedRows);
+
+      // `Engine::sort` uses `sortByPermutation` for such a large and wide
+      // table.
+      IdTable sorted2 = table.clone();
+      Engine::sort(sorted2, sortCols);
+      EXPECT_TRUE(isSortedBy(sorted2, sortCols));
+    }
+  }
+
+  // Passes of the radix sort are skipped if all the keys have the same digit,
+  // also if the keys are distributed over several threads.
+  for (size_t numThreads : {1, 4}) {
+    IdTable table{2, makeAllocator()};
+    for (size_t i = 0; i < numRows; ++i) {
+      auto j = static_cast<int64_t>(i);
+      // Only the lowest byte of the first column and the two lowest bytes of
+      // the second column differ between the rows.
+      table.push_back({IntId((j * 7) % 200), VocabId((j * 7919) % 60'000)});
+    }
+    IdTable sorted = table.clone();
+    EXPECT_EQ(Engine::sortByPermutation(sorted, {0}, numThreads), 1u);
+    EXPECT_TRUE(isSortedBy(sorted, {0}));
+    sorted = table.clone();
+    EXPECT_EQ(Engine::sortByPermutation(sorted, {1, 0}, numThreads), 3u);
+    EXPECT_TRUE(isSortedBy(sorted, {1, 0}));
+  }
+
+  // Empty tables and tables with a single row are not changed.
+  IdTable empty{3, makeAllocator()};
+  Engine::sortByPermutation(empty, {0, 1});
+  EXPECT_TRUE(empty.empty());
+  auto single = makeIdTableFromVector({{3, 2, 1}});
+  Engine::sortByPermutation(single, {2});
+  EXPECT_EQ(single, makeIdTableFromVector({{3, 2, 1}}));
+}
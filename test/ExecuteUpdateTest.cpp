@@ -13,6 +13,7 @@
 #include "util/GTestHelpers.h"
 #include "util/IdTableHelpers.h"
 #include "util/IndexTestHelpers.h"
+#include "util/OperationTestHelpers.h"
 
 using namespace deltaTriplesTestHelpers;
 
@@ -193,6 +194,141 @@ TEST(ExecuteUpdate, executeUpdate) {
   }
 }
 
+// _____________________________________________________________________________
+TEST(ExecuteUpdate, executeUpdateStreaming) {
+  // Execute the `update` in streaming mode with the given `batchSize` and
+  // check that the delta triples are correct.
+  auto expectStreamingUpdate =
+      [](const std::string& update, size_t batchSize,
+         const testing::Matcher<const DeltaTriples&>& deltaTriplesMatcher,
+         source_location sourceLocation = source_location::current()) {
+        auto l = generateLocationTrace(sourceLocation);
+        Index index = ad_utility::testing::makeTestIndex(
+            "ExecuteUpdate_executeUpdateStreaming",
+            ad_utility::testing::TestIndexConfig{});
+        QueryResultCache cache = QueryResultCache();
+        QueryExecutionContext qec(index, &cache,
+                                  ad_utility::testing::makeAllocator(
+                                      ad_utility::MemorySize::megabytes(100)),
+                                  SortPerformanceEstimator{});
+        const auto sharedHandle =
+            std::make_shared<ad_utility::CancellationHandle<>>();
+        for (auto& pq : SparqlParser::parseUpdate(update)) {
+          QueryPlanner qp{&qec, sharedHandle};
+          const auto qet = qp.createExecutionTree(pq);
+          DeltaTriplesManager::BatchedModification modification{
+              index.deltaTriplesManager(), qec.getAllocator()};
+          ExecuteUpdate::executeUpdateStreaming(index, pq, qet, modification,
+                                                sharedHandle, batchSize);
+          modification.commit<DeltaTriplesCount>(
+              [](DeltaTriples& deltaTriples) {
+                return deltaTriples.getCounts();
+              });
+          qec.updateLocatedTriplesSnapshot();
+        }
+        index.deltaTriplesManager().modify<void>(
+            [&deltaTriplesMatcher](DeltaTriples& deltaTriples) {
+              EXPECT_THAT(deltaTriples, deltaTriplesMatcher);
+            });
+      };
+
+  // The result must not depend on the batch size, in particular, a triple
+  // that is inserted for an earlier batch must not be deleted for a later
+  // batch.
+  for (size_t batchSize : {1, 2, 100}) {
+    expectStreamingUpdate("INSERT DATA { <s> <p> <o> . }", batchSize,
+                          NumTriples(1, 0, 1));
+    expectStreamingUpdate("DELETE WHERE { ?s ?p ?o }", batchSize,
+                          NumTriples(0, 8, 8));
+    expectStreamingUpdate(
+        "DELETE { ?s <is-a> ?o } INSERT { <a> <b> <c> } WHERE { ?s <is-a> ?o "
+        "}",
+        batchSize, NumTriples(1, 2, 3));
+    expectStreamingUpdate(
+        "DELETE { <a> <b> <c> } INSERT { <a> <b> <c> } WHERE { ?s <is-a> ?o }",
+        batchSize, NumTriples(1, 0, 1));
+    expectStreamingUpdate(
+        "DELETE { ?s <is-a> ?o } INSERT { ?o <is-a> ?s } WHERE { ?s <is-a> ?o "
+        "}",
+        batchSize, NumTriples(2, 0, 2));
+    expectStreamingUpdate(
+        "INSERT { ?s <label> \"new\" } WHERE { ?s <label> ?o }", batchSize,
+        NumTriples(3, 0, 3));
+    expectStreamingUpdate(
+        "INSERT DATA { <a> <b> <c> }; DELETE WHERE { ?s ?p ?o }", batchSize,
+        NumTriples(0, 9, 9));
+  }
+  EXPECT_ANY_THROW(expectStreamingUpdate("INSERT DATA { <s> <p> <o> . }", 0,
+                                         NumTriples(1, 0, 1)));
+}
+
+// _____________________________________________________________________________
+TEST(ExecuteUpdate, executeUpdateStreamingIsRolledBackOnFailure) {
+  // A lazy operation (without variables) that can be used in a
+  // `QueryExecutionTree`.
+  class GeneratorOperation : public CustomGeneratorOperation {
+    using CustomGeneratorOperation::CustomGeneratorOperation;
+    std::string getCacheKeyImpl() const override {
+      return "GeneratorOperation";
+    }
+  };
+  Index index = ad_utility::testing::makeTestIndex(
+      "ExecuteUpdate_executeUpdateStreamingIsRolledBackOnFailure",
+      ad_utility::testing::TestIndexConfig{});
+  QueryResultCache cache = QueryResultCache();
+  QueryExecutionContext qec(index, &cache,
+                            ad_utility::testing::makeAllocator(
+                                ad_utility::MemorySize::megabytes(100)),
+                            SortPerformanceEstimator{});
+  const auto sharedHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  auto& manager = index.deltaTriplesManager();
+  auto executeUpdate = [&](const std::string& update,
+                           Result::Generator whereClause) {
+    auto pq = SparqlParser::parseUpdate(update).at(0);
+    QueryExecutionTree qet{&qec, std::make_shared<GeneratorOperation>(
+                                     &qec, std::move(whereClause))};
+    DeltaTriplesManager::BatchedModification modification{manager,
+                                                          qec.getAllocator()};
+    ExecuteUpdate::executeUpdateStreaming(index, pq, qet, modification,
+                                          sharedHandle, 1);
+    modification.commit<DeltaTriplesCount>(
+        [](DeltaTriples& deltaTriples) { return deltaTriples.getCounts(); });
+  };
+  // Two rows (without columns), each of which is a batch of its own.
+  auto twoRows = []() -> Result::Generator {
+    co_yield {makeIdTableFromVector({{}, {}}), LocalVocab{}};
+  };
+  auto twoRowsThenFail = []() -> Result::Generator {
+    co_yield {makeIdTableFromVector({{}, {}}), LocalVocab{}};
+    throw std::runtime_error{"The WHERE clause failed"};
+  };
+
+  executeUpdate("INSERT { <a> <b> <c> } WHERE {}", twoRows());
+  auto snapshot = manager.getCurrentSnapshot();
+  // The batches of the second update are applied before its WHERE clause
+  // fails, but they must neither be visible nor remain in the delta triples.
+  AD_EXPECT_THROW_WITH_MESSAGE(
+      executeUpdate("DELETE { <a> <b> <c> . <x> <label> \"alpha\" } "
+                    "INSERT { <s> <p> <o> } WHERE {}",
+                    twoRowsThenFail()),
+      testing::HasSubstr("The WHERE clause failed"));
+  EXPECT_EQ(manager.getCurrentSnapshot(), snapshot);
+  manager.modify<void>([](DeltaTriples& deltaTriples) {
+    EXPECT_THAT(deltaTriples, NumTriples(1, 0, 1));
+  });
+
+  // The same update without the failure.
+  executeUpdate(
+      "DELETE { <a> <b> <c> . <x> <label> \"alpha\" } "
+      "INSERT { <s> <p> <o> } WHERE {}",
+      twoRows());
+  EXPECT_NE(manager.getCurrentSnapshot(), snapshot);
+  manager.modify<void>([](DeltaTriples& deltaTriples) {
+    EXPECT_THAT(deltaTriples, NumTriples(1, 2, 3));
+  });
+}
+
 // _____________________________________________________________________________
 TEST(ExecuteUpdate, computeGraphUpdateQuads) {
   // For each test suite the `qec` and the `defaultGraphId` have to be set
@@ -186,6 +186,78 @@ TEST(GraphStoreProtocolTest, parseTriples) {
       testing::HasSubstr(" Parse error at byte position 7"));
 }
 
+// _____________________________________________________________________________________________
+TEST(GraphStoreProtocolTest, parseAndConvertTriplesInParallel) {
+  using namespace ad_utility::memory_literals;
+  auto parseInParallel = [](std::string_view body,
+                            const GraphOrDefault& graph = DEFAULT{}) {
+    return GraphStoreProtocol::parseAndConvertTriplesInParallel(body, graph,
+                                                                1_kB);
+  };
+  // Many small batches, which are parsed in parallel.
+  std::string body = "@prefix ex: <http://example.org/> .\n";
+  for (size_t i = 0; i < 1000; ++i) {
+    absl::StrAppend(&body, "ex:s", i, " ex:p \"o", i, "\" .\n");
+  }
+  auto expectedTriples = GraphStoreProtocol::convertTriples(
+      iri("<g>"),
+      GraphStoreProtocol::parseTriples(body, ad_utility::MediaType::turtle));
+  ASSERT_EQ(expectedTriples.size(), 1000);
+  auto triples = parseInParallel(body, iri("<g>"));
+  ASSERT_TRUE(triples.has_value());
+  EXPECT_THAT(triples.value(),
+              testing::UnorderedElementsAreArray(expectedTriples));
+
+  EXPECT_THAT(parseInParallel(""), testing::Optional(testing::IsEmpty()));
+
+  // A prefix declaration after the first batch and an undeclared prefix might
+  // still be valid Turtle, which has to be parsed sequentially.
+  EXPECT_EQ(parseInParallel(absl::StrCat(
+                body, "@prefix ex2: <http://example.com/> .\n",
+                "ex2:s ex2:p ex2:o .\n")),
+            std::nullopt);
+  EXPECT_EQ(parseInParallel(absl::StrCat(body, "ex3:s ex3:p ex3:o .\n")),
+            std::nullopt);
+
+  // A statement that is longer than a batch.
+  EXPECT_EQ(parseInParallel(absl::StrCat("<s> <p> \"", std::string(3000, 'a'),
+                                         "\" .\n")),
+            std::nullopt);
+
+  // Syntax errors are reported directly.
+  EXPECT_THROW(parseInParallel("<a> <b> .\n"), ParseException);
+  EXPECT_THROW(parseInParallel(absl::StrCat(body, "ex:s ex:p .\n")),
+               ParseException);
+}
+
+// _____________________________________________________________________________________________
+TEST(GraphStoreProtocolTest, parseAndConvertLargeBodies) {
+  // Bodies of at least `DEFAULT_PARSER_BUFFER_SIZE` bytes with a long literal.
+  std::string literal(DEFAULT_PARSER_BUFFER_SIZE.getBytes() + 1000, 'a');
+  auto expectSingleTriple = [](const std::string& body,
+                               ad_utility::MediaType contentType,
+                               ad_utility::source_location l =
+                                   ad_utility::source_location::current()) {
+    auto trace = generateLocationTrace(l);
+    auto triples = GraphStoreProtocol::parseAndConvertTriples(
+        body, contentType, DEFAULT{});
+    ASSERT_EQ(triples.size(), 1);
+    EXPECT_EQ(triples[0].p_, TC(iri("<p>")));
+  };
+  // A single N-Triples statement that doesn't fit into a batch of the parallel
+  // parser.
+  expectSingleTriple(absl::StrCat("<s> <p> \"", literal, "\" .\n"),
+                     ad_utility::MediaType::ntriples);
+  // A multi-line Turtle literal that contains `.` followed by a line break,
+  // and a Turtle statement that spans several lines.
+  for (size_t i = 1000; i < literal.size(); i += 1000) {
+    literal[i - 1] = '.';
+    literal[i] = '\n';
+  }
+  expectSingleTriple(absl::StrCat("<s>\n<p>\n\"\"\"", literal, "\"\"\" .\n"),
+                     ad_utility::MediaType::turtle);
+}
+
 // _____________________________________________________________________________________________
 TEST(GraphStoreProtocolTest, convertTriples) {
   auto expectConvert =
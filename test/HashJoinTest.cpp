@@ -0,0 +1,294 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <absl/strings/str_cat.h>
+#include <gmock/gmock.h>
+
+#include "./engine/ValuesForTesting.h"
+#include "./util/AllocatorTestHelpers.h"
+#include "./util/IdTableHelpers.h"
+#include "./util/IdTestHelpers.h"
+#include "./util/IndexTestHelpers.h"
+#include "./util/RuntimeParametersTestHelpers.h"
+#include "engine/HashJoin.h"
+#include "engine/Join.h"
+
+namespace {
+using Vars = std::vector<std::optional<Variable>>;
+
+// Return the rows of `table` in sorted order.
+std::vector<std::vector<Id>> sortedRows(const IdTable& table) {
+  std::vector<std::vector<Id>> rows;
+  for (size_t i = 0; i < table.numRows(); ++i) {
+    auto& row = rows.emplace_back();
+    for (size_t j = 0; j < table.numColumns(); ++j) {
+      row.push_back(table(i, j));
+    }
+  }
+  ql::ranges::sort(rows);
+  return rows;
+}
+
+// Make a `ValuesForTesting` with the given `table` and `variables`.
+std::shared_ptr<QueryExecutionTree> makeValues(QueryExecutionContext* qec,
+                                               const IdTable& table,
+                                               Vars variables) {
+  return ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, table.clone(), std::move(variables));
+}
+
+// Make a `ValuesForTesting` that yields the given `tables` lazily and has the
+// given size estimate.
+std::shared_ptr<QueryExecutionTree> makeLazyValues(
+    QueryExecutionContext* qec, const std::vector<IdTable>& tables,
+    Vars variables, size_t sizeEstimate) {
+  auto tree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec,
+      ad_utility::transform(tables,
+                            [](const IdTable& table) { return table.clone(); }),
+      std::move(variables));
+  static_cast<ValuesForTesting*>(tree->getRootOperation().get())
+      ->sizeEstimate() = sizeEstimate;
+  return tree;
+}
+
+// Compute the result of a `Join` of the same inputs, which the `HashJoin` has
+// to match up to the order of the rows.
+IdTable computeJoin(QueryExecutionContext* qec,
+                    std::shared_ptr<QueryExecutionTree> left,
+                    std::shared_ptr<QueryExecutionTree> right,
+                    ColumnIndex leftJoinCol, ColumnIndex rightJoinCol) {
+  Join join{qec, std::move(left), std::move(right), leftJoinCol, rightJoinCol,
+            false};
+  return join.computeResultOnlyForTesting().idTable().clone();
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(HashJoin, hashTable) {
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  // Many rows with duplicates, so that there are several chunks and
+  // partitions.
+  constexpr size_t numRows = 50'000;
+  constexpr size_t numDistinct = 1'000;
+  std::vector<Id> column;
+  for (size_t i = 0; i < numRows; ++i) {
+    column.push_back(Id::makeFromInt(static_cast<int64_t>(i % numDistinct)));
+  }
+  for (size_t numPartitionBits : {0, 1, 4}) {
+    for (size_t numThreads : {1, 4}) {
+      HashJoin::HashTable hashTable{column, numPartitionBits, numThreads,
+                                    cancellationHandle,
+                                    ad_utility::testing::makeAllocator()};
+      EXPECT_EQ(hashTable.numPartitions(), size_t{1} << numPartitionBits);
+      for (size_t key = 0; key < numDistinct; key += 97) {
+        std::vector<size_t> matches;
+        hashTable.forEachMatch(Id::makeFromInt(static_cast<int64_t>(key)),
+                               [&matches](size_t row) {
+                                 matches.push_back(row);
+                               });
+        // The matching rows are reported in their original order.
+        std::vector<size_t> expected;
+        for (size_t row = key; row < numRows; row += numDistinct) {
+          expected.push_back(row);
+        }
+        EXPECT_EQ(matches, expected);
+      }
+      size_t numMatches = 0;
+      hashTable.forEachMatch(
+          Id::makeFromInt(static_cast<int64_t>(numDistinct)),
+          [&numMatches](size_t) { ++numMatches; });
+      EXPECT_EQ(numMatches, 0);
+    }
+  }
+
+  // The memory of the hash table is limited by the allocator.
+  using namespace ad_utility::memory_literals;
+  EXPECT_THROW(
+      (HashJoin::HashTable{column, 4, 4, cancellationHandle,
+                           ad_utility::testing::makeAllocator(10_kB)}),
+      ad_utility::detail::AllocationExceedsLimitException);
+}
+
+// _____________________________________________________________________________
+TEST(HashJoin, materializedInputs) {
+  auto* qec = ad_utility::testing::getQec();
+  IdTable left = makeIdTableFromVector(
+      {{4, 1}, {2, 10}, {1, 11}, {2, 12}, {7, 13}, {2, 14}});
+  IdTable right = makeIdTableFromVector(
+      {{20, 2, 21}, {30, 4, 31}, {40, 2, 41}, {50, 5, 51}});
+  auto leftTree = makeValues(qec, left, Vars{Variable{"?x"}, Variable{"?a"}});
+  auto rightTree = makeValues(
+      qec, right, Vars{Variable{"?b"}, Variable{"?x"}, Variable{"?c"}});
+
+  HashJoin hashJoin{qec, leftTree, rightTree, 0, 1, false};
+  EXPECT_EQ(hashJoin.getDescriptor(), "HashJoin on ?x");
+  EXPECT_EQ(hashJoin.getResultWidth(), 4);
+  EXPECT_TRUE(hashJoin.resultSortedOn().empty());
+  // The right child is smaller, so it is the build side.
+  EXPECT_FALSE(hashJoin.leftIsBuildSide());
+
+  auto result = hashJoin.computeResultOnlyForTesting();
+  ASSERT_TRUE(result.isFullyMaterialized());
+  auto expected = makeIdTableFromVector({{4, 1, 30, 31},
+                                         {2, 10, 20, 21},
+                                         {2, 10, 40, 41},
+                                         {2, 12, 20, 21},
+                                         {2, 12, 40, 41},
+                                         {2, 14, 20, 21},
+                                         {2, 14, 40, 41}});
+  EXPECT_EQ(sortedRows(result.idTable()), sortedRows(expected));
+  EXPECT_EQ(sortedRows(result.idTable()),
+            sortedRows(computeJoin(qec, leftTree, rightTree, 0, 1)));
+
+  // The column order is the same if the left child is the build side.
+  auto smallLeft = makeIdTableFromVector({{2, 10}});
+  auto smallLeftTree =
+      makeValues(qec, smallLeft, Vars{Variable{"?x"}, Variable{"?a"}});
+  HashJoin hashJoin2{qec, smallLeftTree, rightTree, 0, 1, false};
+  EXPECT_TRUE(hashJoin2.leftIsBuildSide());
+  EXPECT_EQ(sortedRows(hashJoin2.computeResultOnlyForTesting().idTable()),
+            sortedRows(makeIdTableFromVector(
+                {{2, 10, 20, 21}, {2, 10, 40, 41}})));
+}
+
+// _____________________________________________________________________________
+TEST(HashJoin, largeInputsAreProbedInParallel) {
+  auto* qec = ad_utility::testing::getQec();
+  auto cleanup = setRuntimeParameterForTest<"hash-join-num-threads">(size_t{4});
+  IdTable left{2, ad_utility::testing::makeAllocator()};
+  IdTable right{2, ad_utility::testing::makeAllocator()};
+  auto I = [](size_t i) { return Id::makeFromInt(static_cast<int64_t>(i)); };
+  for (size_t i = 0; i < 40'000; ++i) {
+    left.push_back({I(i % 5'000), I(i)});
+  }
+  for (size_t i = 0; i < 30'000; ++i) {
+    right.push_back({I((i * 7) % 6'000), I(i)});
+  }
+  auto leftTree = makeValues(qec, left, Vars{Variable{"?x"}, Variable{"?a"}});
+  auto rightTree = makeValues(qec, right, Vars{Variable{"?x"}, Variable{"?b"}});
+  HashJoin hashJoin{qec, leftTree, rightTree, 0, 0, false};
+  auto result = hashJoin.computeResultOnlyForTesting();
+  EXPECT_EQ(sortedRows(result.idTable()),
+            sortedRows(computeJoin(qec, leftTree, rightTree, 0, 0)));
+}
+
+// _____________________________________________________________________________
+TEST(HashJoin, lazyProbeSide) {
+  auto* qec = ad_utility::testing::getQec();
+  IdTable build = makeIdTableFromVector({{1, 100}, {3, 300}, {3, 301}});
+  std::vector<IdTable> probeTables;
+  probeTables.push_back(makeIdTableFromVector({{3, 10}, {2, 11}}));
+  probeTables.push_back(makeIdTableFromVector({{5, 12}}));
+  probeTables.push_back(makeIdTableFromVector({{1, 13}, {3, 14}}));
+  IdTable expected = makeIdTableFromVector({{3, 10, 300},
+                                            {3, 10, 301},
+                                            {1, 13, 100},
+                                            {3, 14, 300},
+                                            {3, 14, 301}});
+
+  for (bool requestLaziness : {false, true}) {
+    auto probeTree = makeLazyValues(
+        qec, probeTables, Vars{Variable{"?x"}, Variable{"?a"}}, 100);
+    auto buildTree =
+        makeValues(qec, build, Vars{Variable{"?x"}, Variable{"?b"}});
+    HashJoin hashJoin{qec, probeTree, buildTree, 0, 0, false};
+    EXPECT_FALSE(hashJoin.leftIsBuildSide());
+    auto result = hashJoin.computeResultOnlyForTesting(requestLaziness);
+    ASSERT_EQ(result.isFullyMaterialized(), !requestLaziness);
+    if (requestLaziness) {
+      // The block without a match is skipped.
+      auto [table, localVocabs] =
+          aggregateTables(result.idTables(), hashJoin.getResultWidth());
+      EXPECT_EQ(localVocabs.size(), 2);
+      EXPECT_EQ(sortedRows(table), sortedRows(expected));
+    } else {
+      EXPECT_EQ(sortedRows(result.idTable()), sortedRows(expected));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+TEST(HashJoin, emptyBuildSide) {
+  auto* qec = ad_utility::testing::getQec();
+  IdTable empty{2, ad_utility::testing::makeAllocator()};
+  auto emptyTree = makeValues(qec, empty, Vars{Variable{"?x"}, Variable{"?a"}});
+  auto otherTree = makeValues(qec, makeIdTableFromVector({{1, 2}}),
+                              Vars{Variable{"?x"}, Variable{"?b"}});
+  HashJoin hashJoin{qec, emptyTree, otherTree, 0, 0, false};
+  EXPECT_TRUE(hashJoin.knownEmptyResult());
+  auto result = hashJoin.computeResultOnlyForTesting();
+  EXPECT_TRUE(result.idTable().empty());
+  EXPECT_EQ(result.idTable().numColumns(), 3);
+}
+
+// _____________________________________________________________________________
+TEST(HashJoin, undefinedJoinColumnIsNotApplicable) {
+  auto* qec = ad_utility::testing::getQec();
+  auto U = Id::makeUndefined();
+  auto I = ad_utility::testing::IntId;
+  IdTable withUndef{2, ad_utility::testing::makeAllocator()};
+  withUndef.push_back({U, I(1)});
+  auto undefTree =
+      makeValues(qec, withUndef, Vars{Variable{"?x"}, Variable{"?a"}});
+  auto otherTree = makeValues(qec, makeIdTableFromVector({{1, 2}}),
+                              Vars{Variable{"?x"}, Variable{"?b"}});
+  EXPECT_FALSE(HashJoin::isApplicable(*undefTree, *otherTree, 0, 0));
+  EXPECT_TRUE(HashJoin::isApplicable(*otherTree, *otherTree, 0, 0));
+  EXPECT_ANY_THROW((HashJoin{qec, undefTree, otherTree, 0, 0}));
+}
+
+// _____________________________________________________________________________
+TEST(HashJoin, equalLocalVocabEntriesFromDifferentVocabs) {
+  auto* qec = ad_utility::testing::getQec();
+  auto cleanup = setRuntimeParameterForTest<"hash-join-num-threads">(size_t{4});
+  // Equal entries in two different local vocabs have `Id`s with different
+  // bits, which have to end up in the same partition of the hash table.
+  auto makeId = [](LocalVocab& localVocab, size_t i) {
+    return Id::makeFromLocalVocabIndex(
+        localVocab.getIndexAndAddIfNotContained(LocalVocabEntry{
+            ad_utility::triple_component::LiteralOrIri::literalWithoutQuotes(
+                absl::StrCat("entry", i))}));
+  };
+  auto I = [](size_t i) { return Id::makeFromInt(static_cast<int64_t>(i)); };
+  LocalVocab buildVocab;
+  LocalVocab probeVocab;
+  IdTable build{2, ad_utility::testing::makeAllocator()};
+  IdTable probe{2, ad_utility::testing::makeAllocator()};
+  for (size_t i = 0; i < 20'000; ++i) {
+    build.push_back({makeId(buildVocab, i % 5'000), I(i)});
+  }
+  for (size_t i = 0; i < 30'000; ++i) {
+    probe.push_back({makeId(probeVocab, i % 6'000), I(i)});
+  }
+  ASSERT_NE(build(0, 0).getBits(), probe(0, 0).getBits());
+  ASSERT_EQ(build(0, 0), probe(0, 0));
+
+  // The hash table is partitioned and finds the rows for the `Id`s of the
+  // other vocab.
+  auto cancellationHandle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  HashJoin::HashTable hashTable{build.getColumn(0), 4, 4, cancellationHandle,
+                                ad_utility::testing::makeAllocator()};
+  EXPECT_EQ(hashTable.numPartitions(), 16);
+  for (size_t i = 0; i < 6'000; i += 101) {
+    size_t numMatches = 0;
+    hashTable.forEachMatch(probe(i, 0),
+                           [&numMatches](size_t) { ++numMatches; });
+    EXPECT_EQ(numMatches, i < 5'000 ? 4 : 0);
+  }
+
+  // The complete join finds all the matches.
+  auto buildTree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, build.clone(), Vars{Variable{"?x"}, Variable{"?a"}}, false,
+      std::vector<ColumnIndex>{}, std::move(buildVocab));
+  auto probeTree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, probe.clone(), Vars{Variable{"?x"}, Variable{"?b"}}, false,
+      std::vector<ColumnIndex>{}, std::move(probeVocab));
+  HashJoin hashJoin{qec, buildTree, probeTree, 0, 0, false};
+  EXPECT_TRUE(hashJoin.leftIsBuildSide());
+  auto result = hashJoin.computeResultOnlyForTesting();
+  // Each of the 25'000 probe rows with an entry `< 5'000` has 4 matches.
+  EXPECT_EQ(result.idTable().numRows(), 100'000);
+}
@@ -101,7 +101,7 @@ TEST_F(LocatedTriplesTest, numTriplesInBlock) {
     return testing::ResultOf(
         absl::StrCat(".map_.at(", std::to_string(blockIndex), ")"),
         [blockIndex](const LocatedTriplesPerBlock& ltpb) {
-          return ltpb.map_.at(blockIndex);
+          return *ltpb.map_.at(blockIndex);
         },
         testing::Eq(expectedLTs));
   };
@@ -118,7 +118,8 @@ TEST_F(LocatedTriplesTest, numTriplesInBlock) {
               return locatedTriplesInBlock(blockIndex, expectedLTs);
             });
         // The macro does not work with templated types.
-        using HashMapType = ad_utility::HashMap<size_t, LocatedTriples>;
+        using HashMapType =
+            ad_utility::HashMap<size_t, std::shared_ptr<LocatedTriples>>;
         return testing::AllOf(
             AD_FIELD(LocatedTriplesPerBlock, map_,
                      AD_PROPERTY(HashMapType, size,
@@ -148,40 +149,41 @@ TEST_F(LocatedTriplesTest, numTriplesInBlock) {
   EXPECT_THAT(locatedTriplesPerBlock, numTriplesTotal(7));
   EXPECT_THAT(locatedTriplesPerBlock,
               numTriplesBlockwise(
-                  {{1, {3, 3}}, {2, {2, 2}}, {3, {0, 0}}, {4, {2, 2}}}));
+                  {{1, {1, 2}}, {2, {2, 0}}, {3, {0, 0}}, {4, {1, 1}}}));
   EXPECT_THAT(locatedTriplesPerBlock,
               locatedTriplesAre(
                   {{1, {LT1, LT2, LT3}}, {2, {LT4, LT5}}, {4, {LT6, LT7}}}));
 
-  auto handles = locatedTriplesPerBlock.add(std::vector{LT8, LT9});
+  locatedTriplesPerBlock.add(std::vector{LT8, LT9});
 
   EXPECT_THAT(locatedTriplesPerBlock, numBlocks(4));
   EXPECT_THAT(locatedTriplesPerBlock, numTriplesTotal(9));
   EXPECT_THAT(locatedTriplesPerBlock,
               numTriplesBlockwise(
-                  {{1, {3, 3}}, {2, {2, 2}}, {3, {1, 1}}, {4, {3, 3}}}));
+                  {{1, {1, 2}}, {2, {2, 0}}, {3, {1, 0}}, {4, {1, 2}}}));
   EXPECT_THAT(locatedTriplesPerBlock,
               locatedTriplesAre({{1, {LT1, LT2, LT3}},
                                  {2, {LT4, LT5}},
                                  {3, {LT8}},
                                  {4, {LT6, LT7, LT9}}}));
 
-  locatedTriplesPerBlock.erase(3, handles[0]);
+  locatedTriplesPerBlock.erase(3, LT8);
   locatedTriplesPerBlock.updateAugmentedMetadata();
 
   EXPECT_THAT(locatedTriplesPerBlock, numBlocks(3));
   EXPECT_THAT(locatedTriplesPerBlock, numTriplesTotal(8));
   EXPECT_THAT(locatedTriplesPerBlock,
               numTriplesBlockwise(
-                  {{1, {3, 3}}, {2, {2, 2}}, {3, {0, 0}}, {4, {3, 3}}}));
+                  {{1, {1, 2}}, {2, {2, 0}}, {3, {0, 0}}, {4, {1, 2}}}));
   EXPECT_THAT(
       locatedTriplesPerBlock,
       locatedTriplesAre(
           {{1, {LT1, LT2, LT3}}, {2, {LT4, LT5}}, {4, {LT6, LT7, LT9}}}));
 
   // Erasing in a block that does not exist, raises an exception.
-  EXPECT_THROW(locatedTriplesPerBlock.erase(100, handles[1]),
-               ad_utility::Exception);
+  EXPECT_THROW(locatedTriplesPerBlock.erase(100, LT9), ad_utility::Exception);
+  // Erasing a triple that is not contained in the block, raises an exception.
+  EXPECT_THROW(locatedTriplesPerBlock.erase(4, LT8), ad_utility::Exception);
   locatedTriplesPerBlock.updateAugmentedMetadata();
 
   // Nothing changed.
@@ -189,24 +191,46 @@ TEST_F(LocatedTriplesTest, numTriplesInBlock) {
   EXPECT_THAT(locatedTriplesPerBlock, numTriplesTotal(8));
   EXPECT_THAT(locatedTriplesPerBlock,
               numTriplesBlockwise(
-                  {{1, {3, 3}}, {2, {2, 2}}, {3, {0, 0}}, {4, {3, 3}}}));
+                  {{1, {1, 2}}, {2, {2, 0}}, {3, {0, 0}}, {4, {1, 2}}}));
   EXPECT_THAT(
       locatedTriplesPerBlock,
       locatedTriplesAre(
           {{1, {LT1, LT2, LT3}}, {2, {LT4, LT5}}, {4, {LT6, LT7, LT9}}}));
 
-  locatedTriplesPerBlock.erase(4, handles[1]);
+  locatedTriplesPerBlock.erase(4, LT9);
   locatedTriplesPerBlock.updateAugmentedMetadata();
 
   EXPECT_THAT(locatedTriplesPerBlock, numBlocks(3));
   EXPECT_THAT(locatedTriplesPerBlock, numTriplesTotal(7));
   EXPECT_THAT(locatedTriplesPerBlock,
               numTriplesBlockwise(
-                  {{1, {3, 3}}, {2, {2, 2}}, {3, {0, 0}}, {4, {2, 2}}}));
+                  {{1, {1, 2}}, {2, {2, 0}}, {3, {0, 0}}, {4, {1, 1}}}));
   EXPECT_THAT(locatedTriplesPerBlock,
               locatedTriplesAre(
                   {{1, {LT1, LT2, LT3}}, {2, {LT4, LT5}}, {4, {LT6, LT7}}}));
 
+  // Erase a batch of triples from several blocks (in arbitrary order).
+  locatedTriplesPerBlock.erase(std::vector{LT7, LT3, LT6, LT1});
+  locatedTriplesPerBlock.updateAugmentedMetadata();
+
+  EXPECT_THAT(locatedTriplesPerBlock, numBlocks(2));
+  EXPECT_THAT(locatedTriplesPerBlock, numTriplesTotal(3));
+  EXPECT_THAT(locatedTriplesPerBlock,
+              numTriplesBlockwise(
+                  {{1, {0, 1}}, {2, {2, 0}}, {3, {0, 0}}, {4, {0, 0}}}));
+  EXPECT_THAT(locatedTriplesPerBlock,
+              locatedTriplesAre({{1, {LT2}}, {2, {LT4, LT5}}}));
+
+  // Erasing a batch with a triple that is not contained raises an exception.
+  EXPECT_THROW(locatedTriplesPerBlock.erase(std::vector{LT8}),
+               ad_utility::Exception);
+
+  // Inserting a batch keeps the triples of a block sorted.
+  locatedTriplesPerBlock.add(std::vector{LT3, LT1});
+  EXPECT_THAT(locatedTriplesPerBlock,
+              locatedTriplesAre({{1, {LT1, LT2, LT3}}, {2, {LT4, LT5}}}));
+  EXPECT_THAT(locatedTriplesPerBlock, numTriplesInBlock(1, {1, 2}));
+
   locatedTriplesPerBlock.clear();
 
   EXPECT_THAT(locatedTriplesPerBlock, numBlocks(0));
@@ -217,6 +241,166 @@ TEST_F(LocatedTriplesTest, numTriplesInBlock) {
   EXPECT_THAT(locatedTriplesPerBlock, locatedTriplesAre({}));
 }
 
+// Test that copies of a `LocatedTriplesPerBlock` (as used for the snapshots of
+// the `DeltaTriples`) share the located triples of each block until one of the
+// copies modifies them.
+TEST_F(LocatedTriplesTest, copyOnWrite) {
+  using LT = LocatedTriple;
+  std::vector<CompressedBlockMetadata> metadata{
+      CBM(PT(5, 1, 1), PT(15, 1, 1)), CBM(PT(15, 1, 2), PT(25, 1, 1))};
+  auto LT1 = LT{0, IT(10, 1, 0), true};
+  auto LT2 = LT{1, IT(20, 2, 0), true};
+  auto LT3 = LT{1, IT(21, 3, 0), false};
+  auto original = makeLocatedTriplesPerBlock({LT1, LT2});
+  original.setOriginalMetadata(metadata);
+  original.updateAugmentedMetadata();
+
+  const LocatedTriplesPerBlock copy = original;
+  auto isShared = [&original, &copy](size_t blockIndex) {
+    return original.map_.at(blockIndex) == copy.map_.at(blockIndex);
+  };
+  EXPECT_TRUE(isShared(0));
+  EXPECT_TRUE(isShared(1));
+  EXPECT_EQ(&original.getAugmentedMetadata(), &copy.getAugmentedMetadata());
+
+  // Modifying block 1 of the original copies only this block, the copy is not
+  // affected.
+  original.add(std::vector{LT3});
+  EXPECT_TRUE(isShared(0));
+  EXPECT_FALSE(isShared(1));
+  EXPECT_EQ(*original.map_.at(1), (LocatedTriples{LT2, LT3}));
+  EXPECT_EQ(*copy.map_.at(1), (LocatedTriples{LT2}));
+  EXPECT_EQ(original.numTriples(), 3);
+  EXPECT_EQ(copy.numTriples(), 2);
+  EXPECT_NE(&original.getAugmentedMetadata(), &copy.getAugmentedMetadata());
+
+  // The same holds for erasing. Once a block is not shared anymore, it is
+  // modified in place.
+  original.erase(0, LT1);
+  EXPECT_FALSE(original.containsTriples(0));
+  EXPECT_EQ(*copy.map_.at(0), (LocatedTriples{LT1}));
+  const auto* block1 = original.map_.at(1).get();
+  original.erase(1, LT3);
+  EXPECT_EQ(original.map_.at(1).get(), block1);
+  EXPECT_EQ(*original.map_.at(1), (LocatedTriples{LT2}));
+}
+
+// Test the cached number of rows of a block after merging its located triples.
+TEST_F(LocatedTriplesTest, numRowsAfterMerge) {
+  using LT = LocatedTriple;
+  std::vector<CompressedBlockMetadata> metadata{
+      CBM(PT(5, 1, 1), PT(15, 1, 1)), CBM(PT(15, 1, 2), PT(25, 1, 1))};
+  auto LT1 = LT{1, IT(20, 2, 0), true};
+  auto LT2 = LT{1, IT(21, 3, 0), false};
+  auto original = makeLocatedTriplesPerBlock({LT1});
+  original.setOriginalMetadata(metadata);
+  EXPECT_EQ(original.getNumRowsAfterMerge(1), std::nullopt);
+  original.setNumRowsAfterMerge(1, 42);
+  EXPECT_EQ(original.getNumRowsAfterMerge(1), 42);
+
+  // The cached value is shared with and copied to copies of the block.
+  const LocatedTriplesPerBlock copy = original;
+  EXPECT_EQ(copy.getNumRowsAfterMerge(1), 42);
+  original.add(std::vector{LT2});
+  EXPECT_EQ(copy.getNumRowsAfterMerge(1), 42);
+
+  // Each modification of the block invalidates the cached value.
+  EXPECT_EQ(original.getNumRowsAfterMerge(1), std::nullopt);
+  original.setNumRowsAfterMerge(1, 41);
+  original.erase(1, LT2);
+  EXPECT_EQ(original.getNumRowsAfterMerge(1), std::nullopt);
+  EXPECT_EQ(copy.getNumRowsAfterMerge(1), 42);
+
+  // Blocks without located triples have no cached value.
+  EXPECT_ANY_THROW(original.getNumRowsAfterMerge(0));
+}
+
+// Test that an update only recomputes the augmented metadata of the blocks
+// that it touches, and that it reuses a previous version of the metadata that
+// is not used by a copy anymore instead of copying the metadata.
+TEST_F(LocatedTriplesTest, augmentedMetadataIsUpdatedIncrementally) {
+  using LT = LocatedTriple;
+  std::vector<CompressedBlockMetadata> metadata{
+      CBM(PT(5, 1, 1), PT(15, 1, 1)), CBM(PT(15, 1, 2), PT(25, 1, 1)),
+      CBM(PT(25, 1, 2), PT(30, 1, 1))};
+  auto LT1 = LT{0, IT(4, 1, 0), true};
+  auto LT2 = LT{1, IT(20, 2, 0), true};
+  auto LT3 = LT{2, IT(26, 1, 0), false};
+  // After the last block.
+  auto LT4 = LT{3, IT(40, 1, 0), true};
+
+  // Check that the augmented metadata and its search index are the same as
+  // when computing them from scratch for the given `triples`.
+  auto expectConsistent = [&metadata](const LocatedTriplesPerBlock& ltpb,
+                                      const std::vector<LT>& triples) {
+    LocatedTriplesPerBlock expected;
+    expected.setOriginalMetadata(metadata);
+    expected.add(triples);
+    const auto& blocks = ltpb.getAugmentedMetadata();
+    EXPECT_THAT(blocks,
+                testing::ElementsAreArray(expected.getAugmentedMetadata()));
+    BlockMetadataSearchIndex searchIndex{blocks};
+    for (const auto& block : blocks) {
+      for (const auto& triple : {block.firstTriple_, block.lastTriple_}) {
+        EXPECT_EQ(
+            ltpb.getAugmentedMetadataSearchIndex().equalRange(triple, triple),
+            searchIndex.equalRange(triple, triple));
+      }
+    }
+  };
+
+  LocatedTriplesPerBlock ltpb;
+  ltpb.setOriginalMetadata(metadata);
+  ltpb.add(std::vector{LT1, LT2});
+  expectConsistent(ltpb, {LT1, LT2});
+  const auto* version1 = &ltpb.getAugmentedMetadata();
+
+  // Without copies, the metadata is updated in place.
+  ltpb.add(std::vector{LT3});
+  EXPECT_EQ(&ltpb.getAugmentedMetadata(), version1);
+  expectConsistent(ltpb, {LT1, LT2, LT3});
+
+  // A copy keeps its version of the metadata, so the next update has to copy
+  // it. The added triple also adds a block at the end.
+  {
+    const LocatedTriplesPerBlock copy = ltpb;
+    ltpb.add(std::vector{LT4});
+    EXPECT_NE(&ltpb.getAugmentedMetadata(), version1);
+    EXPECT_EQ(&copy.getAugmentedMetadata(), version1);
+    expectConsistent(copy, {LT1, LT2, LT3});
+    expectConsistent(ltpb, {LT1, LT2, LT3, LT4});
+  }
+  const auto* version2 = &ltpb.getAugmentedMetadata();
+
+  // The first version is not used by a copy anymore, so it is reused and
+  // brought up to date.
+  {
+    const LocatedTriplesPerBlock copy = ltpb;
+    ltpb.erase(std::vector{LT1, LT4});
+    ltpb.updateAugmentedMetadata();
+    EXPECT_EQ(&ltpb.getAugmentedMetadata(), version1);
+    EXPECT_EQ(&copy.getAugmentedMetadata(), version2);
+    expectConsistent(ltpb, {LT2, LT3});
+    expectConsistent(copy, {LT1, LT2, LT3, LT4});
+  }
+
+  // The same holds for the second version, from which the block at the end
+  // has to be removed again.
+  {
+    const LocatedTriplesPerBlock copy = ltpb;
+    ltpb.add(std::vector{LT1});
+    EXPECT_EQ(&ltpb.getAugmentedMetadata(), version2);
+    EXPECT_EQ(&copy.getAugmentedMetadata(), version1);
+    expectConsistent(ltpb, {LT1, LT2, LT3});
+    expectConsistent(copy, {LT2, LT3});
+  }
+
+  // Setting new original metadata recomputes the augmented metadata.
+  metadata.pop_back();
+  ltpb.setOriginalMetadata(metadata);
+  expectConsistent(ltpb, {LT1, LT2, LT3});
+}
+
 // Test the method that merges the matching `LocatedTriple`s from a block into
 // an `IdTable`.
 TEST_F(LocatedTriplesTest, mergeTriples) {
@@ -716,6 +900,40 @@ TEST_F(LocatedTriplesTest, locatedTriple) {
   }
 }
 
+// Test the locating of a large number of unsorted triples (which are located
+// in several chunks concurrently if several threads are used) against a binary
+// search for each triple.
+TEST_F(LocatedTriplesTest, locatedTriplesLargeInput) {
+  const qlever::KeyOrder permutedKeyOrder{2, 1, 0, 3};
+  std::vector<CompressedBlockMetadata> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    blocks.push_back(CBM(PT(2 * i, 0, 0), PT(2 * i + 1, 5, 5)));
+  }
+  ad_utility::SlowRandomIntGenerator<int> randomId{0, 2010};
+  std::vector<IdTriple<0>> triples;
+  for (size_t i = 0; i < 300'000; ++i) {
+    triples.push_back(IT(randomId() % 7, randomId() % 7, randomId()));
+  }
+  ad_utility::SharedCancellationHandle handle =
+      std::make_shared<ad_utility::CancellationHandle<>>();
+  for (size_t numThreads : {1, 4}) {
+    auto locatedTriples = LocatedTriple::locateTriplesInPermutation(
+        triples, blocks, permutedKeyOrder, true, handle, numThreads);
+    ASSERT_EQ(locatedTriples.size(), triples.size());
+    for (size_t i = 0; i < triples.size(); ++i) {
+      auto triple = triples[i].permute(permutedKeyOrder);
+      size_t expectedBlockIndex =
+          ql::ranges::lower_bound(blocks, triple.toPermutedTriple(),
+                                  std::less<>{},
+                                  &CompressedBlockMetadata::lastTriple_) -
+          blocks.begin();
+      ASSERT_EQ(locatedTriples[i],
+                LocatedTriple(expectedBlockIndex, triple, true))
+          << i;
+    }
+  }
+}
+
 TEST_F(LocatedTriplesTest, augmentedMetadata) {
   // Create a vector that is automatically converted to a span.
   using Span = std::vector<IdTriple<0>>;
@@ -783,9 +1001,9 @@ TEST_F(LocatedTriplesTest, augmentedMetadata) {
                 testing::ElementsAreArray(expectedAugmentedMetadata));
 
     // T4 is before block 4. The beginning of block 4 changes.
-    auto handles =
-        locatedTriplesPerBlock.add(LocatedTriple::locateTriplesInPermutation(
-            Span{T4}, metadata, keyOrder, true, handle));
+    auto locatedT4 = LocatedTriple::locateTriplesInPermutation(
+        Span{T4}, metadata, keyOrder, true, handle);
+    locatedTriplesPerBlock.add(locatedT4);
 
     expectedAugmentedMetadata[4] = CBM(T4.toPermutedTriple(), PT8);
     expectedAugmentedMetadata[4].containsDuplicatesWithDifferentGraphs_ = true;
@@ -793,7 +1011,7 @@ TEST_F(LocatedTriplesTest, augmentedMetadata) {
                 testing::ElementsAreArray(expectedAugmentedMetadata));
 
     // Erasing the update of T4 restores the beginning of block 4.
-    locatedTriplesPerBlock.erase(4, handles[0]);
+    locatedTriplesPerBlock.erase(4, locatedT4[0]);
     locatedTriplesPerBlock.updateAugmentedMetadata();
 
     expectedAugmentedMetadata[4] = CBM(PT8, PT8);
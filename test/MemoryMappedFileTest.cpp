@@ -0,0 +1,51 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <string>
+
+#include "util/File.h"
+#include "util/MemoryMappedFile.h"
+
+using ad_utility::MemoryMappedFile;
+
+namespace {
+// Return the contents of the `file` as a string.
+std::string toString(const MemoryMappedFile& file) {
+  return {file.bytes().begin(), file.bytes().end()};
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(MemoryMappedFile, mapFile) {
+  std::string filename = "memoryMappedFileTest.mapFile.dat";
+  std::string contents = "Hello, memory mapping!";
+  {
+    ad_utility::File file{filename, "w"};
+    file.write(contents.data(), contents.size());
+  }
+  ad_utility::File file{filename, "r"};
+  MemoryMappedFile mapping{file.fileDescriptor()};
+  // The mapping stays valid after the file is closed.
+  file.close();
+  EXPECT_EQ(toString(mapping), contents);
+
+  // Moving transfers the mapping.
+  MemoryMappedFile moved{std::move(mapping)};
+  EXPECT_EQ(toString(moved), contents);
+  EXPECT_TRUE(mapping.bytes().empty());
+  mapping = std::move(moved);
+  EXPECT_EQ(toString(mapping), contents);
+
+  // An empty file yields an empty mapping.
+  { ad_utility::File emptyFile{filename, "w"}; }
+  ad_utility::File emptyFile{filename, "r"};
+  EXPECT_TRUE(MemoryMappedFile{emptyFile.fileDescriptor()}.bytes().empty());
+  EXPECT_TRUE(MemoryMappedFile{}.bytes().empty());
+
+  // An invalid file descriptor.
+  EXPECT_THROW(MemoryMappedFile{-1}, std::runtime_error);
+  std::remove(filename.c_str());
+}
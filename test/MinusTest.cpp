@@ -171,3 +171,60 @@ TEST(Minus, columnOriginatesFromGraphOrUndef) {
       minus4.columnOriginatesFromGraphOrUndef(Variable{"?notExisting"}),
       ad_utility::Exception);
 }
+
+// _____________________________________________________________________________
+TEST(Minus, lazyInputs) {
+  auto* qec = ad_utility::testing::getQec();
+  using Vars = std::vector<std::optional<Variable>>;
+  Vars leftVars{Variable{"?x"}, Variable{"?y"}};
+  Vars rightVars{Variable{"?x"}, Variable{"?y"}, Variable{"?z"}};
+  // Rows with the same value in the first join column are split across
+  // several blocks.
+  std::vector<IdTable> leftTables;
+  leftTables.push_back(makeIdTableFromVector({{1, 1}, {2, 1}, {2, 2}}));
+  leftTables.push_back(makeIdTableFromVector({{2, 3}, {3, 1}}));
+  leftTables.push_back(makeIdTableFromVector({{3, 2}, {5, 1}, {6, 6}}));
+  std::vector<IdTable> rightTables;
+  rightTables.push_back(makeIdTableFromVector({{2, 2, 10}}));
+  rightTables.push_back(makeIdTableFromVector({{2, 3, 11}, {4, 1, 12}}));
+  rightTables.push_back(makeIdTableFromVector({{5, 1, 13}}));
+  auto expected =
+      makeIdTableFromVector({{1, 1}, {2, 1}, {3, 1}, {3, 2}, {6, 6}});
+
+  auto makeTree = [qec](const std::vector<IdTable>& tables, Vars vars,
+                        bool lazy) {
+    if (lazy) {
+      return ad_utility::makeExecutionTree<ValuesForTesting>(
+          qec,
+          ad_utility::transform(
+              tables, [](const IdTable& table) { return table.clone(); }),
+          std::move(vars), false, std::vector<ColumnIndex>{0, 1});
+    }
+    IdTable table = tables.at(0).clone();
+    for (size_t i = 1; i < tables.size(); ++i) {
+      table.insertAtEnd(tables.at(i));
+    }
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, std::move(table), std::move(vars), false,
+        std::vector<ColumnIndex>{0, 1}, LocalVocab{}, std::nullopt, true);
+  };
+
+  for (bool leftLazy : {false, true}) {
+    for (bool rightLazy : {false, true}) {
+      for (bool requestLaziness : {false, true}) {
+        Minus minus{qec, makeTree(leftTables, leftVars, leftLazy),
+                    makeTree(rightTables, rightVars, rightLazy)};
+        auto result = minus.computeResultOnlyForTesting(requestLaziness);
+        bool lazyResult = requestLaziness && (leftLazy || rightLazy);
+        ASSERT_EQ(result.isFullyMaterialized(), !lazyResult);
+        if (lazyResult) {
+          auto [table, localVocabs] =
+              aggregateTables(result.idTables(), minus.getResultWidth());
+          EXPECT_EQ(table, expected);
+        } else {
+          EXPECT_EQ(result.idTable(), expected);
+        }
+      }
+    }
+  }
+}
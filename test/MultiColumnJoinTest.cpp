@@ -180,3 +180,80 @@ TEST(MultiColumnJoin, columnOriginatesFromGraphOrUndef) {
   testWithTrees(values2, values3, false, false, false);
   testWithTrees(values2, values1, false, false, false);
 }
+
+// _____________________________________________________________________________
+TEST(MultiColumnJoin, lazyInputs) {
+  auto* qec = ad_utility::testing::getQec();
+  using Vars = std::vector<std::optional<Variable>>;
+  Vars leftVars{Variable{"?x"}, Variable{"?y"}, Variable{"?a"}};
+  Vars rightVars{Variable{"?x"}, Variable{"?y"}, Variable{"?b"}};
+  // Rows with the same value in the first join column are split across
+  // several blocks.
+  std::vector<IdTable> leftTables;
+  leftTables.push_back(makeIdTableFromVector({{1, 1, 10}, {2, 1, 11}}));
+  leftTables.push_back(makeIdTableFromVector({{2, 1, 12}, {2, 2, 13}}));
+  leftTables.push_back(makeIdTableFromVector({{4, 4, 14}}));
+  std::vector<IdTable> rightTables;
+  rightTables.push_back(makeIdTableFromVector({{2, 1, 20}}));
+  rightTables.push_back(
+      makeIdTableFromVector({{2, 1, 21}, {2, 2, 22}, {3, 3, 23}}));
+  rightTables.push_back(makeIdTableFromVector({{4, 4, 24}, {7, 7, 25}}));
+
+  auto makeTree = [qec](const std::vector<IdTable>& tables, Vars vars,
+                        bool lazy) {
+    if (lazy) {
+      return ad_utility::makeExecutionTree<ValuesForTesting>(
+          qec,
+          ad_utility::transform(
+              tables, [](const IdTable& table) { return table.clone(); }),
+          std::move(vars), false, std::vector<ColumnIndex>{0, 1});
+    }
+    IdTable table = tables.at(0).clone();
+    for (size_t i = 1; i < tables.size(); ++i) {
+      table.insertAtEnd(tables.at(i));
+    }
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, std::move(table), std::move(vars), false,
+        std::vector<ColumnIndex>{0, 1}, LocalVocab{}, std::nullopt, true);
+  };
+
+  MultiColumnJoin materializedJoin{qec,
+                                   makeTree(leftTables, leftVars, false),
+                                   makeTree(rightTables, rightVars, false),
+                                   false};
+  auto expected =
+      materializedJoin.computeResultOnlyForTesting().idTable().clone();
+  ASSERT_EQ(expected.numRows(), 6);
+
+  for (bool leftLazy : {false, true}) {
+    for (bool rightLazy : {false, true}) {
+      for (bool requestLaziness : {false, true}) {
+        MultiColumnJoin join{qec, makeTree(leftTables, leftVars, leftLazy),
+                             makeTree(rightTables, rightVars, rightLazy),
+                             false};
+        auto result = join.computeResultOnlyForTesting(requestLaziness);
+        bool lazyResult = requestLaziness && (leftLazy || rightLazy);
+        ASSERT_EQ(result.isFullyMaterialized(), !lazyResult);
+        if (lazyResult) {
+          auto [table, localVocabs] =
+              aggregateTables(result.idTables(), join.getResultWidth());
+          EXPECT_EQ(table, expected);
+        } else {
+          EXPECT_EQ(result.idTable(), expected);
+        }
+      }
+    }
+  }
+
+  // With a possibly undefined first join column, the inputs are always
+  // materialized.
+  auto U = Id::makeUndefined();
+  std::vector<IdTable> undefTables;
+  undefTables.push_back(makeIdTableFromVector({{U, V(1), V(30)}}));
+  undefTables.push_back(makeIdTableFromVector({{V(2), V(2), V(31)}}));
+  MultiColumnJoin undefJoin{qec, makeTree(undefTables, leftVars, true),
+                            makeTree(rightTables, rightVars, true), false};
+  auto result = undefJoin.computeResultOnlyForTesting(true);
+  ASSERT_TRUE(result.isFullyMaterialized());
+  EXPECT_EQ(result.idTable().numRows(), 3);
+}
@@ -743,8 +743,7 @@ TEST(OperationTest, disableCaching) {
   ValuesForTesting valuesForTesting{
       qec, std::move(idTablesVector), {Variable{"?x"}, Variable{"?y"}}, true};
 
-  QueryCacheKey cacheKey{valuesForTesting.getCacheKey(),
-                         qec->locatedTriplesSnapshot().index_};
+  QueryCacheKey cacheKey = valuesForTesting.getQueryCacheKey();
 
   // By default, the result of `valuesForTesting` is cached because it is
   // sufficiently small, no matter if it was computed lazily or fully
@@ -7,6 +7,7 @@
 
 #include "./util/IdTableHelpers.h"
 #include "./util/IdTestHelpers.h"
+#include "./util/RuntimeParametersTestHelpers.h"
 #include "engine/OrderBy.h"
 #include "engine/ValuesForTesting.h"
 #include "global/ValueIdComparators.h"
@@ -272,3 +273,155 @@ TEST(OrderBy, clone) {
   EXPECT_THAT(orderBy, IsDeepCopy(*clone));
   EXPECT_EQ(clone->getDescriptor(), orderBy.getDescriptor());
 }
+
+// _____________________________________________________________________________
+TEST(OrderBy, externalSortForInputsLargerThanTheThreshold) {
+  auto* qec = ad_utility::testing::getQec();
+  auto I = ad_utility::testing::IntId;
+  auto D = ad_utility::testing::DoubleId;
+  // Negative numbers and mixed datatypes, s.t. the semantic order differs from
+  // the internal order of the IDs.
+  std::vector<IdTable> blocks;
+  for (int64_t i = 0; i < 1000; ++i) {
+    if (i % 150 == 0) {
+      blocks.emplace_back(2, qec->getAllocator());
+    }
+    Id second =
+        i % 2 == 0 ? I((i * 7919) % 100 - 50) : D(-0.5 * (i % 7) - 0.25);
+    blocks.back().push_back({I(i % 13 - 6), second});
+  }
+  std::vector<std::optional<Variable>> vars{Variable{"?0"}, Variable{"?1"}};
+  auto makeTree = [&]() {
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec,
+        ad_utility::transform(
+            blocks, [](const IdTable& block) { return block.clone(); }),
+        vars);
+  };
+  OrderBy::SortIndices sortIndices{{0, true}, {1, false}};
+
+  // The expected result is computed in RAM.
+  OrderBy inMemory{qec, makeTree(), sortIndices};
+  IdTable expected =
+      inMemory.computeResultOnlyForTesting(false).idTable().clone();
+  EXPECT_FALSE(inMemory.runtimeInfo().details_.contains("sorted-externally"));
+
+  using namespace ad_utility::memory_literals;
+  auto cleanup = setRuntimeParameterForTest<"sort-in-memory-threshold">(1_kB);
+  for (bool requestLaziness : {false, true}) {
+    OrderBy orderBy{qec, makeTree(), sortIndices};
+    auto result = orderBy.computeResultOnlyForTesting(requestLaziness);
+    ASSERT_EQ(result.isFullyMaterialized(), !requestLaziness);
+    if (requestLaziness) {
+      EXPECT_EQ(aggregateTables(result.idTables(), 2).first, expected);
+    } else {
+      EXPECT_EQ(result.idTable(), expected);
+    }
+    EXPECT_EQ(orderBy.runtimeInfo().details_["sorted-externally"], true);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(OrderBy, topKForSmallLimit) {
+  auto* qec = ad_utility::testing::getQec();
+  auto I = ad_utility::testing::IntId;
+  auto cleanupThreads =
+      setRuntimeParameterForTest<"order-by-top-k-num-threads">(size_t{4});
+  // The sort keys are unique, so the result of an `OrderBy` is deterministic.
+  std::vector<IdTable> blocks;
+  constexpr int64_t numRows = 50'000;
+  for (int64_t i = 0; i < numRows; ++i) {
+    if (i % 20'000 == 0) {
+      blocks.emplace_back(2, qec->getAllocator());
+    }
+    blocks.back().push_back({I((i * 7919) % numRows - numRows / 2), I(i)});
+  }
+  std::vector<std::optional<Variable>> vars{Variable{"?0"}, Variable{"?1"}};
+  auto makeTree = [&](bool lazy) {
+    auto tables = ad_utility::transform(
+        blocks, [](const IdTable& block) { return block.clone(); });
+    if (lazy) {
+      return ad_utility::makeExecutionTree<ValuesForTesting>(
+          qec, std::move(tables), vars);
+    }
+    IdTable table{2, qec->getAllocator()};
+    for (const auto& block : tables) {
+      table.insertAtEnd(block);
+    }
+    return ad_utility::makeExecutionTree<ValuesForTesting>(
+        qec, std::move(table), vars, false, std::vector<ColumnIndex>{},
+        LocalVocab{}, std::nullopt, true);
+  };
+
+  for (bool isDescending : {false, true}) {
+    OrderBy::SortIndices sortIndices{{0, isDescending}};
+    OrderBy fullSort{qec, makeTree(false), sortIndices};
+    IdTable sorted =
+        fullSort.computeResultOnlyForTesting(false).idTable().clone();
+    auto expectedRows = [&](size_t begin, size_t end) {
+      IdTable expected{2, qec->getAllocator()};
+      expected.insertAtEnd(sorted, begin, end);
+      return expected;
+    };
+
+    for (bool lazy : {false, true}) {
+      // Only the first rows are computed for a small LIMIT. The LIMIT and
+      // OFFSET themselves are applied by `Operation::getResult`.
+      OrderBy topK{qec, makeTree(lazy), sortIndices};
+      topK.applyLimitOffset({5, 3});
+      EXPECT_EQ(topK.getSizeEstimate(), 5);
+      auto result = topK.computeResultOnlyForTesting(true);
+      ASSERT_TRUE(result.isFullyMaterialized());
+      EXPECT_EQ(result.idTable(), expectedRows(0, 8));
+      EXPECT_EQ(topK.runtimeInfo().details_["top-k"], 8);
+
+      // The same holds for the hint for the LIMIT and OFFSET of the query,
+      // which are applied by the export.
+      OrderBy topKHint{qec, makeTree(lazy), sortIndices};
+      topKHint.setLimitOffsetHint({5, 3});
+      EXPECT_EQ(topKHint.computeResultOnlyForTesting(false).idTable(),
+                expectedRows(0, 8));
+      EXPECT_EQ(topKHint.runtimeInfo().details_["top-k"], 8);
+
+      // A LIMIT of zero.
+      OrderBy limitZero{qec, makeTree(lazy), sortIndices};
+      limitZero.setLimitOffsetHint({0, 0});
+      EXPECT_TRUE(
+          limitZero.computeResultOnlyForTesting(false).idTable().empty());
+
+      // A LIMIT that is too large for the top-k computation is ignored, and
+      // the complete input is sorted.
+      OrderBy largeLimit{qec, makeTree(lazy), sortIndices};
+      largeLimit.setLimitOffsetHint({20'000, 7});
+      auto largeResult = largeLimit.computeResultOnlyForTesting(false);
+      EXPECT_FALSE(largeLimit.runtimeInfo().details_.contains("top-k"));
+      EXPECT_EQ(largeResult.idTable(), sorted);
+    }
+
+    // The hint only changes the cache key if the top-k computation is used,
+    // such that the complete sort can be reused for different LIMITs and
+    // OFFSETs.
+    auto tree = makeTree(false);
+    auto cacheKeyWithHint = [&](std::optional<LimitOffsetClause> hint) {
+      OrderBy orderBy{qec, tree, sortIndices};
+      if (hint.has_value()) {
+        orderBy.setLimitOffsetHint(hint.value());
+      }
+      return orderBy.getCacheKey();
+    };
+    EXPECT_EQ(cacheKeyWithHint(LimitOffsetClause{20'000, 7}),
+              cacheKeyWithHint(std::nullopt));
+    EXPECT_EQ(cacheKeyWithHint(LimitOffsetClause{std::nullopt, 7}),
+              cacheKeyWithHint(std::nullopt));
+    EXPECT_NE(cacheKeyWithHint(LimitOffsetClause{5, 3}),
+              cacheKeyWithHint(std::nullopt));
+    EXPECT_NE(cacheKeyWithHint(LimitOffsetClause{5, 3}),
+              cacheKeyWithHint(LimitOffsetClause{5, 4}));
+
+    // With a LIMIT of zero, the cost estimate is still finite.
+    OrderBy limitZero{qec, tree, sortIndices};
+    limitZero.setLimitOffsetHint({0, 0});
+    EXPECT_EQ(limitZero.getCostEstimate(),
+              tree->getSizeEstimate() + tree->getCostEstimate());
+  }
+}
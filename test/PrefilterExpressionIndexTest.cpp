@@ -1212,6 +1212,55 @@ TEST_F(PrefilterExpressionOnMetadataTest, testWithFewBlockMetadataValues) {
             std::vector<CompressedBlockMetadata>{});
 }
 
+//______________________________________________________________________________
+// Test the prefiltering with the zone maps of the blocks, which also works for
+// unsorted columns and blocks with mixed datatypes.
+TEST_F(PrefilterExpressionOnMetadataTest, testEvaluateWithZoneMaps) {
+  using CBM = CompressedBlockMetadata;
+  // Create a block with the given (unsorted) values in column 2. The columns 0
+  // and 1 are irrelevant for the evaluation with the zone maps.
+  auto makeBlockWithZoneMaps = [](std::vector<Id> column2,
+                                  size_t blockIndex) {
+    std::vector<Id> column0(column2.size(), VocabId10);
+    return CBM{{{},
+                column2.size(),
+                {VocabId10, DoubleId33, column2.front(), GraphId},
+                {VocabId10, DoubleId33, column2.back(), GraphId},
+                {},
+                false,
+                {CBM::computeZoneMap(column0), CBM::computeZoneMap(column0),
+                 CBM::computeZoneMap(column2)}},
+               blockIndex};
+  };
+  auto bInts = makeBlockWithZoneMaps({IntId(5), IntId(100), IntId(50)}, 0);
+  auto bMixed =
+      makeBlockWithZoneMaps({IntId(1), DoubleId(2.5), vocabIdBerlin}, 1);
+  auto bVocab = makeBlockWithZoneMaps({vocabIdHamburg, vocabIdBe}, 2);
+  // A block without zone maps can't be pruned.
+  auto bNoZoneMaps = makeBlock(IntId(0), IntId(1));
+  std::vector<CBM> input{bInts, bMixed, bVocab, bNoZoneMaps};
+
+  auto test = [&](std::unique_ptr<PrefilterExpression> expr,
+                  const std::vector<CBM>& expected,
+                  ad_utility::source_location l =
+                      ad_utility::source_location::current()) {
+    auto t = generateLocationTrace(l);
+    EXPECT_EQ(expr->evaluateWithZoneMaps(indexVocab, input, 2), expected);
+  };
+  test(gt(IntId(60)), {bInts, bNoZoneMaps});
+  test(lt(IntId(2)), {bMixed, bNoZoneMaps});
+  test(andExpr(gt(DoubleId(2.0)), lt(IntId(3))), {bMixed, bNoZoneMaps});
+  test(eq(IntId(75)), {bInts, bNoZoneMaps});
+  test(eq(IntId(101)), {bNoZoneMaps});
+  test(eq(vocabIdHamb), {bVocab, bNoZoneMaps});
+  test(isNum(), {bInts, bMixed, bNoZoneMaps});
+  test(orExpr(gt(IntId(60)), eq(vocabIdBerlin)),
+       {bInts, bMixed, bNoZoneMaps});
+
+  // Zone maps are only stored for the first three columns.
+  EXPECT_ANY_THROW(gt(IntId(60))->evaluateWithZoneMaps(indexVocab, input, 3));
+}
+
 //______________________________________________________________________________
 // Test method clone. clone() creates a copy of the complete PrefilterExpression
 // tree.
@@ -15,6 +15,7 @@
 #include "parser/SparqlParser.h"
 #include "parser/SpatialQuery.h"
 #include "parser/data/Variable.h"
+#include "util/RuntimeParametersTestHelpers.h"
 #include "util/TripleComponentTestHelpers.h"
 
 namespace h = queryPlannerTestHelpers;
@@ -4513,3 +4514,34 @@ TEST(QueryPlanner, FilterSubstitutesMockQPTest) {
       h::UnorderedJoins(scan("?a", "<b>", "?c"), scan("?b", "<c>", "?d"),
                         scan("?a", "<equal-to>", "?b")));
 }
+
+// _____________________________________________________________________________
+TEST(QueryPlanner, hashJoinForLargeUnsortedInputs) {
+  auto cleanup =
+      setRuntimeParameterForTest<"hash-join-min-input-size">(size_t{0});
+  // Two `VALUES` clauses with many rows that are joined on `?x`. They are not
+  // sorted, so the `Join` would have to sort both of them.
+  auto makeQuery = [](std::string_view additionalRow) {
+    auto makeValues = [](std::string_view otherVar,
+                         std::string_view additionalRow) {
+      std::string values = absl::StrCat("VALUES (?x ", otherVar, ") { ");
+      for (size_t i = 0; i < 1000; ++i) {
+        absl::StrAppend(&values, "(<x", i, "> <y", i, ">) ");
+      }
+      return absl::StrCat(values, additionalRow, "}");
+    };
+    return absl::StrCat("SELECT * { ", makeValues("?y", ""), " ",
+                        makeValues("?z", additionalRow), " }");
+  };
+  h::expect(makeQuery(""), h::HashJoin(::testing::_, ::testing::_));
+
+  // If one of the join columns might be undefined, the `HashJoin` is not
+  // applicable.
+  h::expect(makeQuery("(UNDEF <z>) "), h::Join(::testing::_, ::testing::_));
+
+  // For smaller inputs than the `hash-join-min-input-size`, only the `Join` is
+  // considered.
+  auto cleanup2 =
+      setRuntimeParameterForTest<"hash-join-min-input-size">(size_t{100'000});
+  h::expect(makeQuery(""), h::Join(::testing::_, ::testing::_));
+}
@@ -0,0 +1,78 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "util/RunTasksInParallel.h"
+
+// _____________________________________________________________________________
+TEST(RunTasksInParallel, runsAllTasks) {
+  for (size_t numThreads : {0, 1, 3, 20}) {
+    std::vector<std::atomic<size_t>> counts(10);
+    ad_utility::runTasksInParallel(counts.size(), numThreads,
+                                   [&counts](size_t i) { ++counts[i]; });
+    for (const auto& count : counts) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+  // Zero tasks are fine.
+  ad_utility::runTasksInParallel(0, 4, [](size_t) { FAIL(); });
+}
+
+// _____________________________________________________________________________
+TEST(ParallelTaskRunner, runsManyBatchesOnTheSameThreads) {
+  ad_utility::ParallelTaskRunner runner{4};
+  EXPECT_EQ(runner.numThreads(), 4);
+  std::mutex mutex;
+  std::set<std::thread::id> threadIds;
+  for (size_t numTasks : {0, 1, 2, 17, 100, 3}) {
+    std::vector<std::atomic<size_t>> counts(numTasks);
+    runner.run(numTasks, [&](size_t i) {
+      ++counts[i];
+      std::lock_guard lock{mutex};
+      threadIds.insert(std::this_thread::get_id());
+    });
+    for (const auto& count : counts) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+  // The batches were run by at most the threads of the runner.
+  EXPECT_LE(threadIds.size(), 4);
+}
+
+// _____________________________________________________________________________
+TEST(ParallelTaskRunner, exceptionStopsTheBatch) {
+  auto failingTask = [](std::atomic<size_t>& numStarted) {
+    return [&numStarted](size_t i) {
+      ++numStarted;
+      if (i == 5) {
+        throw std::runtime_error{"task failed"};
+      }
+    };
+  };
+  // With a single thread, the tasks are run in order, and no task is started
+  // after the exception.
+  {
+    ad_utility::ParallelTaskRunner runner{1};
+    std::atomic<size_t> numStarted = 0;
+    EXPECT_THROW(runner.run(1000, failingTask(numStarted)),
+                 std::runtime_error);
+    EXPECT_EQ(numStarted.load(), 6);
+  }
+
+  ad_utility::ParallelTaskRunner runner{3};
+  std::atomic<size_t> numStarted = 0;
+  EXPECT_THROW(runner.run(1000, failingTask(numStarted)), std::runtime_error);
+
+  // The runner can be used again after an exception.
+  std::atomic<size_t> sum = 0;
+  runner.run(10, [&sum](size_t i) { sum += i; });
+  EXPECT_EQ(sum.load(), 45);
+}
@@ -2,9 +2,11 @@
 // Chair of Algorithms and Data Structures.
 // Author: Julian Mundhahs (mundhahj@tf.uni-freiburg.de)
 
+#include <absl/cleanup/cleanup.h>
 #include <gmock/gmock.h>
 
 #include <boost/beast/http.hpp>
+#include <filesystem>
 
 #include "engine/QueryPlanner.h"
 #include "engine/Server.h"
@@ -290,3 +292,56 @@ TEST(ServerTest, adjustParsedQueryLimitOffset) {
   expectExportLimit(csv, std::nullopt, complexQuery);
   expectExportLimit(tsv, std::nullopt);
 }
+
+// _____________________________________________________________________________
+TEST(ServerTest, cachedResultsSurviveUnrelatedUpdates) {
+  // Write an index to disk and load it into the server.
+  const std::string indexBasename = "ServerTest_cachedResults";
+  absl::Cleanup cleanup{[&indexBasename]() {
+    for (const auto& filename : getAllIndexFilenames(indexBasename)) {
+      std::filesystem::remove(filename);
+    }
+  }};
+  { makeTestIndex(indexBasename, "<a> <p> <b> . <a> <q> <c> ."); }
+  Server server{9999, 1, ad_utility::MemorySize::megabytes(100),
+                "accessToken"};
+  server.initialize(indexBasename, false);
+  QueryExecutionContext qec{server.index_, &server.cache_, server.allocator_,
+                            server.sortPerformanceEstimator_};
+  auto handle = std::make_shared<ad_utility::CancellationHandle<>>();
+
+  // Run a query on the predicate `<p>` with the current snapshot and return
+  // whether its result was read from the cache.
+  auto runQueryOnP = [&qec, &handle]() {
+    qec.updateLocatedTriplesSnapshot();
+    QueryExecutionTree qet = QueryPlanner{&qec, handle}.createExecutionTree(
+        SparqlParser::parseQuery("SELECT ?s ?o { ?s <p> ?o }"));
+    auto result = qet.getResult();
+    return qet.getRootOperation()->runtimeInfo().cacheStatus_;
+  };
+  // Process the `update` like the server does for an update request.
+  auto processUpdate = [&server, &qec, &handle](const std::string& update) {
+    qec.updateLocatedTriplesSnapshot();
+    auto pqs = SparqlParser::parseUpdate(update);
+    ASSERT_EQ(pqs.size(), 1u);
+    QueryExecutionTree qet =
+        QueryPlanner{&qec, handle}.createExecutionTree(pqs[0]);
+    Server::PlannedQuery plannedUpdate{std::move(pqs[0]), std::move(qet)};
+    ad_utility::Timer timer{ad_utility::Timer::Started};
+    server.processUpdateImpl(plannedUpdate, timer, handle,
+                             server.index_.deltaTriplesManager());
+  };
+
+  using enum ad_utility::CacheStatus;
+  EXPECT_EQ(runQueryOnP(), computed);
+  EXPECT_EQ(runQueryOnP(), cachedNotPinned);
+
+  // An update that only touches the predicate `<q>` keeps the cached result.
+  processUpdate("INSERT DATA { <x> <q> <y> }");
+  EXPECT_EQ(runQueryOnP(), cachedNotPinned);
+
+  // An update of `<p>` invalidates it.
+  processUpdate("INSERT DATA { <x> <p> <y> }");
+  EXPECT_EQ(runQueryOnP(), computed);
+  EXPECT_EQ(runQueryOnP(), cachedNotPinned);
+}
@@ -6,6 +6,9 @@
 #include <gtest/gtest.h>
 
 #include "./util/IdTableHelpers.h"
+#include "./util/IdTestHelpers.h"
+#include "./util/RuntimeParametersTestHelpers.h"
+#include "engine/Engine.h"
 #include "engine/Sort.h"
 #include "engine/ValuesForTesting.h"
 #include "global/ValueIdComparators.h"
@@ -233,3 +236,65 @@ TEST(Sort, clone) {
   EXPECT_THAT(sort, IsDeepCopy(*clone));
   EXPECT_EQ(clone->getDescriptor(), sort.getDescriptor());
 }
+
+// _____________________________________________________________________________
+TEST(Sort, externalSortForInputsLargerThanTheThreshold) {
+  using namespace ad_utility::memory_literals;
+  auto cleanup = setRuntimeParameterForTest<"sort-in-memory-threshold">(1_kB);
+  auto qec = ad_utility::testing::getQec();
+  auto I = ad_utility::testing::IntId;
+  IdTable input{2, qec->getAllocator()};
+  for (int64_t i = 0; i < 1000; ++i) {
+    input.push_back({I((i * 7919) % 1000), I(i % 3)});
+  }
+  IdTable expected = input.clone();
+  Engine::sort(expected, {1, 0});
+  std::vector<std::optional<Variable>> vars{Variable{"?0"}, Variable{"?1"}};
+
+  // Split the input into several blocks for a lazy child.
+  std::vector<IdTable> blocks;
+  for (size_t i = 0; i < input.numRows(); i += 150) {
+    auto& block = blocks.emplace_back(2, qec->getAllocator());
+    block.insertAtEnd(input, i, std::min(i + 150, input.numRows()));
+  }
+
+  for (bool lazyChild : {false, true}) {
+    for (bool requestLaziness : {false, true}) {
+      auto subtree =
+          lazyChild
+              ? ad_utility::makeExecutionTree<ValuesForTesting>(
+                    qec,
+                    ad_utility::transform(
+                        blocks,
+                        [](const IdTable& block) { return block.clone(); }),
+                    vars)
+              : ad_utility::makeExecutionTree<ValuesForTesting>(
+                    qec, input.clone(), vars, false, std::vector<ColumnIndex>{},
+                    LocalVocab{}, std::nullopt, true);
+      Sort sort{qec, subtree, {1, 0}};
+      auto result = sort.computeResultOnlyForTesting(requestLaziness);
+      ASSERT_EQ(result.isFullyMaterialized(), !requestLaziness);
+      if (requestLaziness) {
+        EXPECT_EQ(aggregateTables(result.idTables(), 2).first, expected);
+      } else {
+        EXPECT_EQ(result.idTable(), expected);
+      }
+      EXPECT_EQ(sort.runtimeInfo().details_["sorted-externally"], true);
+    }
+  }
+
+  // A lazy input that is smaller than the threshold is sorted in RAM. The
+  // size estimate is too large, so that the child is actually read lazily.
+  std::vector<IdTable> smallBlocks;
+  smallBlocks.push_back(makeIdTableFromVector({{3, 0}, {1, 2}}));
+  smallBlocks.push_back(makeIdTableFromVector({{2, 1}}));
+  auto subtree = ad_utility::makeExecutionTree<ValuesForTesting>(
+      qec, std::move(smallBlocks), vars);
+  static_cast<ValuesForTesting*>(subtree->getRootOperation().get())
+      ->sizeEstimate() = 1000;
+  Sort sort{qec, subtree, {0}};
+  auto result = sort.computeResultOnlyForTesting(true);
+  ASSERT_TRUE(result.isFullyMaterialized());
+  EXPECT_EQ(result.idTable(), makeIdTableFromVector({{1, 2}, {2, 1}, {3, 0}}));
+  EXPECT_FALSE(sort.runtimeInfo().details_.contains("sorted-externally"));
+}
@@ -169,4 +169,55 @@ TEST(TripleSerializer, rethrowsOnInvalidFileAccess) {
             HasSubstr("(Permission denied)")),
       std::runtime_error);
 }
+
+// _____________________________________________________________________________
+TEST(TripleSerializer, appendAfterIncompleteRecordOfUpdateLog) {
+  auto tmpFile = std::filesystem::temp_directory_path() / "updateLogTornTail";
+  std::filesystem::remove(tmpFile);
+  absl::Cleanup cleanup{[&tmpFile]() { std::filesystem::remove(tmpFile); }};
+  ad_utility::BlankNodeManager bm;
+  auto readLog = [&tmpFile, &bm]() {
+    LocalVocab vocab;
+    ad_utility::BlankNodeMapping blankNodeMapping;
+    return ad_utility::readUpdateLog(tmpFile, vocab, &bm, blankNodeMapping);
+  };
+  auto numRecords = [&readLog]() { return readLog().size(); };
+
+  std::vector<ad_utility::UpdateLogRecord> records;
+  records.push_back({true, {I(1), V(2), V(3), V(4)}});
+  ad_utility::appendToUpdateLog(tmpFile, records);
+  auto sizeAfterFirstRecord = std::filesystem::file_size(tmpFile);
+
+  // Simulate a crash while writing the second record: Only the size and some
+  // of the bytes of the record are written.
+  {
+    std::ofstream stream{tmpFile, std::ios::binary | std::ios::app};
+    uint64_t recordSize = 1000;
+    stream.write(reinterpret_cast<const char*>(&recordSize),
+                 sizeof(recordSize));
+    stream.write("abc", 3);
+  }
+  EXPECT_EQ(numRecords(), 1u);
+  // The incomplete record has been removed from the file.
+  EXPECT_EQ(std::filesystem::file_size(tmpFile), sizeAfterFirstRecord);
+
+  // Records that are appended afterwards can be read.
+  records.front() = {false, {I(5), V(6), V(7), V(8)}};
+  ad_utility::appendToUpdateLog(tmpFile, records);
+  auto recordsOut = readLog();
+  ASSERT_EQ(recordsOut.size(), 2u);
+  EXPECT_TRUE(recordsOut.at(0).insertOrDelete_);
+  EXPECT_EQ(recordsOut.at(0).ids_, (std::vector{I(1), V(2), V(3), V(4)}));
+  EXPECT_FALSE(recordsOut.at(1).insertOrDelete_);
+  EXPECT_EQ(recordsOut.at(1).ids_, (std::vector{I(5), V(6), V(7), V(8)}));
+
+  // The same holds if the incomplete record is the only one.
+  std::filesystem::remove(tmpFile);
+  ad_utility::appendToUpdateLog(tmpFile, records);
+  std::filesystem::resize_file(tmpFile,
+                               std::filesystem::file_size(tmpFile) - 1);
+  EXPECT_EQ(numRecords(), 0u);
+  ad_utility::appendToUpdateLog(tmpFile, records);
+  EXPECT_EQ(numRecords(), 1u);
+}
 }  // namespace
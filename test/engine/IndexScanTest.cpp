@@ -695,16 +695,23 @@ TEST(IndexScan, SetPrefilterVariablePairAndCheckCacheKey) {
   EXPECT_THAT(updatedQet.value()->getRootOperation()->getCacheKey(),
               ::testing::HasSubstr(os.str()));
 
-  // Assert that we don't set a <PrefilterExpression, ColumnIndex> pair for the
-  // second Variable.
+  // For the second Variable, the <PrefilterExpression, ColumnIndex> pair is
+  // set as well (it is then evaluated using the zone maps of the blocks).
   prefilterPairs = makePrefilterVec(pr(lt(IntId(10)), V{"?a"}),
                                     pr(gt(DoubleId(22)), V{"?z"}),
                                     pr(gt(IntId(10)), V{"?b"}));
   updatedQet =
       scan.setPrefilterGetUpdatedQueryExecutionTree(std::move(prefilterPairs));
-  // No PrefilterExpression should be set for this IndexScan, we don't expect a
-  // updated QueryExecutionTree.
-  EXPECT_TRUE(!updatedQet.has_value());
+  ASSERT_TRUE(updatedQet.has_value());
+  EXPECT_THAT(updatedQet.value()->getRootOperation()->getCacheKey(),
+              ::testing::HasSubstr("\nApplied on column: 2."));
+
+  // No PrefilterExpression can be set if none of the Variables matches.
+  prefilterPairs = makePrefilterVec(pr(lt(IntId(10)), V{"?a"}),
+                                    pr(gt(IntId(10)), V{"?b"}));
+  updatedQet =
+      scan.setPrefilterGetUpdatedQueryExecutionTree(std::move(prefilterPairs));
+  EXPECT_FALSE(updatedQet.has_value());
 }
 
 // _____________________________________________________________________________
@@ -745,15 +752,15 @@ TEST(IndexScan, checkEvaluationWithPrefiltering) {
 
   // For the following tests, the first sorted column given the permutation
   // doesn't match with the corresponding column for the Variable of the
-  // <PrefilterExpression, Variable> pair. We expect that the provided prefilter
-  // is not applicable (and can't be set).
-  testSetAndMakeScanWithPrefilterExpr(
-      kg, triple, Permutation::PSO,
-      pr(andExpr(gt(DoubleId(12.00)), le(IntId(174))), Variable{"?price"}), {},
-      false);
+  // <PrefilterExpression, Variable> pair. The prefilter is then applied using
+  // the zone maps of the blocks. In the PSO permutation, the blocks (two
+  // triples each) contain the prices [10, 194], [12, 18], [22, 25],
+  // [147, 174], and [174, 189] (the subject `<P10>` comes before `<P2>`).
   testSetAndMakeScanWithPrefilterExpr(
-      kg, triple, Permutation::POS,
-      pr(andExpr(gt(VocabId(0)), lt(VocabId(100))), Variable{"?x"}), {}, false);
+      kg, triple, Permutation::PSO, pr(lt(IntId(20)), Variable{"?price"}),
+      {I(10), I(194), I(12), I(18)});
+  testSetAndMakeScanWithPrefilterExpr(kg, triple, Permutation::POS,
+                                      pr(lt(VocabId(0)), Variable{"?x"}), {});
 
   // This knowledge graph yields an incomplete first and last block.
   std::string kgFirstAndLastIncomplete =
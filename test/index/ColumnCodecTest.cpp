@@ -0,0 +1,155 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include "index/ColumnCodec.h"
+#include "index/CompressedRelation.h"
+#include "util/Random.h"
+#include "util/Serializer/ByteBufferSerializer.h"
+
+namespace {
+auto V = [](uint64_t bits) { return Id::fromBits(bits); };
+
+// Different columns that are typical for the blocks of a permutation as well
+// as some corner cases.
+std::vector<std::vector<Id>> testColumns() {
+  std::vector<std::vector<Id>> columns;
+  // Empty and single element.
+  columns.emplace_back();
+  columns.push_back({V(42)});
+  // Constant (like the first column of most blocks).
+  columns.emplace_back(1000, V(17));
+  // Few long runs.
+  std::vector<Id> runs;
+  for (size_t i = 0; i < 1000; ++i) {
+    runs.push_back(V(1'000'000 + i / 300));
+  }
+  columns.push_back(std::move(runs));
+  // Sorted with small gaps (like the second column of a block).
+  std::vector<Id> sorted;
+  ad_utility::SlowRandomIntGenerator<uint64_t> smallGaps{0, 10};
+  uint64_t current = Id::makeFromVocabIndex(VocabIndex::make(12345)).getBits();
+  for (size_t i = 0; i < 1000; ++i) {
+    current += smallGaps();
+    sorted.push_back(V(current));
+  }
+  columns.push_back(std::move(sorted));
+  // Unsorted values from a small range.
+  std::vector<Id> smallRange;
+  ad_utility::SlowRandomIntGenerator<uint64_t> smallValues{5000, 6000};
+  for (size_t i = 0; i < 1000; ++i) {
+    smallRange.push_back(V(smallValues()));
+  }
+  columns.push_back(std::move(smallRange));
+  // Completely random bits, including the largest possible values.
+  std::vector<Id> random;
+  ad_utility::SlowRandomIntGenerator<uint64_t> allValues{
+      0, std::numeric_limits<uint64_t>::max()};
+  for (size_t i = 0; i < 1000; ++i) {
+    random.push_back(V(allValues()));
+  }
+  random.push_back(V(std::numeric_limits<uint64_t>::max()));
+  random.push_back(V(0));
+  columns.push_back(std::move(random));
+  return columns;
+}
+
+// Decompress the `compressed` column and check that the result is `expected`.
+void expectRoundTrip(ColumnCodec codec, const std::vector<char>& compressed,
+                     const std::vector<Id>& expected) {
+  std::vector<Id> result(expected.size(), V(12345));
+  columnCodec::decompress(codec, compressed, result);
+  EXPECT_THAT(result, ::testing::ElementsAreArray(expected))
+      << "codec: " << toString(codec);
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, roundTripForAllCodecs) {
+  for (const auto& column : testColumns()) {
+    for (ColumnCodec codec : columnCodec::allCodecs) {
+      auto compressed = columnCodec::compress(column, codec);
+      if (!compressed.has_value()) {
+        // Only the `Simple8bDelta` codec can fail, and only for large
+        // differences.
+        EXPECT_EQ(codec, ColumnCodec::Simple8bDelta);
+        continue;
+      }
+      expectRoundTrip(codec, compressed.value(), column);
+    }
+    auto [codec, compressed] = columnCodec::compressWithBestCodec(column);
+    expectRoundTrip(codec, compressed, column);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, lightweightCodecsAreChosenForTypicalColumns) {
+  auto columns = testColumns();
+  // Constant column.
+  auto constant = columnCodec::compressWithBestCodec(columns.at(2));
+  EXPECT_NE(constant.codec_, ColumnCodec::Zstd);
+  EXPECT_LE(constant.data_.size(), 3 * sizeof(uint64_t));
+  // Sorted column with small gaps, each gap needs at most 4 bits.
+  auto sorted = columnCodec::compressWithBestCodec(columns.at(4));
+  EXPECT_NE(sorted.codec_, ColumnCodec::Zstd);
+  EXPECT_LE(sorted.data_.size(), 1000 * 4 / 8 + 4 * sizeof(uint64_t));
+
+  // The `Simple8bDelta` codec can't handle differences that need more than 60
+  // bits.
+  std::vector<Id> largeGap{V(0), V(uint64_t{1} << 62)};
+  EXPECT_FALSE(columnCodec::compress(largeGap, ColumnCodec::Simple8bDelta)
+                   .has_value());
+}
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, corruptedInputThrows) {
+  std::vector<Id> column(100, V(3));
+  auto compressed = columnCodec::compress(column, ColumnCodec::RunLength);
+  ASSERT_TRUE(compressed.has_value());
+  // The number of rows doesn't match.
+  std::vector<Id> target(99);
+  EXPECT_ANY_THROW(columnCodec::decompress(ColumnCodec::RunLength,
+                                           compressed.value(), target));
+  compressed = columnCodec::compress(column, ColumnCodec::FrameOfReference);
+  EXPECT_ANY_THROW(columnCodec::decompress(ColumnCodec::FrameOfReference,
+                                           compressed.value(), target));
+  // The size is not a multiple of 8.
+  compressed->push_back('a');
+  target.resize(100);
+  EXPECT_ANY_THROW(columnCodec::decompress(ColumnCodec::FrameOfReference,
+                                           compressed.value(), target));
+}
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, uncompressed) {
+  for (const auto& column : testColumns()) {
+    auto compressed = columnCodec::compress(column, ColumnCodec::Uncompressed);
+    ASSERT_TRUE(compressed.has_value());
+    EXPECT_EQ(compressed->size(), column.size() * sizeof(Id));
+    expectRoundTrip(ColumnCodec::Uncompressed, compressed.value(), column);
+  }
+  // The number of rows doesn't match.
+  std::vector<Id> column(10, V(3));
+  auto compressed = columnCodec::compress(column, ColumnCodec::Uncompressed);
+  std::vector<Id> target(9);
+  EXPECT_ANY_THROW(columnCodec::decompress(ColumnCodec::Uncompressed,
+                                           compressed.value(), target));
+  EXPECT_EQ(toString(ColumnCodec::Uncompressed), "uncompressed");
+}
+
+// _____________________________________________________________________________
+TEST(ColumnCodec, serializationOfBlockMetadata) {
+  using O = CompressedBlockMetadata::OffsetAndCompressedSize;
+  std::vector<O> offsets{{0, 12, ColumnCodec::RunLength},
+                         {12, 34, ColumnCodec::Simple8bDelta},
+                         {46, 7}};
+  EXPECT_EQ(offsets.back().codec_, ColumnCodec::Zstd);
+  ad_utility::serialization::ByteBufferWriteSerializer writer;
+  writer << offsets;
+  ad_utility::serialization::ByteBufferReadSerializer reader{
+      std::move(writer).data()};
+  std::vector<O> result;
+  reader >> result;
+  EXPECT_EQ(result, offsets);
+}
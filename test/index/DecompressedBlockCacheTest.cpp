@@ -0,0 +1,93 @@
+// Copyright 2025, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+
+#include <gmock/gmock.h>
+
+#include "index/DecompressedBlockCache.h"
+#include "util/RuntimeParametersTestHelpers.h"
+
+using namespace ad_utility::memory_literals;
+
+namespace {
+// Return a column with `n` consecutive integer `Id`s starting at `start`.
+DecompressedBlockCache::Column makeColumn(size_t n, int64_t start = 0) {
+  DecompressedBlockCache::Column column;
+  for (size_t i = 0; i < n; ++i) {
+    column.push_back(Id::makeFromInt(start + static_cast<int64_t>(i)));
+  }
+  return column;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(DecompressedBlockCache, insertAndLookup) {
+  DecompressedBlockCache cache{1_MB};
+  EXPECT_TRUE(cache.isEnabled());
+  DecompressedBlockCache::Key key{0, 3};
+  EXPECT_EQ(cache.lookup(key), nullptr);
+  cache.insert(key, makeColumn(10));
+  auto result = cache.lookup(key);
+  ASSERT_NE(result, nullptr);
+  EXPECT_THAT(*result, ::testing::ElementsAreArray(makeColumn(10)));
+
+  // Keys that differ in one of the components are different.
+  EXPECT_EQ(cache.lookup({1, 3}), nullptr);
+  EXPECT_EQ(cache.lookup({0, 4}), nullptr);
+
+  // Inserting the same key again doesn't change the stored value.
+  cache.insert(key, makeColumn(10, 42));
+  EXPECT_THAT(*cache.lookup(key),
+              ::testing::ElementsAreArray(makeColumn(10)));
+
+  auto stats = cache.getStatistics();
+  EXPECT_EQ(stats.numEntries_, 1);
+  EXPECT_EQ(stats.numHits_, 2);
+  EXPECT_EQ(stats.numMisses_, 3);
+  EXPECT_EQ(stats.maxSize_, 1_MB);
+  EXPECT_GE(stats.size_, ad_utility::MemorySize::bytes(10 * sizeof(Id)));
+
+  cache.clear();
+  EXPECT_EQ(cache.lookup(key), nullptr);
+  EXPECT_EQ(cache.getStatistics().numEntries_, 0);
+}
+
+// _____________________________________________________________________________
+TEST(DecompressedBlockCache, sizeLimit) {
+  DecompressedBlockCache cache{1_kB};
+  // A column that is larger than the complete cache is never stored.
+  cache.insert({0, 0}, makeColumn(1000));
+  EXPECT_EQ(cache.lookup({0, 0}), nullptr);
+
+  // Storing more columns than fit into the cache evicts the least recently
+  // used ones.
+  for (size_t i = 0; i < 20; ++i) {
+    cache.insert({0, i}, makeColumn(10));
+  }
+  auto stats = cache.getStatistics();
+  EXPECT_LT(stats.numEntries_, 20);
+  EXPECT_LE(stats.size_, 1_kB);
+  EXPECT_NE(cache.lookup({0, 19}), nullptr);
+  EXPECT_EQ(cache.lookup({0, 0}), nullptr);
+
+  // Shrinking the cache evicts entries, a size of zero disables the cache.
+  cache.setMaxSize(0_B);
+  EXPECT_FALSE(cache.isEnabled());
+  EXPECT_EQ(cache.getStatistics().numEntries_, 0);
+  cache.insert({0, 0}, makeColumn(1));
+  EXPECT_EQ(cache.lookup({0, 0}), nullptr);
+}
+
+// _____________________________________________________________________________
+TEST(DecompressedBlockCache, globalInstanceFollowsRuntimeParameter) {
+  auto& cache = DecompressedBlockCache::get();
+  {
+    auto cleanup =
+        setRuntimeParameterForTest<"decompressed-block-cache-max-size">(0_B);
+    EXPECT_FALSE(cache.isEnabled());
+    EXPECT_EQ(cache.getStatistics().maxSize_, 0_B);
+  }
+  EXPECT_TRUE(cache.isEnabled());
+  EXPECT_EQ(
+      cache.getStatistics().maxSize_,
+      RuntimeParameters().get<"decompressed-block-cache-max-size">());
+}
@@ -122,3 +122,36 @@ TEST(ParallelBuffer, ParallelBufferWithEndRegexLongLookahead) {
   }
   ad_utility::deleteFile(filename);
 }
+
+// ________________________________________________________
+TEST(ParallelBuffer, ParallelStringBuffer) {
+  std::string input = "abcdefghij";
+  size_t blocksize = 4;
+  ParallelStringBuffer buf(blocksize, input);
+  EXPECT_EQ(buf.getBlocksize(), blocksize);
+  buf.open("ignored");
+  std::vector<ParallelFileBuffer::BufferType> expected{
+      {'a', 'b', 'c', 'd'}, {'e', 'f', 'g', 'h'}, {'i', 'j'}};
+
+  std::vector<ParallelFileBuffer::BufferType> actual;
+  while (auto block = buf.getNextBlock()) {
+    actual.push_back(block.value());
+  }
+  EXPECT_THAT(actual, ::testing::ElementsAreArray(expected));
+
+  // The same input, split at the end of the given regex.
+  ParallelBufferWithEndRegex bufWithRegex(
+      std::make_unique<ParallelStringBuffer>(5, "ab1cde23fgh"),
+      "([0-9])[a-z]");
+  EXPECT_EQ(bufWithRegex.getBlocksize(), 5);
+  expected = {{'a', 'b', '1'}, {'c', 'd', 'e', '2', '3'}, {'f', 'g', 'h'}};
+  actual.clear();
+  while (auto block = bufWithRegex.getNextBlock()) {
+    actual.push_back(block.value());
+  }
+  EXPECT_THAT(actual, ::testing::ElementsAreArray(expected));
+
+  // An empty input yields no blocks.
+  ParallelStringBuffer emptyBuf(blocksize, "");
+  EXPECT_FALSE(emptyBuf.getNextBlock().has_value());
+}